@@ -0,0 +1,565 @@
+// End-to-end latency benchmark: HID arrival -> reader ring -> pipeline -> mapper -> output.
+//
+// Runs on any platform with no devices attached. Reports are synthesized (or replayed
+// from a recording) into the same HidReportRing the HID reader threads fill; a pipeline
+// thread drains them like main's background thread; the mapper publishes into a
+// RecordingNullOutput. Every report is timestamped at each boundary:
+//
+//   ring     arrival (push)          -> picked up by the pipeline thread
+//   pipeline picked up               -> decode/filter/forward done
+//   mapper   forward done            -> mapper tick that consumed it
+//   output   mapper tick start       -> backend submit()
+//   total    arrival                 -> backend submit()
+//
+// Usage: hotas_latency_bench [--mode fixed|event|both] [--reports N] [--rate HZ]
+//                            [--poll-us US] [--mapper-hz HZ] [--no-filters]
+//                            [--replay FILE] [--record-out FILE]
+//                            [--csv FILE] [--profile FILE] [--alloc-check]
+//                            [--priority low|normal|above_normal|high|realtime]
+//                            [--cpus LIST] [--lock-memory] [--inject-stall MS]
+//                            [--log-level debug|info|warn|error] [--log-file FILE]
+//                            [--devices N] [--all-signals]
+//                            [--topology split|fused] [--queue-depth N]
+//                            [--spectrum FFT_SIZE]
+//
+// --log-level debug turns on the mapper's per-tick diagnostics (async logger, written
+// to stderr or --log-file) to check what they cost in latency.
+//
+// The pipeline thread merges the device rings into frames (FrameMerger) and evaluates one
+// per report; the skew of those frames is printed too. --devices N (up to 16) adds
+// copies of the stick/throttle definitions under new names and VID/PIDs, to time the
+// path with N devices reporting at --rate each.
+//
+// As in the app, the pipeline evaluates only the signals the mapping profile uses
+// (signal bus); --all-signals evaluates every descriptor for comparison.
+//
+// --topology picks the stage layout as the app's pipeline_topology setting does:
+// split (default) runs the mapper on its own thread, fed through an SPSC queue of
+// --queue-depth frames (0 = hand-off under the mapper lock); fused ticks the mapper
+// on the pipeline thread after each pass (--mode is ignored, there is no pacing).
+// The queue's depth and lag print with each run. Combine with --cpus to compare
+// layouts pinned to few or many cores.
+//
+// The producer feeds each device's ReportIntervalStats like the HID reader threads do;
+// the detected rate and interval percentiles are printed with the latencies.
+//
+// The stall watchdog runs throughout; --inject-stall blocks the pipeline thread once,
+// halfway through each run, to exercise detection and the neutral-output hold.
+//
+// --priority / --cpus apply to the producer (input_io), pipeline and mapper (output)
+// thread roles, as the app's settings would; what the OS actually granted is printed
+// at the end (without privileges realtime falls back to nice, then to unchanged).
+//
+// --spectrum analyzes the workload (synthetic or --replay) offline instead of timing it:
+// each axis's noise spectrum (analyze_spectrum, FFT_SIZE points, a power of two) with
+// its peaks and the notch/low-pass it suggests, as the app's Axis Spectrum window shows.
+//
+// --alloc-check (builds with -DHOTAS_ENABLE_ALLOC_CHECK=ON) arms the no-alloc zones
+// after the first 10% of the workload and fails the run if the steady-state hot
+// path (ring push, pipeline pass, filters, mapper tick) allocated at all.
+#include "core/alloc_guard.hpp"
+#include "core/async_log.hpp"
+#include "core/hid_report_ring.hpp"
+#include "core/report_recording.hpp"
+#include "core/report_stats.hpp"
+#include "core/spectrum.hpp"
+#include "core/stall_watchdog.hpp"
+#include "core/thread_roles.hpp"
+#include "xinput/hotas_mapper.hpp"
+#include "xinput/hotas_pipeline.hpp"
+#include "xinput/null_output.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifndef HOTAS_CONFIG_DIR
+#define HOTAS_CONFIG_DIR "res/config" // set by CMake to the source tree's res/config
+#endif
+
+static double steady_seconds() {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+struct Options {
+    std::string mode = "both";
+    size_t reports = 5000;         // per device (synthetic)
+    double rate = 1000.0;          // reports/s per device (synthetic)
+    int poll_us = 4000;            // pipeline pass period; 4 ms = the app's background thread
+    double mapper_hz = 1000.0;
+    bool filters = true;
+    bool alloc_check = false;
+    int inject_stall_ms = 0;
+    std::string log_file;
+    hotas_rt::ThreadRoleConfig roles;
+    std::string replay;
+    std::string record_out;
+    std::string csv = HOTAS_CONFIG_DIR "/X56_Hotas_hid_bit_map.csv";
+    std::string profile;
+    size_t devices = 2;
+    bool all_signals = false;
+    bool fused = false;
+    size_t queue_depth = 64;
+    size_t spectrum = 0;           // FFT size; 0 = time the pipeline
+};
+
+static void usage() {
+    std::fprintf(stderr,
+        "usage: hotas_latency_bench [--mode fixed|event|both] [--reports N] [--rate HZ]\n"
+        "                           [--poll-us US] [--mapper-hz HZ] [--no-filters]\n"
+        "                           [--replay FILE] [--record-out FILE] [--csv FILE] [--profile FILE]\n"
+        "                           [--alloc-check] [--priority P] [--cpus LIST] [--lock-memory]\n"
+        "                           [--inject-stall MS] [--log-level L] [--log-file FILE] [--devices N]\n"
+        "                           [--all-signals] [--topology split|fused] [--queue-depth N]\n"
+        "                           [--spectrum FFT_SIZE]\n");
+}
+
+static bool parse_args(int argc, char** argv, Options& o) {
+    for (int i = 1; i < argc; ++i) {
+        std::string a = argv[i];
+        auto value = [&](const char* name) -> const char* {
+            if (i + 1 >= argc) { std::fprintf(stderr, "%s needs a value\n", name); return nullptr; }
+            return argv[++i];
+        };
+        const char* v = nullptr;
+        if (a == "--no-filters") { o.filters = false; continue; }
+        if (a == "--alloc-check") { o.alloc_check = true; continue; }
+        if (a == "--lock-memory") { o.roles.lock_memory = true; continue; }
+        if (a == "--all-signals") { o.all_signals = true; continue; }
+        if (a == "-h" || a == "--help") return false;
+        if (!(v = value(a.c_str()))) return false;
+        if (a == "--mode") o.mode = v;
+        else if (a == "--reports") o.reports = (size_t)std::strtoull(v, nullptr, 10);
+        else if (a == "--rate") o.rate = std::atof(v);
+        else if (a == "--poll-us") o.poll_us = std::atoi(v);
+        else if (a == "--mapper-hz") o.mapper_hz = std::atof(v);
+        else if (a == "--replay") o.replay = v;
+        else if (a == "--record-out") o.record_out = v;
+        else if (a == "--csv") o.csv = v;
+        else if (a == "--profile") o.profile = v;
+        else if (a == "--spectrum") o.spectrum = (size_t)std::strtoull(v, nullptr, 10);
+        else if (a == "--devices") o.devices = (size_t)std::strtoull(v, nullptr, 10);
+        else if (a == "--queue-depth") o.queue_depth = (size_t)std::strtoull(v, nullptr, 10);
+        else if (a == "--topology") {
+            if (std::strcmp(v, "split") != 0 && std::strcmp(v, "fused") != 0) { std::fprintf(stderr, "--topology takes split or fused\n"); return false; }
+            o.fused = std::strcmp(v, "fused") == 0;
+        }
+        else if (a == "--inject-stall") o.inject_stall_ms = std::atoi(v);
+        else if (a == "--log-file") o.log_file = v;
+        else if (a == "--log-level") {
+            hotas_log::Level lvl{};
+            if (!hotas_log::parse_level(v, lvl)) { std::fprintf(stderr, "bad value for --log-level: %s\n", v); return false; }
+            hotas_log::set_level(lvl);
+        }
+        else if (a == "--priority" || a == "--cpus") {
+            hotas_rt::Priority p{};
+            uint64_t mask = 0;
+            const bool ok = a == "--priority" ? hotas_rt::parse_priority(v, p) : hotas_rt::parse_cpu_list(v, mask);
+            if (!ok) { std::fprintf(stderr, "bad value for %s: %s\n", a.c_str(), v); return false; }
+            for (auto r : { hotas_rt::ThreadRole::InputIo, hotas_rt::ThreadRole::Pipeline, hotas_rt::ThreadRole::Output }) {
+                if (a == "--priority") o.roles.roles[(size_t)r].priority = p;
+                else o.roles.roles[(size_t)r].cpu_mask = mask;
+            }
+        }
+        else { std::fprintf(stderr, "unknown option %s\n", a.c_str()); return false; }
+    }
+    if (o.mode != "fixed" && o.mode != "event" && o.mode != "both") return false;
+    if (o.spectrum && (o.spectrum < 16 || (o.spectrum & (o.spectrum - 1)))) { std::fprintf(stderr, "--spectrum takes a power of two >= 16\n"); return false; }
+    if (o.devices < 1 || o.devices > DeviceRegistry::kMaxDevices) { std::fprintf(stderr, "--devices takes 1..%zu\n", DeviceRegistry::kMaxDevices); return false; }
+    return o.rate > 0.0 && o.mapper_hz > 0.0 && o.poll_us >= 0 && o.inject_stall_ms >= 0;
+}
+
+static void put_bits(std::vector<uint8_t>& bytes, int bit_start, int bits, uint64_t value) {
+    for (int i = 0; i < bits; ++i) {
+        const size_t byte_idx = (size_t)(bit_start + i) / 8;
+        const int bit_in_byte = (bit_start + i) % 8;
+        if (byte_idx >= bytes.size()) return;
+        if ((value >> i) & 1) bytes[byte_idx] |= (uint8_t)(1u << bit_in_byte);
+        else bytes[byte_idx] &= (uint8_t)~(1u << bit_in_byte);
+    }
+}
+
+// The X56 pair, plus copies of its halves (alternating stick, throttle) up to `count`
+// devices, each with its own name and PID and the same signals.
+static void build_devices(const Options& o, DeviceRegistry& devices, std::vector<HotasReader::SignalDescriptor>& sigs) {
+    devices = DeviceRegistry::x56();
+    sigs = HotasReader::load_signal_csv(o.csv, devices);
+    if (sigs.empty()) sigs = HotasReader::default_signals();
+    const std::vector<HotasReader::SignalDescriptor> x56_sigs = sigs;
+    for (size_t d = devices.size(); d < o.devices; ++d) {
+        const DeviceIndex model = (DeviceIndex)(d % 2);
+        DeviceDefinition def = devices.device(model);
+        def.name = "dev" + std::to_string(d);
+        def.label = def.name;
+        def.pid = (uint16_t)(0x1000 + d);
+        devices.add(def, nullptr);
+        for (auto sd : x56_sigs) {
+            if (sd.device != model) continue;
+            sd.device = (DeviceIndex)d;
+            sd.device_name = def.name;
+            sigs.push_back(sd);
+        }
+    }
+    if (o.devices < devices.size()) {
+        // Stick only
+        DeviceRegistry one;
+        one.add(devices.device(DeviceRegistry::kX56Stick), nullptr);
+        devices = one;
+        sigs.erase(std::remove_if(sigs.begin(), sigs.end(), [](const auto& sd) { return sd.device != DeviceRegistry::kX56Stick; }), sigs.end());
+    }
+}
+
+// Interleaved reports of every device at `rate`: analog signals sweep sines with a
+// per-signal phase, digital signals toggle with per-signal periods.
+static std::vector<RecordedReport> synthesize(const DeviceRegistry& devices, const std::vector<HotasReader::SignalDescriptor>& sigs,
+                                              size_t count, double rate) {
+    const size_t nd = devices.size();
+    std::vector<size_t> len(nd, 1);
+    for (const auto& sd : sigs) len[sd.device] = std::max(len[sd.device], (size_t)(sd.bit_start + sd.bits + 7) / 8);
+    std::vector<RecordedReport> out;
+    out.reserve(count * nd);
+    for (size_t k = 0; k < count; ++k) {
+        for (size_t dev = 0; dev < nd; ++dev) {
+            RecordedReport r;
+            r.device = devices.device((DeviceIndex)dev).name;
+            r.t = ((double)k + (double)dev / (double)nd) / rate;
+            r.bytes.assign(len[dev], 0);
+            for (size_t i = 0; i < sigs.size(); ++i) {
+                const auto& sd = sigs[i];
+                if (sd.device != dev || sd.bits <= 0 || sd.bits > 32) continue;
+                const uint64_t maxv = (1ULL << sd.bits) - 1;
+                uint64_t v;
+                if (sd.analog) v = (uint64_t)std::llround((0.5 + 0.5 * std::sin(2.0 * 3.14159265358979 * 0.5 * r.t + (double)i)) * (double)maxv);
+                else v = ((k / (50 + 7 * i)) & 1) ? std::min<uint64_t>(maxv, 1 + i % maxv) : 0;
+                put_bits(r.bytes, sd.bit_start, sd.bits, v);
+            }
+            out.push_back(std::move(r));
+        }
+    }
+    return out;
+}
+
+// --spectrum: noise spectrum, peaks and suggested sections of every axis in the workload
+static int print_spectra(const Options& o, const std::vector<HotasReader::SignalDescriptor>& sigs, const std::vector<RecordedReport>& work) {
+    const auto inputs = recorded_analog_inputs(sigs, work);
+    for (size_t i = 0; i < sigs.size(); ++i) {
+        if (!sigs[i].analog) continue;
+        const std::string name = sigs[i].device_name + ":" + sigs[i].name;
+        SpectrumResult r;
+        const double range = sigs[i].norm != SignalNorm::Raw ? 2.0 : (double)((1ULL << sigs[i].bits) - 1ULL);
+        if (!analyze_spectrum(inputs[i], o.spectrum, r, range)) {
+            std::printf("%-28s %zu samples, too few for %zu-point segments\n", name.c_str(), inputs[i].size(), o.spectrum);
+            continue;
+        }
+        std::printf("%-28s fs %.1f Hz, %zu segments, floor %.1f dB, >%.0f Hz rms %.5f\n", name.c_str(), r.fs, r.segments, r.floor_db,
+                    kSpectrumMotionHz, r.hf_rms);
+        for (const auto& p : r.peaks) std::printf("    peak %8.2f Hz %7.1f dB (+%.1f)\n", p.hz, p.db, p.prominence_db);
+        std::printf("    suggest %s: %s\n", format_biquad_chain(r.suggestion).c_str(), r.reason.c_str());
+    }
+    return 0;
+}
+
+static void add_default_mappings(HotasMapper& mapper) {
+    auto add = [&](const char* id, const char* sig, const char* action) {
+        MappingEntry e; e.id = id; e.signal_id = sig; e.action = action;
+        mapper.add_mapping(e);
+    };
+    add("roll", "stick:joy_x", "x360:left_x");
+    add("pitch", "stick:joy_y", "x360:left_y");
+    add("yaw", "stick:joy_z", "x360:right_x");
+    add("thrust", "throttle:left_throttle", "x360:left_trigger");
+    add("fire", "stick:trigger", "x360:button_a");
+    add("hat", "stick:H1_UP", "x360:dpad_up");
+    add("gear", "stick:B", "keyboard:PAGEDOWN");
+}
+
+struct StageStats {
+    std::vector<double> us;
+    void add(double seconds) { us.push_back(seconds * 1e6); }
+    void print(const char* name) {
+        if (us.empty()) { std::printf("  %-9s        n/a\n", name); return; }
+        std::sort(us.begin(), us.end());
+        auto pct = [&](double p) { return us[std::min(us.size() - 1, (size_t)(p * (double)(us.size() - 1) + 0.5))]; };
+        std::printf("  %-9s %10.1f %10.1f %10.1f\n", name, pct(0.50), pct(0.99), us.back());
+    }
+};
+
+static bool run(const Options& o, HotasMapper::Pacing pacing, const DeviceRegistry& devices,
+                const std::vector<HotasReader::SignalDescriptor>& sigs, const std::vector<RecordedReport>& work) {
+    const size_t n = work.size();
+    const size_t nd = devices.size();
+    // Device names are resolved once here, as the reader does at enumeration
+    std::vector<DeviceIndex> device_of(n);
+    for (size_t i = 0; i < n; ++i) device_of[i] = (DeviceIndex)devices.find(work[i].device);
+
+    std::vector<HidReportRing> rings(nd);
+    std::vector<ReportIntervalStats> input_stats(nd); // arrival statistics, as the reader threads keep them
+    std::vector<std::vector<size_t>> ring_to_global(nd);
+    for (size_t i = 0; i < n; ++i) ring_to_global[device_of[i]].push_back(i);
+
+    // Per-report timestamps, written by exactly one thread each
+    std::vector<double> arrival(n, 0.0), picked(n, 0.0), done(n, 0.0);
+
+    const double replay_span = n ? work.back().t - work.front().t : 0.0;
+    const size_t out_capacity = (size_t)((replay_span + 1.0) * o.mapper_hz) * 2 + n * 2 + 1024;
+    auto output_owner = std::make_unique<RecordingNullOutput>(out_capacity);
+    RecordingNullOutput* output = output_owner.get();
+    HotasMapper mapper(std::move(output_owner));
+    if (!o.profile.empty()) {
+        if (!mapper.load_profile(o.profile)) { std::fprintf(stderr, "cannot load profile %s\n", o.profile.c_str()); return false; }
+    } else {
+        add_default_mappings(mapper);
+    }
+
+    HotasPipeline pipeline(sigs, nd);
+    pipeline.set_mapper(&mapper);
+    if (o.filters) {
+        for (const auto& out : pipeline.outputs()) {
+            if (out.derived) continue;
+            const auto& sd = sigs[(size_t)out.descriptor];
+            pipeline.set_filter_mode(out.map_key, sd.analog ? HotasPipeline::FilterAnalog : HotasPipeline::FilterDigital);
+        }
+        pipeline.set_filter_params(5.0, 5.0);
+    }
+    // The mapping profile is the only consumer
+    SignalBus bus(sigs.size());
+    if (!o.all_signals) {
+        std::vector<std::string> keys;
+        for (const auto& e : mapper.list_mapping_entries()) keys.push_back(e.signal_id);
+        bus.set_interest(bus.add_consumer("mappings"), pipeline.interest_for(keys));
+        pipeline.set_signal_bus(&bus);
+    }
+
+    // As in the app: hold the output centered while a stage is stalled
+    hotas_watchdog::reset_stats();
+    int stalled_stages = 0;
+    uint64_t neutral_holds = 0;
+    hotas_watchdog::set_stall_handler([&](const hotas_watchdog::StallNotice& sn) {
+        stalled_stages += sn.begin ? 1 : -1;
+        if (stalled_stages < 0) stalled_stages = 0;
+        if (sn.begin) ++neutral_holds;
+        mapper.set_neutral_hold(stalled_stages > 0);
+    });
+
+    FrameMerger merger;
+    for (size_t d = 0; d < nd; ++d) merger.attach(d, &rings[d]);
+
+    mapper.set_sample_queue(o.fused ? 0 : o.queue_depth);
+    if (o.fused) mapper.start_inline();
+    else mapper.start(o.mapper_hz, pacing);
+    std::atomic<bool> producer_done{false};
+    std::atomic<bool> stop{false};
+
+    std::thread pipeline_thread([&] {
+        hotas_rt::ScopedThreadRole role(hotas_rt::ThreadRole::Pipeline, "pipeline");
+        hotas_watchdog::StageHeartbeat heartbeat("pipeline", 0.1);
+        std::vector<size_t> batch;
+        batch.reserve(1024);
+        size_t handled = 0;
+        bool stall_injected = o.inject_stall_ms == 0;
+        while (!stop.load(std::memory_order_acquire)) {
+            heartbeat.beat();
+            if (!stall_injected && handled >= n / 2) {
+                stall_injected = true;
+                std::this_thread::sleep_for(std::chrono::milliseconds(o.inject_stall_ms));
+            }
+            HOTAS_NO_ALLOC_ZONE("pipeline.pass");
+            const bool last_pass = producer_done.load(std::memory_order_acquire);
+            const double pick_t = steady_seconds();
+            batch.clear();
+            // One pipeline evaluation per report, as in the app (frames in arrival order)
+            while (const MergedFrame* frame = merger.next()) {
+                const size_t g = ring_to_global[frame->trigger][frame->parts[frame->trigger].seq];
+                picked[g] = pick_t;
+                batch.push_back(g);
+                pipeline.process_frame(*frame, false);
+            }
+            if (!batch.empty()) {
+                pipeline.notify_mapper();
+                const double done_t = steady_seconds();
+                for (size_t g : batch) done[g] = done_t;
+                handled += batch.size();
+            }
+            if (o.fused) mapper.tick();
+            if (batch.empty() && last_pass) break;
+            if (o.poll_us > 0) std::this_thread::sleep_for(std::chrono::microseconds(o.poll_us));
+            else std::this_thread::yield();
+        }
+    });
+
+    // Producer: replay the workload with its original spacing, stamping arrival at push
+    {
+        hotas_rt::ScopedThreadRole role(hotas_rt::ThreadRole::InputIo, "producer");
+        const double t0 = steady_seconds() + 0.010;
+        const double w0 = n ? work.front().t : 0.0;
+        for (size_t i = 0; i < n; ++i) {
+            if (o.alloc_check && i == n / 10) hotas_alloc::arm(true); // warm-up done
+            HOTAS_NO_ALLOC_ZONE("hid.read");
+            const double due = t0 + (work[i].t - w0);
+            double now = steady_seconds();
+            if (due - now > 0.0005) std::this_thread::sleep_for(std::chrono::duration<double>(due - now - 0.0003));
+            while ((now = steady_seconds()) < due) {}
+            arrival[i] = now;
+            const size_t d = device_of[i];
+            rings[d].push(work[i].bytes.data(), work[i].bytes.size(), now);
+            input_stats[d].on_report(now, work[i].bytes.data(), work[i].bytes.size());
+        }
+        producer_done.store(true, std::memory_order_release);
+    }
+    pipeline_thread.join();
+    // Let the publisher pick up the final frame before stopping
+    std::this_thread::sleep_for(std::chrono::duration<double>(3.0 / o.mapper_hz + 0.005));
+    stop.store(true, std::memory_order_release);
+    mapper.stop();
+    hotas_watchdog::set_stall_handler(nullptr);
+
+    // Match each report to the first output whose source time covers its arrival
+    StageStats ring_s, pipe_s, mapper_s, output_s, total_s;
+    const size_t recs = output->count();
+    size_t r = 0, unmatched = 0;
+    std::vector<size_t> order(n);
+    for (size_t i = 0; i < n; ++i) order[i] = i;
+    std::sort(order.begin(), order.end(), [&](size_t a, size_t b) { return arrival[a] < arrival[b]; });
+    for (size_t i : order) {
+        while (r < recs && output->record(r).timing.source_t < arrival[i]) ++r;
+        if (r >= recs || done[i] == 0.0) { ++unmatched; continue; }
+        const auto& rec = output->record(r);
+        ring_s.add(picked[i] - arrival[i]);
+        pipe_s.add(done[i] - picked[i]);
+        mapper_s.add(std::max(0.0, rec.timing.tick_t - done[i]));
+        output_s.add(rec.submit_t - rec.timing.tick_t);
+        total_s.add(rec.submit_t - arrival[i]);
+    }
+
+    std::printf("\n[%s] %zu reports, %zu outputs (%llu submits), %zu unmatched, %zu of %zu signals evaluated\n",
+                o.fused ? "fused" : pacing == HotasMapper::Pacing::Fixed ? "fixed pacing" : "event-driven pacing", n, recs,
+                (unsigned long long)output->submits(), unmatched, pipeline.active_signal_count(), sigs.size());
+    std::printf("  %-9s %10s %10s %10s   (microseconds)\n", "stage", "p50", "p99", "max");
+    ring_s.print("ring");
+    pipe_s.print("pipeline");
+    mapper_s.print("mapper");
+    output_s.print("output");
+    total_s.print("total");
+    const auto qs = mapper.sample_queue_stats();
+    if (qs.capacity) {
+        std::printf("  queue    pipeline->output SPSC %zu frames: %llu pushed, %llu full, depth max %zu, lag mean %.1f / max %.1f us\n",
+                    qs.capacity, (unsigned long long)qs.frames, (unsigned long long)qs.overflows, qs.meter.high_water,
+                    qs.meter.lag_mean_us, qs.meter.lag_max_us);
+    } else {
+        std::printf("  queue    pipeline->output %s\n", o.fused ? "fused (mapper ticks on the pipeline thread)" : "mapper lock");
+    }
+    for (size_t d = 0; d < nd; ++d) {
+        const auto st = input_stats[d].snapshot();
+        if (st.reports == 0) continue;
+        std::printf("  input    %-9s ", devices.device((DeviceIndex)d).name.c_str());
+        if (st.nominal_hz > 0.0) std::printf("%.0f Hz", st.nominal_hz);
+        else std::printf("%s", st.measuring() ? "measuring" : "irregular");
+        std::printf(", interval mean %.3f / p50 %.3f / p99 %.3f / max %.3f ms, %llu duplicates, ~%llu missed\n",
+                    st.mean_ms, st.p50_ms, st.p99_ms, st.max_gap_ms, (unsigned long long)st.duplicates,
+                    (unsigned long long)st.missed_estimate);
+    }
+    const auto skew = merger.skew_stats();
+    std::printf("  frames   %llu merged, device skew mean %.3f / max %.3f ms, %llu at the %.0f ms bound, %llu dropped\n",
+                (unsigned long long)skew.frames, skew.mean_ms, skew.max_ms, (unsigned long long)skew.over_bound,
+                merger.skew_bound() * 1000.0, (unsigned long long)skew.dropped);
+    for (const auto& st : hotas_watchdog::stage_stats()) {
+        if (st.beats == 0) continue;
+        std::printf("  stall    %-9s %llu stalls, longest %.1f ms, histogram", st.name.c_str(), (unsigned long long)st.stalls, st.longest_s * 1000.0);
+        for (size_t b = 0; b < hotas_watchdog::kBuckets; ++b) std::printf(" %llu", (unsigned long long)st.histogram[b]);
+        std::printf("\n");
+    }
+    if (neutral_holds) std::printf("  stall    output held neutral %llu time(s)\n", (unsigned long long)neutral_holds);
+    for (const auto& rec : hotas_watchdog::recent_stalls()) {
+        std::printf("  stall    %s %.1f ms, last trace events:", rec.stage.c_str(), rec.duration_s * 1000.0);
+        if (rec.tail.empty()) std::printf(" (tracing not compiled in)");
+        for (size_t i = rec.tail.size() > 4 ? rec.tail.size() - 4 : 0; i < rec.tail.size(); ++i)
+            std::printf(" %s@-%.1fms", rec.tail[i].name ? rec.tail[i].name : "?", rec.tail[i].age_ms);
+        std::printf("\n");
+    }
+
+    if (o.alloc_check) {
+        hotas_alloc::arm(false);
+        hotas_alloc::Violation v[16];
+        const size_t distinct = hotas_alloc::violations(v, 16);
+        std::printf("  alloc check: %llu allocations in no-alloc zones after warm-up\n",
+                    (unsigned long long)hotas_alloc::violation_count());
+        for (size_t i = 0; i < distinct && i < 16; ++i) {
+            char where[160];
+            hotas_alloc::format_zone_stack(v[i], where, sizeof(where));
+            std::printf("    %-50s %8llu allocs %10llu bytes\n", where, (unsigned long long)v[i].count, (unsigned long long)v[i].bytes);
+        }
+        const bool clean = distinct == 0;
+        hotas_alloc::reset_violations();
+        return clean;
+    }
+    return true;
+}
+
+int main(int argc, char** argv) {
+    Options o;
+    if (!parse_args(argc, argv, o)) { usage(); return 2; }
+
+    DeviceRegistry devices;
+    std::vector<HotasReader::SignalDescriptor> sigs;
+    build_devices(o, devices, sigs);
+
+    std::vector<RecordedReport> work;
+    if (!o.replay.empty()) {
+        std::string err;
+        if (!load_report_recording(o.replay, work, &err)) { std::fprintf(stderr, "%s\n", err.c_str()); return 1; }
+        std::stable_sort(work.begin(), work.end(), [](const RecordedReport& a, const RecordedReport& b) { return a.t < b.t; });
+        const size_t before = work.size();
+        work.erase(std::remove_if(work.begin(), work.end(), [&](const RecordedReport& r) { return devices.find(r.device) < 0; }), work.end());
+        if (work.size() != before) std::fprintf(stderr, "skipped %zu reports of unknown devices\n", before - work.size());
+    } else {
+        work = synthesize(devices, sigs, o.reports, o.rate);
+    }
+    if (work.empty()) { std::fprintf(stderr, "no reports to replay\n"); return 1; }
+    if (o.spectrum) return print_spectra(o, sigs, work);
+    if (o.alloc_check && !hotas_alloc::compiled_in()) {
+        std::fprintf(stderr, "--alloc-check needs a build configured with -DHOTAS_ENABLE_ALLOC_CHECK=ON\n");
+        return 2;
+    }
+    if (!o.record_out.empty()) {
+        std::string err;
+        if (!save_report_recording(o.record_out, work, &err)) { std::fprintf(stderr, "%s\n", err.c_str()); return 1; }
+    }
+
+    hotas_rt::configure(o.roles);
+    const std::string mem_lock = hotas_rt::apply_memory_lock();
+    hotas_watchdog::start();
+    if (!o.log_file.empty()) {
+        std::string err;
+        if (!hotas_log::open_file(o.log_file, &err)) { std::fprintf(stderr, "%s\n", err.c_str()); return 1; }
+        hotas_log::set_stderr(false);
+    }
+    hotas_log::start();
+
+    std::printf("hotas_latency_bench: %zu devices, %zu signals, %zu reports, pipeline poll %d us, mapper %.0f Hz, filters %s, %s topology\n",
+                devices.size(), sigs.size(), work.size(), o.poll_us, o.mapper_hz, o.filters ? "on" : "off", o.fused ? "fused" : "split");
+    bool ok = true;
+    if (o.fused) {
+        ok = run(o, HotasMapper::Pacing::Fixed, devices, sigs, work);
+    } else {
+        if (o.mode == "fixed" || o.mode == "both") ok = run(o, HotasMapper::Pacing::Fixed, devices, sigs, work) && ok;
+        if (o.mode == "event" || o.mode == "both") ok = run(o, HotasMapper::Pacing::EventDriven, devices, sigs, work) && ok;
+    }
+
+    hotas_watchdog::stop();
+    hotas_log::stop();
+    if (hotas_log::dropped()) std::printf("log: %llu records dropped (ring full)\n", (unsigned long long)hotas_log::dropped());
+
+    std::printf("\nthread roles (memory lock: %s)\n", mem_lock.c_str());
+    for (const auto& ts : hotas_rt::thread_status()) {
+        const std::string cpus = ts.cpu_mask ? hotas_rt::format_cpu_list(ts.cpu_mask) + (ts.affinity_ok ? "" : " (failed)") : "any";
+        std::printf("  %-9s %-10s requested %-12s applied %-40s cpus %s\n", ts.name.c_str(), hotas_rt::role_name(ts.role),
+                    hotas_rt::priority_name(ts.requested), ts.applied.c_str(), cpus.c_str());
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,1528 @@
+// Microbenchmarks for the core data structures and per-sample kernels.
+//
+// Each benchmark is timed in batches that grow until one batch takes --min-time;
+// the reported ns/op is the median over --repeat batches. Results print as a table
+// and, with --json, as a JSON document for tracking regressions between builds:
+//
+//   { "suite": "hotas_bench", "timestamp": <unix s>, "compiler": "...",
+//     "results": [ { "name": "...", "ns_per_op": 12.3, "iterations": N, "items_per_op": K }, ... ] }
+//
+// Usage: hotas_bench [--filter SUBSTR] [--min-time SECONDS] [--repeat K] [--json FILE|-]
+#define HOTAS_TELEMETRY_ATTACH // reader-side attach for the telemetry checks
+#include "core/aligned_window.hpp"
+#include "core/alloc_guard.hpp"
+#include "core/async_log.hpp"
+#include "core/axis_histogram.hpp"
+#include "core/biquad.hpp"
+#include "core/cache_line.hpp"
+#include "core/frame_arena.hpp"
+#include "core/hid_decode.hpp"
+#include "core/hid_descriptor.hpp"
+#include "core/input_filters.hpp"
+#include "core/page_alloc.hpp"
+#include "core/report_stats.hpp"
+#include "core/ring_buffer.hpp"
+#include "core/spectrum.hpp"
+#include "core/spike_detector.hpp"
+#include "core/stall_watchdog.hpp"
+#include "core/telemetry_export.hpp"
+#include "core/trace.hpp"
+#include "generated/x56_bitmap.hpp"
+#include "ui/plot_series.hpp"
+#include "xinput/hotas_mapper.hpp"
+#include "xinput/hotas_pipeline.hpp"
+#include "xinput/hotas_reader.hpp"
+#include "xinput/null_output.hpp"
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <functional>
+#include <initializer_list>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#if defined(__linux__)
+#include <fcntl.h>
+#include <linux/perf_event.h>
+#include <sys/file.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+#ifndef HOTAS_CONFIG_DIR
+#define HOTAS_CONFIG_DIR "res/config" // set by CMake to the source tree's res/config
+#endif
+
+// Results are folded into this so the optimizer cannot drop the measured work
+static volatile uint64_t g_sink = 0;
+static void consume(uint64_t v) { g_sink = g_sink + v; }
+static void consume(double v) { consume((uint64_t)(int64_t)(v * 1024.0)); }
+// Set by the consistency checks that run alongside the timings (non-zero exit)
+static bool g_check_failed = false;
+
+struct BenchResult {
+    std::string name;
+    double ns_per_op = 0.0;
+    uint64_t iterations = 0;   // ops in the median batch
+    double items_per_op = 1.0; // elements processed per op (samples, mappings, ...)
+};
+
+struct BenchOptions {
+    std::string filter;
+    double min_time = 0.1;
+    int repeat = 5;
+    std::string json;
+};
+
+class BenchRunner {
+public:
+    explicit BenchRunner(const BenchOptions& o) : _opt(o) {}
+
+    // body(iters) performs `iters` operations.
+    void run(const std::string& name, double items_per_op, const std::function<void(uint64_t)>& body) {
+        if (!enabled(name)) return;
+        using clock = std::chrono::steady_clock;
+        auto time_batch = [&](uint64_t iters) {
+            auto t0 = clock::now();
+            body(iters);
+            return std::chrono::duration<double>(clock::now() - t0).count();
+        };
+        // Calibrate: grow the batch until it runs for min_time
+        uint64_t iters = 1;
+        double secs = time_batch(iters);
+        while (secs < _opt.min_time && iters < (1ULL << 40)) {
+            const double scale = secs > 0.0 ? std::min(10.0, std::max(2.0, 1.2 * _opt.min_time / secs)) : 10.0;
+            iters = (uint64_t)((double)iters * scale);
+            secs = time_batch(iters);
+        }
+        std::vector<double> ns;
+        for (int r = 0; r < _opt.repeat; ++r) ns.push_back(time_batch(iters) * 1e9 / (double)iters);
+        std::sort(ns.begin(), ns.end());
+        record(BenchResult{ name, ns[ns.size() / 2], iters, items_per_op });
+    }
+
+    bool enabled(const std::string& name) const { return _opt.filter.empty() || name.find(_opt.filter) != std::string::npos; }
+    int repeat() const { return _opt.repeat; }
+
+    // For benchmarks that time themselves (one-shot work that cannot be batched)
+    void record(const BenchResult& res) {
+        std::fprintf(table(), "%-40s %12.2f ns/op %12.2f ns/item %14llu iters\n", res.name.c_str(), res.ns_per_op,
+                    res.ns_per_op / res.items_per_op, (unsigned long long)res.iterations);
+        _results.push_back(res);
+    }
+
+    // With JSON on stdout the table goes to stderr
+    FILE* table() const { return _opt.json == "-" ? stderr : stdout; }
+
+    bool write_json() const {
+        if (_opt.json.empty()) return true;
+        nlohmann::json j;
+        j["suite"] = "hotas_bench";
+        j["timestamp"] = (int64_t)std::time(nullptr);
+#if defined(__clang__)
+        j["compiler"] = std::string("clang ") + __clang_version__;
+#elif defined(__GNUC__)
+        j["compiler"] = std::string("gcc ") + __VERSION__;
+#elif defined(_MSC_VER)
+        j["compiler"] = "msvc " + std::to_string(_MSC_VER);
+#endif
+        j["results"] = nlohmann::json::array();
+        for (const auto& r : _results) {
+            j["results"].push_back({ {"name", r.name}, {"ns_per_op", r.ns_per_op},
+                                     {"iterations", r.iterations}, {"items_per_op", r.items_per_op} });
+        }
+        if (_opt.json == "-") { std::cout << j.dump(2) << "\n"; return true; }
+        std::ofstream out(_opt.json, std::ios::out | std::ios::trunc);
+        if (!out) { std::fprintf(stderr, "cannot write %s\n", _opt.json.c_str()); return false; }
+        out << j.dump(2) << "\n";
+        return (bool)out;
+    }
+
+private:
+    BenchOptions _opt;
+    std::vector<BenchResult> _results;
+};
+
+// --- Hardware counters --------------------------------------------------------
+
+// Linux perf_event counters around a measured region, user space only (so they open at
+// the default perf_event_paranoid of 2) and inherited by threads started inside it.
+// A counter the kernel or a VM does not provide reads as unavailable; elsewhere none are.
+class PerfCounters {
+public:
+    enum Event { DtlbLoadMiss, DtlbStoreMiss, PageFault, L1dLoadMiss, LlcLoadMiss, kEventCount };
+
+    PerfCounters() {
+#if defined(__linux__)
+        auto cache = [](uint64_t cache, uint64_t op) {
+            return (cache) | (op << 8) | ((uint64_t)PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+        };
+        open(DtlbLoadMiss, PERF_TYPE_HW_CACHE, cache(PERF_COUNT_HW_CACHE_DTLB, PERF_COUNT_HW_CACHE_OP_READ));
+        open(DtlbStoreMiss, PERF_TYPE_HW_CACHE, cache(PERF_COUNT_HW_CACHE_DTLB, PERF_COUNT_HW_CACHE_OP_WRITE));
+        open(PageFault, PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS);
+        open(L1dLoadMiss, PERF_TYPE_HW_CACHE, cache(PERF_COUNT_HW_CACHE_L1D, PERF_COUNT_HW_CACHE_OP_READ));
+        open(LlcLoadMiss, PERF_TYPE_HW_CACHE, cache(PERF_COUNT_HW_CACHE_LL, PERF_COUNT_HW_CACHE_OP_READ));
+#endif
+    }
+    ~PerfCounters() {
+#if defined(__linux__)
+        for (int fd : _fd) if (fd >= 0) close(fd);
+#endif
+    }
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    void start() {
+#if defined(__linux__)
+        for (int fd : _fd) if (fd >= 0) { ioctl(fd, PERF_EVENT_IOC_RESET, 0); ioctl(fd, PERF_EVENT_IOC_ENABLE, 0); }
+#endif
+    }
+    void stop() {
+#if defined(__linux__)
+        for (int e = 0; e < kEventCount; ++e) {
+            if (_fd[e] < 0) continue;
+            ioctl(_fd[e], PERF_EVENT_IOC_DISABLE, 0);
+            uint64_t v = 0;
+            _value[e] = read(_fd[e], &v, sizeof(v)) == (ssize_t)sizeof(v) ? (int64_t)v : -1;
+        }
+#endif
+    }
+    bool available(Event e) const { return _fd[e] >= 0; }
+    // Count between the last start() and stop(); -1 if unavailable
+    int64_t value(Event e) const { return _value[e]; }
+
+    // "dtlb_load_miss 0.0012 ..." per item for the table, "n/a" for missing counters
+    std::string per(double items, std::initializer_list<Event> events) const {
+        static const char* const names[kEventCount] = { "dtlb_load_miss", "dtlb_store_miss", "page_faults", "l1d_load_miss",
+                                                        "llc_load_miss" };
+        std::string out;
+        char buf[64];
+        for (Event e : events) {
+            if (_value[e] < 0) std::snprintf(buf, sizeof(buf), "%s%s n/a", out.empty() ? "" : "  ", names[e]);
+            else std::snprintf(buf, sizeof(buf), "%s%s %.4g", out.empty() ? "" : "  ", names[e], (double)_value[e] / items);
+            out += buf;
+        }
+        return out;
+    }
+
+private:
+#if defined(__linux__)
+    void open(Event e, uint32_t type, uint64_t config) {
+        perf_event_attr attr{};
+        attr.size = sizeof(attr);
+        attr.type = type;
+        attr.config = config;
+        attr.disabled = 1;
+        attr.inherit = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        _fd[e] = (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+    }
+#endif
+    int _fd[kEventCount] = { -1, -1, -1, -1, -1 };
+    int64_t _value[kEventCount] = { -1, -1, -1, -1, -1 };
+};
+
+// --- SampleRing ---------------------------------------------------------------
+
+static void bench_sample_ring(BenchRunner& b) {
+    b.run("sample_ring.push", 1, [](uint64_t n) {
+        SampleRing ring(1 << 16);
+        for (uint64_t i = 0; i < n; ++i) ring.push((double)i * 0.001, (float)(i & 1023));
+        consume(ring.size());
+    });
+
+    // 1 kHz signal, 60 s capacity, 10 s window: the plots' steady state
+    SampleRing ring(1 << 16);
+    for (int i = 0; i < 60000; ++i) ring.push(i * 0.001, (float)std::sin(i * 0.01));
+    const double latest = 59.999, window = 10.0;
+    std::vector<Sample> out;
+    out.reserve(1 << 16);
+    b.run("sample_ring.snapshot/10s@1kHz", 10000, [&](uint64_t n) {
+        for (uint64_t i = 0; i < n; ++i) { ring.snapshot(latest, window, out); consume((uint64_t)out.size()); }
+    });
+    b.run("sample_ring.snapshot_with_baseline/10s@1kHz", 10000, [&](uint64_t n) {
+        for (uint64_t i = 0; i < n; ++i) { ring.snapshot_with_baseline(latest, window, out); consume((uint64_t)out.size()); }
+    });
+
+    // Check: aggregate() over ranges of every alignment (and across the wrap) matches a
+    // scan of the same samples; then a 10 s aggregate against snapshot + scan
+    {
+        SampleRing small(1 << 13);
+        for (int i = 0; i < 20000; ++i) small.push(i * 0.001, (float)(1000.0 + 300.0 * std::sin(i * 0.37) + (i % 11)));
+        int bad = 0;
+        for (int k = 0; k < 200 && bad < 3; ++k) {
+            const double t0 = 11.8 + 0.0371 * k, t1 = t0 + 0.0013 + 0.041 * (k % 97);
+            const SampleAggregate a = small.aggregate(t0, t1);
+            small.snapshot(t1, t1 - t0, out);
+            double sum = 0.0, sq = 0.0;
+            float mn = 1e30f, mx = -1e30f;
+            uint64_t count = 0;
+            for (const auto& smp : out) {
+                if (smp.t > t1) continue;
+                sum += smp.v; sq += (double)smp.v * smp.v; mn = std::min(mn, smp.v); mx = std::max(mx, smp.v); ++count;
+            }
+            const double mean = count ? sum / (double)count : 0.0;
+            const double sd = count ? std::sqrt(std::max(0.0, sq / (double)count - mean * mean)) : 0.0;
+            if (a.count != count || (count && (a.min != mn || a.max != mx || std::fabs(a.mean - mean) > 1e-6 || std::fabs(a.stddev - sd) > 1e-4))) {
+                std::fprintf(stderr, "sample_ring.aggregate: [%.4f, %.4f] count %llu/%llu min %g/%g max %g/%g mean %g/%g sd %g/%g\n", t0, t1,
+                             (unsigned long long)a.count, (unsigned long long)count, a.min, mn, a.max, mx, a.mean, mean, a.stddev, sd);
+                ++bad;
+            }
+        }
+        if (bad) g_check_failed = true;
+    }
+    // Check: a requested clear empties the ring for readers at once; samples pushed after
+    // it are all that aggregates and snapshots see
+    {
+        SampleRing cleared(1 << 10);
+        for (int i = 0; i < 1500; ++i) cleared.push(i * 0.001, 500.0f + (float)(i % 7));
+        cleared.request_clear();
+        const bool empty = cleared.size() == 0 && cleared.latest_time() == 0.0 && cleared.aggregate(0.0, 10.0).count == 0;
+        for (int i = 0; i < 100; ++i) cleared.push(1.5 + i * 0.001, (float)i);
+        const SampleAggregate a = cleared.aggregate(0.0, 10.0);
+        cleared.snapshot(cleared.latest_time(), 10.0, out);
+        if (!empty || cleared.size() != 100 || out.size() != 100 || a.count != 100 || a.min != 0.0f || a.max != 99.0f ||
+            std::fabs(a.mean - 49.5) > 1e-9) {
+            std::fprintf(stderr, "sample_ring.request_clear: empty %d, then %llu samples (%zu in snapshot), aggregate count %llu mean %g\n",
+                         (int)empty, (unsigned long long)cleared.size(), out.size(), (unsigned long long)a.count, a.mean);
+            g_check_failed = true;
+        }
+    }
+    // Check: a reader racing the writer never sees a head whose newest sample is not
+    // written yet (sample k has t = k + 1, so the slot at head - 1 must hold t >= head)
+    {
+        SampleRing live(1 << 16);
+        std::atomic<bool> done{false};
+        std::thread writer([&] {
+            for (uint64_t i = 0; i < 2000000; ++i) live.push((double)(i + 1), (float)(i & 1023));
+            done.store(true, std::memory_order_release);
+        });
+        uint64_t reads = 0, stale = 0;
+        while (!done.load(std::memory_order_acquire)) {
+            const uint64_t end = live.head();
+            if (end == 0) continue;
+            ++reads;
+            if (live.at(end - 1).t < (double)end) ++stale;
+        }
+        writer.join();
+        if (stale) {
+            std::fprintf(stderr, "sample_ring.push: %llu of %llu reads saw the head before its sample\n",
+                         (unsigned long long)stale, (unsigned long long)reads);
+            g_check_failed = true;
+        }
+    }
+    b.run("sample_ring.aggregate/10s@1kHz", 1, [&](uint64_t n) {
+        for (uint64_t i = 0; i < n; ++i) consume(ring.aggregate(latest - window, latest).stddev);
+    });
+    b.run("sample_ring.snapshot+scan/10s@1kHz", 1, [&](uint64_t n) {
+        for (uint64_t i = 0; i < n; ++i) {
+            ring.snapshot(latest, window, out);
+            double sq = 0.0;
+            for (const auto& smp : out) sq += (double)smp.v * smp.v;
+            consume(sq);
+        }
+    });
+}
+
+// --- SampleRing pages ---------------------------------------------------------
+
+// The 8 MB history rings (2^19 samples) under each page policy. "zeroed" is how they
+// were allocated before PageBuffer: a value-initialized std::vector, every page faulted
+// in at construction on the creating thread.
+//
+// first_lap: one ring per lap, created (and prefaulted, as it would be while the app
+// starts up) before the writer's first pass over it. ns/item is the mean push; the
+// table also shows the time per 256 pushes (one 4 KB page), median and 99th percentile,
+// and the construction cost.
+// random_read: reads at random indices across 40 such rings, the working set of the
+// poller and the filtered forwarder, where the TLB reach of 4 KB pages runs out.
+static void bench_ring_pages(BenchRunner& b) {
+    using clock = std::chrono::steady_clock;
+    constexpr size_t kCap = size_t(1) << 19;
+    struct Mode { const char* name; hotas_mem::PageConfig cfg; bool zero; };
+    const Mode modes[] = {
+        { "zeroed", { hotas_mem::HugePages::Off, false }, true },
+        { "regular", { hotas_mem::HugePages::Off, false }, false },
+        { "regular+prefault", { hotas_mem::HugePages::Off, true }, false },
+        { "transparent+prefault", { hotas_mem::HugePages::Transparent, true }, false },
+        { "explicit+prefault", { hotas_mem::HugePages::Explicit, true }, false },
+    };
+    PerfCounters pc;
+    for (const Mode& m : modes) {
+        const std::string name = std::string("sample_ring.first_lap/") + m.name;
+        if (!b.enabled(name)) continue;
+        const int laps = std::max(3, b.repeat());
+        double push_ns = 0.0, construct_ns = 0.0;
+        std::vector<double> page_ns;  // per 256 pushes, all laps
+        page_ns.reserve(laps * (kCap / 256));
+        int64_t faults = 0, tlb = 0;
+        hotas_mem::PageKind kind = hotas_mem::PageKind::Regular;
+        for (int lap = 0; lap < laps; ++lap) {
+            const auto c0 = clock::now();
+            auto ring = std::make_unique<SampleRing>(kCap, m.cfg);
+            if (m.zero) std::memset(ring->storage().data(), 0, ring->storage().size());
+            construct_ns += std::chrono::duration<double, std::nano>(clock::now() - c0).count();
+            ring->storage().wait_prefaulted();
+            kind = ring->storage().kind();
+            pc.start();
+            const auto t0 = clock::now();
+            auto tp = t0;
+            for (size_t i = 0; i < kCap; i += 256) {
+                for (size_t k = i; k < i + 256; ++k) ring->push((double)k * 0.001, (float)(k & 1023));
+                const auto tn = clock::now();
+                page_ns.push_back(std::chrono::duration<double, std::nano>(tn - tp).count());
+                tp = tn;
+            }
+            push_ns += std::chrono::duration<double, std::nano>(tp - t0).count();
+            pc.stop();
+            consume(ring->size());
+            faults += pc.value(PerfCounters::PageFault);
+            tlb += pc.value(PerfCounters::DtlbStoreMiss);
+        }
+        b.record(BenchResult{ name, push_ns / laps, (uint64_t)kCap, (double)kCap });
+        std::sort(page_ns.begin(), page_ns.end());
+        std::fprintf(b.table(), "    %s pages, construct %.2f ms, 4 KB of pushes p50 %.2f us p99 %.2f us", hotas_mem::page_kind_name(kind),
+                     construct_ns / laps * 1e-6, page_ns[page_ns.size() / 2] * 1e-3, page_ns[page_ns.size() * 99 / 100] * 1e-3);
+        if (pc.available(PerfCounters::PageFault)) std::fprintf(b.table(), ", page faults/lap %.0f", (double)faults / laps);
+        if (pc.available(PerfCounters::DtlbStoreMiss))
+            std::fprintf(b.table(), ", dtlb_store_miss/item %.4f", (double)tlb / laps / (double)kCap);
+        std::fprintf(b.table(), "\n");
+    }
+
+    constexpr int kRings = 40;
+    constexpr size_t kReads = 4096;
+    for (const Mode& m : modes) {
+        if (m.zero || !m.cfg.prefault) continue;  // same pages as regular+prefault once touched
+        const std::string name = std::string("sample_ring.random_read/40x8MB/") + m.name;
+        if (!b.enabled(name)) continue;
+        std::vector<std::unique_ptr<SampleRing>> rings;
+        for (int r = 0; r < kRings; ++r) rings.push_back(std::make_unique<SampleRing>(kCap, m.cfg));
+        for (auto& ring : rings) {
+            for (size_t k = 0; k < kCap; ++k) ring->push((double)k * 0.001, (float)(k & 1023));
+        }
+        std::vector<std::pair<uint32_t, uint32_t>> at(kReads);
+        uint64_t x = 0x9e3779b97f4a7c15ull;
+        for (auto& a : at) {
+            x ^= x << 13; x ^= x >> 7; x ^= x << 17;
+            a = { (uint32_t)(x % kRings), (uint32_t)((x >> 8) % kCap) };
+        }
+        pc.start();
+        uint64_t reads = 0;
+        b.run(name, (double)kReads, [&](uint64_t n) {
+            double sum = 0.0;
+            for (uint64_t i = 0; i < n; ++i) {
+                for (const auto& a : at) sum += rings[a.first]->at(a.second).v;
+            }
+            reads += n * kReads;
+            consume(sum);
+        });
+        pc.stop();
+        std::fprintf(b.table(), "    %s pages, %s\n", hotas_mem::page_kind_name(rings.front()->storage().kind()),
+                     pc.per((double)std::max<uint64_t>(reads, 1),
+                            { PerfCounters::DtlbLoadMiss, PerfCounters::DtlbStoreMiss, PerfCounters::PageFault }).c_str());
+    }
+}
+
+// --- Shared field layout ------------------------------------------------------
+
+// XInputPoller's threaded fields in their old order (poller-written state next to the
+// UI's settings) and split into one block per writer as the class has them now. A
+// thread stands in for the poller at full speed, updating the fields it owns; the timed
+// thread is the UI reading settings the poller never writes. Sharing a line, each of
+// those reads misses after every poller store. The counters cover both threads.
+struct PollerFieldsShared {
+    std::atomic<bool> running{true};
+    std::atomic<bool> connected{false};
+    std::atomic<double> latest_time{0.0};
+    std::atomic<double> target_hz{1000.0};
+    std::atomic<double> window_seconds{30.0};
+    std::atomic<uint64_t> samples_captured{0};
+    std::atomic<int> controller_index{0};
+};
+struct PollerFieldsSplit {
+    std::atomic<bool> running{true};
+    std::atomic<double> target_hz{1000.0};
+    std::atomic<double> window_seconds{30.0};
+    std::atomic<int> controller_index{0};
+    alignas(kCacheLineSize) std::atomic<bool> connected{false};
+    std::atomic<double> latest_time{0.0};
+    std::atomic<uint64_t> samples_captured{0};
+};
+
+template <class Fields>
+static void bench_layout_case(BenchRunner& b, PerfCounters& pc, const std::string& name) {
+    if (!b.enabled(name)) return;
+    Fields f;
+    std::atomic<bool> stop{false};
+    std::thread poller([&] {
+        double t = 0.0;
+        while (!stop.load(std::memory_order_relaxed)) {
+            if (!f.running.load(std::memory_order_relaxed)) continue;
+            t += 1.0 / f.target_hz.load(std::memory_order_relaxed);
+            f.connected.store(true, std::memory_order_release);
+            f.samples_captured.store(f.samples_captured.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+            f.latest_time.store(t, std::memory_order_release);
+        }
+    });
+    uint64_t reads = 0;
+    pc.start();
+    b.run(name, 64, [&](uint64_t n) {
+        double sum = 0.0;
+        for (uint64_t i = 0; i < n; ++i) {
+            for (int k = 0; k < 64; ++k)
+                sum += f.window_seconds.load(std::memory_order_acquire) + f.controller_index.load(std::memory_order_acquire);
+        }
+        reads += n * 64;
+        consume(sum);
+    });
+    pc.stop();
+    stop.store(true);
+    poller.join();
+    std::fprintf(b.table(), "    %s\n", pc.per((double)std::max<uint64_t>(reads, 1), { PerfCounters::L1dLoadMiss, PerfCounters::LlcLoadMiss }).c_str());
+}
+
+static void bench_layout(BenchRunner& b) {
+    if (std::thread::hardware_concurrency() < 2 && b.enabled("layout."))
+        std::fprintf(b.table(), "    (one CPU: the threads take turns, so there is no line to bounce)\n");
+    PerfCounters pc;
+    bench_layout_case<PollerFieldsShared>(b, pc, "layout.poller_fields/shared_line");
+    bench_layout_case<PollerFieldsSplit>(b, pc, "layout.poller_fields/split");
+}
+
+// --- Aligned window -----------------------------------------------------------
+
+static void bench_aligned_window(BenchRunner& b) {
+    // Rings at different, uneven rates (the newest starting late), as the pipeline and
+    // the poller fill them; the reference looks every row up in plain sample vectors
+    const double rates[4] = { 1000.0, 250.0, 125.0, 500.0 };
+    const double starts[4] = { 0.0, 0.0013, 0.0021, 12.5 };
+    std::vector<std::unique_ptr<SampleRing>> owned;
+    std::vector<std::vector<Sample>> ref(4);
+    std::vector<const SampleRing*> rings;
+    for (int k = 0; k < 4; ++k) {
+        owned.push_back(std::make_unique<SampleRing>(1 << 15));
+        for (int i = 0;; ++i) {
+            const double t = starts[k] + i / rates[k] + ((i * 7919) % 13) * 1e-5;
+            if (t > 20.0) break;
+            const float v = (float)std::sin(t * (k + 1) * 3.1) + (float)k;
+            owned[k]->push(t, v);
+            ref[k].push_back(Sample{ t, v });
+        }
+        rings.push_back(owned[k].get());
+    }
+    rings.push_back(nullptr);
+
+    {
+        auto expect = [&](size_t k, double t, AlignInterp interp) {
+            if (k >= 4) return std::numeric_limits<float>::quiet_NaN();
+            const auto& v = ref[k];
+            auto it = std::upper_bound(v.begin(), v.end(), t, [](double x, const Sample& s) { return x < s.t; });
+            if (it == v.begin()) return std::numeric_limits<float>::quiet_NaN();
+            const Sample a = *(it - 1);
+            if (interp == AlignInterp::Hold || it == v.end() || it->t <= a.t) return a.v;
+            return (float)(a.v + (it->v - a.v) * ((t - a.t) / (it->t - a.t)));
+        };
+        AlignedWindow table;
+        int bad = 0;
+        size_t union_rows = 0;
+        for (const double step : { 0.0, 0.0007, 0.01 }) {
+            for (const AlignInterp interp : { AlignInterp::Hold, AlignInterp::Linear }) {
+                aligned_window(rings, 10.0, 15.0, step, interp, table);
+                if (step == 0.0) union_rows = table.rows();
+                for (size_t r = 0; r < table.rows() && bad < 3; ++r) {
+                    for (size_t k = 0; k < rings.size(); ++k) {
+                        const float e = expect(k, table.t[r], interp), g = table.columns[k][r];
+                        if (std::isnan(e) != std::isnan(g) || (!std::isnan(e) && std::fabs(e - g) > 1e-5f)) {
+                            std::fprintf(stderr, "aligned_window: step %g row %zu t %.5f ring %zu: %g, expected %g\n", step, r, table.t[r], k, g, e);
+                            ++bad;
+                        }
+                    }
+                }
+            }
+        }
+        // Union rows: every distinct sample time in the range, once
+        std::vector<double> times;
+        for (const auto& v : ref)
+            for (const auto& smp : v)
+                if (smp.t >= 10.0 && smp.t <= 15.0) times.push_back(smp.t);
+        std::sort(times.begin(), times.end());
+        times.erase(std::unique(times.begin(), times.end()), times.end());
+        if (union_rows != times.size()) {
+            std::fprintf(stderr, "aligned_window: %zu union rows, expected %zu\n", union_rows, times.size());
+            ++bad;
+        }
+        if (bad) g_check_failed = true;
+    }
+
+    // 10 s of four rings (~18.8k rows) in one pass, against a snapshot per ring plus a merge
+    rings.pop_back();
+    AlignedWindow table;
+    b.run("aligned_window/4x10s", 1, [&](uint64_t n) {
+        for (uint64_t i = 0; i < n; ++i) {
+            aligned_window(rings, 9.999, 19.999, 0.0, AlignInterp::Hold, table);
+            consume((uint64_t)table.rows());
+        }
+    });
+    std::vector<std::vector<Sample>> snaps(4);
+    std::vector<double> merged;
+    b.run("aligned_window.snapshots+merge/4x10s", 1, [&](uint64_t n) {
+        for (uint64_t i = 0; i < n; ++i) {
+            merged.clear();
+            for (int k = 0; k < 4; ++k) {
+                owned[k]->snapshot_with_baseline(19.999, 10.0, snaps[k]);
+                for (const auto& smp : snaps[k]) merged.push_back(smp.t);
+            }
+            std::sort(merged.begin(), merged.end());
+            merged.erase(std::unique(merged.begin(), merged.end()), merged.end());
+            std::vector<size_t> pos(4, 0);
+            double sum = 0.0;
+            for (const double t : merged) {
+                for (int k = 0; k < 4; ++k) {
+                    while (pos[k] + 1 < snaps[k].size() && snaps[k][pos[k] + 1].t <= t) ++pos[k];
+                    if (!snaps[k].empty()) sum += snaps[k][pos[k]].v;
+                }
+            }
+            consume(sum);
+        }
+    });
+}
+
+// --- HID decode ---------------------------------------------------------------
+
+static void bench_hid(BenchRunner& b) {
+    auto sigs = HotasReader::load_signal_csv(HOTAS_CONFIG_DIR "/X56_Hotas_hid_bit_map.csv", DeviceRegistry::x56());
+    if (sigs.empty()) sigs = HotasReader::default_signals();
+    std::vector<HotasReader::SignalDescriptor> stick;
+    for (const auto& sd : sigs) if (sd.device == DeviceRegistry::kX56Stick) stick.push_back(sd);
+
+    uint8_t report[HidReport::kMaxBytes];
+    for (size_t i = 0; i < sizeof(report); ++i) report[i] = (uint8_t)(i * 37 + 11);
+    const size_t stick_len = 14;
+
+    b.run("hid.extract_bits/16", 1, [&](uint64_t n) {
+        uint64_t acc = 0;
+        for (uint64_t i = 0; i < n; ++i) {
+            report[0] = (uint8_t)i;
+            acc += extract_bits(report, stick_len, 8, 16);
+        }
+        consume(acc);
+    });
+    b.run("hid.extract_bits/stick_report", (double)stick.size(), [&](uint64_t n) {
+        uint64_t acc = 0;
+        for (uint64_t i = 0; i < n; ++i) {
+            report[1] = (uint8_t)i;
+            for (const auto& sd : stick) acc += extract_bits(report, stick_len, sd.bit_start, sd.bits);
+        }
+        consume(acc);
+    });
+
+    // Whole-report decode: generic per-field extraction (custom CSVs, descriptors) against
+    // the decoders generated from the X56 bit map at build time
+    auto bench_decode = [&](const char* name, DeviceIndex device, size_t count, size_t len,
+                            void (*decode)(const uint8_t*, size_t, uint64_t*)) {
+        std::vector<HotasReader::SignalDescriptor> fields;
+        for (const auto& sd : sigs) if (sd.device == device) fields.push_back(sd);
+        std::vector<uint64_t> generic(fields.size()), generated(count);
+        decode(report, len, generated.data());
+        for (size_t k = 0; k < fields.size(); ++k) generic[k] = extract_bits(report, len, fields[k].bit_start, fields[k].bits);
+        if (generic != generated) {
+            std::fprintf(stderr, "hid.decode/%s: generated decoder disagrees with the bit map\n", name);
+            g_check_failed = true;
+        }
+        b.run(std::string("hid.decode/") + name + "/generic", (double)fields.size(), [&](uint64_t n) {
+            uint64_t acc = 0;
+            for (uint64_t i = 0; i < n; ++i) {
+                report[1] = (uint8_t)i;
+                for (size_t k = 0; k < fields.size(); ++k) generic[k] = extract_bits(report, len, fields[k].bit_start, fields[k].bits);
+                acc += generic[i % generic.size()];
+            }
+            consume(acc);
+        });
+        b.run(std::string("hid.decode/") + name + "/generated", (double)count, [&](uint64_t n) {
+            uint64_t acc = 0;
+            for (uint64_t i = 0; i < n; ++i) {
+                report[1] = (uint8_t)i;
+                decode(report, len, generated.data());
+                acc += generated[i % generated.size()];
+            }
+            consume(acc);
+        });
+    };
+    using Stick = x56_bitmap::Layout<DeviceRegistry::kX56Stick>;
+    using Throttle = x56_bitmap::Layout<DeviceRegistry::kX56Throttle>;
+    bench_decode("stick", DeviceRegistry::kX56Stick, Stick::count, stick_len, &Stick::decode);
+    bench_decode("throttle", DeviceRegistry::kX56Throttle, Throttle::count, stick_len, &Throttle::decode);
+
+    const std::string hex = bytes_to_hex(report, stick_len);
+    std::vector<uint8_t> bytes;
+    b.run("hid.hex_to_bytes/14B", (double)stick_len, [&](uint64_t n) {
+        for (uint64_t i = 0; i < n; ++i) { hex_to_bytes(hex, bytes); consume((uint64_t)bytes[i % stick_len]); }
+    });
+
+    // Per-report cost on the reader thread (interval histogram + duplicate compare)
+    ReportIntervalStats stats;
+    double t = 0.0;
+    b.run("hid.report_stats/on_report", 1, [&](uint64_t n) {
+        for (uint64_t i = 0; i < n; ++i) {
+            t += 0.001 + (double)(i & 7) * 1e-5;
+            report[2] = (uint8_t)(i >> 4);
+            stats.on_report(t, report, stick_len);
+        }
+        consume(stats.snapshot().reports);
+    });
+    b.run("hid.report_stats/snapshot", 1, [&](uint64_t n) {
+        uint64_t acc = 0;
+        for (uint64_t i = 0; i < n; ++i) acc += (uint64_t)stats.snapshot().nominal_hz;
+        consume(acc);
+    });
+}
+
+// Generated signals must cover the bit map: analog rows with one field of the same
+// range, digital rows bit by bit. The X56 descriptors were reconstructed from this CSV,
+// so this only shows the two agree; the hand-worked cases below check the parser.
+static void check_descriptor_signals(const char* what, const std::vector<HotasReader::SignalDescriptor>& generated,
+                                     const std::vector<HotasReader::SignalDescriptor>& bitmap) {
+    for (const auto& row : bitmap) {
+        bool ok = true;
+        if (row.analog) {
+            ok = std::any_of(generated.begin(), generated.end(), [&](const auto& g) {
+                return g.analog && g.bit_start == row.bit_start && g.bits == row.bits;
+            });
+        } else {
+            for (int bit = row.bit_start; bit < row.bit_start + row.bits && ok; ++bit) {
+                ok = std::any_of(generated.begin(), generated.end(), [&](const auto& g) {
+                    return bit >= g.bit_start && bit < g.bit_start + g.bits;
+                });
+            }
+        }
+        if (!ok) {
+            std::fprintf(stderr, "%s: bit map row %s (bits %d+%d) has no matching descriptor field\n", what,
+                         row.id.c_str(), row.bit_start, row.bits);
+            g_check_failed = true;
+        }
+    }
+}
+
+// Descriptors with field offsets worked out by hand from the HID 1.11 item rules, for
+// what the X56 files do not exercise: a published device descriptor (the boot keyboard
+// of HID 1.11 Appendix E.6, with output items in between and array fields), Push/Pop,
+// Report ID switching, long items and extended usages. No USB capture of the X56 ships
+// with the repo, so these stand in for one.
+struct ExpectedField {
+    uint8_t report_id;
+    int bit_start, bits;
+    uint16_t usage_page, usage;
+    int32_t logical_min, logical_max;
+    bool constant, variable;
+};
+
+static void check_descriptor_case(const char* what, const std::vector<uint8_t>& bytes, const std::vector<ExpectedField>& want,
+                                  const std::vector<std::pair<uint8_t, size_t>>& report_bytes) {
+    HidDescriptor d;
+    std::string error;
+    if (!parse_hid_descriptor(bytes.data(), bytes.size(), d, &error)) {
+        std::fprintf(stderr, "hid.descriptor %s: %s\n", what, error.c_str());
+        g_check_failed = true;
+        return;
+    }
+    if (d.inputs.size() != want.size()) {
+        std::fprintf(stderr, "hid.descriptor %s: %zu fields, expected %zu\n", what, d.inputs.size(), want.size());
+        g_check_failed = true;
+        return;
+    }
+    for (size_t k = 0; k < want.size(); ++k) {
+        const HidField& f = d.inputs[k];
+        const ExpectedField& e = want[k];
+        if (f.report_id != e.report_id || f.bit_start != e.bit_start || f.bits != e.bits || f.usage_page != e.usage_page ||
+            f.usage != e.usage || f.logical_min != e.logical_min || f.logical_max != e.logical_max ||
+            f.constant != e.constant || f.variable != e.variable) {
+            std::fprintf(stderr, "hid.descriptor %s: field %zu is id %u bits %d+%d usage %04x:%04x range %d..%d%s%s, expected "
+                                 "id %u bits %d+%d usage %04x:%04x range %d..%d%s%s\n",
+                         what, k, f.report_id, f.bit_start, f.bits, f.usage_page, f.usage, f.logical_min, f.logical_max,
+                         f.constant ? " const" : "", f.variable ? "" : " array", e.report_id, e.bit_start, e.bits, e.usage_page,
+                         e.usage, e.logical_min, e.logical_max, e.constant ? " const" : "", e.variable ? "" : " array");
+            g_check_failed = true;
+        }
+    }
+    for (const auto& [id, size] : report_bytes) {
+        if (d.report_bytes(id) != size) {
+            std::fprintf(stderr, "hid.descriptor %s: report %u is %zu bytes, expected %zu\n", what, id, d.report_bytes(id), size);
+            g_check_failed = true;
+        }
+    }
+}
+
+static void check_descriptor_cases() {
+    // HID 1.11 Appendix E.6: 8 modifier bits, a constant byte, LED outputs (not in the
+    // input report), then 6 key-code array slots
+    std::vector<ExpectedField> keyboard;
+    for (int k = 0; k < 8; ++k) keyboard.push_back({ 0, 8 + k, 1, 0x07, (uint16_t)(0xE0 + k), 0, 1, false, true });
+    keyboard.push_back({ 0, 16, 8, 0, 0, 0, 1, true, false });  // no usage: padding
+    for (int k = 0; k < 6; ++k) keyboard.push_back({ 0, 24 + 8 * k, 8, 0x07, 0, 0, 101, false, false });
+    check_descriptor_case("boot_keyboard", {
+        0x05, 0x01, 0x09, 0x06, 0xA1, 0x01,
+        0x05, 0x07, 0x19, 0xE0, 0x29, 0xE7, 0x15, 0x00, 0x25, 0x01, 0x75, 0x01, 0x95, 0x08, 0x81, 0x02,
+        0x95, 0x01, 0x75, 0x08, 0x81, 0x01,
+        0x95, 0x05, 0x75, 0x01, 0x05, 0x08, 0x19, 0x01, 0x29, 0x05, 0x91, 0x02,
+        0x95, 0x01, 0x75, 0x03, 0x91, 0x01,
+        0x95, 0x06, 0x75, 0x08, 0x15, 0x00, 0x25, 0x65, 0x05, 0x07, 0x19, 0x00, 0x29, 0x65, 0x81, 0x00,
+        0xC0,
+    }, keyboard, { { 0, 9 } });
+
+    // Push saves the 8-bit X globals, the buttons change page/size/range, Pop restores
+    // them for Y, which follows the buttons at bit 18
+    check_descriptor_case("push_pop", {
+        0x05, 0x01, 0x09, 0x04, 0xA1, 0x01,
+        0x09, 0x30, 0x15, 0x00, 0x26, 0xFF, 0x00, 0x75, 0x08, 0x95, 0x01, 0x81, 0x02,
+        0xA4,
+        0x05, 0x09, 0x19, 0x01, 0x29, 0x02, 0x25, 0x01, 0x75, 0x01, 0x95, 0x02, 0x81, 0x02,
+        0xB4,
+        0x09, 0x31, 0x81, 0x02,
+        0xC0,
+    }, {
+        { 0, 8, 8, 0x01, 0x30, 0, 255, false, true },
+        { 0, 16, 1, 0x09, 0x01, 0, 1, false, true },
+        { 0, 17, 1, 0x09, 0x02, 0, 1, false, true },
+        { 0, 18, 8, 0x01, 0x31, 0, 255, false, true },
+    }, { { 0, 4 } });
+
+    // Report 1 resumes at bit 16 after report 2's field; the long item between them is
+    // skipped; a 4-byte usage keeps its own page under a vendor usage page
+    check_descriptor_case("report_ids", {
+        0x05, 0x01, 0x09, 0x05, 0xA1, 0x01,
+        0x85, 0x01, 0x09, 0x30, 0x15, 0x00, 0x25, 0x7F, 0x75, 0x08, 0x95, 0x01, 0x81, 0x02,
+        0x85, 0x02, 0x09, 0x31, 0x75, 0x10, 0x81, 0x02,
+        0xFE, 0x03, 0x42, 0xAA, 0xBB, 0xCC,
+        0x85, 0x01, 0x09, 0x32, 0x75, 0x04, 0x81, 0x02,
+        0x06, 0x00, 0xFF, 0x0B, 0x35, 0x00, 0x01, 0x00, 0x81, 0x02,
+        0xC0,
+    }, {
+        { 1, 8, 8, 0x01, 0x30, 0, 127, false, true },
+        { 2, 8, 16, 0x01, 0x31, 0, 127, false, true },
+        { 1, 16, 4, 0x01, 0x32, 0, 127, false, true },
+        { 1, 20, 4, 0x01, 0x35, 0, 127, false, true },
+    }, { { 1, 3 }, { 2, 3 }, { 3, 0 } });
+
+    // Malformed input is refused
+    const struct { const char* name; std::vector<uint8_t> bytes; } bad[] = {
+        { "pop_without_push", { 0x05, 0x01, 0xA1, 0x01, 0xB4, 0x75, 0x08, 0x95, 0x01, 0x81, 0x02, 0xC0 } },
+        { "truncated_long_item", { 0x05, 0x01, 0xA1, 0x01, 0x75, 0x08, 0x95, 0x01, 0x81, 0x02, 0xFE, 0x05, 0x42, 0x11, 0x22 } },
+        { "unterminated_collection", { 0x05, 0x01, 0xA1, 0x01, 0x75, 0x08, 0x95, 0x01, 0x81, 0x02 } },
+    };
+    for (const auto& c : bad) {
+        HidDescriptor d;
+        if (parse_hid_descriptor(c.bytes.data(), c.bytes.size(), d)) {
+            std::fprintf(stderr, "hid.descriptor %s: parsed, expected an error\n", c.name);
+            g_check_failed = true;
+        }
+    }
+}
+
+static void bench_hid_descriptor(BenchRunner& b) {
+    check_descriptor_cases();
+    const DeviceRegistry x56 = DeviceRegistry::x56();
+    auto bitmap = HotasReader::load_signal_csv(HOTAS_CONFIG_DIR "/X56_Hotas_hid_bit_map.csv", x56);
+    if (bitmap.empty()) bitmap = HotasReader::default_signals();
+    const struct { const char* name; const char* path; DeviceIndex device; } halves[] = {
+        { "x56_stick", HOTAS_CONFIG_DIR "/descriptors/x56_stick.hid", DeviceRegistry::kX56Stick },
+        { "x56_throttle", HOTAS_CONFIG_DIR "/descriptors/x56_throttle.hid", DeviceRegistry::kX56Throttle },
+    };
+    for (const auto& h : halves) {
+        std::vector<uint8_t> bytes;
+        std::string error;
+        HidDescriptor desc;
+        if (!load_hid_descriptor_file(h.path, bytes, &error) || !parse_hid_descriptor(bytes.data(), bytes.size(), desc, &error)) {
+            std::fprintf(stderr, "%s: %s\n", h.name, error.c_str());
+            g_check_failed = true;
+            continue;
+        }
+        std::vector<HotasReader::SignalDescriptor> device_rows;
+        for (const auto& sd : bitmap) if (sd.device == h.device) device_rows.push_back(sd);
+        check_descriptor_signals(h.name, HotasReader::descriptor_signals(desc, x56, h.device), device_rows);
+
+        b.run(std::string("hid.descriptor_parse/") + h.name, (double)bytes.size(), [&](uint64_t n) {
+            uint64_t acc = 0;
+            for (uint64_t i = 0; i < n; ++i) {
+                HidDescriptor d;
+                parse_hid_descriptor(bytes.data(), bytes.size(), d);
+                acc += d.inputs.size();
+            }
+            consume(acc);
+        });
+        b.run(std::string("hid.descriptor_signals/") + h.name, 1, [&](uint64_t n) {
+            uint64_t acc = 0;
+            for (uint64_t i = 0; i < n; ++i) acc += HotasReader::descriptor_signals(desc, x56, h.device).size();
+            consume(acc);
+        });
+    }
+}
+
+// --- Filters ------------------------------------------------------------------
+
+static void bench_filters(BenchRunner& b) {
+    // Jittery axis with occasional spikes
+    std::vector<double> axis(4096);
+    for (size_t i = 0; i < axis.size(); ++i) axis[i] = std::sin(i * 0.02) + ((i % 97) == 0 ? 0.8 : 0.0);
+    b.run("filter.analog_rate_limit", 1, [&](uint64_t n) {
+        InputFilterState st;
+        double acc = 0.0;
+        for (uint64_t i = 0; i < n; ++i) acc += filter_analog(st, axis[i & 4095], 2.0, 5.0);
+        consume(acc);
+    });
+
+    // Button with bounces, sampled at 1 kHz
+    std::vector<double> button(4096);
+    for (size_t i = 0; i < button.size(); ++i) button[i] = ((i / 40) & 1) || (i % 13 == 0) ? 1.0 : 0.0;
+    b.run("filter.digital_debounce/button", 1, [&](uint64_t n) {
+        InputFilterState st;
+        double acc = 0.0;
+        for (uint64_t i = 0; i < n; ++i) acc += filter_digital(st, button[i & 4095], (double)i * 0.001, 0.005, false, false);
+        consume(acc);
+    });
+
+    // 4-bit hat cycling through directions
+    std::vector<double> hat(4096);
+    for (size_t i = 0; i < hat.size(); ++i) hat[i] = (double)((i / 25) % 9);
+    b.run("filter.digital_debounce/hat", 1, [&](uint64_t n) {
+        InputFilterState st;
+        double acc = 0.0;
+        for (uint64_t i = 0; i < n; ++i) acc += filter_digital(st, hat[i & 4095], (double)i * 0.001, 0.005, false, true);
+        consume(acc);
+    });
+}
+
+// --- Spike detection ----------------------------------------------------------
+
+static void bench_spike(BenchRunner& b) {
+    // Check: on a noisy axis a one-sample glitch is flagged and held, a step that stays is
+    // accepted after max_hold samples, and the plain noise is never flagged
+    SpikeParams sp;
+    sp.k_sigma = 6.0;
+    auto noise = [](size_t i) { return 0.004 * std::sin((double)i * 1.7) + 0.003 * std::sin((double)i * 0.31); };
+    {
+        SpikeDetector det;
+        int false_flags = 0;
+        for (size_t i = 0; i < 2000; ++i) false_flags += det.update(noise(i), sp, 2.0) != SpikeDetector::State::Quiet;
+        const bool glitch = det.update(noise(2000) + 0.6, sp, 2.0) == SpikeDetector::State::Start;
+        const bool back = det.update(noise(2001), sp, 2.0) == SpikeDetector::State::Quiet;
+        int step_held = 0;
+        for (size_t i = 2002; i < 2012; ++i) step_held += det.update(noise(i) + 0.5, sp, 2.0) != SpikeDetector::State::Quiet;
+        if (false_flags != 0 || !glitch || !back || step_held != sp.max_hold) {
+            std::fprintf(stderr, "spike.detector: %d noise samples flagged, glitch %s, return %s, step held %d samples\n", false_flags,
+                         glitch ? "flagged" : "missed", back ? "ok" : "still held", step_held);
+            g_check_failed = true;
+        }
+    }
+
+    std::vector<double> axis(4096);
+    for (size_t i = 0; i < axis.size(); ++i) axis[i] = std::sin(i * 0.02) + noise(i) + ((i % 97) == 0 ? 0.8 : 0.0);
+    b.run("spike.detector", 1, [&](uint64_t n) {
+        SpikeDetector det;
+        uint64_t flagged = 0;
+        for (uint64_t i = 0; i < n; ++i) flagged += det.update(axis[i & 4095], sp, 2.0) == SpikeDetector::State::Start;
+        consume(flagged);
+    });
+}
+
+// --- Axis histograms -----------------------------------------------------------
+
+// Check: a 16-bit axis swept end to end with a worn stretch it jumps across reports
+// that stretch as a dead spot and a jump region, and a clean sweep reports neither;
+// then the per-sample cost of record()
+static void bench_axis_histogram(BenchRunner& b) {
+    auto sweep = [](AxisHistogram& h, bool worn) {
+        uint64_t n = 0;
+        for (int pass = 0; pass < 8; ++pass) {
+            for (int k = 0; k < 65536 / 20; ++k) {
+                int code = pass & 1 ? 65535 - k * 20 : k * 20;
+                if (worn && code > 30000 && code < 33000) continue; // the wiper never reports here
+                h.record((uint64_t)code, (double)n++ * 0.004);
+            }
+        }
+        return h.snapshot();
+    };
+    {
+        AxisHistogram clean_h(16), worn_h(16);
+        const auto clean = sweep(clean_h, false);
+        const auto worn = sweep(worn_h, true);
+        auto covers = [](const std::vector<AxisHistogram::Region>& rs, size_t bin) {
+            for (const auto& r : rs) if (r.first <= bin && bin <= r.last) return true;
+            return false;
+        };
+        const size_t hole = 31500 >> 6, edge = 30000 >> 6;
+        const bool ok = clean.dead_spots.empty() && clean.jump_regions.empty() && covers(worn.dead_spots, hole) &&
+                        covers(worn.jump_regions, edge);
+        if (!ok) {
+            std::fprintf(stderr, "axis.histogram: clean sweep %zu dead spots, %zu jump regions; worn sweep %s the dead spot, %s the jump\n",
+                         clean.dead_spots.size(), clean.jump_regions.size(), covers(worn.dead_spots, hole) ? "found" : "missed",
+                         covers(worn.jump_regions, edge) ? "found" : "missed");
+            g_check_failed = true;
+        }
+    }
+
+    std::vector<uint64_t> codes(4096);
+    for (size_t i = 0; i < codes.size(); ++i) codes[i] = (uint64_t)(32768.0 + 30000.0 * std::sin(i * 0.02)) + (i % 7);
+    AxisHistogram h(16);
+    h.set_period(60.0);
+    b.run("axis.histogram.record", 1, [&](uint64_t n) {
+        for (uint64_t i = 0; i < n; ++i) h.record(codes[i & 4095], (double)i * 0.001);
+        consume((uint64_t)h.snapshot().samples);
+    });
+}
+
+// --- Spectrum and biquads ------------------------------------------------------
+
+// Check: 50 Hz hum on a slowly moving axis sampled at a jittery ~1 kHz is found as a
+// peak and gets a notch, and that notch takes the hum down by 20 dB or more while the
+// movement passes; then the cost of one FFT and of one bank step over all lanes
+static void bench_spectrum(BenchRunner& b) {
+    {
+        std::vector<Sample> samples;
+        double t = 0.0;
+        for (size_t i = 0; i < 8192; ++i) {
+            t += 0.001 + 0.00005 * std::sin((double)i * 2.3); // report jitter
+            samples.push_back(Sample{ t, (float)(0.5 * std::sin(t * 2.0) + 0.02 * std::sin(t * 2.0 * 3.14159265 * 50.0)) });
+        }
+        SpectrumResult r;
+        const bool ok = analyze_spectrum(samples, 1024, r);
+        const bool notch = ok && r.suggestion.stages[0].kind == BiquadKind::Notch && std::fabs(r.suggestion.stages[0].freq_hz - 50.0f) < 1.0f;
+        double before = 0.0, after = 0.0;
+        if (notch) {
+            BiquadBank bank(1);
+            bank.set_lane(0, r.suggestion);
+            float x[BiquadBank::kLaneGroup] = {}, y[BiquadBank::kLaneGroup] = {};
+            for (size_t i = 0; i < 8192; ++i) {
+                const double ti = (double)i / r.fs;
+                const double hum = 0.02 * std::sin(ti * 2.0 * 3.14159265 * 50.0);
+                x[0] = (float)(0.5 * std::sin(ti * 2.0) + hum);
+                bank.process(x, y);
+                if (i < 4096) continue; // settled
+                before += hum * hum;
+                const double left = y[0] - 0.5 * std::sin(ti * 2.0);
+                after += left * left;
+            }
+        }
+        const double db = after > 0.0 ? 10.0 * std::log10(before / after) : 0.0;
+        if (!notch || db < 20.0) {
+            std::fprintf(stderr, "spectrum: %s, suggestion %s (%s), notch attenuation %.1f dB\n", ok ? "analyzed" : "not analyzed",
+                         format_biquad_chain(r.suggestion).c_str(), r.reason.c_str(), db);
+            g_check_failed = true;
+        }
+    }
+
+    std::vector<std::complex<float>> buf(1024);
+    b.run("spectrum.fft/1024", 1, [&](uint64_t n) {
+        for (uint64_t i = 0; i < n; ++i) {
+            for (size_t k = 0; k < buf.size(); ++k) buf[k] = std::complex<float>((float)((k * 37 + i) % 101), 0.0f);
+            fft_inplace(buf.data(), buf.size());
+        }
+        consume((double)buf[1].real());
+    });
+
+    for (size_t lanes : { 1, 8 }) {
+        BiquadBank bank(lanes);
+        BiquadChainSpec chain;
+        chain.fs = 1000.0;
+        chain.stages[0] = BiquadSpec{ BiquadKind::Notch, 50.0f, 8.0f };
+        chain.stages[1] = BiquadSpec{ BiquadKind::LowPass, 40.0f, 0.707f };
+        for (size_t l = 0; l < lanes; ++l) bank.set_lane(l, chain);
+        std::vector<float> x(bank.padded_lanes()), y(bank.padded_lanes());
+        b.run("biquad.bank/" + std::to_string(lanes) + "_lanes", (double)lanes, [&](uint64_t n) {
+            for (uint64_t i = 0; i < n; ++i) {
+                for (size_t l = 0; l < lanes; ++l) x[l] = (float)((i + l) & 63) * 0.01f;
+                bank.process(x.data(), y.data());
+            }
+            consume((double)y[0]);
+        });
+    }
+}
+
+// --- Mapper -------------------------------------------------------------------
+
+static void bench_mapper(BenchRunner& b) {
+    static const char* kActions[] = {
+        "x360:left_x", "x360:left_y", "x360:right_x", "x360:right_y", "x360:left_trigger", "x360:right_trigger",
+        "x360:button_a", "x360:button_b", "x360:button_x", "x360:button_y", "x360:dpad_up", "x360:dpad_down",
+    };
+    for (int count : { 1, 8, 32, 128 }) {
+        auto backend = std::make_unique<RecordingNullOutput>();
+        RecordingNullOutput* out = backend.get();
+        HotasMapper mapper(std::move(backend));
+        out->open();
+        std::vector<std::string> signal_ids;
+        for (int i = 0; i < count; ++i) {
+            MappingEntry e;
+            e.id = "m" + std::to_string(i);
+            e.signal_id = "stick:sig" + std::to_string(i);
+            e.action = kActions[i % (sizeof(kActions) / sizeof(kActions[0]))];
+            e.priority = i % 3;
+            mapper.add_mapping(e);
+            signal_ids.push_back(e.signal_id);
+        }
+        // One op = a frame of samples for every mapped signal plus one publish pass
+        b.run("mapper.tick/" + std::to_string(count) + "_mappings", (double)count, [&](uint64_t n) {
+            for (uint64_t i = 0; i < n; ++i) {
+                const double t = (double)i * 0.001;
+                for (size_t k = 0; k < signal_ids.size(); ++k) mapper.accept_sample(signal_ids[k], std::sin(t + (double)k), t);
+                mapper.tick();
+            }
+            consume(out->submits());
+        });
+    }
+}
+
+// --- Pipeline -----------------------------------------------------------------
+
+// One op = a stick + throttle report evaluated (decode, filters, HAT/POV directions,
+// forward to the mapper), with every descriptor live, with only the ones a small
+// profile maps subscribed on the signal bus, with every descriptor live plus the
+// spike detector on the axes, and with every descriptor live plus a notch and a
+// low-pass on every axis
+static void bench_pipeline(BenchRunner& b) {
+    auto sigs = HotasReader::load_signal_csv(HOTAS_CONFIG_DIR "/X56_Hotas_hid_bit_map.csv", DeviceRegistry::x56());
+    if (sigs.empty()) sigs = HotasReader::default_signals();
+    static const char* kMapped[][2] = {
+        {"stick:joy_x", "x360:left_x"}, {"stick:joy_y", "x360:left_y"}, {"stick:joy_z", "x360:right_x"},
+        {"stick:c_joy_x", "x360:right_y"}, {"throttle:left_throttle", "x360:left_trigger"},
+        {"throttle:right_throttle", "x360:right_trigger"}, {"stick:trigger", "x360:button_a"},
+        {"stick:A", "x360:button_b"}, {"stick:B", "x360:button_x"}, {"stick:H1_UP", "x360:dpad_up"},
+    };
+    uint8_t report[HidReport::kMaxBytes];
+    for (size_t i = 0; i < sizeof(report); ++i) report[i] = (uint8_t)(i * 37 + 11);
+
+    for (int variant = 0; variant < 4; ++variant) {
+        const bool subset = variant == 1;
+        auto backend = std::make_unique<RecordingNullOutput>();
+        HotasMapper mapper(std::move(backend));
+        std::vector<std::string> keys;
+        for (const auto& m : kMapped) {
+            MappingEntry e;
+            e.id = m[0];
+            e.signal_id = m[0];
+            e.action = m[1];
+            mapper.add_mapping(e);
+            keys.push_back(m[0]);
+        }
+        HotasPipeline pipeline(sigs, 2);
+        pipeline.set_mapper(&mapper);
+        for (const auto& out : pipeline.outputs()) {
+            if (out.derived) continue;
+            const auto& sd = sigs[(size_t)out.descriptor];
+            pipeline.set_filter_mode(out.map_key, sd.analog ? HotasPipeline::FilterAnalog : HotasPipeline::FilterDigital);
+        }
+        SignalBus bus(sigs.size());
+        if (subset) {
+            bus.set_interest(bus.add_consumer("mappings"), pipeline.interest_for(keys));
+            pipeline.set_signal_bus(&bus);
+        }
+        if (variant == 2) pipeline.set_spike_params(6.0, 15.0);
+        if (variant == 3) {
+            BiquadChainSpec chain;
+            chain.fs = 1000.0;
+            chain.stages[0] = BiquadSpec{ BiquadKind::Notch, 50.0f, 8.0f };
+            chain.stages[1] = BiquadSpec{ BiquadKind::LowPass, 40.0f, 0.707f };
+            for (const auto& out : pipeline.outputs()) if (!out.derived) pipeline.set_biquad_chain(out.map_key, chain);
+        }
+        pipeline.process(0.0, false); // take the interest set up front
+        std::string name = subset ? "pipeline.process/" + std::to_string(pipeline.active_signal_count()) + "_of_" +
+                                    std::to_string(sigs.size()) + "_signals"
+                                  : "pipeline.process/all_" + std::to_string(sigs.size()) + "_signals";
+        if (variant == 2) name += "+spike";
+        if (variant == 3) name += "+biquad";
+        b.run(name, (double)pipeline.active_signal_count(), [&](uint64_t n) {
+            for (uint64_t i = 0; i < n; ++i) {
+                const double t = (double)i * 0.001;
+                report[1] = (uint8_t)i;
+                report[3] = (uint8_t)(i >> 3);
+                pipeline.ingest(DeviceRegistry::kX56Stick, report, 14, t);
+                pipeline.ingest(DeviceRegistry::kX56Throttle, report, 14, t);
+                pipeline.process(t, false);
+            }
+            consume(pipeline.values()[0]);
+        });
+    }
+}
+
+// Ghost burst filter: cost per ingested report with the detector off, on with nothing
+// flipping, and on with a burst every report; plus a check that one button press
+// passes while a four-button burst is held
+static void bench_coincidence(BenchRunner& b) {
+    auto sigs = HotasReader::load_signal_csv(HOTAS_CONFIG_DIR "/X56_Hotas_hid_bit_map.csv", DeviceRegistry::x56());
+    if (sigs.empty()) sigs = HotasReader::default_signals();
+    std::vector<int> buttons; // stick one-bit digital fields
+    for (const auto& sd : sigs) if (sd.device == DeviceRegistry::kX56Stick && !sd.analog && sd.bits == 1) buttons.push_back(sd.bit_start);
+    if (buttons.size() < 5) { std::fprintf(stderr, "pipeline.coincidence: bit map has too few stick buttons\n"); g_check_failed = true; return; }
+    const size_t len = 14;
+    uint8_t base[HidReport::kMaxBytes] = {}, burst[HidReport::kMaxBytes] = {};
+    for (size_t i = 0; i < len; ++i) base[i] = (uint8_t)(i * 37 + 11);
+    for (int bit : buttons) base[bit / 8] &= (uint8_t)~(1u << (bit % 8)); // all released
+    std::memcpy(burst, base, sizeof(base));
+    for (size_t k = 1; k < 5; ++k) burst[buttons[k] / 8] |= (uint8_t)(1u << (buttons[k] % 8));
+
+    {
+        HotasPipeline pipeline(sigs, 2);
+        pipeline.set_coincidence_params(3, 25.0, 20.0);
+        size_t out_b = 0;
+        for (size_t k = 0; k < pipeline.outputs().size(); ++k) {
+            const auto& sd = sigs[(size_t)pipeline.outputs()[k].descriptor];
+            if (!pipeline.outputs()[k].derived && sd.device == DeviceRegistry::kX56Stick && sd.bit_start == buttons[1]) out_b = k;
+        }
+        uint8_t single[HidReport::kMaxBytes];
+        std::memcpy(single, base, sizeof(base));
+        single[buttons[0] / 8] |= (uint8_t)(1u << (buttons[0] % 8));
+        pipeline.ingest(DeviceRegistry::kX56Stick, base, len, 0.000); pipeline.process(0.000, false);
+        pipeline.ingest(DeviceRegistry::kX56Stick, single, len, 0.001); pipeline.process(0.001, false);
+        const bool single_passed = pipeline.coincidence_bursts(DeviceRegistry::kX56Stick) == 0;
+        pipeline.ingest(DeviceRegistry::kX56Stick, burst, len, 0.002); pipeline.process(0.002, false);
+        const bool burst_held = pipeline.coincidence_bursts(DeviceRegistry::kX56Stick) == 1 && pipeline.values()[out_b] == 0.0;
+        pipeline.process(0.030, false); // past the hold: the (now steady) buttons come through
+        const bool released = pipeline.values()[out_b] == 1.0;
+        if (!single_passed || !burst_held || !released) {
+            std::fprintf(stderr, "pipeline.coincidence: single press %s, burst %s, after hold %s\n", single_passed ? "ok" : "flagged",
+                         burst_held ? "held" : "not held", released ? "ok" : "still held");
+            g_check_failed = true;
+        }
+    }
+
+    for (int mode = 0; mode < 3; ++mode) {
+        HotasPipeline pipeline(sigs, 2);
+        pipeline.set_coincidence_params(mode == 0 ? 0 : 3, 25.0, 0.0);
+        static const char* kNames[] = { "pipeline.ingest/coincidence_off", "pipeline.ingest/coincidence_quiet", "pipeline.ingest/coincidence_burst" };
+        b.run(kNames[mode], 1, [&](uint64_t n) {
+            for (uint64_t i = 0; i < n; ++i) {
+                const uint8_t* r = mode == 2 && (i & 1) ? burst : base;
+                pipeline.ingest(DeviceRegistry::kX56Stick, r, len, (double)i * 0.001);
+            }
+            consume(pipeline.coincidence_bursts(DeviceRegistry::kX56Stick));
+        });
+    }
+}
+
+// --- Stall watchdog -----------------------------------------------------------
+
+// --- Tracing ------------------------------------------------------------------
+
+static void bench_trace(BenchRunner& b) {
+    // Check: threads started one after another (the HID readers on every device refresh)
+    // take over the exited threads' rings instead of adding one each
+    auto record_on_new_thread = [] { std::thread([] { hotas_trace::record_counter("bench.trace", 1.0); }).join(); };
+    record_on_new_thread();
+    const size_t rings = hotas_trace::ring_count();
+    for (int i = 0; i < 16; ++i) record_on_new_thread();
+    if (hotas_trace::ring_count() != rings) {
+        std::fprintf(stderr, "trace: %zu rings after 16 short-lived threads (expected %zu)\n", hotas_trace::ring_count(), rings);
+        g_check_failed = true;
+    }
+    b.run("trace.record_counter", 1, [&](uint64_t n) {
+        for (uint64_t i = 0; i < n; ++i) hotas_trace::record_counter("bench.trace", (double)i);
+        consume(n);
+    });
+    hotas_trace::clear();
+}
+
+static void bench_watchdog(BenchRunner& b) {
+    // Check: a stage blocked past its threshold is reported as one stall; the same block
+    // with the heartbeat paused (the pipeline loop re-enumerating devices) is not
+    std::atomic<int> stalls{0};
+    hotas_watchdog::set_stall_handler([&](const hotas_watchdog::StallNotice& n) {
+        if (n.begin) stalls.fetch_add(1, std::memory_order_relaxed);
+    });
+    hotas_watchdog::start(0.002);
+    {
+        hotas_watchdog::StageHeartbeat heartbeat("bench-stage", 0.02);
+        auto block = [&](bool paused) {
+            for (int i = 0; i < 5; ++i) { heartbeat.beat(); std::this_thread::sleep_for(std::chrono::milliseconds(2)); }
+            if (paused) heartbeat.pause();
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            if (paused) heartbeat.resume();
+            for (int i = 0; i < 10; ++i) { heartbeat.beat(); std::this_thread::sleep_for(std::chrono::milliseconds(2)); }
+            return stalls.exchange(0, std::memory_order_relaxed);
+        };
+        const int while_paused = block(true);
+        const int while_blocked = block(false);
+        if (while_paused != 0 || while_blocked != 1) {
+            std::fprintf(stderr, "watchdog: %d stall(s) across a paused 100 ms block (want 0), %d across an unpaused one (want 1)\n",
+                         while_paused, while_blocked);
+            g_check_failed = true;
+        }
+        b.run("watchdog.beat", 1, [&](uint64_t n) {
+            for (uint64_t i = 0; i < n; ++i) heartbeat.beat();
+            consume(n);
+        });
+    }
+    hotas_watchdog::stop();
+    hotas_watchdog::set_stall_handler(nullptr);
+}
+
+// --- Telemetry export ---------------------------------------------------------
+
+static void bench_telemetry(BenchRunner& b) {
+    TelemetryExporter w;
+#if defined(__linux__)
+    const std::string name = "/hotas_bench_telemetry_" + std::to_string((long long)getpid());
+    // Check: a region left mapped by a writer that died is taken over, and a second
+    // writer started while this one runs fails without touching the live frames
+    auto child_open = [&](bool crash_after_publish) {
+        const pid_t pid = fork();
+        if (pid == 0) {
+            TelemetryExporter c;
+            const bool ok = c.open(name.c_str());
+            if (ok && crash_after_publish) {
+                const float v = 7.0f;
+                c.publish(99.0, &v, 1, 0);
+                _exit(0); // no close(): the region stays initialized, as after a crash
+            }
+            _exit(ok ? 1 : 0);
+        }
+        int status = 0;
+        waitpid(pid, &status, 0);
+        return WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+    };
+    // Check: a writer does not take a region another one has created but not initialized
+    // yet. This process plays the first writer: it creates the region, holds the init lock
+    // while a second writer starts, then fills in a live header; the second must fail.
+    {
+        const std::string race_name = name + "_race";
+        const int fd = shm_open(race_name.c_str(), O_CREAT | O_RDWR, 0644);
+        void* mem = MAP_FAILED;
+        if (fd >= 0 && ftruncate(fd, sizeof(hotas_telemetry_region)) == 0 && flock(fd, LOCK_EX) == 0) {
+            mem = mmap(nullptr, sizeof(hotas_telemetry_region), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        }
+        if (mem == MAP_FAILED) {
+            std::fprintf(stderr, "telemetry: cannot set up %s: %s\n", race_name.c_str(), std::strerror(errno));
+            g_check_failed = true;
+        } else {
+            const pid_t pid = fork();
+            if (pid == 0) {
+                TelemetryExporter c;
+                _exit(c.open(race_name.c_str()) ? 1 : 0);
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+            auto* r = static_cast<hotas_telemetry_region*>(mem);
+            r->version = HOTAS_TELEMETRY_VERSION;
+            r->region_size = sizeof(hotas_telemetry_region);
+            r->writer_pid = (uint32_t)getpid();
+            __atomic_store_n(&r->magic, HOTAS_TELEMETRY_MAGIC, __ATOMIC_RELEASE);
+            flock(fd, LOCK_UN);
+            int status = 0;
+            waitpid(pid, &status, 0);
+            if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+                std::fprintf(stderr, "telemetry: a second writer took a region that was still being initialized\n");
+                g_check_failed = true;
+            }
+            munmap(mem, sizeof(hotas_telemetry_region));
+        }
+        if (fd >= 0) ::close(fd);
+        shm_unlink(race_name.c_str());
+    }
+    if (child_open(true) != 0) {
+        std::fprintf(stderr, "telemetry: crashing writer could not open %s\n", name.c_str());
+        g_check_failed = true;
+    }
+#else
+    const std::string name = std::string(HOTAS_TELEMETRY_DEFAULT_NAME) + "_bench";
+#endif
+    if (!w.open(name.c_str())) {
+        std::fprintf(stderr, "telemetry: open %s: %s\n", name.c_str(), w.last_error().c_str());
+        g_check_failed = true;
+        return;
+    }
+    std::vector<float> values(32);
+    for (size_t k = 0; k < values.size(); ++k) values[k] = (float)k * 0.25f;
+    w.publish(1.0, values.data(), (uint32_t)values.size(), HOTAS_TELEMETRY_FLAG_STICK);
+#if defined(__linux__)
+    if (child_open(false) != 0) {
+        std::fprintf(stderr, "telemetry: a second writer opened a live region\n");
+        g_check_failed = true;
+    }
+    void* handle = nullptr;
+    const hotas_telemetry_region* r = hotas_telemetry_attach(name.c_str(), &handle);
+    hotas_telemetry_frame f{};
+    if (!r || !hotas_telemetry_read_latest(r, &f) || f.t != 1.0 || f.signal_count != values.size() ||
+        r->writer_pid != (uint32_t)getpid()) {
+        std::fprintf(stderr, "telemetry: live region was disturbed by the second writer\n");
+        g_check_failed = true;
+    }
+    // Check: the writer sees the reader while it is attached, and not after
+    const uint32_t attached = w.readers_attached();
+    hotas_telemetry_detach(r, handle);
+    if (attached != 1 || w.readers_attached() != 0) {
+        std::fprintf(stderr, "telemetry: readers attached %u, after detach %u (expected 1, 0)\n", attached, w.readers_attached());
+        g_check_failed = true;
+    }
+#endif
+
+    b.run("telemetry.publish/32_signals", (double)values.size(), [&](uint64_t n) {
+        for (uint64_t i = 0; i < n; ++i) {
+            values[0] = (float)i;
+            w.publish((double)i * 0.001, values.data(), (uint32_t)values.size(), HOTAS_TELEMETRY_FLAG_STICK);
+        }
+        consume(w.frames_published());
+    });
+    w.close();
+}
+
+// --- Logging ------------------------------------------------------------------
+
+static void bench_log(BenchRunner& b) {
+    hotas_log::set_stderr(false);
+    hotas_log::start();
+    const std::string sig = "stick:joy_x";
+    // Level filtered out: what a debug call site costs in a normal build
+    hotas_log::set_level(hotas_log::Level::Info);
+    b.run("log.disabled", 1.0, [&](uint64_t n) {
+        for (uint64_t i = 0; i < n; ++i) HOTAS_LOG_DEBUG("bench", "sample {}={} ts={}", sig, (double)i, (double)i * 0.001);
+        consume(n);
+    });
+    hotas_log::set_level(hotas_log::Level::Debug);
+    // Past its 100/s budget almost every call is counted and skipped
+    b.run("log.write/rate_limited", 1.0, [&](uint64_t n) {
+        for (uint64_t i = 0; i < n; ++i) HOTAS_LOG_DEBUG("bench", "sample {}={} ts={}", sig, (double)i, (double)i * 0.001);
+        consume(n);
+    });
+    // Record into the ring; the flush per 256 (formatting on the log thread) is included
+    b.run("log.write+drain/256", 256.0, [&](uint64_t n) {
+        for (uint64_t i = 0; i < n; ++i) {
+            for (int k = 0; k < 256; ++k)
+                HOTAS_LOG_LIMITED(hotas_log::Level::Debug, "bench", 0, "sample {}={} ts={}", sig, (double)k, (double)i * 0.001);
+            hotas_log::flush();
+        }
+        consume(hotas_log::dropped());
+    });
+    hotas_log::CallSite site(hotas_log::Level::Debug, "bench", "X360 report LX={} LY={} RX={} RY={} LT={} RT={} buttons={}", 0);
+    hotas_log::Record rec;
+    rec.site = &site;
+    rec.nargs = 7;
+    for (int k = 0; k < 6; ++k) { rec.types[k] = hotas_log::ArgType::Int; rec.values[k].i = 1000 * k - 2000; }
+    rec.types[6] = hotas_log::ArgType::Hex; rec.values[6].u = 0x1010;
+    b.run("log.format/7_args", 1.0, [&](uint64_t n) {
+        for (uint64_t i = 0; i < n; ++i) consume((uint64_t)hotas_log::format(rec).size());
+    });
+    hotas_log::stop();
+    hotas_log::set_level(hotas_log::Level::Info);
+}
+
+// --- Plot series --------------------------------------------------------------
+
+static void bench_plots(BenchRunner& b) {
+    std::vector<Sample> analog(60000);
+    for (size_t i = 0; i < analog.size(); ++i) analog[i] = Sample{ i * 0.001, (float)std::sin(i * 0.01) };
+    std::vector<double> x, y;
+    b.run("plot.stride_downsample/60k->8k", (double)analog.size(), [&](uint64_t n) {
+        for (uint64_t i = 0; i < n; ++i) { stride_downsample(analog, 8000, x, y); consume((uint64_t)x.size()); }
+    });
+
+    // Baseline + edges of a button toggling every 50 ms over a 60 s window
+    std::vector<Sample> edges;
+    edges.push_back(Sample{ -0.5, 0.0f });
+    for (int i = 0; i < 1200; ++i) edges.push_back(Sample{ i * 0.05, (float)(i & 1) });
+    b.run("plot.build_step_series/1200_edges", (double)edges.size(), [&](uint64_t n) {
+        for (uint64_t i = 0; i < n; ++i) { build_step_series(edges, 0.0, 60.0, x, y); consume((uint64_t)x.size()); }
+    });
+
+    // One UI frame's plot temporaries: 12 groups of 3 series (10 s windows downsampled
+    // to point arrays) and a formatted id per group, as fresh heap vectors and strings
+    // vs. the frame arena reset per frame
+    const std::vector<Sample> window(analog.begin(), analog.begin() + 10000);
+    struct HeapSeries { std::vector<double> x, y; const char* label; };
+    b.run("plot.frame_temporaries/heap", 36, [&](uint64_t n) {
+        for (uint64_t i = 0; i < n; ++i) {
+            for (int g = 0; g < 12; ++g) {
+                std::vector<HeapSeries> series;
+                for (int k = 0; k < 3; ++k) {
+                    HeapSeries hs; hs.label = "x";
+                    stride_downsample(window, 2000, hs.x, hs.y);
+                    series.push_back(std::move(hs));
+                }
+                const std::string id = "Axes##dev_" + std::to_string(g);
+                consume((uint64_t)series.size() + id.size());
+            }
+        }
+    });
+    FrameArena arena(64 * 1024);
+    struct ArenaSeries { frame_vector<double> x, y; const char* label; };
+    auto arena_frame = [&]() {
+        arena.reset();
+        for (int g = 0; g < 12; ++g) {
+            frame_vector<ArenaSeries> series(&arena);
+            series.reserve(3);
+            for (int k = 0; k < 3; ++k) {
+                ArenaSeries as{ frame_vector<double>(&arena), frame_vector<double>(&arena), "x" };
+                stride_downsample(window, 2000, as.x, as.y);
+                series.push_back(std::move(as));
+            }
+            consume((uint64_t)series.size() + std::strlen(arena.format("Axes##dev_%d", g)));
+        }
+    };
+    // Check: the first frames outgrow the 64 KB block; after that one block serves a
+    // frame without the heap (no new blocks, and no allocations in alloc-check builds)
+    {
+        for (int f = 0; f < 3; ++f) arena_frame();
+        const uint64_t blocks = arena.heap_blocks(), allocations = hotas_alloc::thread_allocations();
+        for (int f = 0; f < 20; ++f) arena_frame();
+        const uint64_t frame_allocations = hotas_alloc::thread_allocations() - allocations;
+        double* p = static_cast<double*>(arena.allocate(3 * sizeof(double), alignof(double)));
+        const bool aligned = reinterpret_cast<uintptr_t>(p) % alignof(double) == 0;
+        if (arena.heap_blocks() != blocks || frame_allocations != 0 || arena.capacity() < arena.peak_used() || !aligned) {
+            std::fprintf(stderr, "frame_arena: %llu -> %llu blocks, %llu heap allocations over 20 frames, capacity %zu peak %zu\n",
+                         (unsigned long long)blocks, (unsigned long long)arena.heap_blocks(), (unsigned long long)frame_allocations,
+                         arena.capacity(), arena.peak_used());
+            g_check_failed = true;
+        }
+    }
+    b.run("plot.frame_temporaries/arena", 36, [&](uint64_t n) {
+        for (uint64_t i = 0; i < n; ++i) arena_frame();
+    });
+}
+
+static void usage() {
+    std::fprintf(stderr, "usage: hotas_bench [--filter SUBSTR] [--min-time SECONDS] [--repeat K] [--json FILE|-]\n");
+}
+
+int main(int argc, char** argv) {
+    BenchOptions o;
+    for (int i = 1; i < argc; ++i) {
+        std::string a = argv[i];
+        if (i + 1 >= argc) { usage(); return 2; }
+        if (a == "--filter") o.filter = argv[++i];
+        else if (a == "--min-time") o.min_time = std::atof(argv[++i]);
+        else if (a == "--repeat") o.repeat = std::max(1, std::atoi(argv[++i]));
+        else if (a == "--json") o.json = argv[++i];
+        else { usage(); return 2; }
+    }
+    BenchRunner b(o);
+    bench_sample_ring(b);
+    bench_ring_pages(b);
+    bench_layout(b);
+    bench_aligned_window(b);
+    bench_hid(b);
+    bench_hid_descriptor(b);
+    bench_filters(b);
+    bench_spike(b);
+    bench_axis_histogram(b);
+    bench_spectrum(b);
+    bench_mapper(b);
+    bench_pipeline(b);
+    bench_coincidence(b);
+    bench_telemetry(b);
+    bench_trace(b);
+    bench_watchdog(b);
+    bench_log(b);
+    bench_plots(b);
+    std::fprintf(b.table(), "(sink %llu)\n", (unsigned long long)g_sink);
+    return b.write_json() && !g_check_failed ? 0 : 1;
+}
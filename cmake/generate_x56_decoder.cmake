@@ -0,0 +1,92 @@
+# Generates the constexpr X56 signal table and unrolled decoders from the bit map CSV.
+#
+#   cmake -DCSV=<X56_Hotas_hid_bit_map.csv> -DOUT=<x56_bitmap.hpp> -P generate_x56_decoder.cmake
+#
+# Rows keep their CSV order per device; ids and names follow HotasReader::load_signal_csv
+# (name = id upper-cased, '-' -> '_'), so the built-in table and the CSV agree.
+
+cmake_minimum_required(VERSION 3.25)
+
+if(NOT CSV OR NOT OUT)
+    message(FATAL_ERROR "usage: cmake -DCSV=<bit map csv> -DOUT=<header> -P generate_x56_decoder.cmake")
+endif()
+
+file(STRINGS "${CSV}" lines)
+list(POP_FRONT lines) # header
+
+set(devices Stick Throttle)
+foreach(dev IN LISTS devices)
+    set(${dev}_fields "")
+    set(${dev}_decode "")
+    set(${dev}_count 0)
+    set(${dev}_bits 8)
+endforeach()
+
+foreach(line IN LISTS lines)
+    if(line STREQUAL "")
+        continue()
+    endif()
+    # Only the first seven columns matter; notes may hold quoted commas
+    string(REPLACE ";" " " line "${line}")
+    string(REPLACE "," ";" cols "${line}")
+    list(LENGTH cols ncols)
+    if(ncols LESS 7)
+        continue()
+    endif()
+    list(GET cols 0 dev)
+    list(GET cols 3 type)
+    list(GET cols 4 id)
+    list(GET cols 5 range)
+    list(GET cols 6 bits)
+    if(NOT dev IN_LIST devices)
+        message(FATAL_ERROR "${CSV}: unknown device '${dev}' (expected Stick or Throttle)")
+    endif()
+    string(REGEX MATCH "^[0-9]+" bit_start "${range}")
+    if(bit_start STREQUAL "" OR NOT bits MATCHES "^[0-9]+$")
+        message(FATAL_ERROR "${CSV}: bad bit range in row '${line}'")
+    endif()
+    string(TOLOWER "${type}" type_lower)
+    if(type_lower MATCHES "analog")
+        set(analog true)
+    else()
+        set(analog false)
+    endif()
+    string(TOUPPER "${id}" name)
+    string(REPLACE "-" "_" name "${name}")
+
+    math(EXPR index "${${dev}_count}")
+    math(EXPR ${dev}_count "${${dev}_count} + 1")
+    math(EXPR end "${bit_start} + ${bits}")
+    if(end GREATER ${dev}_bits)
+        set(${dev}_bits ${end})
+    endif()
+    string(APPEND ${dev}_fields "        { \"${id}\", \"${name}\", ${bit_start}, ${bits}, ${analog} },\n")
+    string(APPEND ${dev}_decode "        out[${index}] = extract_bits_fixed<${bit_start}, ${bits}>(report);\n")
+endforeach()
+
+get_filename_component(csv_name "${CSV}" NAME)
+set(text "// Generated from ${csv_name} by cmake/generate_x56_decoder.cmake; do not edit.\n")
+string(APPEND text "#pragma once\n#include <cstddef>\n#include <cstdint>\n#include \"core/device_registry.hpp\"\n#include \"core/hid_decode.hpp\"\n\n")
+string(APPEND text "namespace x56_bitmap {\n\n")
+string(APPEND text "struct Field {\n    const char* id;\n    const char* name;\n    int bit_start;\n    int bits;\n    bool analog;\n};\n\n")
+string(APPEND text "// Layout<device>: the device's fields in CSV order and decode(), which writes each\n")
+string(APPEND text "// field's raw value to out[i] with the offsets folded in at compile time.\n")
+string(APPEND text "template <DeviceIndex Device> struct Layout;\n")
+foreach(dev IN LISTS devices)
+    if(${dev}_count EQUAL 0)
+        message(FATAL_ERROR "${CSV}: no ${dev} rows")
+    endif()
+    math(EXPR bytes "(${${dev}_bits} + 7) / 8")
+    string(APPEND text "\ntemplate <> struct Layout<DeviceRegistry::kX56${dev}> {\n")
+    string(APPEND text "    static constexpr Field fields[] = {\n${${dev}_fields}    };\n")
+    string(APPEND text "    static constexpr size_t count = ${${dev}_count};\n")
+    string(APPEND text "    static constexpr size_t report_bytes = ${bytes};\n\n")
+    string(APPEND text "    static void decode(const uint8_t* report, size_t len, uint64_t* out) {\n")
+    string(APPEND text "        if (len < report_bytes) {\n")
+    string(APPEND text "            for (size_t i = 0; i < count; ++i) out[i] = extract_bits(report, len, fields[i].bit_start, fields[i].bits);\n")
+    string(APPEND text "            return;\n        }\n")
+    string(APPEND text "${${dev}_decode}    }\n};\n")
+endforeach()
+string(APPEND text "\n} // namespace x56_bitmap\n")
+
+file(WRITE "${OUT}" "${text}")
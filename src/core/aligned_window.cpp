@@ -0,0 +1,70 @@
+#include "aligned_window.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+void aligned_window(const std::vector<const SampleRing*>& rings, double t0, double t1, double step, AlignInterp interp,
+                    AlignedWindow& out) {
+    const size_t n = rings.size();
+    out.t.clear();
+    out.columns.resize(n);
+    for (auto& c : out.columns) c.clear();
+    if (!(t1 >= t0)) return;
+
+    // One cursor per ring: the last sample at or before the current row, and the next one
+    struct Cursor {
+        const SampleRing* ring = nullptr;
+        uint64_t next = 0, last = 0, end = 0; // next sample, one past the last inside [t0, t1], head
+        Sample prev{ 0.0, 0.0f };
+        bool have_prev = false;
+    };
+    std::vector<Cursor> cur(n);
+    for (size_t k = 0; k < n; ++k) {
+        Cursor& c = cur[k];
+        if (!(c.ring = rings[k])) continue;
+        c.end = c.ring->head();
+        c.next = c.ring->lower_index(c.end, t0, false);
+        c.last = c.ring->lower_index(c.end, t1, true);
+        // A sample before t0 holds into the window, like snapshot_with_baseline()
+        if (c.next > c.ring->oldest(c.end)) {
+            c.prev = c.ring->at(c.next - 1);
+            c.have_prev = true;
+        }
+    }
+
+    const float nan = std::numeric_limits<float>::quiet_NaN();
+    auto row = [&](double t) {
+        out.t.push_back(t);
+        for (size_t k = 0; k < n; ++k) {
+            Cursor& c = cur[k];
+            if (!c.ring) { out.columns[k].push_back(nan); continue; }
+            while (c.next < c.end && c.ring->at(c.next).t <= t) {
+                c.prev = c.ring->at(c.next++);
+                c.have_prev = true;
+            }
+            float v = c.have_prev ? c.prev.v : nan;
+            if (interp == AlignInterp::Linear && c.have_prev && c.next < c.end) {
+                const Sample s = c.ring->at(c.next);
+                if (s.t > c.prev.t) v = (float)(c.prev.v + (s.v - c.prev.v) * ((t - c.prev.t) / (s.t - c.prev.t)));
+            }
+            out.columns[k].push_back(v);
+        }
+    };
+
+    if (step > 0.0) {
+        const size_t count = (size_t)std::floor((t1 - t0) / step) + 1;
+        out.t.reserve(count);
+        for (auto& c : out.columns) c.reserve(count);
+        for (size_t i = 0; i < count; ++i) row(t0 + (double)i * step);
+        return;
+    }
+    // Union of the sample times: the earliest next sample of any ring is the next row
+    for (;;) {
+        double tn = std::numeric_limits<double>::infinity();
+        for (const Cursor& c : cur) {
+            if (c.ring && c.next < c.last) tn = std::min(tn, c.ring->at(c.next).t);
+        }
+        if (tn == std::numeric_limits<double>::infinity()) break;
+        row(tn);
+    }
+}
@@ -0,0 +1,27 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "ring_buffer.hpp"
+
+// Several rings over one time range as a single table with a shared time column, e.g. a
+// stick axis next to the controller output it is mapped to, or raw next to filtered.
+// Each ring's head is read once and all of them are walked together in one pass, so the
+// columns describe the same instants (separate snapshot() calls each see their own head).
+//
+// Rows are either every sample time of any ring within [t0, t1] (equal times share a row)
+// or a fixed grid t0, t0 + step, ... <= t1. A column holds its ring's value at each row:
+// the latest sample at or before it (Hold) or the line to the following sample (Linear).
+// Before a ring's first sample, and for a null ring, the value is NaN.
+
+enum class AlignInterp : uint8_t { Hold, Linear };
+
+struct AlignedWindow {
+    std::vector<double> t;
+    std::vector<std::vector<float>> columns; // by ring, one value per row
+    size_t rows() const { return t.size(); }
+};
+
+// step 0 = rows at the union of the sample times. Reuses out's storage.
+void aligned_window(const std::vector<const SampleRing*>& rings, double t0, double t1, double step, AlignInterp interp,
+                    AlignedWindow& out);
@@ -0,0 +1,154 @@
+#include "alloc_guard.hpp"
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+namespace hotas_alloc {
+
+namespace {
+
+std::atomic<uint64_t> g_total{0};
+std::atomic<uint64_t> g_violations{0};
+std::atomic<bool> g_armed{false};
+
+// Zone stack of this thread (plain TLS; touching it never allocates)
+struct ThreadZones {
+    const char* tags[kMaxZoneDepth];
+    int depth;
+    uint64_t allocations;
+};
+thread_local ThreadZones t_zones = {};
+
+// Distinct violating zone stacks. Fixed storage behind a spinlock: this runs
+// inside operator new, so it must not allocate or take a blocking lock.
+constexpr size_t kMaxViolations = 64;
+Violation g_table[kMaxViolations];
+size_t g_table_size = 0;
+std::atomic_flag g_table_lock = ATOMIC_FLAG_INIT;
+
+struct TableLock {
+    TableLock() { while (g_table_lock.test_and_set(std::memory_order_acquire)) {} }
+    ~TableLock() { g_table_lock.clear(std::memory_order_release); }
+};
+
+#if defined(HOTAS_ALLOC_CHECK)
+void record_violation(size_t bytes) {
+    g_violations.fetch_add(1, std::memory_order_relaxed);
+    const int depth = t_zones.depth < kMaxZoneDepth ? t_zones.depth : kMaxZoneDepth;
+    TableLock lock;
+    for (size_t i = 0; i < g_table_size; ++i) {
+        Violation& v = g_table[i];
+        if (v.depth == depth && std::memcmp(v.tags, t_zones.tags, sizeof(const char*) * (size_t)depth) == 0) {
+            ++v.count; v.bytes += bytes;
+            return;
+        }
+    }
+    if (g_table_size == kMaxViolations) return;
+    Violation& v = g_table[g_table_size++];
+    std::memcpy(v.tags, t_zones.tags, sizeof(const char*) * (size_t)depth);
+    v.depth = depth; v.count = 1; v.bytes = bytes;
+}
+#endif
+
+} // namespace
+
+#if defined(HOTAS_ALLOC_CHECK)
+void note_allocation(size_t bytes) {
+    g_total.fetch_add(1, std::memory_order_relaxed);
+    ++t_zones.allocations;
+    if (t_zones.depth > 0 && g_armed.load(std::memory_order_relaxed)) record_violation(bytes);
+}
+#endif
+
+uint64_t total_allocations() { return g_total.load(std::memory_order_relaxed); }
+uint64_t thread_allocations() { return t_zones.allocations; }
+
+void arm(bool on) { g_armed.store(on, std::memory_order_relaxed); }
+bool armed() { return g_armed.load(std::memory_order_relaxed); }
+
+uint64_t violation_count() { return g_violations.load(std::memory_order_relaxed); }
+
+size_t violations(Violation* out, size_t max) {
+    TableLock lock;
+    for (size_t i = 0; i < g_table_size && i < max; ++i) out[i] = g_table[i];
+    return g_table_size;
+}
+
+void reset_violations() {
+    TableLock lock;
+    g_table_size = 0;
+    g_violations.store(0, std::memory_order_relaxed);
+}
+
+void format_zone_stack(const Violation& v, char* out, size_t out_size) {
+    if (!out || out_size == 0) return;
+    out[0] = '\0';
+    size_t used = 0;
+    for (int i = 0; i < v.depth && used + 1 < out_size; ++i) {
+        int n = std::snprintf(out + used, out_size - used, "%s%s", i ? " > " : "", v.tags[i] ? v.tags[i] : "?");
+        if (n < 0) break;
+        used += (size_t)n;
+    }
+}
+
+NoAllocZone::NoAllocZone(const char* tag) {
+    if (t_zones.depth < kMaxZoneDepth) t_zones.tags[t_zones.depth] = tag;
+    ++t_zones.depth;
+}
+
+NoAllocZone::~NoAllocZone() { --t_zones.depth; }
+
+} // namespace hotas_alloc
+
+#if defined(HOTAS_ALLOC_CHECK)
+// Counting replacements for the global allocation functions.
+
+static void* counted_alloc(size_t n) {
+    hotas_alloc::note_allocation(n);
+    if (n == 0) n = 1;
+    return std::malloc(n);
+}
+
+static void* counted_alloc_aligned(size_t n, std::align_val_t al) {
+    hotas_alloc::note_allocation(n);
+    if (n == 0) n = 1;
+#if defined(_MSC_VER)
+    return _aligned_malloc(n, (size_t)al);
+#else
+    void* p = nullptr;
+    return posix_memalign(&p, (size_t)al < sizeof(void*) ? sizeof(void*) : (size_t)al, n) == 0 ? p : nullptr;
+#endif
+}
+
+static void counted_free_aligned(void* p) {
+#if defined(_MSC_VER)
+    _aligned_free(p);
+#else
+    std::free(p);
+#endif
+}
+
+void* operator new(size_t n) { if (void* p = counted_alloc(n)) return p; throw std::bad_alloc(); }
+void* operator new[](size_t n) { if (void* p = counted_alloc(n)) return p; throw std::bad_alloc(); }
+void* operator new(size_t n, const std::nothrow_t&) noexcept { return counted_alloc(n); }
+void* operator new[](size_t n, const std::nothrow_t&) noexcept { return counted_alloc(n); }
+void* operator new(size_t n, std::align_val_t al) { if (void* p = counted_alloc_aligned(n, al)) return p; throw std::bad_alloc(); }
+void* operator new[](size_t n, std::align_val_t al) { if (void* p = counted_alloc_aligned(n, al)) return p; throw std::bad_alloc(); }
+void* operator new(size_t n, std::align_val_t al, const std::nothrow_t&) noexcept { return counted_alloc_aligned(n, al); }
+void* operator new[](size_t n, std::align_val_t al, const std::nothrow_t&) noexcept { return counted_alloc_aligned(n, al); }
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+void operator delete[](void* p, size_t) noexcept { std::free(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { std::free(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { counted_free_aligned(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { counted_free_aligned(p); }
+void operator delete(void* p, size_t, std::align_val_t) noexcept { counted_free_aligned(p); }
+void operator delete[](void* p, size_t, std::align_val_t) noexcept { counted_free_aligned(p); }
+void operator delete(void* p, std::align_val_t, const std::nothrow_t&) noexcept { counted_free_aligned(p); }
+void operator delete[](void* p, std::align_val_t, const std::nothrow_t&) noexcept { counted_free_aligned(p); }
+#endif
@@ -0,0 +1,71 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// Heap-allocation checking for the input hot path.
+//
+// With HOTAS_ALLOC_CHECK defined (CMake option HOTAS_ENABLE_ALLOC_CHECK) the global
+// operator new/delete are replaced by counting versions, and HOTAS_NO_ALLOC_ZONE(tag)
+// marks the rest of a scope as a region that must not allocate. Zones nest per
+// thread; an allocation inside one is recorded with the thread's current zone
+// stack (e.g. "pipeline.pass > mapper.tick") once zones are armed. Arm them after
+// warm-up, when every buffer has reached its steady-state size.
+//
+// Without the define the macro compiles to nothing and the counters read 0.
+// Tags must be string literals (only the pointer is stored).
+namespace hotas_alloc {
+
+constexpr bool compiled_in() {
+#if defined(HOTAS_ALLOC_CHECK)
+    return true;
+#else
+    return false;
+#endif
+}
+
+constexpr int kMaxZoneDepth = 4;
+
+// One distinct zone stack that allocated, with how often and how much.
+struct Violation {
+    const char* tags[kMaxZoneDepth] = {};
+    int depth = 0;
+    uint64_t count = 0;
+    uint64_t bytes = 0;
+};
+
+// Process-wide allocation count (operator new calls).
+uint64_t total_allocations();
+// Allocations made by the calling thread.
+uint64_t thread_allocations();
+
+// Start/stop recording violations. Zones are disarmed at startup.
+void arm(bool on);
+bool armed();
+
+// Allocations inside armed zones since the last reset.
+uint64_t violation_count();
+// Copy up to `max` distinct zone stacks that allocated; returns how many exist.
+size_t violations(Violation* out, size_t max);
+void reset_violations();
+
+// Zone stack as text, e.g. "pipeline.pass > mapper.tick" (not for the hot path).
+void format_zone_stack(const Violation& v, char* out, size_t out_size);
+
+class NoAllocZone {
+public:
+    explicit NoAllocZone(const char* tag);
+    ~NoAllocZone();
+    NoAllocZone(const NoAllocZone&) = delete;
+    NoAllocZone& operator=(const NoAllocZone&) = delete;
+};
+
+} // namespace hotas_alloc
+
+#define HOTAS_ALLOC_CONCAT_INNER(a, b) a##b
+#define HOTAS_ALLOC_CONCAT(a, b) HOTAS_ALLOC_CONCAT_INNER(a, b)
+
+#if defined(HOTAS_ALLOC_CHECK)
+#define HOTAS_NO_ALLOC_ZONE(tag) ::hotas_alloc::NoAllocZone HOTAS_ALLOC_CONCAT(_hotas_no_alloc_, __LINE__)(tag)
+#else
+#define HOTAS_NO_ALLOC_ZONE(tag) ((void)0)
+#endif
@@ -0,0 +1,59 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Recent anomalies seen by the pipeline (spikes, for now), newest last.
+// Single writer (the pipeline thread), any number of readers that each keep their own
+// cursor. push() never blocks or allocates; a reader that falls more than a ring behind
+// loses the oldest events and is told how many.
+
+struct AnomalyEvent {
+    double t = 0.0;         // report time of the sample that tripped the detector
+    uint32_t descriptor = 0; // index into HotasPipeline::signals()
+    float value = 0.0f;     // the flagged value
+    float baseline = 0.0f;  // level before it
+    float z = 0.0f;         // first-difference z-score
+};
+
+class AnomalyRing {
+public:
+    explicit AnomalyRing(size_t capacity_pow2 = 256) : _mask(capacity_pow2 - 1), _events(capacity_pow2) {}
+
+    void push(const AnomalyEvent& e) {
+        const uint64_t idx = _write.load(std::memory_order_relaxed);
+        _events[idx & _mask] = e;
+        _write.store(idx + 1, std::memory_order_release);
+    }
+
+    // Append events after `cursor` to `out` and advance the cursor; returns how many
+    // were overwritten before they could be read.
+    uint64_t read(uint64_t& cursor, std::vector<AnomalyEvent>& out) const {
+        const uint64_t end = _write.load(std::memory_order_acquire);
+        const uint64_t cap = _events.size();
+        uint64_t lost = 0;
+        uint64_t start = cursor;
+        if (end - start > cap) { lost = end - cap - start; start = end - cap; }
+        const size_t first = out.size();
+        for (uint64_t i = start; i < end; ++i) out.push_back(_events[i & _mask]);
+        // Slots the writer lapped while they were copied are torn; drop them
+        const uint64_t now = _write.load(std::memory_order_acquire);
+        if (now - start > cap) {
+            const uint64_t torn = std::min<uint64_t>(now - cap - start, end - start);
+            out.erase(out.begin() + (ptrdiff_t)first, out.begin() + (ptrdiff_t)(first + torn));
+            lost += torn;
+        }
+        cursor = end;
+        return lost;
+    }
+
+    uint64_t total() const { return _write.load(std::memory_order_relaxed); }
+    size_t capacity() const { return _events.size(); }
+
+private:
+    size_t _mask;
+    std::vector<AnomalyEvent> _events;
+    std::atomic<uint64_t> _write{0};
+};
@@ -0,0 +1,270 @@
+#include "async_log.hpp"
+#include "thread_roles.hpp"
+#include <algorithm>
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace hotas_log {
+
+namespace {
+
+constexpr size_t kRingCapacity = 512;         // records per thread (128 KB), power of two
+constexpr size_t kRecentLines = 512;
+constexpr auto kDrainPeriod = std::chrono::milliseconds(20);
+
+struct ThreadRing {
+    std::atomic<uint64_t> write_index{0};
+    std::atomic<uint64_t> read_index{0};
+    std::atomic<bool> orphaned{false};        // owning thread exited; reusable once drained
+    std::vector<Record> records;
+    ThreadRing() : records(kRingCapacity) {}
+};
+
+struct Registry {
+    std::mutex mtx;                           // ring list, sinks, recent lines
+    std::mutex drain_mtx;                     // one consumer at a time (worker, stop, flush)
+    std::vector<std::unique_ptr<ThreadRing>> rings;
+    std::deque<LogLine> recent;
+    bool to_stderr = true;
+    FILE* file = nullptr;
+    std::atomic<uint64_t> dropped{0};
+    const int64_t start_ns = detail::now_ns();
+
+    std::mutex wake_mtx;
+    std::condition_variable wake_cv;
+    uint64_t flush_requested = 0;
+    uint64_t flush_done = 0;
+    std::atomic<bool> running{false};
+    std::thread worker;
+};
+
+Registry& registry() {
+    static Registry r;
+    return r;
+}
+
+// Marks the ring reusable when its thread exits
+struct RingOwner {
+    ThreadRing* ring = nullptr;
+    ~RingOwner() { if (ring) ring->orphaned.store(true, std::memory_order_release); }
+};
+thread_local RingOwner t_owner;
+
+ThreadRing* this_thread_ring() {
+    if (t_owner.ring) return t_owner.ring;
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lk(reg.mtx);
+    for (auto& r : reg.rings) {
+        if (r->orphaned.load(std::memory_order_acquire) &&
+            r->read_index.load(std::memory_order_acquire) == r->write_index.load(std::memory_order_relaxed)) {
+            r->orphaned.store(false, std::memory_order_relaxed);
+            return t_owner.ring = r.get();
+        }
+    }
+    reg.rings.push_back(std::make_unique<ThreadRing>());
+    return t_owner.ring = reg.rings.back().get();
+}
+
+const char* kLevelNames[] = { "debug", "info", "warn", "error" };
+const char kLevelTags[] = { 'D', 'I', 'W', 'E' };
+
+void emit(Registry& reg, std::vector<LogLine>& lines) {
+    std::lock_guard<std::mutex> lk(reg.mtx);
+    char prefix[64];
+    for (auto& l : lines) {
+        std::snprintf(prefix, sizeof(prefix), "[%10.3f] %c %s: ", (double)(l.t_ns - reg.start_ns) * 1e-9,
+                      kLevelTags[(size_t)l.level & 3], l.category);
+        if (reg.to_stderr) std::fprintf(stderr, "%s%s\n", prefix, l.text.c_str());
+        if (reg.file) std::fprintf(reg.file, "%s%s\n", prefix, l.text.c_str());
+        reg.recent.push_back(std::move(l));
+        if (reg.recent.size() > kRecentLines) reg.recent.pop_front();
+    }
+    if (reg.file) std::fflush(reg.file);
+}
+
+// Drain every ring once; lines from different threads are merged by time.
+void drain(Registry& reg) {
+    std::lock_guard<std::mutex> drain_lk(reg.drain_mtx);
+    std::vector<ThreadRing*> rings;
+    {
+        std::lock_guard<std::mutex> lk(reg.mtx);
+        for (auto& r : reg.rings) rings.push_back(r.get());
+    }
+    std::vector<LogLine> lines;
+    for (ThreadRing* r : rings) {
+        const uint64_t w = r->write_index.load(std::memory_order_acquire);
+        uint64_t rd = r->read_index.load(std::memory_order_relaxed);
+        for (; rd < w; ++rd) {
+            const Record& rec = r->records[rd & (kRingCapacity - 1)];
+            LogLine line;
+            line.t_ns = rec.t_ns;
+            line.level = rec.site ? rec.site->level : Level::Info;
+            line.category = rec.site ? rec.site->category : "";
+            line.text = format(rec);
+            lines.push_back(std::move(line));
+        }
+        r->read_index.store(rd, std::memory_order_release);
+    }
+    if (lines.empty()) return;
+    std::stable_sort(lines.begin(), lines.end(), [](const LogLine& a, const LogLine& b) { return a.t_ns < b.t_ns; });
+    emit(reg, lines);
+}
+
+void append_arg(std::string& out, const Record& r, size_t i) {
+    char buf[48];
+    switch (r.types[i]) {
+        case ArgType::Int: std::snprintf(buf, sizeof(buf), "%lld", (long long)r.values[i].i); out += buf; break;
+        case ArgType::UInt: std::snprintf(buf, sizeof(buf), "%llu", (unsigned long long)r.values[i].u); out += buf; break;
+        case ArgType::Double: std::snprintf(buf, sizeof(buf), "%.6g", r.values[i].d); out += buf; break;
+        case ArgType::Bool: out += r.values[i].u ? "true" : "false"; break;
+        case ArgType::Hex: std::snprintf(buf, sizeof(buf), "0x%llx", (unsigned long long)r.values[i].u); out += buf; break;
+        case ArgType::Str: out.append(r.strings + r.values[i].s.off, r.values[i].s.len); break;
+        case ArgType::None: break;
+    }
+}
+
+} // namespace
+
+namespace detail {
+
+std::atomic<uint8_t> g_min_level{(uint8_t)Level::Info};
+
+Record* begin_record() {
+    ThreadRing* r = this_thread_ring();
+    const uint64_t w = r->write_index.load(std::memory_order_relaxed);
+    if (w - r->read_index.load(std::memory_order_acquire) >= kRingCapacity) {
+        registry().dropped.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+    }
+    Record* rec = &r->records[w & (kRingCapacity - 1)];
+    *rec = Record{};
+    return rec;
+}
+
+void commit_record() {
+    ThreadRing* r = t_owner.ring;
+    r->write_index.store(r->write_index.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+} // namespace detail
+
+bool CallSite::admit(int64_t now_ns) {
+    if (max_per_sec == 0) return true;
+    int64_t w = window_start_ns.load(std::memory_order_relaxed);
+    if (now_ns - w >= 1000000000LL && window_start_ns.compare_exchange_strong(w, now_ns, std::memory_order_relaxed)) {
+        window_count.store(0, std::memory_order_relaxed);
+    }
+    if (window_count.fetch_add(1, std::memory_order_relaxed) < max_per_sec) return true;
+    suppressed.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
+void set_level(Level level) { detail::g_min_level.store((uint8_t)level, std::memory_order_relaxed); }
+Level level() { return (Level)detail::g_min_level.load(std::memory_order_relaxed); }
+const char* level_name(Level level) { return kLevelNames[(size_t)level & 3]; }
+
+bool parse_level(const std::string& s, Level& out) {
+    for (size_t i = 0; i < 4; ++i) if (s == kLevelNames[i]) { out = (Level)i; return true; }
+    return false;
+}
+
+std::string format(const Record& r) {
+    std::string out;
+    const char* f = r.site && r.site->fmt ? r.site->fmt : "";
+    size_t arg = 0;
+    for (; *f; ++f) {
+        if (f[0] == '{' && f[1] == '}') {
+            if (arg < r.nargs) append_arg(out, r, arg++);
+            ++f;
+        } else {
+            out.push_back(*f);
+        }
+    }
+    // Arguments without a placeholder are appended rather than lost
+    for (; arg < r.nargs; ++arg) { out.push_back(' '); append_arg(out, r, arg); }
+    if (r.suppressed) out += " (+" + std::to_string(r.suppressed) + " suppressed)";
+    return out;
+}
+
+void start() {
+    Registry& reg = registry();
+    if (reg.running.exchange(true)) return;
+    reg.worker = std::thread([&reg]() {
+        hotas_rt::ScopedThreadRole role(hotas_rt::ThreadRole::Background, "log");
+        while (true) {
+            uint64_t flush_target = 0;
+            {
+                std::unique_lock<std::mutex> lk(reg.wake_mtx);
+                reg.wake_cv.wait_for(lk, kDrainPeriod, [&] { return reg.flush_requested != reg.flush_done || !reg.running.load(); });
+                flush_target = reg.flush_requested;
+            }
+            drain(reg);
+            {
+                std::lock_guard<std::mutex> lk(reg.wake_mtx);
+                reg.flush_done = flush_target;
+            }
+            reg.wake_cv.notify_all();
+            if (!reg.running.load()) break;
+        }
+    });
+}
+
+void stop() {
+    Registry& reg = registry();
+    if (!reg.running.exchange(false)) return;
+    reg.wake_cv.notify_all();
+    if (reg.worker.joinable()) reg.worker.join();
+    drain(reg); // anything logged while the worker exited
+}
+
+void flush() {
+    Registry& reg = registry();
+    if (!reg.running.load()) { drain(reg); return; }
+    std::unique_lock<std::mutex> lk(reg.wake_mtx);
+    const uint64_t target = ++reg.flush_requested;
+    reg.wake_cv.notify_all();
+    reg.wake_cv.wait(lk, [&] { return reg.flush_done >= target || !reg.running.load(); });
+}
+
+void set_stderr(bool on) {
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lk(reg.mtx);
+    reg.to_stderr = on;
+}
+
+bool open_file(const std::string& path, std::string* error) {
+    FILE* f = std::fopen(path.c_str(), "a");
+    if (!f) { if (error) *error = "cannot open " + path; return false; }
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lk(reg.mtx);
+    if (reg.file) std::fclose(reg.file);
+    reg.file = f;
+    return true;
+}
+
+void close_file() {
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lk(reg.mtx);
+    if (reg.file) std::fclose(reg.file);
+    reg.file = nullptr;
+}
+
+std::vector<LogLine> recent(const char* category, int64_t since_ns) {
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lk(reg.mtx);
+    std::vector<LogLine> out;
+    for (const auto& l : reg.recent) {
+        if (l.t_ns < since_ns) continue;
+        if (category && std::strcmp(l.category, category) != 0) continue;
+        out.push_back(l);
+    }
+    return out;
+}
+
+uint64_t dropped() { return registry().dropped.load(std::memory_order_relaxed); }
+
+} // namespace hotas_log
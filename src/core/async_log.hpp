@@ -0,0 +1,163 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+// Asynchronous structured logging.
+//
+// HOTAS_LOG(level, category, fmt, args...) copies its arguments as a fixed-size
+// binary record into the calling thread's ring (single producer, single consumer;
+// no lock, no allocation, no formatting). A background thread drains all rings,
+// formats the records ("{}" placeholders, in argument order) and hands the lines
+// to the sinks: stderr, an optional file and an in-memory tail for the UI.
+//
+// Each call site is rate limited (default 100 records/s); suppressed records are
+// counted and reported with the next one that gets through. A full ring drops the
+// record and counts the drop. The format string and category must be string
+// literals; string arguments are copied (up to kStringBytes per record in total).
+namespace hotas_log {
+
+enum class Level : uint8_t { Debug = 0, Info, Warn, Error };
+
+constexpr size_t kMaxArgs = 8;
+constexpr size_t kStringBytes = 160;               // room for a HID device path
+constexpr uint32_t kDefaultRatePerSec = 100;
+
+// Formats as 0x<hex>.
+struct Hex { uint64_t value; };
+
+struct CallSite {
+    Level level;
+    const char* category;
+    const char* fmt;
+    uint32_t max_per_sec;                     // 0 = unlimited
+    std::atomic<int64_t> window_start_ns{0};
+    std::atomic<uint32_t> window_count{0};
+    std::atomic<uint32_t> suppressed{0};
+
+    CallSite(Level l, const char* cat, const char* f, uint32_t per_sec)
+        : level(l), category(cat), fmt(f), max_per_sec(per_sec) {}
+    bool admit(int64_t now_ns);
+};
+
+enum class ArgType : uint8_t { None = 0, Int, UInt, Double, Bool, Hex, Str };
+
+struct Record {
+    int64_t t_ns = 0;                         // steady clock
+    const CallSite* site = nullptr;
+    uint32_t suppressed = 0;                  // records this site dropped before this one
+    uint8_t nargs = 0;
+    ArgType types[kMaxArgs] = {};
+    union Value { int64_t i; uint64_t u; double d; struct { uint16_t off, len; } s; } values[kMaxArgs] = {};
+    char strings[kStringBytes] = {};
+};
+
+struct LogLine {
+    int64_t t_ns = 0;
+    Level level = Level::Info;
+    const char* category = "";
+    std::string text;
+};
+
+namespace detail {
+extern std::atomic<uint8_t> g_min_level;
+Record* begin_record();                       // slot in this thread's ring, or null when full
+void commit_record();
+
+inline int64_t now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+inline void put_str(Record& r, size_t i, size_t& used, const char* p, size_t n) {
+    if (n > kStringBytes - used) n = kStringBytes - used;
+    if (n) std::memcpy(r.strings + used, p, n);
+    r.types[i] = ArgType::Str;
+    r.values[i].s.off = (uint16_t)used;
+    r.values[i].s.len = (uint16_t)n;
+    used += n;
+}
+
+template <class T>
+inline void put(Record& r, size_t i, size_t& used, const T& v) {
+    using U = std::decay_t<T>;
+    if constexpr (std::is_same_v<U, bool>) { r.types[i] = ArgType::Bool; r.values[i].u = v ? 1 : 0; }
+    else if constexpr (std::is_same_v<U, Hex>) { r.types[i] = ArgType::Hex; r.values[i].u = v.value; }
+    else if constexpr (std::is_enum_v<U>) { r.types[i] = ArgType::Int; r.values[i].i = (int64_t)v; }
+    else if constexpr (std::is_integral_v<U> && std::is_signed_v<U>) { r.types[i] = ArgType::Int; r.values[i].i = (int64_t)v; }
+    else if constexpr (std::is_integral_v<U>) { r.types[i] = ArgType::UInt; r.values[i].u = (uint64_t)v; }
+    else if constexpr (std::is_floating_point_v<U>) { r.types[i] = ArgType::Double; r.values[i].d = (double)v; }
+    else if constexpr (std::is_convertible_v<const U&, std::string_view>) {
+        const std::string_view sv(v);
+        put_str(r, i, used, sv.data(), sv.size());
+    } else {
+        static_assert(sizeof(U) == 0, "unsupported log argument type");
+    }
+}
+} // namespace detail
+
+inline bool enabled(Level level) { return (uint8_t)level >= detail::g_min_level.load(std::memory_order_relaxed); }
+void set_level(Level level);
+Level level();
+const char* level_name(Level level);
+bool parse_level(const std::string& s, Level& out);
+
+template <class... Args>
+void write(CallSite& site, const Args&... args) {
+    static_assert(sizeof...(Args) <= kMaxArgs, "too many log arguments");
+    const int64_t now = detail::now_ns();
+    if (!site.admit(now)) return;
+    Record* r = detail::begin_record();
+    if (!r) return;
+    r->t_ns = now;
+    r->site = &site;
+    r->suppressed = site.suppressed.exchange(0, std::memory_order_relaxed);
+    r->nargs = (uint8_t)sizeof...(Args);
+    size_t i = 0, used = 0;
+    (detail::put(*r, i++, used, args), ...);
+    (void)i; (void)used; // unused without arguments
+    detail::commit_record();
+}
+
+// Start/stop the formatting thread. Records written while it is stopped wait in
+// the rings (and drop once a ring is full).
+void start();
+void stop();
+// Block until everything logged before the call has reached the sinks.
+void flush();
+
+// Sinks
+void set_stderr(bool on);
+bool open_file(const std::string& path, std::string* error = nullptr);
+void close_file();
+
+// Formatted lines kept in memory (newest last), optionally one category / since a time.
+std::vector<LogLine> recent(const char* category = nullptr, int64_t since_ns = 0);
+// Records lost to full rings since startup.
+uint64_t dropped();
+
+// Format one record (used by the worker; exposed for the benchmark).
+std::string format(const Record& r);
+
+} // namespace hotas_log
+
+#define HOTAS_LOG_LIMITED(level, category, per_sec, fmt, ...)                                   \
+    do {                                                                                         \
+        if (::hotas_log::enabled(level)) {                                                       \
+            static ::hotas_log::CallSite _hotas_log_site((level), (category), (fmt), (per_sec)); \
+            ::hotas_log::write(_hotas_log_site __VA_OPT__(,) __VA_ARGS__);                       \
+        }                                                                                        \
+    } while (0)
+
+#define HOTAS_LOG(level, category, fmt, ...) \
+    HOTAS_LOG_LIMITED(level, category, ::hotas_log::kDefaultRatePerSec, fmt __VA_OPT__(,) __VA_ARGS__)
+
+#define HOTAS_LOG_DEBUG(category, fmt, ...) HOTAS_LOG(::hotas_log::Level::Debug, category, fmt __VA_OPT__(,) __VA_ARGS__)
+#define HOTAS_LOG_INFO(category, fmt, ...) HOTAS_LOG(::hotas_log::Level::Info, category, fmt __VA_OPT__(,) __VA_ARGS__)
+#define HOTAS_LOG_WARN(category, fmt, ...) HOTAS_LOG(::hotas_log::Level::Warn, category, fmt __VA_OPT__(,) __VA_ARGS__)
+#define HOTAS_LOG_ERROR(category, fmt, ...) HOTAS_LOG(::hotas_log::Level::Error, category, fmt __VA_OPT__(,) __VA_ARGS__)
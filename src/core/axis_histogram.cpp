@@ -0,0 +1,103 @@
+#include "axis_histogram.hpp"
+#include <algorithm>
+
+namespace {
+
+constexpr double kDeadFraction = 0.05;  // bin below this share of the mean count is (almost) empty
+constexpr size_t kNeighbourBins = 8;    // populated bins wanted on each side of a dead spot
+constexpr uint32_t kMinJumps = 3;       // jumps from a bin before it can be part of a jump region
+constexpr double kJumpShare = 0.10;     // of the bin's visits that leave by a jump
+
+} // namespace
+
+AxisHistogram::AxisHistogram(int bits, bool signed_codes) {
+    _bits = std::clamp(bits, 1, 32);
+    _signed = signed_codes && _bits >= 2;
+    _mask = (1ULL << _bits) - 1;
+    _sign_bit = 1ULL << (_bits - 1);
+    _value_shift = _bits > 10 ? _bits - 10 : 0;
+    _step_shift = _bits > 12 ? _bits - 12 : 0; // 16-bit axis: 16 codes per step bin, +/-1/8 of travel
+    _jump_codes = std::max<uint64_t>(1, (_mask + 1) / 32);
+    _reset_requested.store(true, std::memory_order_relaxed); // first sample starts the banks
+}
+
+void AxisHistogram::clear(Bank& b) {
+    for (auto& c : b.values) c.store(0, std::memory_order_relaxed);
+    for (auto& c : b.steps) c.store(0, std::memory_order_relaxed);
+    for (auto& c : b.jump_from) c.store(0, std::memory_order_relaxed);
+}
+
+void AxisHistogram::apply_reset(double t) {
+    clear(_banks[0]);
+    clear(_banks[1]);
+    _bank = 0;
+    _bank_start = t;
+    _have_prev = false;
+    _oldest_t.store(t, std::memory_order_relaxed);
+    _reset_requested.store(false, std::memory_order_relaxed);
+}
+
+void AxisHistogram::rotate(double t) {
+    // The current bank becomes the older one; the other is emptied and takes new samples
+    _oldest_t.store(_bank_start, std::memory_order_relaxed);
+    _bank ^= 1;
+    clear(_banks[_bank]);
+    _bank_start = t;
+}
+
+AxisHistogram::Snapshot AxisHistogram::snapshot() const {
+    Snapshot s;
+    s.bins = (size_t)1 << std::min(_bits, 10);
+    if (_reset_requested.load(std::memory_order_relaxed)) return s;
+    for (size_t i = 0; i < kBins; ++i) {
+        s.values[i] = _banks[0].values[i].load(std::memory_order_relaxed) + _banks[1].values[i].load(std::memory_order_relaxed);
+        s.steps[i] = _banks[0].steps[i].load(std::memory_order_relaxed) + _banks[1].steps[i].load(std::memory_order_relaxed);
+        s.jump_from[i] = _banks[0].jump_from[i].load(std::memory_order_relaxed) + _banks[1].jump_from[i].load(std::memory_order_relaxed);
+        s.samples += s.values[i];
+        s.jumps += s.jump_from[i];
+    }
+    const double oldest = _oldest_t.load(std::memory_order_relaxed);
+    s.seconds = oldest >= 0.0 ? std::max(0.0, _last_t.load(std::memory_order_relaxed) - oldest) : 0.0;
+    if (s.samples == 0) return s;
+    while (s.lo < s.bins && s.values[s.lo] == 0) ++s.lo;
+    s.hi = s.bins - 1;
+    while (s.hi > s.lo && s.values[s.hi] == 0) --s.hi;
+    if (s.measuring() || s.hi - s.lo < 4 * kNeighbourBins) return s;
+
+    // Dead spots: runs of (almost) empty bins with populated bins on both sides. A sweep
+    // through working travel fills the bins in proportion to the time spent there; a
+    // worn track that never reports some positions leaves a hole between two full areas.
+    const double mean = (double)s.samples / (double)(s.hi - s.lo + 1);
+    const double low = mean * kDeadFraction;
+    auto side_mean = [&](size_t from, size_t to) { // [from, to)
+        uint64_t sum = 0;
+        for (size_t i = from; i < to; ++i) sum += s.values[i];
+        return to > from ? (double)sum / (double)(to - from) : 0.0;
+    };
+    for (size_t i = s.lo + 1; i < s.hi && s.dead_spots.size() < kMaxRegions;) {
+        if ((double)s.values[i] > low) { ++i; continue; }
+        size_t j = i;
+        uint64_t inside = 0;
+        while (j < s.hi && (double)s.values[j] <= low) inside += s.values[j++];
+        // [i, j) is the run; compare with the bins just outside it
+        const double left = side_mean(i > s.lo + kNeighbourBins ? i - kNeighbourBins : s.lo, i);
+        const double right = side_mean(j, std::min(j + kNeighbourBins, s.hi + 1));
+        if (left >= mean * 0.25 && right >= mean * 0.25) s.dead_spots.push_back(Region{ i, j - 1, inside });
+        i = j;
+    }
+
+    // Jump regions: bins that a good share of visits leave by a jump of 1/32 of the travel
+    for (size_t i = s.lo; i <= s.hi && s.jump_regions.size() < kMaxRegions;) {
+        auto jumpy = [&](size_t b) { return s.jump_from[b] >= kMinJumps && (double)s.jump_from[b] >= kJumpShare * (double)s.values[b]; };
+        if (!jumpy(i)) { ++i; continue; }
+        Region r{ i, i, 0 };
+        size_t j = i;
+        while (j <= s.hi && (jumpy(j) || (j + 1 <= s.hi && jumpy(j + 1)))) { // bridge one-bin gaps
+            if (jumpy(j)) { r.last = j; r.count += s.jump_from[j]; }
+            ++j;
+        }
+        s.jump_regions.push_back(r);
+        i = j;
+    }
+    return s;
+}
@@ -0,0 +1,112 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Value and step histograms of one analog axis, for spotting potentiometer wear.
+//
+// record() runs on the pipeline thread for every evaluated sample and is O(1): the raw
+// code goes into one of up to 1024 value bins, its difference from the previous code
+// into one of 1024 step bins (centered on zero), and a step of 1/32 of the range or
+// more is also counted against the bin it left from. Counters are single-writer
+// relaxed atomics, so snapshot() may run on any thread; the dead-spot and jump-region
+// report is derived there.
+//
+// Counts are kept in two banks. With a period set, the writer switches banks every
+// half period and clears the one it switches to, so a snapshot covers between half
+// and one full period; period 0 keeps everything since the last reset.
+class AxisHistogram {
+public:
+    static constexpr size_t kBins = 1024;
+    static constexpr uint64_t kMinSamples = 512;   // before a report is made
+    static constexpr size_t kMaxRegions = 8;
+
+    struct Region {
+        size_t first = 0;   // value bins, inclusive
+        size_t last = 0;
+        uint64_t count = 0; // samples (dead spot) or jumps (jump region) inside
+    };
+
+    struct Snapshot {
+        size_t bins = 0;            // value bins in use: min(1024, 2^bits)
+        uint64_t samples = 0;
+        uint64_t jumps = 0;
+        double seconds = 0.0;       // time covered
+        size_t lo = 0, hi = 0;      // lowest/highest value bin seen
+        std::array<uint32_t, kBins> values{};
+        std::array<uint32_t, kBins> steps{}; // bin kBins/2 = no change
+        std::array<uint32_t, kBins> jump_from{};
+        // Stretches inside [lo, hi] the axis (almost) never reports although both sides
+        // are well populated, and stretches a large share of visits leave by a jump
+        std::vector<Region> dead_spots;
+        std::vector<Region> jump_regions;
+        bool measuring() const { return samples < kMinSamples; }
+        // Position of a value bin's center in the axis travel, 0..1
+        double position(size_t bin) const { return bins ? ((double)bin + 0.5) / (double)bins : 0.0; }
+    };
+
+    // bits: width of the raw field; signed_codes: two's complement field (HID logical minimum < 0)
+    explicit AxisHistogram(int bits = 16, bool signed_codes = false);
+
+    // Pipeline thread only.
+    void record(uint64_t raw, double t) {
+        if (_reset_requested.load(std::memory_order_relaxed)) apply_reset(t);
+        const double period = _period.load(std::memory_order_relaxed);
+        if (period > 0.0 && t - _bank_start >= period * 0.5) rotate(t);
+        Bank& b = _banks[_bank];
+        if (_signed) raw ^= _sign_bit; // offset binary: bin 0 is the low end of travel
+        raw &= _mask;
+        bump(b.values[raw >> _value_shift]);
+        if (_have_prev) {
+            const int64_t d = (int64_t)raw - (int64_t)_prev;
+            int64_t sb = (d >= 0 ? d >> _step_shift : -((-d) >> _step_shift)) + (int64_t)(kBins / 2);
+            if (sb < 0) sb = 0;
+            if (sb >= (int64_t)kBins) sb = kBins - 1;
+            bump(b.steps[(size_t)sb]);
+            if ((uint64_t)(d < 0 ? -d : d) >= _jump_codes) bump(b.jump_from[_prev >> _value_shift]);
+        }
+        _prev = raw;
+        _have_prev = true;
+        _last_t.store(t, std::memory_order_relaxed);
+    }
+
+    // Any thread; applied by the writer on its next sample.
+    void request_reset() { _reset_requested.store(true, std::memory_order_relaxed); }
+    void set_period(double seconds) { _period.store(seconds > 0.0 ? seconds : 0.0, std::memory_order_relaxed); }
+    double period() const { return _period.load(std::memory_order_relaxed); }
+
+    // Any thread (not the hot path).
+    Snapshot snapshot() const;
+
+private:
+    struct Bank {
+        std::atomic<uint32_t> values[kBins] = {};
+        std::atomic<uint32_t> steps[kBins] = {};
+        std::atomic<uint32_t> jump_from[kBins] = {};
+    };
+
+    static void bump(std::atomic<uint32_t>& c) { c.store(c.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed); }
+    static void clear(Bank& b);
+    void apply_reset(double t);
+    void rotate(double t);
+
+    int _bits = 16;
+    bool _signed = false;
+    uint64_t _mask = 0;
+    uint64_t _sign_bit = 0;
+    int _value_shift = 0;        // raw code -> value bin
+    int _step_shift = 0;         // code difference -> step bin
+    uint64_t _jump_codes = 1;    // difference that counts as a jump
+    Bank _banks[2];
+    std::atomic<double> _period{0.0};
+    std::atomic<double> _oldest_t{-1.0}; // start of the older bank's data (-1 = none yet)
+    std::atomic<double> _last_t{0.0};
+    std::atomic<bool> _reset_requested{false};
+    // Writer state
+    size_t _bank = 0;
+    double _bank_start = -1.0;
+    bool _have_prev = false;
+    uint64_t _prev = 0;
+};
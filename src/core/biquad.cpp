@@ -0,0 +1,155 @@
+#include "biquad.hpp"
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_IX86_FP)
+#include <immintrin.h>
+#define HOTAS_BIQUAD_SSE 1
+#endif
+
+bool BiquadChainSpec::empty() const {
+    for (const auto& s : stages) if (s.kind != BiquadKind::None) return false;
+    return true;
+}
+
+bool BiquadChainSpec::operator==(const BiquadChainSpec& o) const {
+    if (fs != o.fs) return false;
+    for (size_t k = 0; k < kStages; ++k) {
+        if (stages[k].kind != o.stages[k].kind || stages[k].freq_hz != o.stages[k].freq_hz || stages[k].q != o.stages[k].q) return false;
+    }
+    return true;
+}
+
+BiquadCoeffs design_biquad(const BiquadSpec& spec, double fs) {
+    BiquadCoeffs c;
+    if (spec.kind == BiquadKind::None || !(fs > 0.0) || !(spec.freq_hz > 0.0f) || spec.freq_hz >= fs * 0.5 || !(spec.q > 0.0f)) return c;
+    const double w0 = 2.0 * 3.14159265358979323846 * spec.freq_hz / fs;
+    const double cw = std::cos(w0), alpha = std::sin(w0) / (2.0 * spec.q);
+    const double a0 = 1.0 + alpha;
+    double b0, b1, b2;
+    if (spec.kind == BiquadKind::Notch) { b0 = 1.0; b1 = -2.0 * cw; b2 = 1.0; }
+    else { b0 = (1.0 - cw) * 0.5; b1 = 1.0 - cw; b2 = (1.0 - cw) * 0.5; }
+    c.b0 = (float)(b0 / a0);
+    c.b1 = (float)(b1 / a0);
+    c.b2 = (float)(b2 / a0);
+    c.a1 = (float)(-2.0 * cw / a0);
+    c.a2 = (float)((1.0 - alpha) / a0);
+    return c;
+}
+
+const char* biquad_kind_name(BiquadKind kind) {
+    switch (kind) {
+    case BiquadKind::Notch: return "notch";
+    case BiquadKind::LowPass: return "lowpass";
+    case BiquadKind::None: break;
+    }
+    return "none";
+}
+
+std::string format_biquad_chain(const BiquadChainSpec& chain) {
+    if (chain.empty()) return "none";
+    char buf[128];
+    std::snprintf(buf, sizeof(buf), "%g|", chain.fs);
+    std::string out = buf;
+    bool first = true;
+    for (const auto& s : chain.stages) {
+        if (s.kind == BiquadKind::None) continue;
+        std::snprintf(buf, sizeof(buf), "%s%s:%g:%g", first ? "" : ",", biquad_kind_name(s.kind), s.freq_hz, s.q);
+        out += buf;
+        first = false;
+    }
+    return out;
+}
+
+bool parse_biquad_chain(const std::string& text, BiquadChainSpec& out) {
+    out = BiquadChainSpec{};
+    if (text.empty() || text == "none") return true;
+    const size_t bar = text.find('|');
+    if (bar == std::string::npos) return false;
+    out.fs = std::atof(text.substr(0, bar).c_str());
+    if (!(out.fs > 0.0)) return false;
+    size_t k = 0, at = bar + 1;
+    while (at < text.size() && k < BiquadChainSpec::kStages) {
+        size_t end = text.find(',', at);
+        if (end == std::string::npos) end = text.size();
+        const std::string item = text.substr(at, end - at);
+        const size_t c1 = item.find(':'), c2 = item.find(':', c1 == std::string::npos ? c1 : c1 + 1);
+        if (c1 == std::string::npos || c2 == std::string::npos) return false;
+        const std::string kind = item.substr(0, c1);
+        BiquadSpec& s = out.stages[k++];
+        if (kind == "notch") s.kind = BiquadKind::Notch;
+        else if (kind == "lowpass") s.kind = BiquadKind::LowPass;
+        else return false;
+        s.freq_hz = (float)std::atof(item.substr(c1 + 1, c2 - c1 - 1).c_str());
+        s.q = (float)std::atof(item.substr(c2 + 1).c_str());
+        at = end + 1;
+    }
+    return true;
+}
+
+BiquadBank::BiquadBank(size_t lanes) : _lanes(lanes) {
+    _padded = (lanes + kLaneGroup - 1) / kLaneGroup * kLaneGroup;
+    for (size_t k = 0; k < kStages; ++k) {
+        Section& s = _sections[k];
+        s.b0.assign(_padded, 1.0f);
+        for (auto* v : { &s.b1, &s.b2, &s.a1, &s.a2, &s.s1, &s.s2 }) v->assign(_padded, 0.0f);
+        _lane_used[k].assign(_padded, 0);
+    }
+}
+
+void BiquadBank::set_lane(size_t lane, const BiquadChainSpec& chain) {
+    if (lane >= _lanes) return;
+    for (size_t k = 0; k < kStages; ++k) {
+        Section& s = _sections[k];
+        const BiquadCoeffs c = design_biquad(chain.stages[k], chain.fs);
+        s.b0[lane] = c.b0; s.b1[lane] = c.b1; s.b2[lane] = c.b2; s.a1[lane] = c.a1; s.a2[lane] = c.a2;
+        s.s1[lane] = s.s2[lane] = 0.0f;
+        const uint8_t used = (c.b0 != 1.0f || c.b1 != 0.0f || c.b2 != 0.0f || c.a1 != 0.0f || c.a2 != 0.0f) ? 1 : 0;
+        if (used && !_lane_used[k][lane]) ++s.used;
+        else if (!used && _lane_used[k][lane]) --s.used;
+        _lane_used[k][lane] = used;
+    }
+}
+
+void BiquadBank::prime(size_t lane, float x) {
+    if (lane >= _lanes) return;
+    for (size_t k = 0; k < kStages; ++k) {
+        Section& s = _sections[k];
+        const float den = 1.0f + s.a1[lane] + s.a2[lane];
+        const float y = den != 0.0f ? x * (s.b0[lane] + s.b1[lane] + s.b2[lane]) / den : x;
+        s.s2[lane] = s.b2[lane] * x - s.a2[lane] * y;
+        s.s1[lane] = s.b1[lane] * x - s.a1[lane] * y + s.s2[lane];
+        x = y;
+    }
+}
+
+void BiquadBank::process(const float* in, float* out) {
+    const float* src = in;
+    for (size_t k = 0; k < kStages; ++k) {
+        Section& s = _sections[k];
+        if (s.used == 0) continue; // identity for every lane
+        size_t l = 0;
+#ifdef HOTAS_BIQUAD_SSE
+        for (; l + kLaneGroup <= _padded; l += kLaneGroup) {
+            const __m128 x = _mm_loadu_ps(src + l);
+            const __m128 s1 = _mm_loadu_ps(&s.s1[l]);
+            const __m128 s2 = _mm_loadu_ps(&s.s2[l]);
+            const __m128 y = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(&s.b0[l]), x), s1);
+            const __m128 n1 = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(_mm_loadu_ps(&s.b1[l]), x), _mm_mul_ps(_mm_loadu_ps(&s.a1[l]), y)), s2);
+            const __m128 n2 = _mm_sub_ps(_mm_mul_ps(_mm_loadu_ps(&s.b2[l]), x), _mm_mul_ps(_mm_loadu_ps(&s.a2[l]), y));
+            _mm_storeu_ps(&s.s1[l], n1);
+            _mm_storeu_ps(&s.s2[l], n2);
+            _mm_storeu_ps(out + l, y);
+        }
+#endif
+        for (; l < _padded; ++l) {
+            const float x = src[l];
+            const float y = s.b0[l] * x + s.s1[l];
+            s.s1[l] = s.b1[l] * x - s.a1[l] * y + s.s2[l];
+            s.s2[l] = s.b2[l] * x - s.a2[l] * y;
+            out[l] = y;
+        }
+        src = out;
+    }
+    if (src != out) for (size_t l = 0; l < _padded; ++l) out[l] = src[l];
+}
@@ -0,0 +1,72 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Second-order IIR sections for analog axes: notch (periodic hum) and low-pass
+// (broadband hiss), RBJ cookbook designs, run as a cascade of up to two sections.
+//
+// BiquadBank evaluates many channels at once, one lane per channel: coefficients and
+// state are stored per section as lane arrays, so a section runs four lanes per SSE
+// instruction (scalar loop elsewhere). A lane without a section passes through.
+
+enum class BiquadKind : uint8_t { None, Notch, LowPass };
+
+struct BiquadSpec {
+    BiquadKind kind = BiquadKind::None;
+    float freq_hz = 0.0f;
+    float q = 0.707f;
+};
+
+struct BiquadChainSpec {
+    static constexpr size_t kStages = 2;
+    double fs = 0.0; // sample rate the sections are designed for (the device's report rate)
+    BiquadSpec stages[kStages];
+    bool empty() const;
+    bool operator==(const BiquadChainSpec& o) const;
+    bool operator!=(const BiquadChainSpec& o) const { return !(*this == o); }
+};
+
+struct BiquadCoeffs {
+    float b0 = 1.0f, b1 = 0.0f, b2 = 0.0f, a1 = 0.0f, a2 = 0.0f; // a0 normalized to 1
+};
+
+// Identity for None or a frequency outside (0, fs/2)
+BiquadCoeffs design_biquad(const BiquadSpec& spec, double fs);
+
+// Text form for settings: "<fs>|<kind>:<hz>:<q>[,<kind>:<hz>:<q>]", e.g. "1000|notch:50:8"
+const char* biquad_kind_name(BiquadKind kind);
+std::string format_biquad_chain(const BiquadChainSpec& chain);
+bool parse_biquad_chain(const std::string& text, BiquadChainSpec& out);
+
+class BiquadBank {
+public:
+    static constexpr size_t kStages = BiquadChainSpec::kStages;
+    static constexpr size_t kLaneGroup = 4; // lanes per SSE register
+
+    explicit BiquadBank(size_t lanes = 0);
+
+    size_t lanes() const { return _lanes; }
+    // Buffers passed to process() hold at least this many floats
+    size_t padded_lanes() const { return _padded; }
+
+    // Replace a lane's sections (empty chain = pass-through) and clear its state
+    void set_lane(size_t lane, const BiquadChainSpec& chain);
+    // State for a steady input x, so a lane (re)starts without a transient
+    void prime(size_t lane, float x);
+
+    // One sample for every lane: out[l] = chain_l(in[l]). in and out may alias.
+    void process(const float* in, float* out);
+
+private:
+    struct Section {
+        std::vector<float> b0, b1, b2, a1, a2; // by lane
+        std::vector<float> s1, s2;             // transposed direct form II state
+        size_t used = 0;                       // lanes with a non-identity section
+    };
+    size_t _lanes = 0;
+    size_t _padded = 0;
+    Section _sections[kStages];
+    std::vector<uint8_t> _lane_used[kStages];
+};
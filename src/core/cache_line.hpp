@@ -0,0 +1,23 @@
+#pragma once
+#include <cstddef>
+#include <new>
+
+// Alignment that keeps fields written by one thread off the cache lines other threads
+// read (false sharing). Classes shared between the input, pipeline and UI threads put
+// each side's fields in their own alignas(kCacheLineSize) block.
+//
+// std::hardware_destructive_interference_size where the library has it, else 64 (x86-64
+// and most ARM cores). GCC warns that the value follows -mtune; it only lays out objects
+// inside this program, so the warning is silenced here.
+#if defined(__cpp_lib_hardware_interference_size)
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Winterference-size"
+#endif
+inline constexpr size_t kCacheLineSize = std::hardware_destructive_interference_size;
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+#else
+inline constexpr size_t kCacheLineSize = 64;
+#endif
@@ -0,0 +1,49 @@
+#pragma once
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include "hid_report_ring.hpp"
+
+// Report-level ghost burst detection. EMI on the X56 shows up as several unrelated
+// buttons and toggles flipping in the same report, sometimes together with an axis
+// jump; a person rarely changes more than one or two buttons within one report
+// interval. Catching the burst as a whole lets the per-button debounce stay short.
+//
+// The mask marks a device's one-bit digital fields (hats and POVs are left out: a
+// legitimate hat move can change all four of its bits). flips() XORs two reports and
+// popcounts the changed bits under the mask, one 64-bit word at a time, so the cost
+// is fixed by the report size and not by the number of signals.
+class CoincidenceMask {
+public:
+    static constexpr size_t kWords = HidReport::kMaxBytes / 8;
+
+    void add_bits(int bit_start, int bits) {
+        for (int b = bit_start; b < bit_start + bits; ++b) {
+            if (b < 0 || (size_t)b >= kWords * 64) continue;
+            _words[b / 64] |= 1ULL << (b % 64);
+            if ((size_t)b / 64 + 1 > _used) _used = (size_t)b / 64 + 1;
+        }
+    }
+    bool empty() const { return _used == 0; }
+
+    // Masked bits that differ between two reports of `len` bytes (bit numbering as in
+    // hid_decode.hpp; words assume a little-endian host, like the decoders)
+    int flips(const uint8_t* prev, const uint8_t* cur, size_t len) const {
+        int n = 0;
+        for (size_t w = 0; w < _used; ++w) {
+            const size_t at = w * 8;
+            if (at >= len) break;
+            const size_t k = len - at < 8 ? len - at : 8;
+            uint64_t a = 0, b = 0;
+            std::memcpy(&a, prev + at, k);
+            std::memcpy(&b, cur + at, k);
+            n += std::popcount((a ^ b) & _words[w]);
+        }
+        return n;
+    }
+
+private:
+    uint64_t _words[kWords] = {};
+    size_t _used = 0; // words up to the last masked bit
+};
@@ -0,0 +1,240 @@
+#include "device_registry.hpp"
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+
+namespace {
+
+// Indexed by SignalNorm / SignalExpand
+constexpr const char* kNormNames[] = { "raw", "full_scale", "byte", "signed" };
+constexpr const char* kExpandNames[] = { "none", "hat", "pov", "hat_switch" };
+
+std::string lower(std::string s) {
+    for (auto& c : s) c = (char)std::tolower((unsigned char)c);
+    return s;
+}
+
+// "0738", "0x0738" or a JSON number
+bool parse_usb_id(const nlohmann::json& j, uint16_t& out) {
+    if (j.is_number_unsigned()) {
+        const auto v = j.get<uint64_t>();
+        if (v > 0xffff) return false;
+        out = (uint16_t)v;
+        return true;
+    }
+    if (!j.is_string()) return false;
+    std::string s = lower(j.get<std::string>());
+    if (s.rfind("0x", 0) == 0) s = s.substr(2);
+    if (s.empty() || s.size() > 4) return false;
+    uint32_t v = 0;
+    for (char c : s) {
+        if (!std::isxdigit((unsigned char)c)) return false;
+        v = v * 16 + (uint32_t)(std::isdigit((unsigned char)c) ? c - '0' : c - 'a' + 10);
+    }
+    out = (uint16_t)v;
+    return true;
+}
+
+// Hex digits following `key` in an already lower-cased path
+bool hex_field(const std::string& p, const char* key, size_t digits, uint32_t& out) {
+    const size_t at = p.find(key);
+    if (at == std::string::npos) return false;
+    const size_t start = at + std::strlen(key);
+    if (start + digits > p.size()) return false;
+    uint32_t v = 0;
+    for (size_t i = 0; i < digits; ++i) {
+        const char c = p[start + i];
+        if (!std::isxdigit((unsigned char)c)) return false;
+        v = v * 16 + (uint32_t)(std::isdigit((unsigned char)c) ? c - '0' : c - 'a' + 10);
+    }
+    out = v;
+    return true;
+}
+
+} // namespace
+
+const char* signal_norm_name(SignalNorm norm) { return kNormNames[(size_t)norm]; }
+
+bool parse_signal_norm(const std::string& name, SignalNorm& out) {
+    for (size_t i = 0; i < std::size(kNormNames); ++i) {
+        if (name == kNormNames[i]) { out = (SignalNorm)i; return true; }
+    }
+    return false;
+}
+
+const char* signal_expand_name(SignalExpand expand) { return kExpandNames[(size_t)expand]; }
+
+bool parse_signal_expand(const std::string& name, SignalExpand& out) {
+    for (size_t i = 0; i < std::size(kExpandNames); ++i) {
+        if (name == kExpandNames[i]) { out = (SignalExpand)i; return true; }
+    }
+    return false;
+}
+
+SignalNorm DeviceDefinition::norm_of(const std::string& id, SignalNorm fallback) const {
+    for (const auto& n : normalize) if (n.first == id) return n.second;
+    return fallback;
+}
+
+SignalExpand DeviceDefinition::expand_of(const std::string& id, SignalExpand fallback) const {
+    for (const auto& e : expand) if (e.first == id) return e.second;
+    return fallback;
+}
+
+bool DeviceDefinition::reads_interface(int iface) const {
+    if (interfaces.empty()) return iface < 0;
+    return std::find(interfaces.begin(), interfaces.end(), iface) != interfaces.end();
+}
+
+DeviceRegistry DeviceRegistry::x56() {
+    DeviceRegistry r;
+    DeviceDefinition stick;
+    stick.name = "stick";
+    stick.label = "X56 H.O.T.A.S. Stick";
+    stick.vid = 0x0738;
+    stick.pid = 0x2221;
+    stick.interfaces = { 0, 2 };
+    stick.report_interface = 0;
+    stick.bitmap_csv = "X56_Hotas_hid_bit_map.csv";
+    stick.normalize = { { "joy_x", SignalNorm::FullScale }, { "joy_y", SignalNorm::FullScale }, { "joy_z", SignalNorm::FullScale },
+                        { "c_joy_x", SignalNorm::Byte }, { "c_joy_y", SignalNorm::Byte } };
+    stick.expand = { { "H1", SignalExpand::Hat }, { "H2", SignalExpand::Hat }, { "POV", SignalExpand::Pov } };
+    r.add(std::move(stick), nullptr);
+
+    DeviceDefinition throttle;
+    throttle.name = "throttle";
+    throttle.label = "X56 H.O.T.A.S. Throttle";
+    throttle.vid = 0x0738;
+    throttle.pid = 0xa221;
+    throttle.interfaces = { 0, 2 };
+    throttle.report_interface = 0;
+    throttle.bitmap_csv = "X56_Hotas_hid_bit_map.csv";
+    throttle.normalize = { { "left_throttle", SignalNorm::FullScale }, { "right_throttle", SignalNorm::FullScale },
+                           { "thumb_joy_x", SignalNorm::Byte }, { "thumb_joy_y", SignalNorm::Byte } };
+    throttle.expand = { { "H3", SignalExpand::Hat }, { "H4", SignalExpand::Hat } };
+    r.add(std::move(throttle), nullptr);
+    return r;
+}
+
+bool DeviceRegistry::parse_definition(const std::string& json_text, DeviceDefinition& out, std::string* error) {
+    auto fail = [&](const std::string& msg) { if (error) *error = msg; return false; };
+    nlohmann::json j;
+    try {
+        j = nlohmann::json::parse(json_text);
+    } catch (const std::exception& e) {
+        return fail(std::string("invalid JSON: ") + e.what());
+    }
+    if (!j.is_object()) return fail("expected an object");
+    DeviceDefinition d;
+    if (!j.contains("name") || !j["name"].is_string() || j["name"].get<std::string>().empty()) return fail("missing \"name\"");
+    d.name = j["name"].get<std::string>();
+    if (d.name.find(':') != std::string::npos) return fail("\"name\" must not contain ':'");
+    d.label = j.value("label", d.name);
+    if (!j.contains("vid") || !parse_usb_id(j["vid"], d.vid)) return fail("missing or invalid \"vid\"");
+    if (!j.contains("pid") || !parse_usb_id(j["pid"], d.pid)) return fail("missing or invalid \"pid\"");
+    if (j.contains("interfaces")) {
+        if (!j["interfaces"].is_array()) return fail("\"interfaces\" must be an array");
+        for (const auto& i : j["interfaces"]) {
+            if (!i.is_number_integer() || i.get<int>() < 0 || i.get<int>() > 255) return fail("invalid interface number");
+            d.interfaces.push_back(i.get<int>());
+        }
+    }
+    d.report_interface = j.value("report_interface", d.interfaces.empty() ? -1 : d.interfaces.front());
+    if (!d.reads_interface(d.report_interface)) return fail("\"report_interface\" is not one of \"interfaces\"");
+    d.bitmap_csv = j.value("bitmap", std::string());
+    d.descriptor_file = j.value("descriptor", std::string());
+    if (d.bitmap_csv.empty() && d.descriptor_file.empty()) return fail("missing \"bitmap\" or \"descriptor\"");
+    if (j.contains("normalize")) {
+        if (!j["normalize"].is_object()) return fail("\"normalize\" must be an object");
+        for (auto it = j["normalize"].begin(); it != j["normalize"].end(); ++it) {
+            SignalNorm n = SignalNorm::Raw;
+            if (!it.value().is_string() || !parse_signal_norm(it.value().get<std::string>(), n)) {
+                return fail("normalize." + it.key() + ": expected raw, full_scale, byte or signed");
+            }
+            d.normalize.emplace_back(it.key(), n);
+        }
+    }
+    if (j.contains("expand")) {
+        if (!j["expand"].is_object()) return fail("\"expand\" must be an object");
+        for (auto it = j["expand"].begin(); it != j["expand"].end(); ++it) {
+            SignalExpand e = SignalExpand::None;
+            if (!it.value().is_string() || !parse_signal_expand(it.value().get<std::string>(), e)) {
+                return fail("expand." + it.key() + ": expected none, hat, pov or hat_switch");
+            }
+            d.expand.emplace_back(it.key(), e);
+        }
+    }
+    out = std::move(d);
+    return true;
+}
+
+size_t DeviceRegistry::load_directory(const std::string& dir, std::vector<std::string>* errors) {
+    namespace fs = std::filesystem;
+    std::error_code ec;
+    std::vector<fs::path> files;
+    for (fs::directory_iterator it(dir, ec), end; !ec && it != end; it.increment(ec)) {
+        if (it->is_regular_file(ec) && lower(it->path().extension().string()) == ".json") files.push_back(it->path());
+    }
+    std::sort(files.begin(), files.end());
+    size_t added = 0;
+    for (const auto& f : files) {
+        std::ifstream in(f);
+        std::stringstream ss;
+        ss << in.rdbuf();
+        DeviceDefinition d;
+        std::string err;
+        if (!in || !parse_definition(ss.str(), d, &err) || !add(std::move(d), &err)) {
+            if (errors) errors->push_back(f.filename().string() + ": " + (err.empty() ? "cannot read" : err));
+            continue;
+        }
+        ++added;
+    }
+    return added;
+}
+
+bool DeviceRegistry::add(DeviceDefinition def, std::string* error) {
+    auto fail = [&](const std::string& msg) { if (error) *error = msg; return false; };
+    if (_devices.size() >= kMaxDevices) return fail("too many devices (max " + std::to_string(kMaxDevices) + ")");
+    if (find(def.name) >= 0) return fail("device name \"" + def.name + "\" is already registered");
+    if (find_usb(def.vid, def.pid) >= 0) return fail("VID/PID of \"" + def.name + "\" is already registered");
+    _devices.push_back(std::move(def));
+    return true;
+}
+
+int DeviceRegistry::find(const std::string& name) const {
+    for (size_t i = 0; i < _devices.size(); ++i) if (_devices[i].name == name) return (int)i;
+    return -1;
+}
+
+int DeviceRegistry::find_usb(uint16_t vid, uint16_t pid) const {
+    for (size_t i = 0; i < _devices.size(); ++i) if (_devices[i].vid == vid && _devices[i].pid == pid) return (int)i;
+    return -1;
+}
+
+bool DeviceRegistry::parse_path(const std::string& path, uint16_t& vid, uint16_t& pid, int& iface) {
+    const std::string p = lower(path);
+    uint32_t v = 0, d = 0, mi = 0;
+    if (!hex_field(p, "vid_", 4, v) || !hex_field(p, "pid_", 4, d)) return false;
+    vid = (uint16_t)v;
+    pid = (uint16_t)d;
+    iface = hex_field(p, "mi_", 2, mi) ? (int)mi : -1;
+    return true;
+}
+
+DeviceMatch DeviceRegistry::match(const std::string& path) const {
+    DeviceMatch m;
+    uint16_t vid = 0, pid = 0;
+    int iface = -1;
+    if (!parse_path(path, vid, pid, iface)) return m;
+    const int d = find_usb(vid, pid);
+    if (d < 0 || !_devices[(size_t)d].reads_interface(iface)) return m;
+    m.device = d;
+    m.interface = iface;
+    m.report_interface = iface == _devices[(size_t)d].report_interface;
+    return m;
+}
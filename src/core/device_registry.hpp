@@ -0,0 +1,122 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Dense device index: position in the registry, used to index every per-device
+// array (reader state, report rings, pipeline reports, merged frame parts).
+using DeviceIndex = uint8_t;
+
+// How a signal's raw value becomes the value the filters and mapper see.
+// Raw; unsigned 0..2^bits-1 -> -1..1; 0..255 -> -1..1; two's complement -(2^(bits-1)-1)..2^(bits-1)-1 -> -1..1
+enum class SignalNorm : uint8_t { Raw, FullScale, Byte, Signed };
+// Extra outputs derived from a 4-bit digital signal: Up/Right/Down/Left mask; 0-8 POV (0 = none);
+// HID hat switch 0-7 clockwise from up (other values = none)
+enum class SignalExpand : uint8_t { None, Hat, Pov, HatSwitch };
+
+// Value of a raw field under `norm` (shared by the pipeline and the raw plots).
+inline double normalize_signal(SignalNorm norm, uint64_t raw, int bits) {
+    if (bits <= 0) return 0.0;
+    switch (norm) {
+    case SignalNorm::FullScale: {
+        const double maxv = (double)((1ULL << bits) - 1);
+        return (double)raw / maxv * 2.0 - 1.0;
+    }
+    case SignalNorm::Byte:
+        return ((double)raw / 255.0) * 2.0 - 1.0;
+    case SignalNorm::Signed: {
+        if (bits < 2) return 0.0;
+        const int64_t v = (raw >> (bits - 1)) & 1 ? (int64_t)raw - (int64_t)(1ULL << bits) : (int64_t)raw;
+        const double maxv = (double)((1ULL << (bits - 1)) - 1);
+        return v < -maxv ? -1.0 : (double)v / maxv;
+    }
+    case SignalNorm::Raw:
+        break;
+    }
+    return (double)raw;
+}
+
+// Names used in definition files and caches: raw/full_scale/byte/signed, none/hat/pov/hat_switch
+const char* signal_norm_name(SignalNorm norm);
+bool parse_signal_norm(const std::string& name, SignalNorm& out);
+const char* signal_expand_name(SignalExpand expand);
+bool parse_signal_expand(const std::string& name, SignalExpand& out);
+
+// One HID controller the app reads, loaded from a definition file.
+struct DeviceDefinition {
+    std::string name;                  // mapping prefix, e.g. "stick" ("stick:joy_x")
+    std::string label;                 // shown in the UI
+    uint16_t vid = 0;
+    uint16_t pid = 0;
+    std::vector<int> interfaces;       // HID interfaces to read (mi_NN); empty = the device path has no mi_ part
+    int report_interface = -1;         // interface whose reports feed the pipeline; -1 = the only one
+    std::string bitmap_csv;            // bit map CSV, relative to the config directory
+    std::string descriptor_file;       // captured HID report descriptor, relative to the config directory
+    std::vector<std::pair<std::string, SignalNorm>> normalize;   // by signal id; others stay Raw
+    std::vector<std::pair<std::string, SignalExpand>> expand;    // by signal id; others None
+
+    // Entry for a signal id, or `fallback` when the definition does not list it
+    SignalNorm norm_of(const std::string& id, SignalNorm fallback = SignalNorm::Raw) const;
+    SignalExpand expand_of(const std::string& id, SignalExpand fallback = SignalExpand::None) const;
+    bool reads_interface(int iface) const;
+};
+
+// A device path resolved against the registry.
+struct DeviceMatch {
+    int device = -1;                   // registry index, -1 = not a registered device
+    int interface = -1;
+    bool report_interface = false;     // this interface feeds the device's report ring
+    explicit operator bool() const { return device >= 0; }
+};
+
+// The set of devices the reader opens, in dense index order.
+//
+// Definitions are JSON files (one device each) in a directory, loaded in file-name
+// order so indices are stable between runs:
+//
+//   { "name": "stick", "label": "X56 H.O.T.A.S. Stick", "vid": "0738", "pid": "2221",
+//     "interfaces": [0, 2], "report_interface": 0, "bitmap": "X56_Hotas_hid_bit_map.csv",
+//     "normalize": { "joy_x": "full_scale", "c_joy_x": "byte" }, "expand": { "H1": "hat" } }
+//
+// A "descriptor" file (captured HID report descriptor) generates the device's signals
+// from the descriptor instead; "bitmap" is then the fallback for descriptors without
+// usable (non vendor-defined) inputs. One of the two is required.
+//
+// All string matching happens here, when devices are enumerated; the hot path only
+// ever sees DeviceIndex values.
+class DeviceRegistry {
+public:
+    static constexpr size_t kMaxDevices = 16;
+    // Indices of the built-in X56 halves in x56()
+    static constexpr DeviceIndex kX56Stick = 0;
+    static constexpr DeviceIndex kX56Throttle = 1;
+
+    // Built-in X56 stick + throttle, used when no definition files are found.
+    static DeviceRegistry x56();
+
+    // Parse one definition; false with a message on malformed input.
+    static bool parse_definition(const std::string& json_text, DeviceDefinition& out, std::string* error);
+    // Load every *.json in `dir` (sorted by file name). Returns the number added;
+    // problems with individual files go to `errors` and skip that file.
+    size_t load_directory(const std::string& dir, std::vector<std::string>* errors);
+    // False when the registry is full or the name / VID:PID is already registered.
+    bool add(DeviceDefinition def, std::string* error);
+
+    size_t size() const { return _devices.size(); }
+    bool empty() const { return _devices.empty(); }
+    const DeviceDefinition& device(DeviceIndex index) const { return _devices[index]; }
+    const std::vector<DeviceDefinition>& devices() const { return _devices; }
+    // Index by name or by USB ids; -1 when unknown.
+    int find(const std::string& name) const;
+    int find_usb(uint16_t vid, uint16_t pid) const;
+
+    // Resolve a HID device path ("\\?\hid#vid_0738&pid_2221&mi_00#..."), case-insensitive.
+    DeviceMatch match(const std::string& path) const;
+    // vid_/pid_/mi_ fields of a device path; iface is -1 without an mi_ part.
+    static bool parse_path(const std::string& path, uint16_t& vid, uint16_t& pid, int& iface);
+
+private:
+    std::vector<DeviceDefinition> _devices;
+};
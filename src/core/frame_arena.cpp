@@ -0,0 +1,75 @@
+#include "frame_arena.hpp"
+#include <algorithm>
+#include <cstdarg>
+#include <cstdio>
+
+FrameArena::FrameArena(size_t initial_bytes) {
+    add_block(std::max<size_t>(initial_bytes, 4096));
+}
+
+void FrameArena::add_block(size_t min_bytes) {
+    const size_t size = std::max(min_bytes, _blocks.empty() ? 0 : _blocks.back().size * 2);
+    _blocks.push_back(Block{ std::make_unique<std::byte[]>(size), size });
+    ++_heap_blocks;
+}
+
+size_t FrameArena::capacity() const {
+    size_t total = 0;
+    for (const Block& b : _blocks) total += b.size;
+    return total;
+}
+
+void FrameArena::reset() {
+    _last_used = _used;
+    _peak_used = std::max(_peak_used, _used);
+    // The frame spilled into more blocks: replace them all with one that fits it
+    if (_blocks.size() > 1) {
+        size_t size = _blocks.front().size;
+        while (size < capacity()) size *= 2;
+        _blocks.clear();
+        add_block(size);
+    }
+    _current = 0;
+    _offset = 0;
+    _used = 0;
+}
+
+void* FrameArena::do_allocate(size_t bytes, size_t align) {
+    for (;;) {
+        Block& b = _blocks[_current];
+        const uintptr_t base = reinterpret_cast<uintptr_t>(b.data.get());
+        const size_t start = (size_t)(((base + _offset + align - 1) & ~(uintptr_t)(align - 1)) - base);
+        if (start + bytes <= b.size) {
+            _used += start + bytes - _offset;
+            _offset = start + bytes;
+            return b.data.get() + start;
+        }
+        // Next block (kept from an earlier frame of this one, or new)
+        if (_current + 1 == _blocks.size()) add_block(bytes + align);
+        ++_current;
+        _offset = 0;
+    }
+}
+
+const char* FrameArena::format(const char* fmt, ...) {
+    char local[256];
+    va_list args;
+    va_start(args, fmt);
+    const int n = std::vsnprintf(local, sizeof(local), fmt, args);
+    va_end(args);
+    if (n < 0) return "";
+    char* out = static_cast<char*>(allocate((size_t)n + 1, 1));
+    if ((size_t)n < sizeof(local)) {
+        std::copy(local, local + n + 1, out);
+    } else {
+        va_start(args, fmt);
+        std::vsnprintf(out, (size_t)n + 1, fmt, args);
+        va_end(args);
+    }
+    return out;
+}
+
+FrameArena& ui_frame_arena() {
+    static FrameArena arena;
+    return arena;
+}
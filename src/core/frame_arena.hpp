@@ -0,0 +1,64 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <string>
+#include <vector>
+
+// Bump allocator for the UI's per-frame temporaries (plot point arrays, series lists,
+// formatted labels and ids). Allocation is a pointer bump, deallocation does nothing,
+// and reset() at the start of each frame takes everything back at once.
+//
+// Memory is kept across frames. A frame that outgrows the current block chains more
+// blocks from the heap; the next reset() replaces them with one block large enough for
+// that frame, so a steady UI runs out of a single block without touching the heap.
+//
+// Use through std::pmr containers (frame_vector, frame_string) constructed with the
+// arena. Anything allocated from it must not outlive the frame. Not thread-safe.
+class FrameArena final : public std::pmr::memory_resource {
+public:
+    explicit FrameArena(size_t initial_bytes = 256 * 1024);
+    FrameArena(const FrameArena&) = delete;
+    FrameArena& operator=(const FrameArena&) = delete;
+
+    // Start a new frame: all memory handed out since the last reset is reused
+    void reset();
+
+    // printf into the arena; the text lives until the next reset()
+    const char* format(const char* fmt, ...)
+#if defined(__GNUC__)
+        __attribute__((format(printf, 2, 3)))
+#endif
+        ;
+
+    size_t used() const { return _used; }                // bytes handed out this frame
+    size_t last_frame_used() const { return _last_used; } // ... during the previous frame
+    size_t peak_used() const { return _peak_used; }       // largest frame so far
+    size_t capacity() const;                              // bytes held in blocks
+    uint64_t heap_blocks() const { return _heap_blocks; } // blocks taken from the heap so far
+
+private:
+    void* do_allocate(size_t bytes, size_t align) override;
+    void do_deallocate(void*, size_t, size_t) override {}
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+
+    struct Block {
+        std::unique_ptr<std::byte[]> data;
+        size_t size = 0;
+    };
+    void add_block(size_t min_bytes);
+
+    std::vector<Block> _blocks;
+    size_t _current = 0; // block being bumped
+    size_t _offset = 0;  // into _blocks[_current]
+    size_t _used = 0, _last_used = 0, _peak_used = 0;
+    uint64_t _heap_blocks = 0;
+};
+
+template <class T>
+using frame_vector = std::pmr::vector<T>;
+using frame_string = std::pmr::string;
+
+// The UI thread's arena, reset by the main loop before each ImGui::NewFrame()
+FrameArena& ui_frame_arena();
@@ -0,0 +1,146 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include "device_registry.hpp"
+#include "hid_report_ring.hpp"
+
+// One combined view of all devices, produced each time any of them reports.
+// parts[] holds every device's latest report as of `t`; the one that triggered the
+// frame is parts[trigger]. `skew` is how old the stalest contributing report was
+// at `t`, capped at the merger's bound.
+struct MergedFrame {
+    static constexpr size_t kMaxDevices = DeviceRegistry::kMaxDevices;
+    struct Part {
+        double t = 0.0;          // arrival time of this device's report
+        uint64_t seq = 0;        // report number on the device's ring
+        uint16_t len = 0;        // 0 = no report yet
+        uint8_t data[HidReport::kMaxBytes] = {};
+    };
+    uint64_t seq = 0;            // frame number, 0-based
+    double t = 0.0;              // arrival time of the triggering report
+    uint8_t trigger = 0;         // device index that reported
+    uint32_t present = 0;        // bit per device with a report
+    uint32_t stale = 0;          // bit per device whose report is at least the bound old
+    double skew = 0.0;           // seconds, <= bound
+    Part parts[kMaxDevices];
+};
+static_assert(MergedFrame::kMaxDevices <= 32, "present/stale hold one bit per device");
+
+// Merges the report rings of all devices into frames in arrival order.
+// Reports are taken oldest-first across devices, so each frame differs from the previous
+// one in exactly one device, and each device's reports appear in sequence. Nothing
+// waits for the other devices: a frame is emitted as soon as its report is drained.
+//
+// next() belongs to one consumer thread; skew statistics may be read from any thread.
+class FrameMerger {
+public:
+    struct SkewStats {
+        uint64_t frames = 0;
+        uint64_t over_bound = 0;     // frames with a device at or past the bound
+        uint64_t dropped = 0;        // reports lost because the consumer fell behind a ring
+        double mean_ms = 0.0;
+        double max_ms = 0.0;
+        double last_ms = 0.0;
+    };
+
+    explicit FrameMerger(double skew_bound_s = 0.25) : _bound(skew_bound_s) {}
+
+    // Attach device `index`'s ring; reading starts at the ring's current head.
+    void attach(size_t index, const HidReportRing* ring) {
+        if (index >= MergedFrame::kMaxDevices) return;
+        _cursors[index] = HidReportCursor(ring);
+        _have_pending[index] = false;
+        if (index + 1 > _devices) _devices = index + 1;
+    }
+
+    double skew_bound() const { return _bound; }
+
+    // Forget a device's report (it disconnected); later frames leave it out until it reports again.
+    void drop_device(size_t index) {
+        if (index >= MergedFrame::kMaxDevices) return;
+        _frame.parts[index] = MergedFrame::Part{};
+        _frame.present &= ~(1u << index);
+    }
+
+    // Next frame in arrival order, valid until the next call; null when every ring is
+    // drained. Returned in place: a frame holds every device's report, too much to copy per report.
+    const MergedFrame* next() {
+        size_t pick = MergedFrame::kMaxDevices;
+        for (size_t d = 0; d < _devices; ++d) {
+            if (!_have_pending[d]) _have_pending[d] = _cursors[d].next(_pending[d]);
+            if (_have_pending[d] && (pick == MergedFrame::kMaxDevices || _pending[d].t < _pending[pick].t)) pick = d;
+        }
+        if (pick == MergedFrame::kMaxDevices) return nullptr;
+        const HidReport& r = _pending[pick];
+        MergedFrame::Part& part = _frame.parts[pick];
+        part.t = r.t;
+        part.seq = r.seq;
+        part.len = r.len;
+        std::memcpy(part.data, r.data, r.len);
+        _have_pending[pick] = false;
+
+        _frame.t = r.t;
+        _frame.trigger = (uint8_t)pick;
+        _frame.present |= 1u << pick;
+        _frame.stale = 0;
+        double skew = 0.0;
+        for (size_t d = 0; d < _devices; ++d) {
+            if (!(_frame.present & (1u << d))) continue;
+            double age = _frame.t - _frame.parts[d].t;
+            if (age < 0.0) age = 0.0; // stamped just before the trigger but drained after it
+            if (age >= _bound) { age = _bound; _frame.stale |= 1u << d; }
+            if (age > skew) skew = age;
+        }
+        _frame.skew = skew;
+        _frame.seq = _next_seq++;
+        record(skew, _frame.stale != 0);
+        return &_frame;
+    }
+
+    // Reports not yet merged, over all rings (consumer thread)
+    size_t backlog() const {
+        uint64_t n = 0;
+        for (size_t d = 0; d < _devices; ++d) n += _cursors[d].pending() + (_have_pending[d] ? 1 : 0);
+        return (size_t)n;
+    }
+
+    SkewStats skew_stats() const {
+        SkewStats s;
+        s.frames = _frames.load(std::memory_order_relaxed);
+        s.over_bound = _over_bound.load(std::memory_order_relaxed);
+        s.mean_ms = s.frames ? _skew_sum.load(std::memory_order_relaxed) / (double)s.frames * 1000.0 : 0.0;
+        s.max_ms = _skew_max.load(std::memory_order_relaxed) * 1000.0;
+        s.last_ms = _skew_last.load(std::memory_order_relaxed) * 1000.0;
+        s.dropped = _dropped.load(std::memory_order_relaxed);
+        return s;
+    }
+
+private:
+    void record(double skew, bool over) {
+        _frames.store(_frames.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        if (over) _over_bound.store(_over_bound.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        _skew_sum.store(_skew_sum.load(std::memory_order_relaxed) + skew, std::memory_order_relaxed);
+        if (skew > _skew_max.load(std::memory_order_relaxed)) _skew_max.store(skew, std::memory_order_relaxed);
+        _skew_last.store(skew, std::memory_order_relaxed);
+        uint64_t dropped = 0;
+        for (size_t d = 0; d < _devices; ++d) dropped += _cursors[d].dropped();
+        _dropped.store(dropped, std::memory_order_relaxed);
+    }
+
+    double _bound;
+    size_t _devices = 0;
+    HidReportCursor _cursors[MergedFrame::kMaxDevices];
+    HidReport _pending[MergedFrame::kMaxDevices];
+    bool _have_pending[MergedFrame::kMaxDevices] = {};
+    MergedFrame _frame;
+    uint64_t _next_seq = 0;
+    // Written by the consumer only
+    std::atomic<uint64_t> _frames{0};
+    std::atomic<uint64_t> _over_bound{0};
+    std::atomic<uint64_t> _dropped{0};
+    std::atomic<double> _skew_sum{0.0};
+    std::atomic<double> _skew_max{0.0};
+    std::atomic<double> _skew_last{0.0};
+};
@@ -0,0 +1,64 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Raw HID report helpers shared by the reader, the pipeline and the tools.
+// Bit numbering is LSB-first within each byte, bit 0 = byte 0 bit 0 (matches the
+// "Bit range" column of the X56 bit map CSV).
+
+inline int hex_nibble(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return 10 + (c - 'a');
+    if (c >= 'A' && c <= 'F') return 10 + (c - 'A');
+    return 0;
+}
+
+// Decode a hex string ("0a1bff...") into bytes. Odd trailing nibbles are ignored.
+inline void hex_to_bytes(const std::string& hex, std::vector<uint8_t>& out) {
+    out.clear();
+    out.reserve(hex.size() / 2);
+    for (size_t i = 0; i + 1 < hex.size(); i += 2) {
+        out.push_back((uint8_t)((hex_nibble(hex[i]) << 4) | hex_nibble(hex[i + 1])));
+    }
+}
+
+// Bytes -> lowercase hex (two chars per byte).
+inline std::string bytes_to_hex(const uint8_t* data, size_t n) {
+    static const char digits[] = "0123456789abcdef";
+    std::string out(n * 2, '0');
+    for (size_t i = 0; i < n; ++i) {
+        out[2 * i] = digits[data[i] >> 4];
+        out[2 * i + 1] = digits[data[i] & 0x0F];
+    }
+    return out;
+}
+
+// Extract `bits` bits starting at `bit_start`. Bits past the end of the report read as 0.
+inline uint64_t extract_bits(const uint8_t* bytes, size_t size, int bit_start, int bits) {
+    if (bits <= 0) return 0;
+    uint64_t val = 0;
+    for (int i = 0; i < bits; ++i) {
+        const int bit_global = bit_start + i;
+        const size_t byte_idx = (size_t)bit_global / 8;
+        const int bit_in_byte = bit_global % 8;
+        if (byte_idx < size) val |= (uint64_t)((bytes[byte_idx] >> bit_in_byte) & 1) << i;
+    }
+    return val;
+}
+
+inline uint64_t extract_bits(const std::vector<uint8_t>& bytes, int bit_start, int bits) {
+    return extract_bits(bytes.data(), bytes.size(), bit_start, bits);
+}
+
+// extract_bits() for a field known at compile time: loads the bytes the field spans and
+// shifts/masks once. The caller guarantees the report holds (BitStart + Bits + 7) / 8 bytes.
+template <int BitStart, int Bits>
+inline uint64_t extract_bits_fixed(const uint8_t* bytes) {
+    static_assert(BitStart >= 0 && Bits > 0 && Bits <= 57, "field must fit one 64-bit load");
+    constexpr int first = BitStart / 8, shift = BitStart % 8, span = (shift + Bits + 7) / 8;
+    uint64_t v = 0;
+    for (int i = 0; i < span; ++i) v |= (uint64_t)bytes[first + i] << (8 * i);
+    return (v >> shift) & ((1ULL << Bits) - 1);
+}
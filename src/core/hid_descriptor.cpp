@@ -0,0 +1,217 @@
+#include "hid_descriptor.hpp"
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <iterator>
+
+namespace {
+
+// Short item types and main item tags (HID 1.11, 6.2.2)
+enum : uint8_t { kTypeMain = 0, kTypeGlobal = 1, kTypeLocal = 2 };
+enum : uint8_t { kMainInput = 0x8, kMainOutput = 0x9, kMainFeature = 0xB, kMainCollection = 0xA, kMainEndCollection = 0xC };
+enum : uint8_t { kGlobalUsagePage = 0x0, kGlobalLogicalMin = 0x1, kGlobalLogicalMax = 0x2, kGlobalReportSize = 0x7,
+                 kGlobalReportId = 0x8, kGlobalReportCount = 0x9, kGlobalPush = 0xA, kGlobalPop = 0xB };
+enum : uint8_t { kLocalUsage = 0x0, kLocalUsageMin = 0x1, kLocalUsageMax = 0x2 };
+
+constexpr uint32_t kMaxReportCount = 1024;  // elements per main item
+
+struct Globals {
+    uint16_t usage_page = 0;
+    int32_t logical_min = 0;
+    int32_t logical_max = 0;
+    uint32_t logical_max_unsigned = 0;  // for descriptors that encode e.g. 255 as the 1-byte 0xFF
+    uint32_t report_size = 0;
+    uint32_t report_count = 0;
+    uint8_t report_id = 0;
+};
+
+struct Locals {
+    std::vector<uint32_t> usages;       // extended usages (page << 16 | id) when 4 bytes long
+    uint32_t usage_min = 0, usage_max = 0;
+    bool have_min = false, have_max = false;
+};
+
+int32_t sign_extend(uint32_t v, size_t bytes) {
+    if (bytes == 1) return (int8_t)v;
+    if (bytes == 2) return (int16_t)v;
+    return (int32_t)v;
+}
+
+} // namespace
+
+size_t HidDescriptor::report_bytes(uint8_t report_id) const {
+    if (std::find(report_ids.begin(), report_ids.end(), report_id) == report_ids.end()) return 0;
+    int end = 8;
+    for (const auto& f : inputs) if (f.report_id == report_id) end = std::max(end, f.bit_start + f.bits);
+    return (size_t)(end + 7) / 8;
+}
+
+bool parse_hid_descriptor(const uint8_t* data, size_t size, HidDescriptor& out, std::string* error) {
+    auto fail = [&](const std::string& msg, size_t at) {
+        if (error) *error = msg + " at byte " + std::to_string(at);
+        return false;
+    };
+    HidDescriptor d;
+    Globals g;
+    std::vector<Globals> stack;
+    Locals l;
+    int depth = 0;
+    bool have_application = false;
+    std::vector<std::pair<uint8_t, int>> input_bits;   // next input bit per report ID
+
+    size_t i = 0;
+    while (i < size) {
+        const size_t at = i;
+        const uint8_t prefix = data[i++];
+        if (prefix == 0xFE) {
+            // Long item: bDataSize, bLongItemTag, data (no standard long items exist; skip)
+            if (i + 2 > size) return fail("truncated long item", at);
+            i += 2 + (size_t)data[i];
+            if (i > size) return fail("truncated long item", at);
+            continue;
+        }
+        const size_t n = (prefix & 3) == 3 ? 4 : (size_t)(prefix & 3);
+        if (i + n > size) return fail("truncated item", at);
+        uint32_t u = 0;
+        for (size_t k = 0; k < n; ++k) u |= (uint32_t)data[i + k] << (8 * k);
+        i += n;
+        const int32_t s = n ? sign_extend(u, n) : 0;
+        const uint8_t type = (prefix >> 2) & 3, tag = prefix >> 4;
+
+        if (type == kTypeGlobal) {
+            switch (tag) {
+            case kGlobalUsagePage: g.usage_page = (uint16_t)u; break;
+            case kGlobalLogicalMin: g.logical_min = s; break;
+            case kGlobalLogicalMax: g.logical_max = s; g.logical_max_unsigned = u; break;
+            case kGlobalReportSize:
+                if (u > 32) return fail("report size over 32 bits", at);
+                g.report_size = u;
+                break;
+            case kGlobalReportId:
+                if (u == 0 || u > 255) return fail("invalid report ID", at);
+                g.report_id = (uint8_t)u;
+                break;
+            case kGlobalReportCount:
+                if (u > kMaxReportCount) return fail("report count too large", at);
+                g.report_count = u;
+                break;
+            case kGlobalPush: stack.push_back(g); break;
+            case kGlobalPop:
+                if (stack.empty()) return fail("pop without push", at);
+                g = stack.back();
+                stack.pop_back();
+                break;
+            default: break; // physical range, units: not needed to extract values
+            }
+            continue;
+        }
+        if (type == kTypeLocal) {
+            const uint32_t usage = n == 4 ? u : ((uint32_t)g.usage_page << 16) | (u & 0xFFFF);
+            switch (tag) {
+            case kLocalUsage: l.usages.push_back(usage); break;
+            case kLocalUsageMin: l.usage_min = usage; l.have_min = true; break;
+            case kLocalUsageMax: l.usage_max = usage; l.have_max = true; break;
+            default: break; // designators, strings, delimiters
+            }
+            continue;
+        }
+        if (type != kTypeMain) return fail("reserved item type", at);
+
+        switch (tag) {
+        case kMainInput: {
+            auto it = std::find_if(input_bits.begin(), input_bits.end(), [&](const auto& p) { return p.first == g.report_id; });
+            if (it == input_bits.end()) {
+                input_bits.emplace_back(g.report_id, 8); // after the report ID byte
+                d.report_ids.push_back(g.report_id);
+                it = input_bits.end() - 1;
+            }
+            // Usages in order: the explicit list, then the range; the last one repeats
+            std::vector<uint32_t> usages = l.usages;
+            if (l.have_min && l.have_max && l.usage_max >= l.usage_min) {
+                for (uint32_t u2 = l.usage_min; u2 <= l.usage_max && usages.size() < g.report_count; ++u2) usages.push_back(u2);
+            }
+            // A logical max below a non-negative min was meant unsigned
+            int32_t lmax = g.logical_max;
+            if (g.logical_min >= 0 && lmax < g.logical_min) lmax = (int32_t)std::min<uint32_t>(g.logical_max_unsigned, INT32_MAX);
+            const bool variable = (u & 0x02) != 0;
+            for (uint32_t e = 0; e < g.report_count; ++e) {
+                HidField f;
+                f.report_id = g.report_id;
+                f.bit_start = it->second;
+                f.bits = (int)g.report_size;
+                const uint32_t usage = usages.empty() ? 0 : usages[std::min<size_t>(variable ? e : 0, usages.size() - 1)];
+                f.usage_page = (uint16_t)(usage >> 16);
+                f.usage = (uint16_t)usage;
+                f.logical_min = g.logical_min;
+                f.logical_max = lmax;
+                f.constant = (u & 0x01) != 0;
+                f.variable = variable;
+                f.relative = (u & 0x04) != 0;
+                f.null_state = (u & 0x40) != 0;
+                it->second += f.bits;
+                if (f.bits > 0) d.inputs.push_back(f);
+            }
+            break;
+        }
+        case kMainOutput:
+        case kMainFeature:
+            break; // separate reports; nothing the reader sees
+        case kMainCollection:
+            if (u == 0x01 && !have_application) {
+                have_application = true;
+                const uint32_t usage = l.usages.empty() ? 0 : l.usages.front();
+                d.application_page = (uint16_t)(usage >> 16);
+                d.application_usage = (uint16_t)usage;
+            }
+            ++depth;
+            break;
+        case kMainEndCollection:
+            if (depth == 0) return fail("end collection without collection", at);
+            --depth;
+            break;
+        default:
+            return fail("unknown main item", at);
+        }
+        l = Locals{}; // locals apply to one main item
+    }
+    if (depth != 0) return fail("unterminated collection", size);
+    if (d.inputs.empty()) return fail("no input reports", size);
+    out = std::move(d);
+    return true;
+}
+
+bool load_hid_descriptor_file(const std::string& path, std::vector<uint8_t>& out, std::string* error) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) { if (error) *error = "cannot open " + path; return false; }
+    const std::vector<uint8_t> raw((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    if (raw.empty()) { if (error) *error = path + " is empty"; return false; }
+
+    // Hex text when every token is a 1-2 digit hex byte (optionally 0x-prefixed); raw bytes otherwise
+    std::vector<uint8_t> bytes;
+    bool text = true;
+    for (size_t i = 0; i < raw.size() && text;) {
+        const char c = (char)raw[i];
+        if (c == '#') { while (i < raw.size() && raw[i] != '\n') ++i; continue; }
+        if (std::isspace((unsigned char)c) || c == ',') { ++i; continue; }
+        if (c == '0' && i + 1 < raw.size() && (raw[i + 1] == 'x' || raw[i + 1] == 'X')) i += 2;
+        size_t digits = 0;
+        uint32_t v = 0;
+        while (i < raw.size() && std::isxdigit(raw[i]) && digits < 3) {
+            const char h = (char)std::tolower(raw[i++]);
+            v = v * 16 + (uint32_t)(std::isdigit((unsigned char)h) ? h - '0' : h - 'a' + 10);
+            ++digits;
+        }
+        const bool separated = i == raw.size() || std::isspace(raw[i]) || raw[i] == ',' || raw[i] == '#';
+        if (digits == 0 || digits > 2 || !separated) text = false;
+        else bytes.push_back((uint8_t)v);
+    }
+    out = text ? std::move(bytes) : raw;
+    if (out.empty()) { if (error) *error = path + " holds no descriptor bytes"; return false; }
+    return true;
+}
+
+uint64_t hid_descriptor_hash(const std::vector<uint8_t>& bytes) {
+    uint64_t h = 1469598103934665603ull;
+    for (uint8_t b : bytes) { h ^= b; h *= 1099511628211ull; }
+    return h;
+}
@@ -0,0 +1,51 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// HID report descriptor parsing: turns the descriptor bytes a device publishes into
+// the input fields of its reports, so a device's signals can be generated instead
+// of written by hand in a bit map CSV.
+//
+// Bit offsets follow hid_decode.hpp and are relative to the report as the reader
+// gets it, which always starts with the report ID byte (0 on devices without report
+// IDs); the first field of a report therefore starts at bit 8.
+
+// One input report field element (a report count of N gives N fields).
+struct HidField {
+    uint8_t report_id = 0;       // 0 = the device uses no report IDs
+    int bit_start = 0;
+    int bits = 0;
+    uint16_t usage_page = 0;
+    uint16_t usage = 0;
+    int32_t logical_min = 0;
+    int32_t logical_max = 0;
+    bool constant = false;       // padding
+    bool variable = true;        // false = array (the field holds usage indices)
+    bool relative = false;
+    bool null_state = false;     // values outside the logical range mean "no value"
+
+    bool vendor_defined() const { return usage_page >= 0xFF00; }
+};
+
+struct HidDescriptor {
+    std::vector<HidField> inputs;        // in descriptor order
+    std::vector<uint8_t> report_ids;     // input report IDs in first-seen order ({0} without IDs)
+    uint16_t application_page = 0;       // usage of the first application collection
+    uint16_t application_usage = 0;
+
+    // Input report size in bytes (including the report ID byte), 0 for an unknown ID
+    size_t report_bytes(uint8_t report_id) const;
+};
+
+// Parse descriptor bytes. False with a message on malformed input (truncated items,
+// unbalanced collections or push/pop, report sizes over 32 bits).
+bool parse_hid_descriptor(const uint8_t* data, size_t size, HidDescriptor& out, std::string* error = nullptr);
+
+// Read a captured descriptor: raw bytes (e.g. Linux /sys/class/hidraw/*/device/report_descriptor)
+// or hex text ("05 01 09 04 ...", "0x05, 0x01", '#' comments to end of line).
+bool load_hid_descriptor_file(const std::string& path, std::vector<uint8_t>& out, std::string* error = nullptr);
+
+// FNV-1a over the descriptor bytes; keys the generated-signal cache.
+uint64_t hid_descriptor_hash(const std::vector<uint8_t>& bytes);
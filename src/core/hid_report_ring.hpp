@@ -0,0 +1,104 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+// Raw HID report as it came off the device, stamped at arrival.
+struct HidReport {
+    static constexpr size_t kMaxBytes = 64;
+    double t = 0.0;       // steady-clock seconds when the read completed
+    uint64_t seq = 0;     // 0-based report number on this device
+    uint16_t len = 0;
+    uint8_t data[kMaxBytes] = {};
+};
+
+// Single-producer ring of raw reports (one per device, written by its reader thread).
+// Each slot is a seqlock, so the producer never waits and any number of consumers
+// read independently with their own cursor. Consumers that fall more than
+// `capacity` reports behind lose the oldest ones (counted by HidReportCursor).
+class HidReportRing {
+public:
+    explicit HidReportRing(size_t capacity_pow2 = 256)
+        : _capacity(capacity_pow2), _mask(capacity_pow2 - 1), _slots(capacity_pow2) {}
+
+    // Producer only.
+    void push(const uint8_t* data, size_t len, double t) {
+        const uint64_t seq = _head.load(std::memory_order_relaxed);
+        Slot& s = _slots[seq & _mask];
+        s.version.store(2 * seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        if (len > HidReport::kMaxBytes) len = HidReport::kMaxBytes;
+        s.report.t = t;
+        s.report.seq = seq;
+        s.report.len = (uint16_t)len;
+        std::memcpy(s.report.data, data, len);
+        s.version.store(2 * seq + 2, std::memory_order_release);
+        _head.store(seq + 1, std::memory_order_release);
+    }
+
+    // Number of reports pushed so far.
+    uint64_t head() const { return _head.load(std::memory_order_acquire); }
+    size_t capacity() const { return _capacity; }
+
+    // Copy report `seq`. False if it has not been written yet or was already overwritten.
+    bool read(uint64_t seq, HidReport& out) const {
+        const Slot& s = _slots[seq & _mask];
+        const uint64_t want = 2 * seq + 2;
+        if (s.version.load(std::memory_order_acquire) != want) return false;
+        out = s.report;
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return s.version.load(std::memory_order_relaxed) == want;
+    }
+
+    // Most recent report, if any.
+    bool read_latest(HidReport& out) const {
+        const uint64_t h = head();
+        return h > 0 && read(h - 1, out);
+    }
+
+    void clear() { _head.store(0, std::memory_order_release); for (auto& s : _slots) s.version.store(0, std::memory_order_relaxed); }
+
+private:
+    struct Slot {
+        std::atomic<uint64_t> version{0}; // 2*seq+1 while writing, 2*seq+2 once complete
+        HidReport report;
+    };
+    size_t _capacity;
+    size_t _mask;
+    std::vector<Slot> _slots;
+    std::atomic<uint64_t> _head{0};
+};
+
+// Per-consumer read position in a HidReportRing.
+class HidReportCursor {
+public:
+    HidReportCursor() = default;
+    explicit HidReportCursor(const HidReportRing* ring) : _ring(ring), _next(ring ? ring->head() : 0) {}
+
+    // Fetch the next unread report. Skips ahead (counting drops) if the producer lapped us.
+    bool next(HidReport& out) {
+        if (!_ring) return false;
+        const uint64_t head = _ring->head();
+        if (_next >= head) return false;
+        if (head - _next > _ring->capacity()) {
+            const uint64_t skip_to = head - _ring->capacity();
+            _dropped += skip_to - _next;
+            _next = skip_to;
+        }
+        while (_next < head) {
+            if (_ring->read(_next++, out)) return true;
+            ++_dropped; // overwritten while we looked
+        }
+        return false;
+    }
+
+    uint64_t pending() const { return _ring ? _ring->head() - _next : 0; }
+    uint64_t dropped() const { return _dropped; }
+
+private:
+    const HidReportRing* _ring = nullptr;
+    uint64_t _next = 0;
+    uint64_t _dropped = 0;
+};
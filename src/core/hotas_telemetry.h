@@ -0,0 +1,194 @@
+/*
+ * Shared-memory telemetry layout for external readers (cockpit software, loggers).
+ *
+ * The HOTAS controller publishes the latest filtered HOTAS frame into a named
+ * shared-memory region ("/hotas_telemetry" via POSIX shm on Linux,
+ * "Local\hotas_telemetry" file mapping on Windows). The writer never blocks on
+ * readers: every slot is protected by a seqlock (odd sequence = write in
+ * progress) so a reader copies frames at any rate. The attach helpers below also
+ * count attached readers in the header; while none is attached the writer may
+ * leave signals the app does not use itself at 0.
+ *
+ * Layout: a fixed header with signal names (written once), the latest frame,
+ * and a small power-of-two history ring of recent frames.
+ *
+ * This header is plain C so it can be dropped into any consumer.
+ */
+#ifndef HOTAS_TELEMETRY_H
+#define HOTAS_TELEMETRY_H
+
+#include <stdint.h>
+#include <string.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define HOTAS_TELEMETRY_MAGIC        0x53544F48u /* "HOTS" little-endian */
+#define HOTAS_TELEMETRY_VERSION      1u
+#define HOTAS_TELEMETRY_MAX_SIGNALS  128u
+#define HOTAS_TELEMETRY_NAME_LEN     32u
+#define HOTAS_TELEMETRY_HISTORY      64u   /* power of two */
+
+#if defined(_WIN32)
+#define HOTAS_TELEMETRY_DEFAULT_NAME "Local\\hotas_telemetry"
+#else
+#define HOTAS_TELEMETRY_DEFAULT_NAME "/hotas_telemetry"
+#endif
+
+/* Frame flags: bit i = a report from device i of the app's device registry is present
+   in this frame. With the built-in X56 registry those are the two below. */
+#define HOTAS_TELEMETRY_FLAG_STICK     0x1u  /* stick report present in this frame */
+#define HOTAS_TELEMETRY_FLAG_THROTTLE  0x2u  /* throttle report present in this frame */
+#define HOTAS_TELEMETRY_FLAG_DEVICE(i) (1u << (i))
+
+typedef struct hotas_telemetry_frame {
+    uint64_t frame_seq;     /* 1-based frame counter; 0 means "never written" */
+    double   t;             /* steady-clock seconds at pipeline time */
+    uint32_t signal_count;  /* number of valid entries in values[] */
+    uint32_t flags;         /* HOTAS_TELEMETRY_FLAG_* */
+    float    values[HOTAS_TELEMETRY_MAX_SIGNALS]; /* filtered values, indexed like names[] */
+} hotas_telemetry_frame;
+
+typedef struct hotas_telemetry_slot {
+    uint32_t seq;           /* seqlock: odd while the writer is updating frame */
+    uint32_t reserved;
+    hotas_telemetry_frame frame;
+} hotas_telemetry_slot;
+
+typedef struct hotas_telemetry_region {
+    uint32_t magic;         /* HOTAS_TELEMETRY_MAGIC once initialized */
+    uint32_t version;       /* HOTAS_TELEMETRY_VERSION */
+    uint32_t region_size;   /* sizeof(hotas_telemetry_region) as seen by the writer */
+    uint32_t max_signals;   /* HOTAS_TELEMETRY_MAX_SIGNALS */
+    uint32_t history_len;   /* HOTAS_TELEMETRY_HISTORY */
+    uint32_t signal_count;  /* number of named signals */
+    uint32_t names_seq;     /* seqlock guarding names[] (changes only on profile/device change) */
+    uint32_t writer_pid;
+    uint32_t readers;       /* readers attached with hotas_telemetry_attach (kept across writer restarts) */
+    uint32_t reserved0[7];  /* pad header to 64 bytes */
+    char     names[HOTAS_TELEMETRY_MAX_SIGNALS][HOTAS_TELEMETRY_NAME_LEN]; /* e.g. "stick:joy_x" */
+    uint64_t head;          /* frames written; newest history entry is (head-1) & (HISTORY-1) */
+    uint64_t reserved[7];   /* keep head on its own cache line */
+    hotas_telemetry_slot latest;
+    hotas_telemetry_slot history[HOTAS_TELEMETRY_HISTORY];
+} hotas_telemetry_region;
+
+/* Memory ordering helpers for readers */
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define HOTAS_TELEMETRY_LOAD_U32(p)  (*(volatile const uint32_t*)(p))
+#define HOTAS_TELEMETRY_LOAD_U64(p)  (*(volatile const uint64_t*)(p))
+#define HOTAS_TELEMETRY_ACQUIRE()    _ReadWriteBarrier()
+#else
+#define HOTAS_TELEMETRY_LOAD_U32(p)  __atomic_load_n((const uint32_t*)(p), __ATOMIC_ACQUIRE)
+#define HOTAS_TELEMETRY_LOAD_U64(p)  __atomic_load_n((const uint64_t*)(p), __ATOMIC_ACQUIRE)
+#define HOTAS_TELEMETRY_ACQUIRE()    __atomic_thread_fence(__ATOMIC_ACQUIRE)
+#endif
+
+/* Copy one slot consistently. Returns 1 on success, 0 if the writer kept it busy. */
+static inline int hotas_telemetry_read_slot(const hotas_telemetry_slot* slot, hotas_telemetry_frame* out) {
+    for (int attempt = 0; attempt < 64; ++attempt) {
+        uint32_t s0 = HOTAS_TELEMETRY_LOAD_U32(&slot->seq);
+        if (s0 & 1u) continue; /* writer in progress */
+        memcpy(out, (const void*)&slot->frame, sizeof(*out));
+        HOTAS_TELEMETRY_ACQUIRE();
+        uint32_t s1 = HOTAS_TELEMETRY_LOAD_U32(&slot->seq);
+        if (s0 == s1) return 1;
+    }
+    return 0;
+}
+
+/* Latest frame (zero-copy attach, copy-out read). */
+static inline int hotas_telemetry_read_latest(const hotas_telemetry_region* r, hotas_telemetry_frame* out) {
+    if (!r || r->magic != HOTAS_TELEMETRY_MAGIC) return 0;
+    return hotas_telemetry_read_slot(&r->latest, out);
+}
+
+/* History entry by absolute frame number (1-based). Fails if already overwritten. */
+static inline int hotas_telemetry_read_history(const hotas_telemetry_region* r, uint64_t frame_seq, hotas_telemetry_frame* out) {
+    if (!r || r->magic != HOTAS_TELEMETRY_MAGIC || frame_seq == 0) return 0;
+    uint64_t head = HOTAS_TELEMETRY_LOAD_U64(&r->head);
+    if (frame_seq > head || head - frame_seq >= HOTAS_TELEMETRY_HISTORY) return 0;
+    const hotas_telemetry_slot* slot = &r->history[(frame_seq - 1) & (HOTAS_TELEMETRY_HISTORY - 1)];
+    if (!hotas_telemetry_read_slot(slot, out)) return 0;
+    return out->frame_seq == frame_seq;
+}
+
+/* Index of a signal name in names[] (-1 if absent). Call again after names_seq changes. */
+static inline int hotas_telemetry_find_signal(const hotas_telemetry_region* r, const char* name) {
+    if (!r || !name) return -1;
+    uint32_t n = r->signal_count;
+    if (n > HOTAS_TELEMETRY_MAX_SIGNALS) n = HOTAS_TELEMETRY_MAX_SIGNALS;
+    for (uint32_t i = 0; i < n; ++i) {
+        if (strncmp(r->names[i], name, HOTAS_TELEMETRY_NAME_LEN) == 0) return (int)i;
+    }
+    return -1;
+}
+
+/*
+ * Optional attach helpers. Define HOTAS_TELEMETRY_ATTACH before including this
+ * header in exactly the consumer translation units that need them.
+ *
+ * attach maps the region read-write when allowed so it can bump `readers` (the
+ * writer then publishes every signal); otherwise it maps it read-only and the
+ * reader goes uncounted. Pass the handle it returned back to detach.
+ */
+#if defined(HOTAS_TELEMETRY_ATTACH)
+#if defined(_WIN32)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+static inline const hotas_telemetry_region* hotas_telemetry_attach(const char* name, void** handle_out) {
+    const char* n = name ? name : HOTAS_TELEMETRY_DEFAULT_NAME;
+    DWORD access = FILE_MAP_READ | FILE_MAP_WRITE;
+    HANDLE h = OpenFileMappingA(access, FALSE, n);
+    if (!h) { access = FILE_MAP_READ; h = OpenFileMappingA(access, FALSE, n); }
+    if (!h) return NULL;
+    void* p = MapViewOfFile(h, access, 0, 0, sizeof(hotas_telemetry_region));
+    if (!p) { CloseHandle(h); return NULL; }
+    hotas_telemetry_region* r = (hotas_telemetry_region*)p;
+    if (access & FILE_MAP_WRITE) InterlockedIncrement((volatile LONG*)&r->readers);
+    if (handle_out) *handle_out = h;
+    return r;
+}
+static inline void hotas_telemetry_detach(const hotas_telemetry_region* r, void* handle) {
+    MEMORY_BASIC_INFORMATION mbi;
+    if (r && VirtualQuery((LPCVOID)r, &mbi, sizeof(mbi)) && mbi.Protect == PAGE_READWRITE) {
+        InterlockedDecrement((volatile LONG*)&((hotas_telemetry_region*)r)->readers);
+    }
+    if (r) UnmapViewOfFile((LPCVOID)r);
+    if (handle) CloseHandle((HANDLE)handle);
+}
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+/* The handle is non-null when this reader was counted */
+static inline const hotas_telemetry_region* hotas_telemetry_attach(const char* name, void** handle_out) {
+    const char* n = name ? name : HOTAS_TELEMETRY_DEFAULT_NAME;
+    int writable = 1;
+    int fd = shm_open(n, O_RDWR, 0);
+    if (fd < 0) { writable = 0; fd = shm_open(n, O_RDONLY, 0); }
+    if (fd < 0) return NULL;
+    void* p = mmap(NULL, sizeof(hotas_telemetry_region), writable ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (p == MAP_FAILED) return NULL;
+    hotas_telemetry_region* r = (hotas_telemetry_region*)p;
+    if (writable) __atomic_fetch_add(&r->readers, 1u, __ATOMIC_RELEASE);
+    if (handle_out) *handle_out = writable ? (void*)r : NULL;
+    return r;
+}
+static inline void hotas_telemetry_detach(const hotas_telemetry_region* r, void* handle) {
+    if (r && handle) __atomic_fetch_sub(&((hotas_telemetry_region*)r)->readers, 1u, __ATOMIC_RELEASE);
+    if (r) munmap((void*)r, sizeof(hotas_telemetry_region));
+}
+#endif
+#endif /* HOTAS_TELEMETRY_ATTACH */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HOTAS_TELEMETRY_H */
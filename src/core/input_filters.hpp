@@ -0,0 +1,88 @@
+#pragma once
+#include <cstdint>
+
+// Per-sample input filters used by the HOTAS pipeline (Filter column in the UI).
+// Each call consumes one new raw value and returns the filtered value; the state
+// remembers the previous filtered value (analog) and previous raw value (digital).
+
+struct InputFilterState {
+    double prev_filtered = 0.0;
+    double prev_raw = 0.0;
+    double rise = 0.0;        // start of the current hold (-1 = none)
+    double pending = 0.0;     // multi-bit digital: value waiting to be promoted
+    bool has_prev = false;
+    bool active = false;      // binary digital: debounced state
+};
+
+inline double filter_store(InputFilterState& st, double raw, double out_v) {
+    // Store previous values: filtered for analog spikes, RAW for digital gating
+    st.prev_filtered = out_v;
+    st.prev_raw = raw;
+    st.has_prev = true;
+    return out_v;
+}
+
+// Pass-through (keeps the state current so switching modes does not jump).
+inline double filter_none(InputFilterState& st, double v) {
+    return filter_store(st, v, v);
+}
+
+// Analog rate limiter: cap per-sample change to delta_percent of full_range.
+inline double filter_analog(InputFilterState& st, double v, double full_range, double delta_percent) {
+    const double prev_filtered = st.has_prev ? st.prev_filtered : v;
+    const double dv = v - prev_filtered;
+    const double max_step = (delta_percent / 100.0) * full_range;
+    double out_v = v;
+    if (dv > max_step) out_v = prev_filtered + max_step;
+    else if (dv < -max_step) out_v = prev_filtered - max_step;
+    return filter_store(st, v, out_v);
+}
+
+// Digital debounce/gating: a new value must hold for hold_s before it is passed on.
+// multi_bit: discrete values (hats) are gated as a whole; otherwise the signal is a
+// button (analog sources count as pressed at >= 0.5, digital at > 0).
+inline double filter_digital(InputFilterState& st, double v, double now, double hold_s, bool analog, bool multi_bit) {
+    double out_v = v;
+    double &rise = st.rise;
+    if (multi_bit) {
+        // Multi-bit digital (e.g., hats): gate discrete value changes
+        double prev_filtered = st.has_prev ? st.prev_filtered : v;
+        double prev_raw = st.has_prev ? st.prev_raw : v;
+        double &pend = st.pending;
+        if (!st.has_prev) {
+            rise = -1.0; pend = v; out_v = v;
+        } else {
+            if (v != prev_raw) {
+                // Value changed; start/refresh hold timer and keep previous filtered value
+                rise = now; pend = v; out_v = prev_filtered;
+            } else {
+                // Stable; promote after threshold when pending matches and differs from filtered
+                if (rise >= 0.0 && (now - rise) >= hold_s && pend == v && v != prev_filtered) {
+                    out_v = v; rise = -1.0;
+                } else {
+                    out_v = prev_filtered;
+                }
+            }
+        }
+    } else {
+        // Binary digital: interpret non-analog values >0 as active
+        bool now_hi = analog ? (v >= 0.5) : (v > 0.0);
+        double prev_raw = st.has_prev ? st.prev_raw : v;
+        bool prev_hi = analog ? (prev_raw >= 0.5) : (prev_raw > 0.0);
+        if (!st.has_prev) rise = -1.0;
+        if (now_hi && !prev_hi) {
+            rise = now; st.active = false;
+        } else if (now_hi && prev_hi) {
+            if (!st.active && rise >= 0.0) {
+                double dur = now - rise;
+                if (dur >= hold_s) st.active = true;
+            }
+        } else if (!now_hi && prev_hi) {
+            st.active = false; rise = -1.0;
+        } else {
+            rise = -1.0; st.active = false;
+        }
+        out_v = st.active ? 1.0 : 0.0;
+    }
+    return filter_store(st, v, out_v);
+}
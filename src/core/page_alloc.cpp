@@ -0,0 +1,404 @@
+#include "page_alloc.hpp"
+#include "thread_roles.hpp"
+#include "trace.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <new>
+#include <thread>
+#if defined(_WIN32)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#pragma comment(lib, "advapi32.lib")
+#elif defined(__linux__)
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace hotas_mem {
+
+namespace {
+
+constexpr size_t kHugePage = size_t(2) << 20;  // x86-64 PMD page; also the prefault chunk
+constexpr size_t kSmallPage = 4096;
+
+#if defined(__linux__) && !defined(MADV_POPULATE_WRITE)
+#define MADV_POPULATE_WRITE 23  // Linux 5.14
+#endif
+
+size_t round_up(size_t n, size_t to) { return (n + to - 1) / to * to; }
+
+struct Registry {
+    std::mutex mtx;
+    PageConfig cfg;
+    std::string fallback;  // why the last huge page request got less, for status()
+};
+
+Registry& registry() {
+    static Registry r;
+    return r;
+}
+
+// Plain atomics: buffers in static objects may be released after registry() is gone
+std::atomic<uint64_t> g_buffers{0};
+std::atomic<uint64_t> g_bytes[3];
+std::atomic<uint64_t> g_pending{0};
+std::atomic<uint64_t> g_prefaulted{0};
+
+void note_fallback(const std::string& why) {
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lk(reg.mtx);
+    reg.fallback = why;
+}
+
+#if defined(__linux__)
+std::string errno_text(int err) {
+    switch (err) {
+        case EPERM: return "EPERM";
+        case EINVAL: return "EINVAL";
+        case ENOMEM: return "ENOMEM";
+        default: return "errno " + std::to_string(err);
+    }
+}
+
+// THP set to "never" accepts MADV_HUGEPAGE but never backs it
+bool thp_enabled() {
+    static const bool enabled = [] {
+        FILE* f = std::fopen("/sys/kernel/mm/transparent_hugepage/enabled", "r");
+        if (!f) return false;
+        char buf[128] = {};
+        const size_t n = std::fread(buf, 1, sizeof(buf) - 1, f);
+        std::fclose(f);
+        buf[n] = '\0';
+        return std::strstr(buf, "[never]") == nullptr;
+    }();
+    return enabled;
+}
+#elif defined(_WIN32)
+bool enable_lock_memory_privilege() {
+    static const bool enabled = [] {
+        HANDLE token = nullptr;
+        if (!OpenProcessToken(GetCurrentProcess(), TOKEN_ADJUST_PRIVILEGES | TOKEN_QUERY, &token)) return false;
+        TOKEN_PRIVILEGES tp{};
+        tp.PrivilegeCount = 1;
+        tp.Privileges[0].Attributes = SE_PRIVILEGE_ENABLED;
+        bool ok = LookupPrivilegeValueA(nullptr, "SeLockMemoryPrivilege", &tp.Privileges[0].Luid) &&
+                  AdjustTokenPrivileges(token, FALSE, &tp, 0, nullptr, nullptr) && GetLastError() == ERROR_SUCCESS;
+        CloseHandle(token);
+        return ok;
+    }();
+    return enabled;
+}
+#endif
+
+// Populate [p, p + n) without changing it: the owner may already be writing
+void touch_pages(unsigned char* p, size_t n) {
+#if defined(__linux__)
+    if (madvise(p, n, MADV_POPULATE_WRITE) == 0) return;
+#endif
+    for (size_t off = 0; off < n; off += kSmallPage) {
+        std::atomic_ref<unsigned char>(p[off]).fetch_add(0, std::memory_order_relaxed);
+    }
+}
+
+} // namespace
+
+struct PageBuffer::PrefaultJob {
+    unsigned char* data = nullptr;
+    size_t size = 0;
+    std::mutex mtx;  // held for each chunk; the owner takes it to cancel before unmapping
+    std::condition_variable cv;
+    bool cancelled = false;
+    bool finished = false;
+};
+
+namespace {
+
+class PrefaultWorker {
+public:
+    static PrefaultWorker& instance() {
+        static PrefaultWorker w;
+        return w;
+    }
+
+    void enqueue(std::shared_ptr<PageBuffer::PrefaultJob> job) {
+        g_pending.fetch_add(job->size, std::memory_order_relaxed);
+        {
+            std::lock_guard<std::mutex> lk(_mtx);
+            _queue.push_back(std::move(job));
+            if (!_thread.joinable()) _thread = std::thread([this] { run(); });
+        }
+        _cv.notify_one();
+    }
+
+    ~PrefaultWorker() {
+        {
+            std::lock_guard<std::mutex> lk(_mtx);
+            _stop.store(true);
+        }
+        _cv.notify_one();
+        if (_thread.joinable()) _thread.join();
+        // Nobody waits for pages past exit, but wait_prefaulted() must not hang
+        for (auto& job : _queue) {
+            std::lock_guard<std::mutex> lk(job->mtx);
+            job->finished = true;
+            job->cv.notify_all();
+        }
+    }
+
+private:
+    void run() {
+        HOTAS_TRACE_THREAD_NAME("prefault");
+        hotas_rt::ScopedThreadRole role(hotas_rt::ThreadRole::Background, "prefault");
+        for (;;) {
+            std::shared_ptr<PageBuffer::PrefaultJob> job;
+            {
+                std::unique_lock<std::mutex> lk(_mtx);
+                _cv.wait(lk, [&] { return _stop || !_queue.empty(); });
+                if (_stop) return;
+                job = std::move(_queue.front());
+                _queue.pop_front();
+            }
+            size_t off = 0;
+            while (off < job->size && !_stop.load(std::memory_order_relaxed)) {
+                const size_t n = std::min(kHugePage, job->size - off);
+                std::lock_guard<std::mutex> lk(job->mtx);
+                if (job->cancelled) break;
+                touch_pages(job->data + off, n);
+                g_prefaulted.fetch_add(n, std::memory_order_relaxed);
+                off += n;
+            }
+            g_pending.fetch_sub(job->size, std::memory_order_relaxed);
+            {
+                std::lock_guard<std::mutex> lk(job->mtx);
+                job->finished = true;
+            }
+            job->cv.notify_all();
+        }
+    }
+
+    std::mutex _mtx;
+    std::condition_variable _cv;
+    std::deque<std::shared_ptr<PageBuffer::PrefaultJob>> _queue;
+    std::thread _thread;
+    std::atomic<bool> _stop{false};  // exit: finish the current chunk only
+};
+
+} // namespace
+
+void configure(const PageConfig& cfg) {
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lk(reg.mtx);
+    reg.cfg = cfg;
+}
+
+PageConfig config() {
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lk(reg.mtx);
+    return reg.cfg;
+}
+
+const char* huge_pages_name(HugePages h) {
+    switch (h) {
+        case HugePages::Off: return "off";
+        case HugePages::Transparent: return "transparent";
+        case HugePages::Explicit: return "explicit";
+    }
+    return "off";
+}
+
+bool parse_huge_pages(const std::string& s, HugePages& out) {
+    for (HugePages h : { HugePages::Off, HugePages::Transparent, HugePages::Explicit }) {
+        if (s == huge_pages_name(h)) { out = h; return true; }
+    }
+    return false;
+}
+
+const char* page_kind_name(PageKind k) {
+    switch (k) {
+        case PageKind::Regular: return "regular";
+        case PageKind::Transparent: return "transparent";
+        case PageKind::Explicit: return "explicit";
+    }
+    return "regular";
+}
+
+PageStats stats() {
+    PageStats s;
+    s.buffers = g_buffers.load(std::memory_order_relaxed);
+    for (int k = 0; k < 3; ++k) s.bytes[k] = g_bytes[k].load(std::memory_order_relaxed);
+    s.prefault_pending = g_pending.load(std::memory_order_relaxed);
+    s.prefaulted = g_prefaulted.load(std::memory_order_relaxed);
+    return s;
+}
+
+std::string status() {
+    const PageStats s = stats();
+    std::string out;
+    for (int k = 2; k >= 0; --k) {
+        if (!s.bytes[k]) continue;
+        if (!out.empty()) out += ", ";
+        out += std::to_string((unsigned long long)(s.bytes[k] >> 20)) + " MB " + page_kind_name((PageKind)k);
+    }
+    if (out.empty()) out = "none";
+    if (s.prefault_pending) out += ", prefault " + std::to_string((unsigned long long)(s.prefault_pending >> 20)) + " MB pending";
+    else if (s.prefaulted) out += ", prefault done";
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lk(reg.mtx);
+    if (!reg.fallback.empty()) out += " (" + reg.fallback + ")";
+    return out;
+}
+
+PageBuffer::PageBuffer(size_t bytes, const PageConfig& cfg) {
+    if (bytes == 0) return;
+    HugePages want = bytes >= cfg.min_huge_bytes ? cfg.huge_pages : HugePages::Off;
+    bool resident = false;
+#if defined(__linux__)
+    if (want == HugePages::Explicit) {
+        const size_t len = round_up(bytes, kHugePage);
+        void* p = mmap(nullptr, len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (p != MAP_FAILED) {
+            _base = _data = p;
+            _mapped = len;
+            _kind = PageKind::Explicit;
+        } else {
+            note_fallback("explicit pages unavailable: " + errno_text(errno));
+            want = HugePages::Transparent;
+        }
+    }
+    if (!_data && want == HugePages::Transparent && thp_enabled()) {
+        // Over-map so a 2 MB-aligned range fits, then trim both ends
+        const size_t len = round_up(bytes, kHugePage);
+        void* p = mmap(nullptr, len + kHugePage, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (p != MAP_FAILED) {
+            const uintptr_t raw = reinterpret_cast<uintptr_t>(p);
+            const uintptr_t aligned = (raw + kHugePage - 1) & ~(uintptr_t)(kHugePage - 1);
+            if (aligned > raw) munmap(p, aligned - raw);
+            const size_t tail = raw + len + kHugePage - (aligned + len);
+            if (tail) munmap(reinterpret_cast<void*>(aligned + len), tail);
+            _base = _data = reinterpret_cast<void*>(aligned);
+            _mapped = len;
+            if (madvise(_data, len, MADV_HUGEPAGE) == 0) _kind = PageKind::Transparent;
+            else note_fallback("MADV_HUGEPAGE: " + errno_text(errno));
+        }
+    } else if (!_data && want == HugePages::Transparent) {
+        note_fallback("transparent huge pages disabled");
+    }
+    if (!_data) {
+        const size_t len = round_up(bytes, kSmallPage);
+        void* p = mmap(nullptr, len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (p == MAP_FAILED) throw std::bad_alloc();
+        _base = _data = p;
+        _mapped = len;
+    }
+#elif defined(_WIN32)
+    if (want == HugePages::Explicit) {
+        const SIZE_T large = GetLargePageMinimum();
+        if (large && enable_lock_memory_privilege()) {
+            const size_t len = round_up(bytes, large);
+            void* p = VirtualAlloc(nullptr, len, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE);
+            if (p) {
+                _base = _data = p;
+                _mapped = len;
+                _kind = PageKind::Explicit;
+                resident = true;  // large pages are locked in when allocated
+            } else {
+                note_fallback("large pages unavailable: error " + std::to_string((unsigned long)GetLastError()));
+            }
+        } else {
+            note_fallback("large pages need SeLockMemoryPrivilege");
+        }
+    }
+    if (!_data) {
+        void* p = VirtualAlloc(nullptr, bytes, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+        if (!p) throw std::bad_alloc();
+        _base = _data = p;
+        _mapped = bytes;
+    }
+#else
+    (void)want;
+    _mapped = round_up(bytes, kSmallPage);
+    _base = _data = ::operator new(_mapped, std::align_val_t(kSmallPage));
+    std::memset(_data, 0, _mapped);
+    resident = true;
+#endif
+    _size = bytes;
+    g_buffers.fetch_add(1, std::memory_order_relaxed);
+    g_bytes[(int)_kind].fetch_add(_mapped, std::memory_order_relaxed);
+
+    if (cfg.prefault && !resident) {
+        _job = std::make_shared<PrefaultJob>();
+        _job->data = static_cast<unsigned char*>(_data);
+        _job->size = _mapped;
+        PrefaultWorker::instance().enqueue(_job);
+    }
+}
+
+PageBuffer::~PageBuffer() { release(); }
+
+PageBuffer::PageBuffer(PageBuffer&& other) noexcept
+    : _data(other._data), _base(other._base), _size(other._size), _mapped(other._mapped), _kind(other._kind),
+      _job(std::move(other._job)) {
+    other._data = other._base = nullptr;
+    other._size = other._mapped = 0;
+}
+
+PageBuffer& PageBuffer::operator=(PageBuffer&& other) noexcept {
+    if (this != &other) {
+        release();
+        _data = other._data;
+        _base = other._base;
+        _size = other._size;
+        _mapped = other._mapped;
+        _kind = other._kind;
+        _job = std::move(other._job);
+        other._data = other._base = nullptr;
+        other._size = other._mapped = 0;
+    }
+    return *this;
+}
+
+bool PageBuffer::prefaulted() const {
+    if (!_job) return true;
+    std::lock_guard<std::mutex> lk(_job->mtx);
+    return _job->finished;
+}
+
+void PageBuffer::wait_prefaulted() const {
+    if (!_job) return;
+    std::unique_lock<std::mutex> lk(_job->mtx);
+    _job->cv.wait(lk, [&] { return _job->finished; });
+}
+
+void PageBuffer::release() {
+    if (_job) {
+        // After this the worker touches no further chunk of the mapping
+        std::lock_guard<std::mutex> lk(_job->mtx);
+        _job->cancelled = true;
+    }
+    _job.reset();
+    if (!_base) return;
+#if defined(__linux__)
+    munmap(_base, _mapped);
+#elif defined(_WIN32)
+    VirtualFree(_base, 0, MEM_RELEASE);
+#else
+    ::operator delete(_base, std::align_val_t(kSmallPage));
+#endif
+    g_buffers.fetch_sub(1, std::memory_order_relaxed);
+    g_bytes[(int)_kind].fetch_sub(_mapped, std::memory_order_relaxed);
+    _data = _base = nullptr;
+    _size = _mapped = 0;
+}
+
+} // namespace hotas_mem
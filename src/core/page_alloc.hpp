@@ -0,0 +1,87 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+// Page-backed storage for the large sample histories (SampleRing arrays).
+//
+// A 2^19-sample ring is 8 MB written sequentially by its producer and read at random by
+// snapshots; with 4 KB pages that is 2048 TLB entries per ring, and every page faults
+// the first time the producer reaches it. PageBuffer maps such buffers with huge pages
+// where the OS offers them and faults the pages in ahead of the producer:
+//
+//   Explicit     Linux MAP_HUGETLB (needs a hugetlbfs pool, vm.nr_hugepages), Windows
+//                MEM_LARGE_PAGES (needs SeLockMemoryPrivilege; always resident)
+//   Transparent  Linux: 2 MB-aligned mapping advised MADV_HUGEPAGE (THP "madvise" or
+//                "always"); Windows has no equivalent and uses regular pages
+//   Regular      anonymous mapping of ordinary pages
+//
+// A request falls back down this list when the OS refuses; buffers smaller than
+// min_huge_bytes always use regular pages. With prefault on, each new buffer is queued
+// to a background thread that populates its pages (MADV_POPULATE_WRITE, or an atomic
+// no-op write per page), so the producer's first lap finds them mapped. Prefaulting
+// never changes the contents: the buffer can be written while it runs.
+//
+// Memory is zero-filled. Configure before the rings are created; buffers keep what
+// they got.
+namespace hotas_mem {
+
+enum class HugePages : uint8_t { Off = 0, Transparent, Explicit };     // requested
+enum class PageKind : uint8_t { Regular = 0, Transparent, Explicit };  // obtained
+
+struct PageConfig {
+    HugePages huge_pages = HugePages::Transparent;
+    bool prefault = true;
+    size_t min_huge_bytes = size_t(2) << 20;
+};
+
+void configure(const PageConfig& cfg);
+PageConfig config();
+
+const char* huge_pages_name(HugePages h);   // "off", "transparent", "explicit"
+bool parse_huge_pages(const std::string& s, HugePages& out);
+const char* page_kind_name(PageKind k);
+
+// Live buffers by the page kind they got, and the prefault backlog.
+struct PageStats {
+    uint64_t buffers = 0;
+    uint64_t bytes[3] = {};        // by PageKind
+    uint64_t prefault_pending = 0; // bytes queued or being populated
+    uint64_t prefaulted = 0;       // bytes populated since startup
+};
+PageStats stats();
+// One line for the stats view, e.g. "320 MB transparent, 12 MB regular, prefault done"
+std::string status();
+
+class PageBuffer {
+public:
+    PageBuffer() = default;
+    explicit PageBuffer(size_t bytes, const PageConfig& cfg = config());
+    ~PageBuffer();
+    PageBuffer(PageBuffer&& other) noexcept;
+    PageBuffer& operator=(PageBuffer&& other) noexcept;
+    PageBuffer(const PageBuffer&) = delete;
+    PageBuffer& operator=(const PageBuffer&) = delete;
+
+    void* data() const { return _data; }
+    size_t size() const { return _size; }
+    PageKind kind() const { return _kind; }
+
+    // True once the background prefault finished (or when there is none)
+    bool prefaulted() const;
+    void wait_prefaulted() const;
+
+    struct PrefaultJob; // shared with the prefault thread
+private:
+    void release();
+
+    void* _data = nullptr;
+    void* _base = nullptr;  // mapping start (may precede _data for alignment)
+    size_t _size = 0;
+    size_t _mapped = 0;
+    PageKind _kind = PageKind::Regular;
+    std::shared_ptr<PrefaultJob> _job;
+};
+
+} // namespace hotas_mem
@@ -0,0 +1,40 @@
+#include "report_recording.hpp"
+#include "hid_decode.hpp"
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+bool load_report_recording(const std::string& path, std::vector<RecordedReport>& out, std::string* error) {
+    std::ifstream in(path);
+    if (!in) { if (error) *error = "cannot open " + path; return false; }
+    out.clear();
+    std::string line;
+    size_t line_no = 0;
+    while (std::getline(in, line)) {
+        ++line_no;
+        if (line.empty() || line[0] == '#') continue;
+        std::istringstream ls(line);
+        RecordedReport r;
+        std::string hex;
+        if (!(ls >> r.device >> r.t >> hex)) {
+            if (error) *error = path + ":" + std::to_string(line_no) + ": expected '<device> <t> <hex>'";
+            return false;
+        }
+        hex_to_bytes(hex, r.bytes);
+        out.push_back(std::move(r));
+    }
+    return true;
+}
+
+bool save_report_recording(const std::string& path, const std::vector<RecordedReport>& reports, std::string* error) {
+    std::ofstream out(path, std::ios::out | std::ios::trunc);
+    if (!out) { if (error) *error = "cannot open " + path; return false; }
+    out << "# device t_seconds hex\n";
+    char tbuf[32];
+    for (const auto& r : reports) {
+        std::snprintf(tbuf, sizeof(tbuf), "%.6f", r.t);
+        out << r.device << ' ' << tbuf << ' ' << bytes_to_hex(r.bytes.data(), r.bytes.size()) << '\n';
+    }
+    if (!out) { if (error) *error = "write failed for " + path; return false; }
+    return true;
+}
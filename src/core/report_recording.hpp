@@ -0,0 +1,17 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Recorded raw HID traffic for offline replay (benchmarks, filter tuning).
+// Text format, one report per line:
+//     <device> <t_seconds> <hex bytes>
+// e.g. "stick 12.004512 0100ff7f..."; lines starting with '#' are comments.
+struct RecordedReport {
+    std::string device;          // device prefix, e.g. "stick" / "throttle"
+    double t = 0.0;              // arrival time (seconds, any epoch; replay uses deltas)
+    std::vector<uint8_t> bytes;
+};
+
+bool load_report_recording(const std::string& path, std::vector<RecordedReport>& out, std::string* error = nullptr);
+bool save_report_recording(const std::string& path, const std::vector<RecordedReport>& reports, std::string* error = nullptr);
@@ -0,0 +1,96 @@
+#include "report_stats.hpp"
+#include <cmath>
+
+namespace {
+
+// USB full-speed interrupt intervals an HID device may be polled at
+constexpr double kUsbIntervalsMs[] = { 1, 2, 4, 8, 10, 16, 32 };
+
+} // namespace
+
+size_t ReportIntervalStats::bucket_of(double interval_us) {
+    if (!(interval_us >= kFirstBucketUs)) return 0;
+    int e = 0;
+    const double m = std::frexp(interval_us / kFirstBucketUs, &e); // [0.5, 1) * 2^e
+    const size_t octave = (size_t)(e - 1);
+    if (octave >= kOctaves) return kBuckets - 1;
+    size_t sub = (size_t)((m * 2.0 - 1.0) * kSubBuckets);
+    if (sub >= kSubBuckets) sub = kSubBuckets - 1;
+    return 1 + octave * kSubBuckets + sub;
+}
+
+double ReportIntervalStats::bucket_lower_us(size_t bucket) {
+    if (bucket == 0) return 0.0;
+    if (bucket >= kBuckets - 1) return std::ldexp(kFirstBucketUs, (int)kOctaves);
+    const size_t octave = (bucket - 1) / kSubBuckets, sub = (bucket - 1) % kSubBuckets;
+    return std::ldexp(kFirstBucketUs, (int)octave) * (1.0 + (double)sub / kSubBuckets);
+}
+
+double ReportIntervalStats::bucket_upper_us(size_t bucket) {
+    if (bucket == 0) return kFirstBucketUs;
+    if (bucket >= kBuckets - 1) return INFINITY;
+    return bucket_lower_us(bucket + 1);
+}
+
+void ReportIntervalStats::apply_reset() {
+    _reports.store(0, std::memory_order_relaxed);
+    _duplicates.store(0, std::memory_order_relaxed);
+    _sum_us.store(0, std::memory_order_relaxed);
+    _max_us.store(0.0, std::memory_order_relaxed);
+    _span_s.store(0.0, std::memory_order_relaxed);
+    for (auto& h : _histogram) h.store(0, std::memory_order_relaxed);
+    _have_last = false;
+    _reset_requested.store(false, std::memory_order_relaxed);
+}
+
+ReportIntervalStats::Snapshot ReportIntervalStats::snapshot() const {
+    Snapshot s;
+    if (_reset_requested.load(std::memory_order_relaxed)) return s;
+    s.reports = _reports.load(std::memory_order_relaxed);
+    s.duplicates = _duplicates.load(std::memory_order_relaxed);
+    s.max_gap_ms = _max_us.load(std::memory_order_relaxed) / 1000.0;
+    uint64_t total = 0;
+    for (size_t b = 0; b < kBuckets; ++b) total += (s.histogram[b] = _histogram[b].load(std::memory_order_relaxed));
+    s.intervals = total;
+    if (total == 0) return s;
+    s.mean_ms = (double)_sum_us.load(std::memory_order_relaxed) / (double)total / 1000.0;
+
+    // Percentiles as bucket upper bounds (the overflow bucket reports the max gap)
+    auto percentile_ms = [&](double q) {
+        const uint64_t want = (uint64_t)std::ceil(q * (double)total);
+        uint64_t acc = 0;
+        for (size_t b = 0; b < kBuckets; ++b) {
+            acc += s.histogram[b];
+            if (acc >= want) return b == kBuckets - 1 ? s.max_gap_ms : bucket_upper_us(b) / 1000.0;
+        }
+        return s.max_gap_ms;
+    };
+    s.p50_ms = percentile_ms(0.50);
+    s.p99_ms = percentile_ms(0.99);
+
+    // Rate class: a fixed-rate stream keeps most intervals in the modal bucket and its
+    // neighbours (jitter straddles bucket edges); its centre snaps to a USB interval.
+    if (total < kMinIntervals) return s;
+    size_t mode = 1;
+    for (size_t b = 1; b + 1 < kBuckets; ++b) if (s.histogram[b] > s.histogram[mode]) mode = b;
+    const uint64_t near = s.histogram[mode - 1] + s.histogram[mode] + s.histogram[mode + 1];
+    if ((double)near < 0.6 * (double)total) return s;
+    const double centre_ms = std::sqrt(bucket_lower_us(mode) * bucket_upper_us(mode)) / 1000.0;
+    double best = 0.0, best_err = 1e9;
+    for (double iv : kUsbIntervalsMs) {
+        const double err = std::fabs(std::log(centre_ms / iv));
+        if (err < best_err) { best_err = err; best = iv; }
+    }
+    if (best_err > std::log(1.2)) return s;
+    s.nominal_ms = best;
+    s.nominal_hz = 1000.0 / best;
+
+    for (size_t b = 0; b < kBuckets; ++b) {
+        if (bucket_lower_us(b) >= 1.5 * best * 1000.0) s.late += s.histogram[b];
+    }
+    // A late report followed by a quick one is jitter, not loss: count the reports the
+    // elapsed time should have held at the nominal rate against those that arrived
+    const double expected = std::round(_span_s.load(std::memory_order_relaxed) * 1000.0 / best) + 1.0;
+    if (expected > (double)(total + 1)) s.missed_estimate = (uint64_t)expected - (total + 1);
+    return s;
+}
@@ -0,0 +1,92 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+// Streaming statistics of a device's report arrivals.
+//
+// on_report() runs on the device's reader thread for every report and is O(1):
+// one interval goes into a log-spaced histogram (4 buckets per octave, 64 us .. ~1 s),
+// plus a running sum, the largest gap and a byte compare against the previous report
+// for the duplicate count. Everything is a single-writer relaxed atomic, so snapshot()
+// may run on any thread; percentiles, the mean and the report-rate class are derived
+// from the histogram there, not on the reader thread.
+//
+// The rate class is the USB polling interval the stream settles on (1, 2, 4, 8, 10,
+// 16 or 32 ms). A device that only reports on change has no dominant interval and is
+// classed as irregular.
+class ReportIntervalStats {
+public:
+    static constexpr size_t kSubBuckets = 4;          // per octave
+    static constexpr size_t kOctaves = 14;            // 64 us << 14 = ~1 s
+    static constexpr size_t kBuckets = 1 + kOctaves * kSubBuckets + 1; // underflow, log buckets, overflow
+    static constexpr double kFirstBucketUs = 64.0;
+    static constexpr uint64_t kMinIntervals = 64;     // before a rate class is reported
+    static constexpr size_t kMaxReportBytes = 64;
+
+    struct Snapshot {
+        uint64_t reports = 0;
+        uint64_t intervals = 0;
+        uint64_t duplicates = 0;      // byte-identical to the previous report
+        double mean_ms = 0.0;
+        double p50_ms = 0.0;          // bucket upper bounds (25% resolution)
+        double p99_ms = 0.0;
+        double max_gap_ms = 0.0;
+        double nominal_hz = 0.0;      // detected USB rate; 0 while measuring or irregular
+        double nominal_ms = 0.0;
+        uint64_t late = 0;            // intervals over 1.5x the nominal one
+        uint64_t missed_estimate = 0; // reports a fixed-rate stream should have delivered but did not
+        uint64_t histogram[kBuckets] = {};
+        bool measuring() const { return intervals < kMinIntervals; }
+    };
+
+    // Reader thread only.
+    void on_report(double t, const uint8_t* data, size_t len) {
+        if (_reset_requested.load(std::memory_order_relaxed)) apply_reset();
+        if (len > kMaxReportBytes) len = kMaxReportBytes;
+        if (_have_last) {
+            const double dt_us = (t - _last_t) * 1e6;
+            bump(_histogram[bucket_of(dt_us)]);
+            _sum_us.store(_sum_us.load(std::memory_order_relaxed) + (dt_us > 0.0 ? (uint64_t)dt_us : 0), std::memory_order_relaxed);
+            if (dt_us > _max_us.load(std::memory_order_relaxed)) _max_us.store(dt_us, std::memory_order_relaxed);
+            _span_s.store(t - _first_t, std::memory_order_relaxed);
+            if (len == _last_len && std::memcmp(data, _last, len) == 0) bump(_duplicates);
+        }
+        std::memcpy(_last, data, len);
+        _last_len = len;
+        _last_t = t;
+        if (!_have_last) _first_t = t;
+        _have_last = true;
+        bump(_reports);
+    }
+
+    // Any thread; applied by the reader thread on its next report.
+    void request_reset() { _reset_requested.store(true, std::memory_order_relaxed); }
+
+    // Any thread (not the hot path).
+    Snapshot snapshot() const;
+
+    // Histogram bucket for an interval, and the interval range a bucket covers.
+    static size_t bucket_of(double interval_us);
+    static double bucket_lower_us(size_t bucket);
+    static double bucket_upper_us(size_t bucket);
+
+private:
+    static void bump(std::atomic<uint64_t>& c) { c.store(c.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed); }
+    void apply_reset();
+
+    std::atomic<uint64_t> _reports{0};
+    std::atomic<uint64_t> _duplicates{0};
+    std::atomic<uint64_t> _sum_us{0};
+    std::atomic<double> _max_us{0.0};
+    std::atomic<double> _span_s{0.0};                 // first to latest report
+    std::atomic<uint64_t> _histogram[kBuckets] = {};
+    std::atomic<bool> _reset_requested{false};
+    // Reader-thread state
+    bool _have_last = false;
+    double _first_t = 0.0;
+    double _last_t = 0.0;
+    size_t _last_len = 0;
+    uint8_t _last[kMaxReportBytes] = {};
+};
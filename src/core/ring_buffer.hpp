@@ -1,26 +1,71 @@
 #pragma once
 #include <vector>
+#include <algorithm>
 #include <atomic>
+#include <cmath>
 #include <cstdint>
+#include <limits>
 #include <span>
 #include <mutex>
+#include "cache_line.hpp"
+#include "page_alloc.hpp"
 
 // Lock-light single-writer multi-reader ring buffer for samples (time,value)
-// Writer pushes sequential indices; readers snapshot head and copy out.
+// Writer pushes sequential indices; readers snapshot head and copy out. Only the writer
+// stores the indices: other threads empty the ring through request_clear().
+//
+// The writer also keeps sum, sum of squares, min and max per block of 64 samples and
+// per super block of 4096, so aggregate() over any time range answers from at most
+// ~250 partial samples and blocks plus one entry per 4096 samples (the whole of a
+// 2^19 ring: ~380 steps) instead of copying and scanning the window.
+//
+// The sample array is a hotas_mem::PageBuffer: huge pages where available and faulted
+// in by a background thread, so the first lap of the writer does not take a page fault
+// every 256 samples (see page_alloc.hpp).
 
 struct Sample {
     double t;   // seconds (wall or relative)
     float  v;   // value
 };
 
+// Aggregate over a time range of a SampleRing (count 0: no samples in range)
+struct SampleAggregate {
+    uint64_t count = 0;
+    float min = 0.0f;
+    float max = 0.0f;
+    double mean = 0.0;
+    double rms = 0.0;     // root mean square of the values
+    double stddev = 0.0;  // RMS around the mean: the noise of a held input
+    double peak() const { return std::max(std::fabs((double)min), std::fabs((double)max)); } // largest deflection from 0
+};
+
 class SampleRing {
 public:
-    explicit SampleRing(size_t capacity_pow2)
-        : _capacity(capacity_pow2), _mask(capacity_pow2 - 1), _data(capacity_pow2) {}
+    static constexpr size_t kBlock = 64;            // samples per block
+    static constexpr size_t kSuperBlock = 64 * kBlock;
+
+    explicit SampleRing(size_t capacity_pow2, const hotas_mem::PageConfig& pages = hotas_mem::config())
+        : _capacity(capacity_pow2), _mask(capacity_pow2 - 1), _storage(capacity_pow2 * sizeof(Sample), pages),
+          _data(static_cast<Sample*>(_storage.data())),
+          _blocks(std::max<size_t>(1, capacity_pow2 / kBlock)), _supers(std::max<size_t>(1, capacity_pow2 / kSuperBlock)),
+          _block_mask(_blocks.size() - 1), _super_mask(_supers.size() - 1) {}
 
+    // Single writer. The sample, _ref and the aggregates are written before the release
+    // store of the new head, so a reader that acquires the head sees all of them.
     void push(double t, float v) {
-        const uint64_t idx = _write_index.fetch_add(1, std::memory_order_relaxed);
+        const uint64_t idx = _write_index.load(std::memory_order_relaxed);
+        if (_clear_requested.load(std::memory_order_relaxed)) {
+            // Keep only samples from here on. Indices and _ref carry on, so no reader sees them move back
+            _begin.store(idx, std::memory_order_relaxed);
+            _clear_requested.store(false, std::memory_order_release);
+        }
         _data[idx & _mask] = Sample{t, v};
+        if (idx == 0) _ref = v;
+        // Sums are taken relative to the first value so sum of squares keeps its precision on raw-code axes
+        const double d = (double)v - _ref;
+        accumulate(_blocks[(idx / kBlock) & _block_mask], idx % kBlock == 0, d, v);
+        accumulate(_supers[(idx / kSuperBlock) & _super_mask], idx % kSuperBlock == 0, d, v);
+        _write_index.store(idx + 1, std::memory_order_release);
     }
 
     // Copy last up to max_seconds of data into out vector; assumes times are monotonic increasing.
@@ -29,7 +74,7 @@ public:
         out.clear();
         uint64_t end = _write_index.load(std::memory_order_acquire);
         if (end == 0) return;
-        const uint64_t start = (end > _capacity) ? end - _capacity : 0;
+        const uint64_t start = oldest(end);
         const double cutoff = latest_time - window_seconds;
         for (uint64_t i = start; i < end; ++i) {
             const Sample &s = _data[i & _mask];
@@ -44,7 +89,7 @@ public:
         out.clear();
         uint64_t end = _write_index.load(std::memory_order_acquire);
         if (end == 0) return;
-        const uint64_t start = (end > _capacity) ? end - _capacity : 0;
+        const uint64_t start = oldest(end);
         const double cutoff = latest_time - window_seconds;
         const Sample* baseline = nullptr;
         for (uint64_t i = start; i < end; ++i) {
@@ -65,12 +110,129 @@ public:
         }
     }
 
-    uint64_t size() const { return _write_index.load(std::memory_order_relaxed); }
+    // Copy the newest up to max_samples samples (oldest first)
+    void snapshot_latest(size_t max_samples, std::vector<Sample>& out) const {
+        out.clear();
+        const uint64_t end = _write_index.load(std::memory_order_acquire);
+        uint64_t start = oldest(end);
+        if (end - start > max_samples) start = end - max_samples;
+        for (uint64_t i = start; i < end; ++i) out.push_back(_data[i & _mask]);
+    }
+
+    // Samples with t0 <= t <= t1 still in the ring; times must be monotonic increasing.
+    // Like snapshot(), a range reaching back to the oldest samples can race the writer.
+    SampleAggregate aggregate(double t0, double t1) const {
+        const uint64_t end = _write_index.load(std::memory_order_acquire);
+        if (end == 0 || t1 < t0) return SampleAggregate{};
+        const uint64_t start = oldest(end);
+        return aggregate_range(first_at(start, end, t0, false), first_at(start, end, t1, true));
+    }
+    // The last `seconds` up to the newest sample
+    SampleAggregate aggregate_latest(double seconds) const {
+        const double t1 = latest_time();
+        return aggregate(t1 - seconds, t1);
+    }
+    double latest_time() const {
+        const uint64_t end = _write_index.load(std::memory_order_acquire);
+        return oldest(end) < end ? _data[(end - 1) & _mask].t : 0.0;
+    }
+
+    // Index access for readers walking several rings together (aligned_window()): read the
+    // head once, then samples oldest(end) .. end - 1 by absolute index
+    uint64_t head() const { return _write_index.load(std::memory_order_acquire); }
+    // Oldest index readable with head `end`: the capacity back, nothing from before a clear
+    uint64_t oldest(uint64_t end) const {
+        if (_clear_requested.load(std::memory_order_acquire)) return end;
+        const uint64_t lo = std::max<uint64_t>((end > _capacity) ? end - _capacity : 0, _begin.load(std::memory_order_relaxed));
+        return std::min(lo, end);
+    }
+    // First index whose time is >= t (after: > t), end if none
+    uint64_t lower_index(uint64_t end, double t, bool after) const { return first_at(oldest(end), end, t, after); }
+    const Sample& at(uint64_t index) const { return _data[index & _mask]; }
+
+    // Samples readers can see
+    uint64_t size() const { const uint64_t end = head(); return end - oldest(end); }
     size_t capacity() const { return _capacity; }
-    void clear() { _write_index.store(0, std::memory_order_relaxed); }
+    // Any thread: drop the samples pushed so far. Readers see the ring empty from now on;
+    // the writer applies it at its next push (it alone stores the indices and _ref).
+    void request_clear() { _clear_requested.store(true, std::memory_order_release); }
+    const hotas_mem::PageBuffer& storage() const { return _storage; }
 private:
+    struct Block {
+        double sum = 0.0;  // of v - _ref
+        double sq = 0.0;
+        float min = 0.0f;
+        float max = 0.0f;
+    };
+
+    static void accumulate(Block& b, bool first, double d, float v) {
+        if (first) { b = Block{ d, d * d, v, v }; return; }
+        b.sum += d;
+        b.sq += d * d;
+        b.min = std::min(b.min, v);
+        b.max = std::max(b.max, v);
+    }
+
+    // First index in [lo, hi) whose time is >= t (after: > t); hi if none
+    uint64_t first_at(uint64_t lo, uint64_t hi, double t, bool after) const {
+        while (lo < hi) {
+            const uint64_t mid = lo + (hi - lo) / 2;
+            const double tm = _data[mid & _mask].t;
+            if (after ? tm <= t : tm < t) lo = mid + 1;
+            else hi = mid;
+        }
+        return lo;
+    }
+
+    // [lo, hi): single samples up to a block boundary, blocks up to a super block boundary,
+    // super blocks, then blocks and samples again. Every whole block or super block in
+    // range is still in its slot: the one that replaces it would start at index >= end.
+    SampleAggregate aggregate_range(uint64_t lo, uint64_t hi) const {
+        SampleAggregate a;
+        if (lo >= hi) return a;
+        double sum = 0.0, sq = 0.0;
+        float mn = std::numeric_limits<float>::max(), mx = std::numeric_limits<float>::lowest();
+        auto take_sample = [&](uint64_t i) {
+            const float v = _data[i & _mask].v;
+            const double d = (double)v - _ref;
+            sum += d; sq += d * d;
+            mn = std::min(mn, v); mx = std::max(mx, v);
+        };
+        auto take_block = [&](const Block& b) {
+            sum += b.sum; sq += b.sq;
+            mn = std::min(mn, b.min); mx = std::max(mx, b.max);
+        };
+        uint64_t i = lo;
+        while (i < hi && i % kBlock != 0) take_sample(i++);
+        while (i + kBlock <= hi && i % kSuperBlock != 0) { take_block(_blocks[(i / kBlock) & _block_mask]); i += kBlock; }
+        while (i + kSuperBlock <= hi) { take_block(_supers[(i / kSuperBlock) & _super_mask]); i += kSuperBlock; }
+        while (i + kBlock <= hi) { take_block(_blocks[(i / kBlock) & _block_mask]); i += kBlock; }
+        while (i < hi) take_sample(i++);
+
+        const double n = (double)(hi - lo);
+        const double md = sum / n;
+        a.count = hi - lo;
+        a.min = mn;
+        a.max = mx;
+        a.mean = _ref + md;
+        a.rms = std::sqrt(std::max(0.0, sq / n + 2.0 * _ref * md + _ref * _ref));
+        a.stddev = std::sqrt(std::max(0.0, sq / n - md * md));
+        return a;
+    }
+
+    // Fixed after construction (and _ref after the first push): read by every reader
     size_t _capacity;
     size_t _mask;
-    std::vector<Sample> _data;
-    std::atomic<uint64_t> _write_index{0};
+    hotas_mem::PageBuffer _storage;
+    Sample* _data;               // _storage, zero-filled
+    std::vector<Block> _blocks;  // by (index / kBlock) mod count
+    std::vector<Block> _supers;  // by (index / kSuperBlock) mod count
+    size_t _block_mask;
+    size_t _super_mask;
+    double _ref = 0.0;           // first value pushed
+    // Written on every push: on its own line so readers' loads of the fields above
+    // do not miss each time the writer moves on (rings sit next to each other in arrays)
+    alignas(kCacheLineSize) std::atomic<uint64_t> _write_index{0};
+    std::atomic<uint64_t> _begin{0};            // first index after the last clear (writer)
+    std::atomic<bool> _clear_requested{false};  // set by request_clear(), reset by the writer
 };
@@ -0,0 +1,50 @@
+#include "signal_bus.hpp"
+
+SignalBus::ConsumerId SignalBus::add_consumer(std::string name) {
+    std::lock_guard<std::mutex> g(_mutex);
+    _names.push_back(std::move(name));
+    _interest.emplace_back(_refs.size());
+    return _names.size() - 1;
+}
+
+void SignalBus::set_interest(ConsumerId consumer, const SignalSet& interest) {
+    std::lock_guard<std::mutex> g(_mutex);
+    if (consumer >= _interest.size() || interest.size() != _refs.size()) return;
+    SignalSet& old = _interest[consumer];
+    if (old == interest) return;
+    bool changed = false;
+    for (size_t i = 0; i < _refs.size(); ++i) {
+        const bool was = old.test(i), now = interest.test(i);
+        if (was == now) continue;
+        if (now && _refs[i]++ == 0) { _union.set(i); changed = true; }
+        if (!now && --_refs[i] == 0) { _union.reset(i); changed = true; }
+    }
+    old.assign(interest);
+    if (changed) _generation.fetch_add(1, std::memory_order_release);
+}
+
+bool SignalBus::poll(uint64_t& seen, SignalSet& out) const {
+    if (_generation.load(std::memory_order_acquire) == seen) return false;
+    std::lock_guard<std::mutex> g(_mutex);
+    if (out.size() != _union.size()) return false;
+    out.assign(_union);
+    seen = _generation.load(std::memory_order_relaxed);
+    return true;
+}
+
+uint32_t SignalBus::references(size_t signal) const {
+    std::lock_guard<std::mutex> g(_mutex);
+    return signal < _refs.size() ? _refs[signal] : 0;
+}
+
+size_t SignalBus::union_count() const {
+    std::lock_guard<std::mutex> g(_mutex);
+    return _union.count();
+}
+
+std::vector<SignalBus::ConsumerInfo> SignalBus::consumers() const {
+    std::lock_guard<std::mutex> g(_mutex);
+    std::vector<ConsumerInfo> out;
+    for (size_t c = 0; c < _names.size(); ++c) out.push_back(ConsumerInfo{ _names[c], _interest[c].count() });
+    return out;
+}
@@ -0,0 +1,75 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Fixed-size bitset over descriptor indices.
+class SignalSet {
+public:
+    SignalSet() = default;
+    explicit SignalSet(size_t size, bool all = false) : _size(size), _words((size + 63) / 64, all ? ~0ULL : 0ULL) {
+        trim();
+    }
+
+    size_t size() const { return _size; }
+    bool test(size_t i) const { return i < _size && (_words[i / 64] >> (i % 64)) & 1; }
+    void set(size_t i) { if (i < _size) _words[i / 64] |= 1ULL << (i % 64); }
+    void reset(size_t i) { if (i < _size) _words[i / 64] &= ~(1ULL << (i % 64)); }
+    void clear() { std::fill(_words.begin(), _words.end(), 0ULL); }
+    size_t count() const {
+        size_t n = 0;
+        for (uint64_t w : _words) for (; w; w &= w - 1) ++n;
+        return n;
+    }
+    // Copy another set of the same size without reallocating
+    void assign(const SignalSet& o) { std::copy(o._words.begin(), o._words.end(), _words.begin()); }
+    bool operator==(const SignalSet& o) const { return _size == o._size && _words == o._words; }
+    bool operator!=(const SignalSet& o) const { return !(*this == o); }
+
+private:
+    void trim() { if (_size % 64 && !_words.empty()) _words.back() &= (1ULL << (_size % 64)) - 1; }
+
+    size_t _size = 0;
+    std::vector<uint64_t> _words;
+};
+
+// Which descriptors anyone consumes. Each consumer (mapping profile, visible plots,
+// telemetry export, recorder) registers once and replaces its interest set whenever it
+// changes; the bus keeps a reference count per descriptor and publishes the union.
+// The pipeline picks the union up with poll() and evaluates only those descriptors.
+//
+// Consumers may call from any thread. poll() takes the lock only when the union changed.
+class SignalBus {
+public:
+    using ConsumerId = size_t;
+
+    explicit SignalBus(size_t signal_count) : _union(signal_count), _refs(signal_count, 0) {}
+
+    size_t signal_count() const { return _refs.size(); }
+
+    // New consumer with an empty interest set
+    ConsumerId add_consumer(std::string name);
+    // Replace a consumer's interest (same size as the bus); empty = not interested
+    void set_interest(ConsumerId consumer, const SignalSet& interest);
+
+    // Copy the union into `out` (sized to the bus) if it changed since `seen`; updates `seen`.
+    bool poll(uint64_t& seen, SignalSet& out) const;
+
+    // UI: reference count of a descriptor, and per-consumer totals
+    uint32_t references(size_t signal) const;
+    size_t union_count() const;
+    struct ConsumerInfo { std::string name; size_t signals = 0; };
+    std::vector<ConsumerInfo> consumers() const;
+
+private:
+    mutable std::mutex _mutex;
+    std::vector<std::string> _names;
+    std::vector<SignalSet> _interest;       // by consumer
+    SignalSet _union;
+    std::vector<uint32_t> _refs;            // consumers interested in each descriptor
+    std::atomic<uint64_t> _generation{1};   // bumped when the union changes
+};
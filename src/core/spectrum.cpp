@@ -0,0 +1,197 @@
+#include "spectrum.hpp"
+#include "thread_roles.hpp"
+#include "trace.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+
+namespace {
+
+constexpr double kPi = 3.14159265358979323846;
+constexpr double kLowPassHz = 20.0; // suggested corner: well above hand movement, ~10 ms of group delay
+
+} // namespace
+
+void fft_inplace(std::complex<float>* data, size_t n) {
+    for (size_t i = 1, j = 0; i < n; ++i) {
+        size_t bit = n >> 1;
+        for (; j & bit; bit >>= 1) j ^= bit;
+        j ^= bit;
+        if (i < j) std::swap(data[i], data[j]);
+    }
+    // Butterflies on the real/imaginary parts: std::complex's operator* goes through the
+    // out-of-line NaN/Inf-correct multiply without -ffast-math
+    for (size_t len = 2; len <= n; len <<= 1) {
+        const size_t half = len / 2;
+        const double sr = std::cos(-2.0 * kPi / (double)len), si = std::sin(-2.0 * kPi / (double)len);
+        double wr_d = 1.0, wi_d = 0.0; // twiddle by rotation, in double so it does not drift
+        for (size_t k = 0; k < half; ++k) {
+            const float wr = (float)wr_d, wi = (float)wi_d;
+            const double t = wr_d * sr - wi_d * si;
+            wi_d = wr_d * si + wi_d * sr;
+            wr_d = t;
+            for (size_t i = k; i < n; i += len) {
+                const float xr = data[i + half].real(), xi = data[i + half].imag();
+                const float vr = xr * wr - xi * wi, vi = xr * wi + xi * wr;
+                const std::complex<float> u = data[i];
+                data[i] = std::complex<float>(u.real() + vr, u.imag() + vi);
+                data[i + half] = std::complex<float>(u.real() - vr, u.imag() - vi);
+            }
+        }
+    }
+}
+
+bool analyze_spectrum(const std::vector<Sample>& samples, size_t fft_size, SpectrumResult& out, double full_range) {
+    out = SpectrumResult{};
+    if (fft_size < 16 || (fft_size & (fft_size - 1)) || samples.size() < fft_size) return false;
+
+    // Sample interval: median of the positive steps (reports are not perfectly regular)
+    std::vector<double> dts;
+    dts.reserve(samples.size());
+    for (size_t i = 1; i < samples.size(); ++i) {
+        const double dt = samples[i].t - samples[i - 1].t;
+        if (dt > 0.0) dts.push_back(dt);
+    }
+    if (dts.size() < fft_size / 2) return false;
+    std::nth_element(dts.begin(), dts.begin() + dts.size() / 2, dts.end());
+    const double dt = dts[dts.size() / 2];
+    const double t0 = samples.front().t, span = samples.back().t - t0;
+    const size_t count = (size_t)(span / dt) + 1;
+    if (count < fft_size) return false;
+    out.fs = 1.0 / dt;
+    out.bin_hz = out.fs / (double)fft_size;
+
+    // Linear interpolation onto the uniform grid
+    std::vector<float> x(count);
+    size_t j = 0;
+    for (size_t i = 0; i < count; ++i) {
+        const double t = t0 + (double)i * dt;
+        while (j + 1 < samples.size() && samples[j + 1].t <= t) ++j;
+        if (j + 1 >= samples.size()) { x[i] = samples.back().v; continue; }
+        const Sample &a = samples[j], &b = samples[j + 1];
+        const double f = b.t > a.t ? (t - a.t) / (b.t - a.t) : 0.0;
+        x[i] = (float)(a.v + (b.v - a.v) * f);
+    }
+
+    // Welch: Hann-windowed segments with 50% overlap, power averaged
+    std::vector<float> w(fft_size);
+    double u = 0.0;
+    for (size_t i = 0; i < fft_size; ++i) {
+        w[i] = (float)(0.5 - 0.5 * std::cos(2.0 * kPi * (double)i / (double)(fft_size - 1)));
+        u += (double)w[i] * w[i];
+    }
+    const size_t half = fft_size / 2;
+    std::vector<double> power(half + 1, 0.0);
+    std::vector<std::complex<float>> buf(fft_size);
+    for (size_t start = 0; start + fft_size <= count; start += half) {
+        double mean = 0.0;
+        for (size_t i = 0; i < fft_size; ++i) mean += x[start + i];
+        mean /= (double)fft_size;
+        for (size_t i = 0; i < fft_size; ++i) buf[i] = std::complex<float>((float)((x[start + i] - mean) * w[i]), 0.0f);
+        fft_inplace(buf.data(), fft_size);
+        for (size_t k = 0; k <= half; ++k) power[k] += (double)std::norm(buf[k]);
+        ++out.segments;
+    }
+    // One-sided, scaled so the bins sum to the signal's variance
+    const double scale = 1.0 / ((double)out.segments * (double)fft_size * u);
+    out.power_db.resize(half + 1);
+    for (size_t k = 0; k <= half; ++k) {
+        power[k] *= (k == 0 || k == half) ? scale : 2.0 * scale;
+        out.power_db[k] = (float)(10.0 * std::log10(power[k] + 1e-20));
+    }
+
+    // Noise floor and broadband level above the movement band
+    const size_t first = std::min(half, (size_t)std::ceil(kSpectrumMotionHz / out.bin_hz) + 1);
+    std::vector<float> upper(out.power_db.begin() + (ptrdiff_t)first, out.power_db.end());
+    if (upper.empty()) return true;
+    double hf = 0.0;
+    for (size_t k = first; k <= half; ++k) hf += power[k];
+    out.hf_rms = (float)std::sqrt(hf);
+    std::nth_element(upper.begin(), upper.begin() + upper.size() / 2, upper.end());
+    out.floor_db = upper[upper.size() / 2];
+
+    const double units = full_range / 2.0;
+    const double min_peak = (double)kSpectrumMinPeakRms * units;
+    const float min_peak_db = (float)(10.0 * std::log10(min_peak * min_peak));
+    for (size_t k = std::max<size_t>(first, 1); k < half; ++k) {
+        const float p = out.power_db[k];
+        if (p <= out.power_db[k - 1] || p < out.power_db[k + 1] || p - out.floor_db < kSpectrumPeakDb || p < min_peak_db) continue;
+        // Parabolic interpolation between the neighbouring bins
+        const double l = out.power_db[k - 1], r = out.power_db[k + 1], d = l - 2.0 * p + r;
+        const double off = d != 0.0 ? std::clamp(0.5 * (l - r) / d, -0.5, 0.5) : 0.0;
+        out.peaks.push_back(SpectrumPeak{ ((double)k + off) * out.bin_hz, p, p - out.floor_db });
+    }
+    std::sort(out.peaks.begin(), out.peaks.end(), [](const SpectrumPeak& a, const SpectrumPeak& b) { return a.db > b.db; });
+    if (out.peaks.size() > kSpectrumMaxPeaks) out.peaks.resize(kSpectrumMaxPeaks);
+
+    // Suggestion: notch the strongest peaks (two sections), else low-pass a raised floor
+    char reason[160];
+    out.suggestion.fs = out.fs;
+    if (!out.peaks.empty()) {
+        for (size_t s = 0; s < BiquadChainSpec::kStages && s < out.peaks.size(); ++s) {
+            const double f = out.peaks[s].hz;
+            out.suggestion.stages[s] = BiquadSpec{ BiquadKind::Notch, (float)f, (float)std::clamp(f / (2.0 * out.bin_hz), 2.0, 30.0) };
+        }
+        std::snprintf(reason, sizeof(reason), "%.1f Hz peak %.0f dB above the floor", out.peaks[0].hz, out.peaks[0].prominence_db);
+        out.reason = reason;
+    } else if (out.hf_rms >= kSpectrumHissRms * units && kLowPassHz < out.fs * 0.45) {
+        out.suggestion.stages[0] = BiquadSpec{ BiquadKind::LowPass, (float)kLowPassHz, 0.707f };
+        std::snprintf(reason, sizeof(reason), "broadband noise %.4f RMS above %.0f Hz", out.hf_rms, kSpectrumMotionHz);
+        out.reason = reason;
+    } else {
+        out.suggestion = BiquadChainSpec{};
+        out.reason = "no periodic or broadband noise worth filtering";
+    }
+    return true;
+}
+
+void SpectrumWorker::set_sources(std::vector<Source> sources) {
+    std::lock_guard<std::mutex> g(_mutex);
+    _sources = std::move(sources);
+    _results.assign(_sources.size(), Entry{});
+    for (size_t i = 0; i < _sources.size(); ++i) _results[i].source = _sources[i];
+}
+
+void SpectrumWorker::start(double interval_s) {
+    if (_running.exchange(true)) return;
+    _thread = std::thread([this, interval_s]() {
+        HOTAS_TRACE_THREAD_NAME("spectrum");
+        hotas_rt::ScopedThreadRole role(hotas_rt::ThreadRole::Background, "spectrum");
+        run(interval_s);
+    });
+}
+
+void SpectrumWorker::stop() {
+    if (!_running.exchange(false)) return;
+    if (_thread.joinable()) _thread.join();
+}
+
+std::vector<SpectrumWorker::Entry> SpectrumWorker::results() const {
+    std::lock_guard<std::mutex> g(_mutex);
+    return _results;
+}
+
+void SpectrumWorker::run(double interval_s) {
+    using clock = std::chrono::steady_clock;
+    std::vector<Sample> samples;
+    auto next = clock::now();
+    while (_running.load(std::memory_order_relaxed)) {
+        if (clock::now() < next || !_enabled.load(std::memory_order_relaxed)) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+            continue;
+        }
+        next = clock::now() + std::chrono::duration_cast<clock::duration>(std::chrono::duration<double>(interval_s));
+        const size_t n = _fft_size.load(std::memory_order_relaxed);
+        for (size_t i = 0; i < _sources.size() && _running.load(std::memory_order_relaxed); ++i) {
+            if (!_sources[i].ring) continue;
+            HOTAS_TRACE_SCOPE("spectrum.analyze");
+            _sources[i].ring->snapshot_latest(n * 4, samples); // ~7 averaged segments
+            SpectrumResult r;
+            const bool ok = analyze_spectrum(samples, n, r, _sources[i].full_range);
+            std::lock_guard<std::mutex> g(_mutex);
+            _results[i].result = std::move(r);
+            _results[i].valid = ok;
+        }
+    }
+}
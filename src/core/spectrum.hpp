@@ -0,0 +1,91 @@
+#pragma once
+#include <atomic>
+#include <complex>
+#include <cstddef>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "biquad.hpp"
+#include "ring_buffer.hpp"
+
+// Noise spectrum of an analog axis and the filter it suggests.
+//
+// analyze_spectrum() takes samples with report timestamps (a live ring or a decoded
+// recording), resamples them onto a uniform grid at the median interval, and averages
+// Hann-windowed FFTs over half-overlapping segments (Welch). Hand movement lives below
+// a few Hz; a narrow peak well above the noise floor higher up is hum or interference
+// and gets a notch, otherwise a raised floor over the upper band gets a low-pass.
+// The suggestion is designed for the estimated sample rate, which is the rate the
+// pipeline evaluates the axis at.
+
+struct SpectrumPeak {
+    double hz = 0.0;
+    float db = 0.0f;
+    float prominence_db = 0.0f; // above the median floor
+};
+
+struct SpectrumResult {
+    double fs = 0.0;                 // estimated sample rate
+    double bin_hz = 0.0;
+    size_t segments = 0;             // FFTs averaged
+    std::vector<float> power_db;     // bins 0 .. fft_size/2 (dB re 1.0^2 per bin)
+    float floor_db = 0.0f;           // median over the bins above kMotionHz
+    float hf_rms = 0.0f;             // RMS of everything above kMotionHz (signal units)
+    std::vector<SpectrumPeak> peaks; // strongest first, at most kMaxPeaks
+    BiquadChainSpec suggestion;      // empty = nothing worth filtering
+    std::string reason;
+};
+
+constexpr double kSpectrumMotionHz = 5.0;      // below: treated as intended movement
+constexpr float kSpectrumPeakDb = 15.0f;       // prominence that makes a peak a notch candidate
+constexpr float kSpectrumHissRms = 0.002f;     // broadband noise (1/1000 of a -1..1 axis) worth a low-pass
+constexpr float kSpectrumMinPeakRms = 0.0005f; // weaker peaks (quantization patterns) are not notched
+constexpr size_t kSpectrumMaxPeaks = 4;
+
+// In-place radix-2 FFT; n must be a power of two
+void fft_inplace(std::complex<float>* data, size_t n);
+
+// False when there are too few samples for one segment of fft_size. The rms thresholds
+// are for a -1..1 axis and scale with full_range (raw-code axes: 2^bits - 1).
+bool analyze_spectrum(const std::vector<Sample>& samples, size_t fft_size, SpectrumResult& out, double full_range = 2.0);
+
+// Background analysis of live rings: every interval, while enabled, each source's newest
+// samples are analyzed on the worker thread; results() hands out a copy for the UI.
+class SpectrumWorker {
+public:
+    struct Source {
+        std::string name;       // e.g. "stick:JOY_X"
+        size_t descriptor = 0;  // pipeline descriptor index
+        double full_range = 2.0;
+        const SampleRing* ring = nullptr;
+    };
+    struct Entry {
+        Source source;
+        SpectrumResult result;
+        bool valid = false;
+    };
+
+    ~SpectrumWorker() { stop(); }
+
+    void set_sources(std::vector<Source> sources); // before start()
+    void start(double interval_s = 0.5);
+    void stop();
+
+    void set_enabled(bool on) { _enabled.store(on, std::memory_order_relaxed); }
+    void set_fft_size(size_t n) { _fft_size.store(n, std::memory_order_relaxed); }
+    size_t fft_size() const { return _fft_size.load(std::memory_order_relaxed); }
+
+    std::vector<Entry> results() const;
+
+private:
+    void run(double interval_s);
+
+    std::vector<Source> _sources;
+    mutable std::mutex _mutex;
+    std::vector<Entry> _results; // by source
+    std::atomic<bool> _running{false};
+    std::atomic<bool> _enabled{false};
+    std::atomic<size_t> _fft_size{1024};
+    std::thread _thread;
+};
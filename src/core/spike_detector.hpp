@@ -0,0 +1,68 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+// Streaming spike detection for one analog signal.
+//
+// Keeps an exponentially weighted mean and variance of the first difference, so the
+// threshold follows each axis' own noise: a step of k sigma is a spike on a quiet
+// axis and ordinary jitter on a worn one. A flagged sample opens a spike; the spike
+// ends when the value comes back within the return band of the level before it (a
+// glitch) or, failing that, after max_hold samples (a real move: the new level is
+// accepted and sigma is raised to the size of the step, then decays as the axis
+// settles, so the rest of the motion does not trip it again). Samples inside a spike
+// are left out of the statistics. O(1) per sample, no allocation.
+
+struct SpikeParams {
+    double k_sigma = 0.0;          // |z| that opens a spike; 0 = off
+    double return_fraction = 0.15; // spike over when back within this fraction of full range of the baseline
+    double alpha = 0.02;           // EWMA weight of each sample (~1/alpha samples of memory)
+    double min_sigma_fraction = 0.002; // sigma floor as a fraction of full range (quantization)
+    int warmup = 16;               // samples before anything is flagged
+    int max_hold = 4;              // samples a level may stay away before it counts as a move
+};
+
+struct SpikeDetector {
+    enum class State : uint8_t { Quiet, Start, Held };
+
+    double mean = 0.0;     // EWMA of the first difference
+    double var = 0.0;      // EWMA variance of the first difference
+    double prev = 0.0;     // last value
+    double baseline = 0.0; // last accepted value (the level a spike is measured from)
+    double jump = 0.0;     // first difference that opened the current spike
+    double z = 0.0;        // score of the last sample outside a spike
+    int seen = 0;
+    int held = 0;          // samples into the current spike (0 = none)
+
+    bool in_spike() const { return held > 0; }
+
+    State update(double v, const SpikeParams& sp, double full_range) {
+        if (seen == 0) { prev = baseline = v; seen = 1; return State::Quiet; }
+        const double d = v - prev;
+        prev = v;
+        if (held > 0) {
+            if (std::fabs(v - baseline) <= sp.return_fraction * full_range) { held = 0; return State::Quiet; }
+            if (++held <= sp.max_hold) return State::Held;
+            // Stayed away: a real move. Take the level and widen sigma to the step.
+            held = 0;
+            baseline = v;
+            if (sp.k_sigma > 0.0) var = std::max(var, (jump / sp.k_sigma) * (jump / sp.k_sigma));
+            return State::Quiet;
+        }
+        const double sigma = std::max(std::sqrt(var), sp.min_sigma_fraction * full_range);
+        z = (d - mean) / sigma;
+        if (sp.k_sigma > 0.0 && seen >= sp.warmup && std::fabs(z) >= sp.k_sigma) {
+            held = 1;
+            jump = d;
+            return State::Start;
+        }
+        const double diff = d - mean;
+        const double incr = sp.alpha * diff;
+        mean += incr;
+        var = (1.0 - sp.alpha) * (var + diff * incr);
+        baseline = v;
+        if (seen < sp.warmup) ++seen;
+        return State::Quiet;
+    }
+};
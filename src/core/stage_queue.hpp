@@ -0,0 +1,120 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include "cache_line.hpp"
+
+// Hand-off between pipeline stages that run on different threads.
+//
+// SpscQueue is a bounded single-producer/single-consumer ring: the producer fills a
+// slot in place and publishes it, the consumer reads it in place and releases it, and
+// neither side ever waits or locks. A full queue rejects the push (counted) and leaves
+// the choice of what to do to the producer.
+//
+// StageMeter keeps the depth and lag (enqueue -> dequeue time) seen at one stage
+// boundary; it is written by one thread and read from any (UI, bench reports).
+
+template <typename T>
+class SpscQueue {
+public:
+    // Capacity rounds up to a power of two
+    explicit SpscQueue(size_t capacity = 64) {
+        size_t c = 1;
+        while (c < capacity) c <<= 1;
+        _capacity = c;
+        _mask = c - 1;
+        _slots = std::make_unique<T[]>(c);
+    }
+
+    size_t capacity() const { return _capacity; }
+
+    // Producer: slot to fill, or null when full (counted as an overflow)
+    T* begin_push() {
+        const uint64_t head = _head.load(std::memory_order_relaxed);
+        if (head - _tail_cache >= _capacity) {
+            _tail_cache = _tail.load(std::memory_order_acquire);
+            if (head - _tail_cache >= _capacity) {
+                _overflows.store(_overflows.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+                return nullptr;
+            }
+        }
+        return &_slots[head & _mask];
+    }
+    // Producer: publish the slot from begin_push()
+    void commit_push() { _head.store(_head.load(std::memory_order_relaxed) + 1, std::memory_order_release); }
+
+    // Consumer: oldest published slot, or null when empty
+    const T* front() {
+        const uint64_t tail = _tail.load(std::memory_order_relaxed);
+        if (tail == _head_cache) {
+            _head_cache = _head.load(std::memory_order_acquire);
+            if (tail == _head_cache) return nullptr;
+        }
+        return &_slots[tail & _mask];
+    }
+    // Consumer: release the slot from front()
+    void pop() { _tail.store(_tail.load(std::memory_order_relaxed) + 1, std::memory_order_release); }
+
+    // Any thread (approximate while both sides run)
+    size_t size() const {
+        const uint64_t tail = _tail.load(std::memory_order_acquire);
+        return (size_t)(_head.load(std::memory_order_acquire) - tail);
+    }
+    uint64_t pushed() const { return _head.load(std::memory_order_relaxed); }
+    uint64_t overflows() const { return _overflows.load(std::memory_order_relaxed); }
+
+private:
+    size_t _capacity = 0;
+    size_t _mask = 0;
+    std::unique_ptr<T[]> _slots;
+    // Producer and consumer indices on separate cache lines, each with a cached copy
+    // of the other side's index so the common case touches only its own line
+    alignas(kCacheLineSize) std::atomic<uint64_t> _head{0};
+    uint64_t _tail_cache = 0;
+    std::atomic<uint64_t> _overflows{0};
+    alignas(kCacheLineSize) std::atomic<uint64_t> _tail{0};
+    uint64_t _head_cache = 0;
+};
+
+class StageMeter {
+public:
+    struct Snapshot {
+        uint64_t items = 0;
+        size_t depth = 0;        // backlog at the last dequeue
+        size_t high_water = 0;
+        double lag_mean_us = 0.0;
+        double lag_max_us = 0.0;
+        double lag_last_us = 0.0;
+    };
+
+    // Writer: one item taken off the boundary `lag_s` after it was queued, `depth` still waiting
+    void record(double lag_s, size_t depth) {
+        if (lag_s < 0.0) lag_s = 0.0;
+        _items.store(_items.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        _lag_sum.store(_lag_sum.load(std::memory_order_relaxed) + lag_s, std::memory_order_relaxed);
+        if (lag_s > _lag_max.load(std::memory_order_relaxed)) _lag_max.store(lag_s, std::memory_order_relaxed);
+        _lag_last.store(lag_s, std::memory_order_relaxed);
+        _depth.store(depth, std::memory_order_relaxed);
+        if (depth > _high_water.load(std::memory_order_relaxed)) _high_water.store(depth, std::memory_order_relaxed);
+    }
+
+    Snapshot snapshot() const {
+        Snapshot s;
+        s.items = _items.load(std::memory_order_relaxed);
+        s.depth = _depth.load(std::memory_order_relaxed);
+        s.high_water = _high_water.load(std::memory_order_relaxed);
+        s.lag_mean_us = s.items ? _lag_sum.load(std::memory_order_relaxed) / (double)s.items * 1e6 : 0.0;
+        s.lag_max_us = _lag_max.load(std::memory_order_relaxed) * 1e6;
+        s.lag_last_us = _lag_last.load(std::memory_order_relaxed) * 1e6;
+        return s;
+    }
+
+private:
+    std::atomic<uint64_t> _items{0};
+    std::atomic<size_t> _depth{0};
+    std::atomic<size_t> _high_water{0};
+    std::atomic<double> _lag_sum{0.0};
+    std::atomic<double> _lag_max{0.0};
+    std::atomic<double> _lag_last{0.0};
+};
@@ -0,0 +1,268 @@
+#include "stall_watchdog.hpp"
+#include "thread_roles.hpp"
+#include "trace.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <thread>
+
+namespace hotas_watchdog {
+
+namespace {
+
+double steady_seconds() {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+struct Slot {
+    // Written by the stage thread
+    std::atomic<uint64_t> beats{0};
+    std::atomic<bool> active{false};
+    std::atomic<bool> paused{false};
+    // Guarded by the registry mutex
+    bool used = false;
+    char name[32] = {};
+    double stall_after_s = 0.0;
+    uint32_t trace_tid = 0;
+    // Watchdog-side state
+    bool watched = false;             // active at the previous scan
+    uint64_t seen_beats = 0;
+    double last_change_t = 0.0;
+    bool stalled = false;
+    double stall_start_t = 0.0;
+    uint64_t record_seq = 0;          // log entry of the ongoing stall
+    uint64_t stalls = 0;
+    double longest_s = 0.0;
+    uint64_t histogram[kBuckets] = {};
+};
+
+struct Registry {
+    std::mutex mtx;
+    Slot slots[kMaxStages];
+    StallRecord log[kMaxStallLog];    // ring; entry seq lives at log[seq % kMaxStallLog]
+    uint64_t log_begin = 0;           // oldest visible seq
+    uint64_t log_next = 0;
+    std::mutex handler_mtx;
+    StallHandler handler;
+    std::atomic<bool> running{false};
+    std::thread worker;
+};
+
+Registry& registry() {
+    static Registry r;
+    return r;
+}
+
+// Log entry for `seq`, or null once it has been overwritten or reset away.
+StallRecord* log_entry(Registry& reg, uint64_t seq) {
+    if (seq < reg.log_begin || seq >= reg.log_next || reg.log_next - seq > kMaxStallLog) return nullptr;
+    return &reg.log[seq % kMaxStallLog];
+}
+
+size_t bucket_of(double seconds) {
+    const double ms = seconds * 1000.0;
+    for (size_t i = 0; i + 1 < kBuckets; ++i) if (ms < kBucketMs[i]) return i;
+    return kBuckets - 1;
+}
+
+void capture_tail(const Slot& s, StallRecord& rec) {
+    if (!hotas_trace::compiled_in() || s.trace_tid == 0) return;
+    hotas_trace::Event events[kTailEvents];
+    const size_t n = hotas_trace::recent_events(s.trace_tid, events, kTailEvents);
+    const int64_t now = hotas_trace::now_ticks();
+    rec.tail.reserve(n);
+    for (size_t i = 0; i < n; ++i) {
+        TraceTailEvent t;
+        t.name = events[i].name;
+        t.age_ms = hotas_trace::ticks_to_us(now - events[i].ts) / 1000.0;
+        t.counter = events[i].kind == hotas_trace::EventKind::Counter;
+        if (t.counter) t.value = events[i].value;
+        else t.dur_ms = hotas_trace::ticks_to_us(events[i].dur) / 1000.0;
+        rec.tail.push_back(t);
+    }
+}
+
+void finish_stall(Registry& reg, Slot& s, double now) {
+    const double d = now - s.stall_start_t;
+    ++s.stalls;
+    if (d > s.longest_s) s.longest_s = d;
+    ++s.histogram[bucket_of(d)];
+    if (StallRecord* rec = log_entry(reg, s.record_seq)) { rec->duration_s = d; rec->ongoing = false; }
+    s.stalled = false;
+}
+
+// One pass over the stages; fills `notices` for the handler.
+void scan(Registry& reg, std::vector<StallNotice>& notices) {
+    const double now = steady_seconds();
+    std::lock_guard<std::mutex> lk(reg.mtx);
+    for (Slot& s : reg.slots) {
+        if (!s.used) continue;
+        const bool active = s.active.load(std::memory_order_acquire);
+        const bool paused = s.paused.load(std::memory_order_acquire);
+        const uint64_t beats = s.beats.load(std::memory_order_relaxed);
+        if (!active || paused) {
+            // Thread exited or paused its heartbeat; that is not a recovery, but it ends the stall
+            if (s.stalled) {
+                const double d = now - s.stall_start_t;
+                finish_stall(reg, s, now);
+                notices.push_back(StallNotice{ s.name, false, d });
+            }
+            s.watched = false;
+            continue;
+        }
+        if (!s.watched || beats != s.seen_beats) {
+            if (s.stalled) {
+                const double d = now - s.stall_start_t;
+                finish_stall(reg, s, now);
+                notices.push_back(StallNotice{ s.name, false, d });
+            }
+            s.watched = true;
+            s.seen_beats = beats;
+            s.last_change_t = now;
+            continue;
+        }
+        if (!s.stalled && now - s.last_change_t > s.stall_after_s) {
+            s.stalled = true;
+            s.stall_start_t = s.last_change_t;
+            s.record_seq = reg.log_next++;
+            if (reg.log_next - reg.log_begin > kMaxStallLog) reg.log_begin = reg.log_next - kMaxStallLog;
+            StallRecord& rec = reg.log[s.record_seq % kMaxStallLog];
+            rec = StallRecord{};
+            rec.stage = s.name;
+            rec.start_t = s.stall_start_t;
+            rec.duration_s = now - s.stall_start_t;
+            capture_tail(s, rec);
+            notices.push_back(StallNotice{ s.name, true, rec.duration_s });
+            HOTAS_TRACE_COUNTER("watchdog.stalled", 1);
+        } else if (s.stalled) {
+            if (StallRecord* rec = log_entry(reg, s.record_seq)) rec->duration_s = now - s.stall_start_t;
+        }
+    }
+}
+
+} // namespace
+
+StageHeartbeat::StageHeartbeat(const char* name, double stall_after_s) {
+    Registry& reg = registry();
+    const uint32_t trace_tid = hotas_trace::enabled() ? hotas_trace::current_thread_id() : 0;
+    std::lock_guard<std::mutex> lk(reg.mtx);
+    size_t free_slot = kMaxStages;
+    for (size_t i = 0; i < kMaxStages; ++i) {
+        Slot& s = reg.slots[i];
+        if (s.used && !s.active.load(std::memory_order_relaxed) && std::strncmp(s.name, name ? name : "", sizeof(s.name) - 1) == 0) {
+            free_slot = i;
+            break;
+        }
+        if (!s.used && free_slot == kMaxStages) free_slot = i;
+    }
+    _slot = free_slot;
+    if (_slot == kMaxStages) return;
+    Slot& s = reg.slots[_slot];
+    if (!s.used) {
+        s.used = true;
+        std::snprintf(s.name, sizeof(s.name), "%s", name ? name : "");
+    }
+    s.stall_after_s = stall_after_s;
+    s.trace_tid = trace_tid;
+    s.paused.store(false, std::memory_order_relaxed);
+    s.active.store(true, std::memory_order_release);
+    _beats = &s.beats;
+}
+
+StageHeartbeat::~StageHeartbeat() {
+    if (_slot < kMaxStages) registry().slots[_slot].active.store(false, std::memory_order_release);
+}
+
+void StageHeartbeat::pause() {
+    if (_slot < kMaxStages) registry().slots[_slot].paused.store(true, std::memory_order_release);
+}
+
+void StageHeartbeat::resume() {
+    if (_slot >= kMaxStages) return;
+    // The beat restarts the deadline even if no scan saw the pause
+    beat();
+    registry().slots[_slot].paused.store(false, std::memory_order_release);
+}
+
+void start(double poll_period_s) {
+    Registry& reg = registry();
+    if (reg.running.exchange(true)) return;
+    reg.worker = std::thread([&reg, poll_period_s]() {
+        HOTAS_TRACE_THREAD_NAME("watchdog");
+        hotas_rt::ScopedThreadRole role(hotas_rt::ThreadRole::Background, "watchdog");
+        const auto period = std::chrono::duration<double>(poll_period_s > 0.0 ? poll_period_s : 0.005);
+        std::vector<StallNotice> notices;
+        while (reg.running.load(std::memory_order_relaxed)) {
+            notices.clear();
+            scan(reg, notices);
+            if (!notices.empty()) {
+                std::lock_guard<std::mutex> lk(reg.handler_mtx);
+                if (reg.handler) {
+                    for (const auto& n : notices) {
+                        try { reg.handler(n); } catch (...) {}
+                    }
+                }
+            }
+            std::this_thread::sleep_for(period);
+        }
+    });
+}
+
+void stop() {
+    Registry& reg = registry();
+    if (!reg.running.exchange(false)) return;
+    if (reg.worker.joinable()) reg.worker.join();
+}
+
+bool running() { return registry().running.load(std::memory_order_relaxed); }
+
+void set_stall_handler(StallHandler handler) {
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lk(reg.handler_mtx);
+    reg.handler = std::move(handler);
+}
+
+std::vector<StageStats> stage_stats() {
+    Registry& reg = registry();
+    const double now = steady_seconds();
+    std::vector<StageStats> out;
+    std::lock_guard<std::mutex> lk(reg.mtx);
+    for (const Slot& s : reg.slots) {
+        if (!s.used) continue;
+        StageStats st;
+        st.name = s.name;
+        st.stall_after_s = s.stall_after_s;
+        st.active = s.active.load(std::memory_order_relaxed);
+        st.paused = s.paused.load(std::memory_order_relaxed);
+        st.beats = s.beats.load(std::memory_order_relaxed);
+        st.stalled = s.stalled;
+        st.current_stall_s = s.stalled ? now - s.stall_start_t : 0.0;
+        st.stalls = s.stalls;
+        st.longest_s = s.longest_s;
+        for (size_t b = 0; b < kBuckets; ++b) st.histogram[b] = s.histogram[b];
+        out.push_back(std::move(st));
+    }
+    return out;
+}
+
+std::vector<StallRecord> recent_stalls() {
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lk(reg.mtx);
+    std::vector<StallRecord> out;
+    for (uint64_t seq = reg.log_begin; seq < reg.log_next; ++seq) out.push_back(reg.log[seq % kMaxStallLog]);
+    return out;
+}
+
+void reset_stats() {
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lk(reg.mtx);
+    for (Slot& s : reg.slots) {
+        s.stalls = 0;
+        s.longest_s = 0.0;
+        for (auto& h : s.histogram) h = 0;
+    }
+    reg.log_begin = reg.log_next;
+}
+
+} // namespace hotas_watchdog
@@ -0,0 +1,96 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+// Stall detection for the input path.
+//
+// Each long-running stage (HID reader, pipeline loop, mapper publisher) owns a
+// heartbeat counter and bumps it once per loop iteration; that is a single relaxed
+// increment, no clock read. A low-priority watchdog thread samples the counters
+// every few milliseconds. A stage whose counter has not moved for longer than its
+// threshold is stalled: the watchdog records the stage, the start time and the
+// newest trace events of the stage's thread (when tracing is compiled in), and calls
+// the stall handler, e.g. to send a neutral controller report. When the counter
+// moves again the stall's duration goes into the stage's histogram.
+namespace hotas_watchdog {
+
+constexpr size_t kMaxStages = 40;   // two reader interfaces for each of 16 devices, plus the pipeline stages
+constexpr size_t kTailEvents = 16;   // trace events kept per stall
+constexpr size_t kMaxStallLog = 32;  // most recent stalls kept
+// Stall histogram bucket upper bounds (ms); the last bucket is open-ended.
+constexpr double kBucketMs[] = { 25, 50, 100, 250, 500, 1000, 2500 };
+constexpr size_t kBuckets = sizeof(kBucketMs) / sizeof(kBucketMs[0]) + 1;
+
+struct StageStats {
+    std::string name;
+    double stall_after_s = 0.0;
+    bool active = false;             // a thread currently owns the heartbeat
+    bool paused = false;             // owned, but not watched for now
+    uint64_t beats = 0;
+    bool stalled = false;
+    double current_stall_s = 0.0;    // while stalled
+    uint64_t stalls = 0;             // completed stalls
+    double longest_s = 0.0;
+    uint64_t histogram[kBuckets] = {};
+};
+
+struct TraceTailEvent {
+    const char* name = nullptr;      // trace event name (static string)
+    double age_ms = 0.0;             // time before the stall was detected
+    double dur_ms = 0.0;             // spans only
+    bool counter = false;
+    double value = 0.0;              // counters only
+};
+
+struct StallRecord {
+    std::string stage;
+    double start_t = 0.0;            // steady-clock seconds of the last heartbeat
+    double duration_s = 0.0;         // so far, while ongoing
+    bool ongoing = true;
+    std::vector<TraceTailEvent> tail; // oldest first; empty without tracing
+};
+
+// Passed to the stall handler on the watchdog thread.
+struct StallNotice {
+    const char* stage = nullptr;
+    bool begin = true;               // false: the stage recovered
+    double duration_s = 0.0;         // detection delay on begin, full stall on end
+};
+using StallHandler = std::function<void(const StallNotice&)>;
+
+// Marks the calling thread as a watched stage until destruction. Stages are keyed by
+// name; a thread that restarts (reader reconnect) takes over its old entry and stats.
+class StageHeartbeat {
+public:
+    StageHeartbeat(const char* name, double stall_after_s);
+    ~StageHeartbeat();
+    StageHeartbeat(const StageHeartbeat&) = delete;
+    StageHeartbeat& operator=(const StageHeartbeat&) = delete;
+    void beat() { if (_beats) _beats->fetch_add(1, std::memory_order_relaxed); }
+    // Unwatch the stage around a deliberate blocking call (device re-enumeration joins the
+    // reader threads); after resume() it gets a full threshold again. A stall already
+    // under way ends at pause(), as when the thread exits.
+    void pause();
+    void resume();
+private:
+    size_t _slot;
+    std::atomic<uint64_t>* _beats = nullptr; // null when the stage table is full
+};
+
+// Start/stop the watchdog thread (runs under the background thread role).
+void start(double poll_period_s = 0.005);
+void stop();
+bool running();
+
+// Called on the watchdog thread, outside its locks. Replaces any previous handler.
+void set_stall_handler(StallHandler handler);
+
+std::vector<StageStats> stage_stats();
+// Most recent stalls, oldest first (ongoing ones included).
+std::vector<StallRecord> recent_stalls();
+void reset_stats();
+
+} // namespace hotas_watchdog
@@ -0,0 +1,192 @@
+#include "telemetry_export.hpp"
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <string>
+#if defined(_WIN32)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+TelemetryExporter::~TelemetryExporter() { close(); }
+
+namespace {
+
+bool process_alive(uint32_t pid) {
+#if defined(_WIN32)
+    HANDLE p = OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION, FALSE, (DWORD)pid);
+    if (!p) return GetLastError() == ERROR_ACCESS_DENIED;
+    DWORD code = 0;
+    const bool alive = GetExitCodeProcess(p, &code) && code == STILL_ACTIVE;
+    CloseHandle(p);
+    return alive;
+#else
+    return kill((pid_t)pid, 0) == 0 || errno == EPERM;
+#endif
+}
+
+// Why an existing region must be left alone, or empty when this writer may initialize it
+// (a fresh all-zero region, one whose writer has exited, or our own from an earlier open()).
+// Only called with the init lock held, so no other writer is half way through initializing.
+std::string existing_region_conflict(const hotas_telemetry_region* r, uint32_t pid) {
+    const uint32_t version = r->version;
+    if (version != 0 && (version != HOTAS_TELEMETRY_VERSION || r->region_size != sizeof(hotas_telemetry_region))) {
+        return "region exists with layout version " + std::to_string(version) + " (" +
+               std::to_string(r->region_size) + " bytes)";
+    }
+    const uint32_t writer = r->writer_pid;
+    if (writer != 0 && writer != pid && process_alive(writer)) {
+        return "region in use by writer pid " + std::to_string(writer);
+    }
+    return {};
+}
+
+} // namespace
+
+bool TelemetryExporter::open(const char* name) {
+    if (_region) return true;
+    const size_t size = sizeof(hotas_telemetry_region);
+    // Writers starting together check and initialize the region one at a time (a named
+    // mutex on Windows, flock on the shm object elsewhere): the second one then finds the
+    // first one's pid and leaves its frames alone.
+#if defined(_WIN32)
+    const std::string lock_name = std::string(name) + ".init";
+    HANDLE lock = CreateMutexA(NULL, FALSE, lock_name.c_str());
+    if (!lock) { _last_error = "CreateMutex failed (" + std::to_string(GetLastError()) + ")"; return false; }
+    const DWORD waited = WaitForSingleObject(lock, 2000);
+    if (waited != WAIT_OBJECT_0 && waited != WAIT_ABANDONED) {
+        _last_error = "timed out waiting for another writer to initialize the region";
+        CloseHandle(lock);
+        return false;
+    }
+    struct Unlock { HANDLE h; ~Unlock() { ReleaseMutex(h); CloseHandle(h); } } unlock{ lock };
+    HANDLE h = CreateFileMappingA(INVALID_HANDLE_VALUE, NULL, PAGE_READWRITE, 0, (DWORD)size, name);
+    if (!h) { _last_error = "CreateFileMapping failed (" + std::to_string(GetLastError()) + ")"; return false; }
+    void* mem = MapViewOfFile(h, FILE_MAP_ALL_ACCESS, 0, 0, size);
+    if (!mem) { _last_error = "MapViewOfFile failed (" + std::to_string(GetLastError()) + ")"; CloseHandle(h); return false; }
+    const uint32_t pid = (uint32_t)GetCurrentProcessId();
+#else
+    const int fd = shm_open(name, O_CREAT | O_RDWR, 0644);
+    if (fd < 0) { _last_error = std::string("shm_open failed: ") + std::strerror(errno); return false; }
+    // Held until initialization is done. Unlocked explicitly: the mapping keeps the open
+    // file (and with it the lock) alive after close()
+    struct Unlock { int fd; ~Unlock() { flock(fd, LOCK_UN); ::close(fd); } } unlock{ fd };
+    if (flock(fd, LOCK_EX) != 0) { _last_error = std::string("flock failed: ") + std::strerror(errno); return false; }
+    struct stat st{};
+    if (fstat(fd, &st) != 0) { _last_error = std::string("fstat failed: ") + std::strerror(errno); return false; }
+    if (st.st_size == 0) {
+        // Newly created (or its creator never sized it): ours to size, zero-filled
+        if (ftruncate(fd, (off_t)size) != 0) { _last_error = std::string("ftruncate failed: ") + std::strerror(errno); return false; }
+    } else if ((size_t)st.st_size != size) {
+        _last_error = "region exists with size " + std::to_string((long long)st.st_size) + " (expected " + std::to_string(size) + ")";
+        return false;
+    }
+    void* mem = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (mem == MAP_FAILED) { _last_error = std::string("mmap failed: ") + std::strerror(errno); return false; }
+    const uint32_t pid = (uint32_t)getpid();
+#endif
+    auto* region = static_cast<hotas_telemetry_region*>(mem);
+    // Another writer's live frames (or a layout our readers cannot parse) stay untouched
+    const std::string conflict = existing_region_conflict(region, pid);
+    if (!conflict.empty()) {
+        _last_error = conflict;
+#if defined(_WIN32)
+        UnmapViewOfFile(mem);
+        CloseHandle(h);
+#else
+        munmap(mem, size);
+#endif
+        return false;
+    }
+    // Taking over a stale region: readers stop on magic before the reset below
+    std::atomic_ref<uint32_t>(region->magic).store(0, std::memory_order_release);
+#if defined(_WIN32)
+    _mapping = h;
+#else
+    _shm_name = name;
+#endif
+    // Fresh layout every time the writer starts; readers detect it via magic/version
+    // and the new writer_pid. Readers still attached keep their count.
+    const size_t readers_at = offsetof(hotas_telemetry_region, readers);
+    std::memset(mem, 0, readers_at);
+    std::memset(static_cast<char*>(mem) + readers_at + sizeof(uint32_t), 0, size - readers_at - sizeof(uint32_t));
+    _region = region;
+    _region->version = HOTAS_TELEMETRY_VERSION;
+    _region->region_size = (uint32_t)size;
+    _region->max_signals = HOTAS_TELEMETRY_MAX_SIGNALS;
+    _region->history_len = HOTAS_TELEMETRY_HISTORY;
+    _region->writer_pid = pid;
+    std::atomic_ref<uint32_t>(_region->magic).store(HOTAS_TELEMETRY_MAGIC, std::memory_order_release);
+    _last_error.clear();
+    return true;
+}
+
+void TelemetryExporter::close() {
+    if (!_region) return;
+    std::atomic_ref<uint32_t>(_region->magic).store(0, std::memory_order_release);
+#if defined(_WIN32)
+    UnmapViewOfFile(_region);
+    if (_mapping) CloseHandle((HANDLE)_mapping);
+    _mapping = nullptr;
+#else
+    munmap(_region, sizeof(hotas_telemetry_region));
+    if (!_shm_name.empty()) shm_unlink(_shm_name.c_str());
+    _shm_name.clear();
+#endif
+    _region = nullptr;
+}
+
+void TelemetryExporter::set_signal_names(const std::vector<std::string>& names) {
+    if (!_region) return;
+    std::atomic_ref<uint32_t> seq(_region->names_seq);
+    const uint32_t s = seq.load(std::memory_order_relaxed);
+    seq.store(s + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    const size_t n = names.size() < HOTAS_TELEMETRY_MAX_SIGNALS ? names.size() : HOTAS_TELEMETRY_MAX_SIGNALS;
+    std::memset(_region->names, 0, sizeof(_region->names));
+    for (size_t i = 0; i < n; ++i) {
+        std::strncpy(_region->names[i], names[i].c_str(), HOTAS_TELEMETRY_NAME_LEN - 1);
+    }
+    _region->signal_count = (uint32_t)n;
+    seq.store(s + 2, std::memory_order_release);
+}
+
+void TelemetryExporter::write_slot(hotas_telemetry_slot& slot, const hotas_telemetry_frame& frame) {
+    std::atomic_ref<uint32_t> seq(slot.seq);
+    const uint32_t s = seq.load(std::memory_order_relaxed);
+    seq.store(s + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    // Only the used prefix of values[] is copied; readers honour signal_count.
+    const size_t bytes = offsetof(hotas_telemetry_frame, values) + frame.signal_count * sizeof(float);
+    std::memcpy(&slot.frame, &frame, bytes);
+    seq.store(s + 2, std::memory_order_release);
+}
+
+void TelemetryExporter::publish(double t, const float* values, uint32_t count, uint32_t flags) {
+    if (!_region) return;
+    if (count > HOTAS_TELEMETRY_MAX_SIGNALS) count = HOTAS_TELEMETRY_MAX_SIGNALS;
+    const uint64_t head = std::atomic_ref<uint64_t>(_region->head).load(std::memory_order_relaxed);
+    _scratch.frame_seq = head + 1;
+    _scratch.t = t;
+    _scratch.signal_count = count;
+    _scratch.flags = flags;
+    if (count > 0) std::memcpy(_scratch.values, values, count * sizeof(float));
+
+    write_slot(_region->history[head & (HOTAS_TELEMETRY_HISTORY - 1)], _scratch);
+    std::atomic_ref<uint64_t>(_region->head).store(head + 1, std::memory_order_release);
+    write_slot(_region->latest, _scratch);
+    _frames.fetch_add(1, std::memory_order_relaxed);
+}
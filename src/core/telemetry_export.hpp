@@ -0,0 +1,50 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <atomic>
+#include "core/hotas_telemetry.h"
+
+// Publishes filtered HOTAS frames into a named shared-memory region (see hotas_telemetry.h).
+// The mapping is created once by open(); publish() only writes to mapped memory
+// (no syscalls, no allocation) so it can run on the pipeline thread every frame.
+// Single writer: call publish() from one thread only.
+class TelemetryExporter {
+public:
+    TelemetryExporter() = default;
+    ~TelemetryExporter();
+    TelemetryExporter(const TelemetryExporter&) = delete;
+    TelemetryExporter& operator=(const TelemetryExporter&) = delete;
+
+    // Create the shared region, or take over one whose writer has exited. Returns false
+    // (see last_error()) if the OS refused the mapping, another running writer owns the
+    // region, or it holds a different layout version; the existing region is left as is.
+    bool open(const char* name = HOTAS_TELEMETRY_DEFAULT_NAME);
+    void close();
+    bool is_open() const { return _region != nullptr; }
+
+    // Publish the signal name table (indices match the values passed to publish()).
+    // Names longer than HOTAS_TELEMETRY_NAME_LEN-1 are truncated.
+    void set_signal_names(const std::vector<std::string>& names);
+
+    // Write one frame into the latest slot and the history ring.
+    void publish(double t, const float* values, uint32_t count, uint32_t flags);
+
+    // Readers attached through hotas_telemetry_attach (0 when closed). A reader that
+    // crashed without detaching stays counted until the region is recreated.
+    uint32_t readers_attached() const {
+        return _region ? std::atomic_ref<uint32_t>(_region->readers).load(std::memory_order_acquire) : 0;
+    }
+    uint64_t frames_published() const { return _frames.load(std::memory_order_relaxed); }
+    const std::string& last_error() const { return _last_error; }
+
+private:
+    static void write_slot(hotas_telemetry_slot& slot, const hotas_telemetry_frame& frame);
+
+    hotas_telemetry_region* _region = nullptr;
+    void* _mapping = nullptr;     // Windows: file mapping HANDLE
+    std::string _shm_name;        // POSIX: name passed to shm_unlink on close
+    hotas_telemetry_frame _scratch{};
+    std::atomic<uint64_t> _frames{0};
+    std::string _last_error;
+};
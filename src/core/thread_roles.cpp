@@ -0,0 +1,286 @@
+#include "thread_roles.hpp"
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#if defined(_WIN32)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#include <avrt.h>
+#pragma comment(lib, "avrt.lib")
+#elif defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace hotas_rt {
+
+namespace {
+
+constexpr const char* kRoleNames[kRoleCount] = { "input_io", "pipeline", "output", "ui", "background" };
+constexpr const char* kPriorityNames[] = { "low", "normal", "above_normal", "high", "realtime" };
+
+struct Registry {
+    std::mutex mtx;
+    ThreadRoleConfig cfg;
+    std::vector<ThreadStatus> threads;
+    std::string memory_lock = "off";
+};
+
+Registry& registry() {
+    static Registry r;
+    return r;
+}
+
+uint64_t current_tid() {
+#if defined(_WIN32)
+    return (uint64_t)GetCurrentThreadId();
+#elif defined(__linux__)
+    return (uint64_t)syscall(SYS_gettid);
+#else
+    return 0;
+#endif
+}
+
+std::string errno_text(int err) {
+    switch (err) {
+        case EPERM: return "EPERM";
+        case EACCES: return "EACCES";
+        case EINVAL: return "EINVAL";
+        case ENOMEM: return "ENOMEM";
+        default: return "errno " + std::to_string(err);
+    }
+}
+
+#if defined(_WIN32)
+std::string win_error_text(DWORD err) { return "error " + std::to_string((unsigned long)err); }
+#endif
+
+bool apply_affinity(uint64_t mask) {
+    if (mask == 0) return true;
+#if defined(_WIN32)
+    return SetThreadAffinityMask(GetCurrentThread(), (DWORD_PTR)mask) != 0;
+#elif defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int i = 0; i < 64; ++i) if (mask & (1ull << i)) CPU_SET(i, &set);
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+    return false;
+#endif
+}
+
+// Applies `p` to the calling thread; returns what the OS granted. `mmcss` receives the
+// MMCSS task handle on Windows (reverted by the caller).
+std::string apply_priority(Priority p, const RoleConfig& rc, void** mmcss) {
+#if defined(_WIN32)
+    static const int kLevels[] = { THREAD_PRIORITY_BELOW_NORMAL, THREAD_PRIORITY_NORMAL,
+                                   THREAD_PRIORITY_ABOVE_NORMAL, THREAD_PRIORITY_HIGHEST };
+    (void)rc;
+    if (p == Priority::Realtime) {
+        DWORD task_index = 0;
+        HANDLE h = AvSetMmThreadCharacteristicsW(L"Games", &task_index);
+        if (h) {
+            AvSetMmThreadPriority(h, AVRT_PRIORITY_HIGH);
+            *mmcss = h;
+            return "MMCSS Games";
+        }
+        const std::string why = win_error_text(GetLastError());
+        if (SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_TIME_CRITICAL)) return "time critical (MMCSS: " + why + ")";
+        return "unchanged (MMCSS: " + why + ")";
+    }
+    if (!SetThreadPriority(GetCurrentThread(), kLevels[(int)p])) return "unchanged (" + win_error_text(GetLastError()) + ")";
+    return priority_name(p);
+#elif defined(__linux__)
+    (void)mmcss;
+    static const int kNice[] = { 5, 0, -5, -10, -10 };
+    const pid_t tid = (pid_t)syscall(SYS_gettid);
+    std::string refused; // what the OS declined, for the status text
+    if (p == Priority::Realtime) {
+        sched_param sp{};
+        sp.sched_priority = rc.fifo_priority < 1 ? 1 : (rc.fifo_priority > 99 ? 99 : rc.fifo_priority);
+        const int err = pthread_setschedparam(pthread_self(), SCHED_FIFO, &sp);
+        if (err == 0) return "SCHED_FIFO " + std::to_string(sp.sched_priority);
+        refused = "FIFO: " + errno_text(err);
+    }
+    // Per-thread nice (Linux applies setpriority to the tid). Lowering nice needs
+    // CAP_SYS_NICE or RLIMIT_NICE; without it the thread keeps its current value.
+    const int want = kNice[(int)p];
+    if (setpriority(PRIO_PROCESS, (id_t)tid, want) == 0) {
+        return "nice " + std::to_string(want) + (refused.empty() ? "" : " (" + refused + ")");
+    }
+    if (!refused.empty()) refused += "; ";
+    refused += "nice " + std::to_string(want) + ": " + errno_text(errno);
+    errno = 0;
+    const int cur = getpriority(PRIO_PROCESS, (id_t)tid);
+    return "nice " + std::to_string(errno ? 0 : cur) + " (" + refused + ")";
+#else
+    (void)p; (void)rc; (void)mmcss;
+    return "unsupported";
+#endif
+}
+
+} // namespace
+
+ThreadRoleConfig::ThreadRoleConfig() {
+    roles[(size_t)ThreadRole::InputIo].priority = Priority::AboveNormal;
+    roles[(size_t)ThreadRole::Pipeline].priority = Priority::AboveNormal;
+    roles[(size_t)ThreadRole::Output].priority = Priority::AboveNormal;
+    roles[(size_t)ThreadRole::Ui].priority = Priority::Normal;
+    roles[(size_t)ThreadRole::Background].priority = Priority::Low;
+    // Real-time requests rank input above the stages it feeds
+    roles[(size_t)ThreadRole::InputIo].fifo_priority = 30;
+    roles[(size_t)ThreadRole::Pipeline].fifo_priority = 20;
+    roles[(size_t)ThreadRole::Output].fifo_priority = 20;
+}
+
+const char* role_name(ThreadRole r) { return (size_t)r < kRoleCount ? kRoleNames[(size_t)r] : "?"; }
+const char* priority_name(Priority p) { return (size_t)p <= (size_t)Priority::Realtime ? kPriorityNames[(size_t)p] : "?"; }
+
+bool parse_role(const std::string& s, ThreadRole& out) {
+    for (size_t i = 0; i < kRoleCount; ++i) if (s == kRoleNames[i]) { out = (ThreadRole)i; return true; }
+    return false;
+}
+
+bool parse_priority(const std::string& s, Priority& out) {
+    for (size_t i = 0; i <= (size_t)Priority::Realtime; ++i) if (s == kPriorityNames[i]) { out = (Priority)i; return true; }
+    return false;
+}
+
+bool parse_cpu_list(const std::string& s, uint64_t& out) {
+    uint64_t mask = 0;
+    size_t i = 0;
+    auto read_num = [&](int& v) {
+        if (i >= s.size() || s[i] < '0' || s[i] > '9') return false;
+        v = 0;
+        while (i < s.size() && s[i] >= '0' && s[i] <= '9') { v = v * 10 + (s[i] - '0'); if (v > 63) return false; ++i; }
+        return true;
+    };
+    while (i < s.size()) {
+        if (s[i] == ' ' || s[i] == ',') { ++i; continue; }
+        int lo = 0, hi = 0;
+        if (!read_num(lo)) return false;
+        hi = lo;
+        if (i < s.size() && s[i] == '-') { ++i; if (!read_num(hi) || hi < lo) return false; }
+        for (int c = lo; c <= hi; ++c) mask |= 1ull << c;
+    }
+    out = mask;
+    return true;
+}
+
+std::string format_cpu_list(uint64_t mask) {
+    std::string out;
+    for (int c = 0; c < 64; ++c) {
+        if (!(mask & (1ull << c))) continue;
+        int end = c;
+        while (end + 1 < 64 && (mask & (1ull << (end + 1)))) ++end;
+        if (!out.empty()) out += ",";
+        out += std::to_string(c);
+        if (end > c) out += "-" + std::to_string(end);
+        c = end;
+    }
+    return out;
+}
+
+void configure(const ThreadRoleConfig& cfg) {
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lk(reg.mtx);
+    reg.cfg = cfg;
+}
+
+ThreadRoleConfig config() {
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lk(reg.mtx);
+    return reg.cfg;
+}
+
+std::string apply_memory_lock() {
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lk(reg.mtx);
+    if (!reg.cfg.lock_memory) return reg.memory_lock = "off";
+#if defined(_WIN32)
+    // Raise the working-set floor so the OS does not trim the ring buffers under memory
+    // pressure (Windows has no mlockall; VirtualLock per region would need the same quota).
+    SIZE_T min_ws = 0, max_ws = 0;
+    HANDLE proc = GetCurrentProcess();
+    if (!GetProcessWorkingSetSize(proc, &min_ws, &max_ws)) return reg.memory_lock = "failed: " + win_error_text(GetLastError());
+    const SIZE_T want = (SIZE_T)256 << 20;
+    if (min_ws < want) min_ws = want;
+    if (max_ws < min_ws * 2) max_ws = min_ws * 2;
+    if (!SetProcessWorkingSetSizeEx(proc, min_ws, max_ws, QUOTA_LIMITS_HARDWS_MIN_ENABLE | QUOTA_LIMITS_HARDWS_MAX_DISABLE))
+        return reg.memory_lock = "failed: " + win_error_text(GetLastError());
+    return reg.memory_lock = "working set min " + std::to_string((unsigned long long)(min_ws >> 20)) + " MB";
+#elif defined(__linux__)
+    // MCL_FUTURE under a finite RLIMIT_MEMLOCK makes later allocations fail once the
+    // limit is reached, so unprivileged processes only pin what is mapped now.
+    rlimit lim{};
+    const bool unbounded = geteuid() == 0 || (getrlimit(RLIMIT_MEMLOCK, &lim) == 0 && lim.rlim_cur == RLIM_INFINITY);
+    if (mlockall(unbounded ? (MCL_CURRENT | MCL_FUTURE) : MCL_CURRENT) != 0) return reg.memory_lock = "failed: " + errno_text(errno);
+    return reg.memory_lock = unbounded ? "locked" : "locked (current pages only)";
+#else
+    return reg.memory_lock = "unsupported";
+#endif
+}
+
+std::string memory_lock_status() {
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lk(reg.mtx);
+    return reg.memory_lock;
+}
+
+ScopedThreadRole::ScopedThreadRole(ThreadRole role, const char* name) {
+    Registry& reg = registry();
+    RoleConfig rc;
+    {
+        std::lock_guard<std::mutex> lk(reg.mtx);
+        rc = reg.cfg.roles[(size_t)role < kRoleCount ? (size_t)role : (size_t)ThreadRole::Background];
+    }
+    ThreadStatus st;
+    st.role = role;
+    st.name = name ? name : "";
+    st.os_tid = current_tid();
+    st.requested = rc.priority;
+    st.cpu_mask = rc.cpu_mask;
+    st.affinity_ok = apply_affinity(rc.cpu_mask);
+    st.applied = apply_priority(rc.priority, rc, &_mmcss);
+
+    std::lock_guard<std::mutex> lk(reg.mtx);
+    // Reuse the entry of an exited thread with the same role and name (reader threads
+    // restart on reconnect), so the table stays bounded.
+    for (size_t i = 0; i < reg.threads.size(); ++i) {
+        const ThreadStatus& old = reg.threads[i];
+        if (!old.alive && old.role == role && old.name == st.name) {
+            reg.threads[i] = std::move(st);
+            _slot = i;
+            return;
+        }
+    }
+    _slot = reg.threads.size();
+    reg.threads.push_back(std::move(st));
+}
+
+ScopedThreadRole::~ScopedThreadRole() {
+#if defined(_WIN32)
+    if (_mmcss) AvRevertMmThreadCharacteristics((HANDLE)_mmcss);
+#endif
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lk(reg.mtx);
+    if (_slot < reg.threads.size()) reg.threads[_slot].alive = false;
+}
+
+std::vector<ThreadStatus> thread_status() {
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lk(reg.mtx);
+    return reg.threads;
+}
+
+} // namespace hotas_rt
@@ -0,0 +1,83 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Scheduling roles for the app's threads.
+//
+// Every long-lived thread declares its role when it starts (ScopedThreadRole);
+// the role's configured CPU affinity and priority are applied to the calling
+// thread and the outcome is recorded for the stats view. Priority requests
+// degrade instead of failing: without the privilege for a real-time class the
+// thread keeps the closest level the OS grants (on Linux: SCHED_FIFO, then a
+// negative nice, then unchanged), and the status says what was actually applied.
+//
+//   Windows: Low..High map to THREAD_PRIORITY_*; Realtime joins the MMCSS "Games"
+//            task (AVRT_PRIORITY_HIGH), falling back to THREAD_PRIORITY_TIME_CRITICAL.
+//   Linux:   Low..High map to per-thread nice 5/0/-5/-10; Realtime is SCHED_FIFO.
+namespace hotas_rt {
+
+enum class ThreadRole : uint8_t { InputIo = 0, Pipeline, Output, Ui, Background, Count };
+enum class Priority : uint8_t { Low = 0, Normal, AboveNormal, High, Realtime };
+
+constexpr size_t kRoleCount = (size_t)ThreadRole::Count;
+
+struct RoleConfig {
+    uint64_t cpu_mask = 0;             // bit i = logical CPU i; 0 leaves affinity alone
+    Priority priority = Priority::Normal;
+    int fifo_priority = 10;            // SCHED_FIFO level for Realtime (Linux, 1..99)
+};
+
+struct ThreadRoleConfig {
+    RoleConfig roles[kRoleCount];
+    bool lock_memory = false;          // mlockall / locked working set at startup
+    ThreadRoleConfig();                // defaults: hot roles AboveNormal, ui Normal, background Low
+};
+
+// What was applied to one thread.
+struct ThreadStatus {
+    ThreadRole role = ThreadRole::Background;
+    std::string name;
+    uint64_t os_tid = 0;
+    Priority requested = Priority::Normal;
+    std::string applied;               // e.g. "SCHED_FIFO 20", "nice -5 (FIFO: EPERM)", "MMCSS Games"
+    uint64_t cpu_mask = 0;             // requested mask (0 = any)
+    bool affinity_ok = true;
+    bool alive = true;
+};
+
+const char* role_name(ThreadRole r);
+const char* priority_name(Priority p);
+// Parsers for the settings file; return false (and leave `out` alone) on bad input.
+bool parse_role(const std::string& s, ThreadRole& out);
+bool parse_priority(const std::string& s, Priority& out);
+// "2,3" / "0-3" / "" (any CPU) <-> mask
+bool parse_cpu_list(const std::string& s, uint64_t& out);
+std::string format_cpu_list(uint64_t mask);
+
+// Process-wide configuration; set before the role threads start.
+void configure(const ThreadRoleConfig& cfg);
+ThreadRoleConfig config();
+
+// Lock current and future pages in RAM when cfg.lock_memory is set. Returns a short
+// description of the outcome ("locked", "off", "failed: EPERM", ...), also kept for stats.
+std::string apply_memory_lock();
+std::string memory_lock_status();
+
+// Applies a role to the calling thread until destruction (MMCSS registration is reverted,
+// the stats entry is marked exited).
+class ScopedThreadRole {
+public:
+    ScopedThreadRole(ThreadRole role, const char* name);
+    ~ScopedThreadRole();
+    ScopedThreadRole(const ScopedThreadRole&) = delete;
+    ScopedThreadRole& operator=(const ScopedThreadRole&) = delete;
+private:
+    size_t _slot;
+    void* _mmcss = nullptr;
+};
+
+// Threads that declared a role, in start order (exited ones stay, marked !alive).
+std::vector<ThreadStatus> thread_status();
+
+} // namespace hotas_rt
@@ -0,0 +1,237 @@
+#include "trace.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace hotas_trace {
+
+namespace {
+
+constexpr size_t kRingCapacity = 1u << 16; // events per thread (~2.5 MB), power of two
+
+struct ThreadRing {
+    uint32_t tid = 0;
+    char name[32] = {};
+    std::atomic<uint64_t> write_index{0};
+    std::atomic<uint64_t> cleared_at{0}; // export ignores indices below this
+    std::atomic<bool> orphaned{false};   // owning thread exited; exported until another thread takes it
+    std::vector<Event> events;
+    ThreadRing() : events(kRingCapacity) {}
+};
+
+struct Registry {
+    std::mutex mtx;
+    std::vector<std::unique_ptr<ThreadRing>> rings; // never freed: an exited thread's ring waits for reuse
+    uint32_t next_tid = 1;
+};
+
+Registry& registry() {
+    static Registry r;
+    return r;
+}
+
+int64_t steady_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Calibration anchor: tick and steady-clock readings taken together at startup.
+// Export takes a second pair and maps ticks linearly onto microseconds since the anchor.
+const int64_t g_anchor_ticks = now_ticks();
+const int64_t g_anchor_ns = steady_ns();
+
+// Marks the ring reusable when its thread exits
+struct RingOwner {
+    ThreadRing* ring = nullptr;
+    ~RingOwner() { if (ring) ring->orphaned.store(true, std::memory_order_release); }
+};
+thread_local RingOwner t_owner;
+
+// A new thread takes over a ring whose thread has exited (threads restarted on device
+// refresh would otherwise add one per start). Its old events are dropped then, under
+// the registry lock, so an export sees them under the old thread's id or not at all.
+ThreadRing* this_thread_ring() {
+    if (t_owner.ring) return t_owner.ring;
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lk(reg.mtx);
+    ThreadRing* ring = nullptr;
+    for (auto& r : reg.rings) {
+        if (r->orphaned.load(std::memory_order_acquire)) { ring = r.get(); break; }
+    }
+    if (ring) {
+        ring->orphaned.store(false, std::memory_order_relaxed);
+        ring->cleared_at.store(ring->write_index.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    } else {
+        reg.rings.push_back(std::make_unique<ThreadRing>());
+        ring = reg.rings.back().get();
+    }
+    ring->tid = reg.next_tid++;
+    std::snprintf(ring->name, sizeof(ring->name), "thread-%u", ring->tid);
+    return t_owner.ring = ring;
+}
+
+inline void push(const Event& e) {
+    ThreadRing* r = this_thread_ring();
+    const uint64_t w = r->write_index.load(std::memory_order_relaxed);
+    r->events[w & (kRingCapacity - 1)] = e;
+    r->write_index.store(w + 1, std::memory_order_release);
+}
+
+void append_json_string(std::string& out, const char* s) {
+    out.push_back('"');
+    for (; s && *s; ++s) {
+        const char c = *s;
+        if (c == '"' || c == '\\') { out.push_back('\\'); out.push_back(c); }
+        else if ((unsigned char)c < 0x20) { out.push_back(' '); }
+        else out.push_back(c);
+    }
+    out.push_back('"');
+}
+
+} // namespace
+
+namespace detail { std::atomic<bool> g_enabled{true}; }
+
+void record_span(const char* name, int64_t start_ticks, int64_t end_ticks) {
+    if (!detail::g_enabled.load(std::memory_order_relaxed)) return;
+    Event e;
+    e.ts = start_ticks;
+    e.dur = end_ticks - start_ticks;
+    e.name = name;
+    e.kind = EventKind::Span;
+    push(e);
+}
+
+void record_counter(const char* name, double value) {
+    if (!detail::g_enabled.load(std::memory_order_relaxed)) return;
+    Event e;
+    e.ts = now_ticks();
+    e.name = name;
+    e.value = value;
+    e.kind = EventKind::Counter;
+    push(e);
+}
+
+void set_thread_name(const char* name) {
+    ThreadRing* r = this_thread_ring();
+    std::lock_guard<std::mutex> lk(registry().mtx);
+    std::snprintf(r->name, sizeof(r->name), "%s", name ? name : "");
+}
+
+void set_enabled(bool on) { detail::g_enabled.store(on, std::memory_order_relaxed); }
+
+void clear() {
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lk(reg.mtx);
+    // Touching the payload would race with writers, so just mark everything before now as consumed.
+    for (auto& r : reg.rings) r->cleared_at.store(r->write_index.load(std::memory_order_acquire), std::memory_order_relaxed);
+}
+
+size_t event_count() {
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lk(reg.mtx);
+    size_t n = 0;
+    for (auto& r : reg.rings) {
+        const uint64_t w = r->write_index.load(std::memory_order_acquire);
+        const uint64_t live = w - r->cleared_at.load(std::memory_order_relaxed);
+        n += (size_t)(live < kRingCapacity ? live : kRingCapacity);
+    }
+    return n;
+}
+
+uint32_t current_thread_id() { return this_thread_ring()->tid; }
+
+size_t ring_count() {
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lk(reg.mtx);
+    return reg.rings.size();
+}
+
+size_t recent_events(uint32_t thread_id, Event* out, size_t max) {
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lk(reg.mtx);
+    for (auto& r : reg.rings) {
+        if (r->tid != thread_id) continue;
+        const uint64_t w0 = r->write_index.load(std::memory_order_acquire);
+        const uint64_t cleared = r->cleared_at.load(std::memory_order_relaxed);
+        uint64_t begin = w0 > max ? w0 - max : 0;
+        if (begin < cleared) begin = cleared;
+        size_t n = 0;
+        for (uint64_t i = begin; i < w0; ++i) out[n++] = r->events[i & (kRingCapacity - 1)];
+        // Drop entries the writer lapped while we copied
+        const uint64_t w1 = r->write_index.load(std::memory_order_acquire);
+        const uint64_t lapped = w1 > kRingCapacity ? w1 - kRingCapacity : 0;
+        size_t skip = lapped > begin ? (size_t)(lapped - begin) : 0;
+        if (skip >= n) return 0;
+        if (skip) std::memmove(out, out + skip, (n - skip) * sizeof(Event));
+        return n - skip;
+    }
+    return 0;
+}
+
+double ticks_to_us(int64_t ticks) {
+    const int64_t span_ticks = now_ticks() - g_anchor_ticks;
+    const int64_t span_ns = steady_ns() - g_anchor_ns;
+    const double us_per_tick = (span_ticks > 0 && span_ns > 0) ? ((double)span_ns / (double)span_ticks) / 1000.0 : 0.001;
+    return (double)ticks * us_per_tick;
+}
+
+bool export_chrome_json(const std::string& path, std::string* error) {
+    std::string out;
+    out.reserve(1 << 20);
+    out += "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+    bool first = true;
+    auto sep = [&]() { if (!first) out += ",\n"; first = false; };
+    char num[96];
+    const int64_t span_ticks = now_ticks() - g_anchor_ticks;
+    const int64_t span_ns = steady_ns() - g_anchor_ns;
+    const double us_per_tick = (span_ticks > 0 && span_ns > 0) ? ((double)span_ns / (double)span_ticks) / 1000.0 : 0.001;
+
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lk(reg.mtx);
+    std::vector<Event> copy;
+    for (auto& r : reg.rings) {
+        sep();
+        std::snprintf(num, sizeof(num), "{\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"name\":\"thread_name\",\"args\":{\"name\":", r->tid);
+        out += num;
+        append_json_string(out, r->name);
+        out += "}}";
+
+        const uint64_t w0 = r->write_index.load(std::memory_order_acquire);
+        const uint64_t cleared = r->cleared_at.load(std::memory_order_relaxed);
+        const uint64_t begin = (w0 > kRingCapacity && w0 - kRingCapacity > cleared) ? w0 - kRingCapacity : cleared;
+        copy.assign(r->events.begin(), r->events.end());
+        // Entries the writer lapped while we copied are unreliable; skip them.
+        const uint64_t w1 = r->write_index.load(std::memory_order_acquire);
+        const uint64_t safe_begin = (w1 > kRingCapacity && w1 - kRingCapacity > begin) ? w1 - kRingCapacity : begin;
+        for (uint64_t i = safe_begin; i < w0; ++i) {
+            const Event& e = copy[i & (kRingCapacity - 1)];
+            if (!e.name) continue;
+            const double ts_us = (double)(e.ts - g_anchor_ticks) * us_per_tick;
+            sep();
+            out += "{\"name\":";
+            append_json_string(out, e.name);
+            if (e.kind == EventKind::Span) {
+                std::snprintf(num, sizeof(num), ",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+                              r->tid, ts_us, (double)e.dur * us_per_tick);
+            } else {
+                std::snprintf(num, sizeof(num), ",\"ph\":\"C\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"args\":{\"value\":%.6g}}",
+                              r->tid, ts_us, e.value);
+            }
+            out += num;
+        }
+    }
+    out += "]}\n";
+
+    std::ofstream f(path, std::ios::binary | std::ios::trunc);
+    if (!f) { if (error) *error = "cannot open " + path; return false; }
+    f.write(out.data(), (std::streamsize)out.size());
+    if (!f) { if (error) *error = "write failed for " + path; return false; }
+    return true;
+}
+
+} // namespace hotas_trace
@@ -0,0 +1,111 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#if defined(_M_X64) || defined(_M_IX86)
+#include <intrin.h>
+#define HOTAS_TRACE_HAS_TSC 1
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define HOTAS_TRACE_HAS_TSC 1
+#endif
+
+// Lightweight timeline tracing.
+//
+// Each thread records into its own fixed-size ring (single writer, no locks on the
+// hot path); a global registry keeps every ring alive so export can walk them on
+// demand. Events are spans (begin + duration) and counters. Export writes the
+// Chrome trace-event JSON format, which loads in chrome://tracing and Perfetto.
+//
+// The macros compile to nothing unless HOTAS_TRACING is defined (CMake option
+// HOTAS_ENABLE_TRACING), so release builds carry no cost. Names must be string
+// literals (only the pointer is stored).
+namespace hotas_trace {
+
+enum class EventKind : uint8_t { Span = 0, Counter = 1 };
+
+struct Event {
+    int64_t ts = 0;             // start (spans) or sample time (counters), in ticks
+    int64_t dur = 0;            // spans only, in ticks
+    const char* name = nullptr; // static string
+    double value = 0.0;         // counters only
+    EventKind kind = EventKind::Span;
+};
+
+// True when the tracing macros were compiled in.
+constexpr bool compiled_in() {
+#if defined(HOTAS_TRACING)
+    return true;
+#else
+    return false;
+#endif
+}
+
+// Timestamp source. On x86 this is the TSC (a few ns per read; converted to
+// wall time at export by calibrating against steady_clock), elsewhere steady_clock ns.
+inline int64_t now_ticks() {
+#if defined(HOTAS_TRACE_HAS_TSC)
+    return (int64_t)__rdtsc();
+#else
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+namespace detail { extern std::atomic<bool> g_enabled; }
+
+// Hot-path recording (current thread's ring; registers the ring on first use).
+void record_span(const char* name, int64_t start_ticks, int64_t end_ticks);
+void record_counter(const char* name, double value);
+void set_thread_name(const char* name);
+
+// Runtime switch; recording is on by default when compiled in.
+void set_enabled(bool on);
+inline bool enabled() { return compiled_in() && detail::g_enabled.load(std::memory_order_relaxed); }
+
+// Drop everything recorded so far (rings stay registered).
+void clear();
+
+// Write all rings as Chrome trace JSON. Safe to call while other threads record;
+// events overwritten during the copy are dropped. Returns false on I/O error.
+bool export_chrome_json(const std::string& path, std::string* error = nullptr);
+
+// Total events currently held across all rings.
+size_t event_count();
+
+// Id of the calling thread's ring (registers it; same id as the export's "tid").
+uint32_t current_thread_id();
+// Rings allocated so far; a thread that exits hands its ring to the next new thread.
+size_t ring_count();
+// Copy the newest `max` events of one thread's ring, oldest first; returns how many.
+// Not for the hot path (takes the registry lock).
+size_t recent_events(uint32_t thread_id, Event* out, size_t max);
+// Convert a tick difference to microseconds (calibrated against steady_clock).
+double ticks_to_us(int64_t ticks);
+
+class Scope {
+public:
+    explicit Scope(const char* name) : _name(name), _start(enabled() ? now_ticks() : 0) {}
+    ~Scope() { if (_start) record_span(_name, _start, now_ticks()); }
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+private:
+    const char* _name;
+    int64_t _start;
+};
+
+} // namespace hotas_trace
+
+#define HOTAS_TRACE_CONCAT_INNER(a, b) a##b
+#define HOTAS_TRACE_CONCAT(a, b) HOTAS_TRACE_CONCAT_INNER(a, b)
+
+#if defined(HOTAS_TRACING)
+#define HOTAS_TRACE_SCOPE(name) ::hotas_trace::Scope HOTAS_TRACE_CONCAT(_hotas_trace_scope_, __LINE__)(name)
+#define HOTAS_TRACE_COUNTER(name, value) ::hotas_trace::record_counter((name), (double)(value))
+#define HOTAS_TRACE_THREAD_NAME(name) ::hotas_trace::set_thread_name(name)
+#else
+#define HOTAS_TRACE_SCOPE(name) ((void)0)
+#define HOTAS_TRACE_COUNTER(name, value) ((void)0)
+#define HOTAS_TRACE_THREAD_NAME(name) ((void)0)
+#endif
@@ -6,6 +6,7 @@
 #include <d3d11.h>
 #include <tchar.h>
 #include <cstdio>
+#include <cstring>
 #include <string>
 #include <vector>
 #include <memory>
@@ -28,40 +29,119 @@
 #pragma comment(lib, "Windowscodecs.lib")
 #include "xinput/xinput_poll.hpp"
 #include <fstream>
+#include <span>
 #include <sstream>
+#include <string_view>
 #include <unordered_map>
 #include "xinput/filtered_forwarder.hpp"
 #include "xinput/hotas_reader.hpp"
 #include "xinput/hotas_mapper.hpp"
+#include "xinput/hotas_pipeline.hpp"
+#include "core/telemetry_export.hpp"
+#include "core/trace.hpp"
+#include "core/aligned_window.hpp"
+#include "core/alloc_guard.hpp"
+#include "core/async_log.hpp"
+#include "core/frame_arena.hpp"
+#include "core/page_alloc.hpp"
+#include "core/report_recording.hpp"
+#include "core/spectrum.hpp"
+#include "core/stall_watchdog.hpp"
+#include "core/thread_roles.hpp"
 // Plots for XInput signals (sticks, triggers, buttons)
 #include "ui/plots_panel.hpp"
 
+// Plot-key maps looked up by const char* / string_view each frame without building a std::string
+struct PlotKeyHash {
+    using is_transparent = void;
+    size_t operator()(std::string_view key) const noexcept { return std::hash<std::string_view>{}(key); }
+};
+template <class V>
+using PlotKeyMap = std::unordered_map<std::string, V, PlotKeyHash, std::equal_to<>>;
+
 // Shared HID buffers for raw Stick/Throttle plotting
 struct HidBuf { std::vector<double> t; std::vector<double> v; };
-static std::unordered_map<std::string, HidBuf> g_hid_buffers;
-// Filtered HID buffers (post per-signal filtering)
-static std::unordered_map<std::string, HidBuf> g_hid_filtered_buffers;
+static PlotKeyMap<HidBuf> g_hid_buffers;
+// Filtered HID history (post per-signal filtering): rings written by the pipeline thread,
+// copied into g_hid_filtered_buffers by the UI thread each frame for plotting
+static constexpr size_t kFilteredRingCapacity = 1u << 14; // > 60 s window at the 250 Hz plot rate
+static constexpr size_t kInputRingCapacity = 1u << 13;    // 8 s at 1 kHz: four segments of the largest FFT
+static std::unordered_map<std::string, SampleRing*> g_hid_filtered_rings; // plot key -> ring (fixed after startup)
+static std::atomic<double> g_hid_filtered_latest{0.0};
+static PlotKeyMap<HidBuf> g_hid_filtered_buffers;
+// Signal bus interest of the "Filtered Signals" plots: PlotHidGroup marks the descriptor
+// behind each series it is asked to draw while g_plot_interest is set
+static PlotKeyMap<int> g_plot_descriptor; // plot key -> descriptor (fixed after startup)
+static SignalSet* g_plot_interest = nullptr;
+
+// Refresh the UI-side copies of the filtered rings for the current window
+static void refresh_filtered_buffers(double window) {
+    static std::vector<Sample> tmp;
+    const double latest = g_hid_filtered_latest.load(std::memory_order_acquire);
+    for (const auto &kv : g_hid_filtered_rings) {
+        kv.second->snapshot(latest, window, tmp);
+        HidBuf &buf = g_hid_filtered_buffers[kv.first];
+        buf.t.resize(tmp.size());
+        buf.v.resize(tmp.size());
+        for (size_t i = 0; i < tmp.size(); ++i) { buf.t[i] = tmp[i].t; buf.v[i] = tmp[i].v; }
+    }
+}
+
+// Mapping-form signal choice: "<device>:<id>" and its label
+struct SigChoice { std::string id; std::string display; };
+
+// "H1_UP" -> "H1 Up", "POV_DOWN_LEFT" -> "POV Down-Left"
+static std::string DirectionLabel(const std::string &sub_id) {
+    size_t us = sub_id.find('_');
+    if (us == std::string::npos) return sub_id;
+    std::string out = sub_id.substr(0, us) + " ";
+    bool word_start = true;
+    for (size_t i = us + 1; i < sub_id.size(); ++i) {
+        char c = sub_id[i];
+        if (c == '_') { out += '-'; word_start = true; continue; }
+        out += word_start ? c : (char)tolower((unsigned char)c);
+        word_start = false;
+    }
+    return out;
+}
 
-// Helper to build canonical device-prefixed keys to avoid stick/throttle collisions
-static inline const char* device_prefix(HotasReader::SignalDescriptor::DeviceKind dk) {
-    return (dk == HotasReader::SignalDescriptor::DeviceKind::Stick) ? "stick" : "throttle";
+// Signals offered by the mapping form for a device selection (0 = all, i+1 = registry
+// device i): each descriptor followed by the HAT/POV directions the pipeline derives from it
+static std::vector<SigChoice> BuildSignalChoices(const HotasPipeline &pipeline, int device_sel) {
+    std::vector<SigChoice> out;
+    const auto &sigs = pipeline.signals();
+    for (const auto &o : pipeline.outputs()) {
+        const auto &sd = sigs[(size_t)o.descriptor];
+        if (device_sel != 0 && (int)sd.device != device_sel - 1) continue;
+        const std::string sub = o.map_key.substr(sd.device_name.size() + 1);
+        out.push_back(SigChoice{ o.map_key, (o.derived ? DirectionLabel(sub) : sd.name) + " (" + sub + ")" });
+    }
+    return out;
 }
 
-// Common raw HID plotter with slight Y padding and fixed ticks for standard ranges
+// Common raw HID plotter with slight Y padding and fixed ticks for standard ranges.
+// Series are (plot key, legend) pairs; the point arrays live in the frame arena.
+using HidSeriesList = std::span<const std::pair<const char*, const char*>>;
 static void PlotHidGroup(const char* title,
-                         const std::unordered_map<std::string, HidBuf>& buffers,
-                         const std::vector<std::pair<const char*, const char*>>& series,
+                         const PlotKeyMap<HidBuf>& buffers,
+                         HidSeriesList series,
                          double window,
                          double t0,
                          float y_min,
                          float y_max) {
-    struct S { std::vector<double> x; std::vector<double> y; const char* name; };
-    std::vector<S> all;
+    FrameArena &arena = ui_frame_arena();
+    struct S { frame_vector<double> x; frame_vector<double> y; const char* name; };
+    frame_vector<S> all(&arena);
+    all.reserve(series.size());
     for (auto &p : series) {
-        auto it = buffers.find(p.first);
+        if (g_plot_interest) {
+            auto d = g_plot_descriptor.find(std::string_view(p.first));
+            if (d != g_plot_descriptor.end()) g_plot_interest->set((size_t)d->second);
+        }
+        auto it = buffers.find(std::string_view(p.first));
         if (it == buffers.end()) continue;
         const HidBuf &buf = it->second;
-        S s; s.name = p.second;
+        S s{ frame_vector<double>(&arena), frame_vector<double>(&arena), p.second };
         s.x.reserve(buf.t.size());
         s.y.reserve(buf.v.size());
         for (size_t i = 0; i < buf.t.size(); ++i) {
@@ -97,6 +177,46 @@ static void PlotHidGroup(const char* title,
         ImPlot::EndPlot();
     }
 }
+static void PlotHidGroup(const char* title,
+                         const PlotKeyMap<HidBuf>& buffers,
+                         std::initializer_list<std::pair<const char*, const char*>> series,
+                         double window,
+                         double t0,
+                         float y_min,
+                         float y_max) {
+    PlotHidGroup(title, buffers, HidSeriesList(series.begin(), series.size()), window, t0, y_min, y_max);
+}
+
+// One-line heat strip of histogram counts (log scale), with marked bin ranges drawn
+// over it in their own colors. Bins are folded into pixel columns by their maximum.
+struct HeatMark { size_t first; size_t last; ImU32 color; };
+static void DrawHeatStrip(const uint32_t* counts, size_t bins, std::span<const HeatMark> marks, float height) {
+    const ImVec2 p0 = ImGui::GetCursorScreenPos();
+    const float width = std::max(64.0f, ImGui::GetContentRegionAvail().x);
+    ImDrawList* dl = ImGui::GetWindowDrawList();
+    dl->AddRectFilled(p0, ImVec2(p0.x + width, p0.y + height), IM_COL32(20, 20, 24, 255));
+    uint32_t peak = 0;
+    for (size_t b = 0; b < bins; ++b) peak = std::max(peak, counts[b]);
+    const int cols = (int)std::min<float>(width, (float)bins);
+    const float col_w = width / (float)cols;
+    if (peak > 0) {
+        const float scale = 1.0f / std::log1p((float)peak);
+        for (int c = 0; c < cols; ++c) {
+            const size_t b0 = (size_t)c * bins / (size_t)cols, b1 = std::max(b0 + 1, (size_t)(c + 1) * bins / (size_t)cols);
+            uint32_t m = 0;
+            for (size_t b = b0; b < b1 && b < bins; ++b) m = std::max(m, counts[b]);
+            if (m == 0) continue;
+            const float k = std::log1p((float)m) * scale;
+            const ImU32 col = IM_COL32((int)(40 + 200 * k), (int)(60 + 160 * k), (int)(90 + 60 * k), 255);
+            dl->AddRectFilled(ImVec2(p0.x + c * col_w, p0.y), ImVec2(p0.x + (c + 1) * col_w, p0.y + height), col);
+        }
+    }
+    for (const auto &m : marks) {
+        const float x0 = p0.x + width * (float)m.first / (float)bins, x1 = p0.x + width * (float)(m.last + 1) / (float)bins;
+        dl->AddRectFilled(ImVec2(x0, p0.y), ImVec2(std::max(x1, x0 + 2.0f), p0.y + height), m.color);
+    }
+    ImGui::Dummy(ImVec2(width, height));
+}
 
 struct FilterSettings {
     bool enabled = false;
@@ -104,6 +224,13 @@ struct FilterSettings {
     double digital_max_ms = 5.0; // stored in milliseconds for UI
     bool left_trigger_digital = false; // treat LT as digital for filtering
     bool right_trigger_digital = false; // treat RT as digital for filtering
+    // Ghost burst filter: buttons flipping together in one report (0 = off)
+    int coincidence_min_bits = 0;
+    float coincidence_axis_jump = 25.0f; // percent of full range that counts as a jump alongside a flip
+    double coincidence_hold_ms = 20.0;
+    // Spike detector on HOTAS axes: sigmas of first-difference noise that open a spike (0 = off)
+    float spike_k_sigma = 0.0f;
+    float spike_return = 15.0f; // percent of full range: back this close to the earlier level ends the spike
     // Per-signal filter mode: 0=none, 1=digital, 2=analog
     std::array<int, SignalCount> per_signal_mode;
     FilterSettings() { per_signal_mode.fill(0); } // default: none (no filtering)
@@ -112,9 +239,17 @@ struct FilterSettings {
 // Global runtime parameters (window_seconds persisted; target_hz fixed at 1 kHz)
 static double g_window_seconds = 30.0;   // plot window length (persisted)
 static bool g_virtual_output_enabled = false; // persisted flag
+static bool g_telemetry_export_enabled = true; // persisted flag: publish filtered frames to shared memory
+static bool g_telemetry_all_signals = true; // persisted (telemetry_signals=all|mapped): export every signal while a reader is attached
+static std::atomic<bool> g_stall_neutral_enabled{true}; // persisted flag: center the virtual pad while an input stage is stalled
+static std::atomic<bool> g_input_rate_auto{true}; // persisted flag: pipeline period and mapper pacing follow the detected report rate
+static bool g_pipeline_fused = false; // persisted (pipeline_topology=split|fused): mapper ticks on the pipeline thread; applied at startup
+static int g_pipeline_queue_depth = 64; // persisted: pipeline -> mapper frame queue (split topology; 0 = hand off under the mapper lock)
+static std::string g_trace_status; // result of the last Help -> Export Trace
 
 // Virtual Output monitor globals
 static bool g_show_virtual_output_window = false;
+static bool g_show_log_window = false;
 static XInputPoller g_output_poller; // polls XInput state of the (virtual) controller
 static PlotConfig g_output_plot_cfg{}; // default config; window_seconds set at runtime
 static PlotsPanel g_output_plots(g_output_poller, g_output_plot_cfg);
@@ -159,10 +294,57 @@ static bool LoadFilterSettings(const char* path, FilterSettings& fs) {
         if (fs.analog_delta > 100.0f) fs.analog_delta = 100.0f;
     }
     fs.digital_max_ms = getd("digital_max_ms", fs.digital_max_ms);
+    fs.coincidence_min_bits = std::clamp((int)getd("coincidence_min_bits", fs.coincidence_min_bits), 0, 64);
+    fs.coincidence_axis_jump = std::clamp(getf("coincidence_axis_jump", fs.coincidence_axis_jump), 1.0f, 100.0f);
+    fs.coincidence_hold_ms = std::clamp(getd("coincidence_hold_ms", fs.coincidence_hold_ms), 0.0, 500.0);
+    fs.spike_k_sigma = std::clamp(getf("spike_k_sigma", fs.spike_k_sigma), 0.0f, 50.0f);
+    fs.spike_return = std::clamp(getf("spike_return", fs.spike_return), 1.0f, 100.0f);
     g_window_seconds = getd("window_seconds", g_window_seconds);
     g_virtual_output_enabled = getb("virtual_output", g_virtual_output_enabled);
+    g_telemetry_export_enabled = getb("telemetry_export", g_telemetry_export_enabled);
+    {
+        auto it = kv.find("telemetry_signals");
+        if (it != kv.end()) g_telemetry_all_signals = it->second != "mapped";
+    }
+    g_stall_neutral_enabled = getb("stall_neutral_output", g_stall_neutral_enabled);
+    g_input_rate_auto = getb("input_rate_auto", g_input_rate_auto);
+    {
+        auto it = kv.find("pipeline_topology");
+        if (it != kv.end()) g_pipeline_fused = it->second == "fused";
+    }
+    g_pipeline_queue_depth = std::clamp((int)getd("pipeline_queue_depth", g_pipeline_queue_depth), 0, 4096);
+    {
+        // log_level=debug|info|warn|error (debug turns on the per-tick mapper diagnostics)
+        auto it = kv.find("log_level");
+        hotas_log::Level lvl = hotas_log::level();
+        if (it != kv.end() && hotas_log::parse_level(it->second, lvl)) hotas_log::set_level(lvl);
+    }
     fs.left_trigger_digital = getb("left_trigger_digital", fs.left_trigger_digital);
     fs.right_trigger_digital = getb("right_trigger_digital", fs.right_trigger_digital);
+
+    // Thread roles: thread_<role>_priority=low|normal|above_normal|high|realtime,
+    // thread_<role>_cpus=<cpu list, e.g. 2,3 or 0-3; empty = any>, lock_memory=0|1
+    {
+        hotas_rt::ThreadRoleConfig trc;
+        trc.lock_memory = getb("lock_memory", trc.lock_memory);
+        for (size_t r = 0; r < hotas_rt::kRoleCount; ++r) {
+            const std::string prefix = std::string("thread_") + hotas_rt::role_name((hotas_rt::ThreadRole)r);
+            auto it = kv.find(prefix + "_priority");
+            if (it != kv.end()) hotas_rt::parse_priority(it->second, trc.roles[r].priority);
+            it = kv.find(prefix + "_cpus");
+            if (it != kv.end()) hotas_rt::parse_cpu_list(it->second, trc.roles[r].cpu_mask);
+        }
+        hotas_rt::configure(trc);
+    }
+    // Sample history pages: ring_huge_pages=off|transparent|explicit, ring_prefault=0|1.
+    // Applies to rings created after the load (the output monitor's exist already).
+    {
+        hotas_mem::PageConfig pc = hotas_mem::config();
+        auto it = kv.find("ring_huge_pages");
+        if (it != kv.end()) hotas_mem::parse_huge_pages(it->second, pc.huge_pages);
+        pc.prefault = getb("ring_prefault", pc.prefault);
+        hotas_mem::configure(pc);
+    }
     
     // Load per-signal filter modes: none|digital|analog
     for (size_t i=0;i<SIGNAL_META.size();++i) {
@@ -186,10 +368,36 @@ static void SaveFilterSettings(const char* path, const FilterSettings& fs) {
     out << "enabled=" << (fs.enabled?1:0) << "\n";
     out << "analog_delta=" << fs.analog_delta << "\n";
     out << "digital_max_ms=" << fs.digital_max_ms << "\n";
+    out << "coincidence_min_bits=" << fs.coincidence_min_bits << "\n";
+    out << "coincidence_axis_jump=" << fs.coincidence_axis_jump << "\n";
+    out << "coincidence_hold_ms=" << fs.coincidence_hold_ms << "\n";
+    out << "spike_k_sigma=" << fs.spike_k_sigma << "\n";
+    out << "spike_return=" << fs.spike_return << "\n";
     out << "window_seconds=" << g_window_seconds << "\n";
     out << "virtual_output=" << (g_virtual_output_enabled?1:0) << "\n";
+    out << "telemetry_export=" << (g_telemetry_export_enabled?1:0) << "\n";
+    out << "telemetry_signals=" << (g_telemetry_all_signals ? "all" : "mapped") << "\n";
+    out << "stall_neutral_output=" << (g_stall_neutral_enabled.load()?1:0) << "\n";
+    out << "input_rate_auto=" << (g_input_rate_auto.load()?1:0) << "\n";
+    out << "pipeline_topology=" << (g_pipeline_fused ? "fused" : "split") << "\n";
+    out << "pipeline_queue_depth=" << g_pipeline_queue_depth << "\n";
+    out << "log_level=" << hotas_log::level_name(hotas_log::level()) << "\n";
     out << "left_trigger_digital=" << (fs.left_trigger_digital?1:0) << "\n";
     out << "right_trigger_digital=" << (fs.right_trigger_digital?1:0) << "\n";
+    {
+        const hotas_rt::ThreadRoleConfig trc = hotas_rt::config();
+        out << "lock_memory=" << (trc.lock_memory?1:0) << "\n";
+        for (size_t r = 0; r < hotas_rt::kRoleCount; ++r) {
+            const char* role = hotas_rt::role_name((hotas_rt::ThreadRole)r);
+            out << "thread_" << role << "_priority=" << hotas_rt::priority_name(trc.roles[r].priority) << "\n";
+            out << "thread_" << role << "_cpus=" << hotas_rt::format_cpu_list(trc.roles[r].cpu_mask) << "\n";
+        }
+    }
+    {
+        const hotas_mem::PageConfig pc = hotas_mem::config();
+        out << "ring_huge_pages=" << hotas_mem::huge_pages_name(pc.huge_pages) << "\n";
+        out << "ring_prefault=" << (pc.prefault?1:0) << "\n";
+    }
     
     // Save per-signal filter modes
     for (size_t i=0;i<SIGNAL_META.size();++i) {
@@ -204,15 +412,16 @@ static void SaveFilterSettings(const char* path, const FilterSettings& fs) {
 
 static void SaveHotasFilterModes(const char* path,
                                  const std::vector<HotasReader::SignalDescriptor>& sigs,
-                                 const std::unordered_map<std::string,int>& hotas_modes) {
+                                 const std::unordered_map<std::string,int>& hotas_modes,
+                                 const std::unordered_map<std::string,BiquadChainSpec>& hotas_biquads) {
     // Append/update per-signal modes for HOTAS signals at the end of the cfg.
     // Simple approach: append lines; loader uses last occurrence effectively.
     std::ofstream out(path, std::ios::out | std::ios::app);
     if (!out) return;
     for (const auto& sd : sigs) {
         int mode = 0;
-        const char* devp = (sd.device == HotasReader::SignalDescriptor::DeviceKind::Stick) ? "stick" : "throttle";
-        std::string map_key = std::string(devp) + ":" + sd.id;
+        const std::string& devp = sd.device_name;
+        std::string map_key = devp + ":" + sd.id;
         auto it = hotas_modes.find(map_key);
         if (it != hotas_modes.end()) mode = it->second;
         // Write device-prefixed key to disambiguate duplicates (legacy reader falls back if this is absent)
@@ -220,8 +429,14 @@ static void SaveHotasFilterModes(const char* path,
         switch (mode) {
             case 1: out << "digital\n"; break;
             case 2: out << "analog\n"; break;
+            case 3: out << "spike\n"; break;
             default: out << "none\n"; break;
         }
+        // Notch/low-pass sections from the Axis Spectrum window ("none" clears earlier lines)
+        if (sd.analog) {
+            auto bq = hotas_biquads.find(map_key);
+            out << "biquad_" << devp << "_" << sd.name << "=" << format_biquad_chain(bq != hotas_biquads.end() ? bq->second : BiquadChainSpec{}) << "\n";
+        }
     }
 }
 
@@ -483,7 +698,11 @@ int APIENTRY WinMain(HINSTANCE, HINSTANCE, LPSTR, int) {
     }
 
     // Load persisted settings before starting poller (overrides defaults if present)
+    hotas_log::start();
     FilterSettings filter_settings; LoadFilterSettings("config/filter_settings.cfg", filter_settings);
+    // Thread roles are configured by the settings load; everything started below picks them up
+    hotas_rt::apply_memory_lock();
+    hotas_rt::ScopedThreadRole ui_role(hotas_rt::ThreadRole::Ui, "ui");
 
     // Clamp loaded values to sane ranges
     if (g_window_seconds < 1.0) g_window_seconds = 1.0; else if (g_window_seconds > 60.0) g_window_seconds = 60.0;
@@ -491,11 +710,20 @@ int APIENTRY WinMain(HINSTANCE, HINSTANCE, LPSTR, int) {
     // Note: Polling rate is fixed at 1000 Hz (not configurable per spec)
     double fixed_polling_hz = 1000.0;
     XInputPoller poller; poller.start(0, fixed_polling_hz, g_window_seconds);
-    HotasReader hotas;
+    // Devices to read: definition files in config/devices, or the built-in X56 pair
+    DeviceRegistry device_registry;
+    {
+        std::vector<std::string> errors;
+        device_registry.load_directory("config/devices", &errors);
+        for (const auto &e : errors) HOTAS_LOG_WARN("hid", "config/devices/{}", e);
+        if (device_registry.empty()) device_registry = DeviceRegistry::x56();
+    }
+    HotasReader hotas(std::move(device_registry));
     HotasMapper hotas_mapper;
     // Build HOTAS per-signal filter mode map from config (device-scoped keys)
     // Key format: "stick:<id>" or "throttle:<id>" to disambiguate duplicates (e.g., E/F/G)
-    std::unordered_map<std::string,int> hotas_filter_modes; // 0=none,1=digital,2=analog
+    std::unordered_map<std::string,int> hotas_filter_modes; // 0=none,1=digital,2=analog,3=spike
+    std::unordered_map<std::string,BiquadChainSpec> hotas_biquads; // analog inputs with notch/low-pass sections
     {
         std::ifstream in("config/filter_settings.cfg", std::ios::in);
         if (in) {
@@ -506,10 +734,10 @@ int APIENTRY WinMain(HINSTANCE, HINSTANCE, LPSTR, int) {
                 auto pos = line.find('='); if (pos==std::string::npos) continue;
                 kv[line.substr(0,pos)] = line.substr(pos+1);
             }
-            auto sigs = hotas.list_signals();
+            const auto &sigs = hotas.list_signals();
             for (const auto &sd : sigs) {
-                const char* devp = (sd.device == HotasReader::SignalDescriptor::DeviceKind::Stick) ? "stick" : "throttle";
-                std::string dev_key = std::string("filter_") + devp + "_" + sd.name; // new device-scoped key
+                const std::string& devp = sd.device_name;
+                std::string dev_key = "filter_" + devp + "_" + sd.name; // new device-scoped key
                 std::string legacy_key = std::string("filter_") + sd.name;             // legacy key without device prefix
                 // Prefer device-scoped key; fall back to legacy
                 std::string key = kv.count(dev_key) ? dev_key : legacy_key;
@@ -517,10 +745,13 @@ int APIENTRY WinMain(HINSTANCE, HINSTANCE, LPSTR, int) {
                 int mode = 0;
                 if (it != kv.end()) {
                     const std::string &v = it->second;
-                    if (v == "digital") mode = 1; else if (v == "analog") mode = 2; else mode = 0;
+                    if (v == "digital") mode = 1; else if (v == "analog") mode = 2; else if (v == "spike") mode = 3; else mode = 0;
                 }
-                std::string map_key = std::string(devp) + ":" + sd.id;
+                std::string map_key = devp + ":" + sd.id;
                 hotas_filter_modes[map_key] = mode; // track by device+id
+                auto bq = kv.find("biquad_" + devp + "_" + sd.name);
+                BiquadChainSpec chain;
+                if (sd.analog && bq != kv.end() && parse_biquad_chain(bq->second, chain) && !chain.empty()) hotas_biquads[map_key] = chain;
             }
         }
     }
@@ -531,11 +762,11 @@ int APIENTRY WinMain(HINSTANCE, HINSTANCE, LPSTR, int) {
         auto entries = hotas_mapper.list_mapping_entries();
         if (!entries.empty()) {
             // Build id -> device map; mark ambiguous ids
-            struct DevInfo { bool seen = false; HotasReader::SignalDescriptor::DeviceKind dk{}; bool ambiguous = false; };
+            struct DevInfo { bool seen = false; std::string device; bool ambiguous = false; };
             std::unordered_map<std::string, DevInfo> id_map;
             for (const auto &sd : hotas.list_signals()) {
                 auto &di = id_map[sd.id];
-                if (!di.seen) { di.seen = true; di.dk = sd.device; }
+                if (!di.seen) { di.seen = true; di.device = sd.device_name; }
                 else { di.ambiguous = true; }
             }
             bool changed = false;
@@ -543,8 +774,7 @@ int APIENTRY WinMain(HINSTANCE, HINSTANCE, LPSTR, int) {
                 if (me.signal_id.find(':') == std::string::npos) {
                     auto it = id_map.find(me.signal_id);
                     if (it != id_map.end() && it->second.seen && !it->second.ambiguous) {
-                        const char* devp = (it->second.dk == HotasReader::SignalDescriptor::DeviceKind::Stick) ? "stick" : "throttle";
-                        std::string new_sig = std::string(devp) + ":" + me.signal_id;
+                        std::string new_sig = it->second.device + ":" + me.signal_id;
                         // Replace mapping entry with updated signal_id
                         hotas_mapper.remove_mapping(me.id);
                         MappingEntry updated = me; updated.signal_id = new_sig;
@@ -564,6 +794,7 @@ int APIENTRY WinMain(HINSTANCE, HINSTANCE, LPSTR, int) {
         poller.inject_state(t, cs);
     });
     static bool show_hotas_detect_window = false;
+    static bool show_spectrum_window = false;
     static std::vector<std::string> hotas_detect_lines;
     static bool show_developer_view = false;
     // HOTAS is always enabled; no UI toggle
@@ -573,9 +804,18 @@ int APIENTRY WinMain(HINSTANCE, HINSTANCE, LPSTR, int) {
     bool virtual_enabled = g_virtual_output_enabled; // start from persisted setting
     // Keep forwarder output disabled; HotasMapper will drive ViGEm output based on mappings
     forwarder.enable_output(false);
+    // Stage topology: io (HID reader threads) -> pipeline (decode/filter/map) -> output (mapper).
+    // Split: the output stage has its own thread fed through an SPSC frame queue. Fused: the
+    // pipeline thread ticks the mapper itself after each pass (one hand-off less).
+    hotas_mapper.set_sample_queue(g_pipeline_fused ? 0 : (size_t)g_pipeline_queue_depth);
+    auto start_mapper = [&]() {
+        if (g_pipeline_fused) hotas_mapper.start_inline();
+        else hotas_mapper.start(1000.0);
+    };
+    StageMeter input_meter; // io -> pipeline: report arrival to pickup, reports waiting in the rings
     // Start mapper if virtual output persisted enabled
     if (virtual_enabled) {
-        hotas_mapper.start(1000.0);
+        start_mapper();
     }
     forwarder.enable_filter(filter_settings.enabled);
     forwarder.set_params(filter_settings.analog_delta, filter_settings.digital_max_ms/1000.0);
@@ -587,237 +827,210 @@ int APIENTRY WinMain(HINSTANCE, HINSTANCE, LPSTR, int) {
     // Saved snapshot for window_seconds to participate in dirty tracking
     double saved_window_seconds = g_window_seconds;
 
+    // Decode/filter/map stage fed from the reader's report rings (runs on the background thread)
+    HotasPipeline pipeline(hotas.list_signals(), hotas.devices().size());
+    FrameMerger frame_merger; // read by the background thread; skew stats shown in Detect HOTAS Devices
+    pipeline.set_mapper(&hotas_mapper);
+    for (const auto &kv : hotas_filter_modes) pipeline.set_filter_mode(kv.first, kv.second);
+    pipeline.set_filter_params(working.analog_delta, working.digital_max_ms);
+    pipeline.set_coincidence_params(working.coincidence_min_bits, working.coincidence_axis_jump, working.coincidence_hold_ms);
+    pipeline.set_spike_params(working.spike_k_sigma, working.spike_return);
+    for (const auto &kv : hotas_biquads) pipeline.set_biquad_chain(kv.first, kv.second);
+
+    // Unfiltered input history per analog descriptor for the Axis Spectrum window; the
+    // spectrum worker analyzes it in the background while the window shows live data
+    std::vector<std::unique_ptr<SampleRing>> input_rings;
+    std::vector<SampleRing*> input_ring_ptrs(pipeline.signals().size(), nullptr);
+    std::vector<SpectrumWorker::Source> spectrum_sources;
+    for (size_t i = 0; i < pipeline.signals().size(); ++i) {
+        const auto &sd = pipeline.signals()[i];
+        if (!sd.analog || sd.bits <= 0) continue;
+        input_rings.push_back(std::make_unique<SampleRing>(kInputRingCapacity));
+        input_ring_ptrs[i] = input_rings.back().get();
+        const double range = sd.norm != SignalNorm::Raw ? 2.0 : (double)((1ULL << sd.bits) - 1ULL);
+        spectrum_sources.push_back(SpectrumWorker::Source{ sd.device_name + ":" + sd.name, i, range, input_ring_ptrs[i] });
+    }
+    pipeline.set_input_rings(input_ring_ptrs);
+    SpectrumWorker spectrum;
+    spectrum.set_sources(spectrum_sources);
+    spectrum.start();
+
+    // Filtered history per pipeline output for the "Filtered Signals" plots. The rings are
+    // created here so the background thread only pushes (no allocation, no locks).
+    std::vector<std::unique_ptr<SampleRing>> filtered_rings;
+    for (const auto &out : pipeline.outputs()) {
+        filtered_rings.push_back(std::make_unique<SampleRing>(kFilteredRingCapacity));
+        g_hid_filtered_rings[out.plot_key] = filtered_rings.back().get();
+        g_plot_descriptor[out.plot_key] = out.descriptor;
+    }
+
+    // Shared-memory telemetry for external tools: one slot per HOTAS descriptor, named "<device>:<id>"
+    TelemetryExporter telemetry;
+    if (g_telemetry_export_enabled && telemetry.open()) {
+        std::vector<std::string> names;
+        for (const auto &sd : hotas.list_signals()) names.push_back(sd.device_name + ":" + sd.id);
+        telemetry.set_signal_names(names);
+    }
+
+    // Only descriptors some consumer needs are evaluated: the mapping profile, the
+    // filtered plots while their window is visible, and the telemetry export (all
+    // signals while an external reader is attached, unless telemetry_signals=mapped)
+    SignalBus signal_bus(pipeline.signals().size());
+    const SignalBus::ConsumerId bus_mappings = signal_bus.add_consumer("mappings");
+    const SignalBus::ConsumerId bus_plots = signal_bus.add_consumer("plots");
+    const SignalBus::ConsumerId bus_telemetry = signal_bus.add_consumer("telemetry");
+    const SignalBus::ConsumerId bus_readouts = signal_bus.add_consumer("readouts");
+    uint64_t mappings_seen = 0;
+    auto update_mapping_interest = [&]() {
+        const uint64_t version = hotas_mapper.mappings_version();
+        if (version == mappings_seen) return;
+        mappings_seen = version;
+        std::vector<std::string> keys;
+        for (const auto &m : hotas_mapper.list_mapping_entries()) keys.push_back(m.signal_id);
+        signal_bus.set_interest(bus_mappings, pipeline.interest_for(keys));
+    };
+    update_mapping_interest();
+    // Built once: the pipeline thread swaps between them as readers attach and detach
+    const SignalSet telemetry_all(pipeline.signals().size(), true), telemetry_none(pipeline.signals().size());
+    SignalSet plot_interest(pipeline.signals().size()), plot_interest_sent(pipeline.signals().size());
+    pipeline.set_signal_bus(&signal_bus);
+
     // Background thread to manage HOTAS input continuously, independent of UI focus/rendering.
     // This ensures HOTAS input is read and processed even when the window is minimized or unfocused.
     std::atomic<bool> hotas_bg_thread_running{true};
     std::atomic<bool> hotas_bg_enabled{true};
     std::atomic<bool> hotas_detected{false};
     std::atomic<bool> output_auto_started{false};
+    // Connect/disconnect transitions from the reader threads: bit per device index, for the background thread
+    std::atomic<uint32_t> liveness_connected{0};
+    std::atomic<uint32_t> liveness_lost{0};
+    hotas.set_liveness_handler([&](DeviceIndex device, bool connected) {
+        const uint32_t bit = 1u << device;
+        (connected ? liveness_connected : liveness_lost).fetch_or(bit, std::memory_order_release);
+    });
     std::thread hotas_background_thread([&]() {
         using clock = std::chrono::steady_clock;
         auto last_ok_tp = clock::now();
         auto next_refresh_tp = clock::now();
-        // Per-signal filter state (id -> prev/current)
-        std::unordered_map<std::string,double> prev_vals;
-        // Track previous RAW values separately for digital gating state machine
-        std::unordered_map<std::string,double> prev_raw_vals;
-        std::unordered_map<std::string,double> rise_times;
-        // For multi-bit digital signals (e.g., hats), track pending target value
-        std::unordered_map<std::string,double> pending_vals;
-        std::unordered_map<std::string,bool> active_flags;
+        // All devices' reports merged into frames in arrival order (own read positions in the rings)
+        const size_t device_count = hotas.devices().size();
+        for (size_t d = 0; d < device_count; ++d) frame_merger.attach(d, &hotas.report_ring((DeviceIndex)d));
+        HOTAS_TRACE_THREAD_NAME("hotas-pipeline");
+        hotas_rt::ScopedThreadRole role(hotas_rt::ThreadRole::Pipeline, "hotas-pipeline");
+        // 4 ms passes; device refreshes can take tens of ms, so allow well beyond that
+        hotas_watchdog::StageHeartbeat heartbeat("hotas-pipeline", 0.1);
+        const auto started_tp = clock::now();
+        // Pass period: 4 ms by default; with input_rate_auto it follows the fastest detected
+        // fixed report rate (down to 1 ms) and the mapper wakes per frame instead of at 1 kHz
+        auto pass_period = std::chrono::microseconds(4000);
+        auto next_rate_check_tp = clock::now() + std::chrono::seconds(1);
+        double applied_rate_hz = 0.0;
+        double last_plot_t = 0.0; // filtered plots stay at <= 250 Hz whatever the pass period
+        bool telemetry_readers = false;
         while (hotas_bg_thread_running.load()) {
+            heartbeat.beat();
             // HOTAS input always enabled
             if (hotas_bg_enabled.load()) {
+                HOTAS_TRACE_SCOPE("pipeline.pass");
                 // Advance HOTAS timebase to keep raw HID plots rolling
                 (void)hotas.poll_once();
                 auto now_tp = clock::now();
-                // Connection-based liveness: prefer handle visibility over report freshness.
-                bool connected = hotas.has_stick() || hotas.has_throttle();
-                // Pull HID live snapshot and parse per-signal values
-                auto live = hotas.get_hid_live_snapshot();
-                // Convert hex to bytes per device
-                auto hex_to_bytes = [&](const std::string &hex, std::vector<uint8_t> &out) {
-                    out.clear();
-                    auto hexval = [](char c)->int {
-                        if (c >= '0' && c <= '9') return c - '0';
-                        if (c >= 'a' && c <= 'f') return 10 + (c - 'a');
-                        if (c >= 'A' && c <= 'F') return 10 + (c - 'A');
-                        return 0;
-                    };
-                    for (size_t i = 0; i + 1 < hex.size(); i += 2) {
-                        int hi = hexval(hex[i]), lo = hexval(hex[i+1]);
-                        out.push_back((uint8_t)((hi << 4) | lo));
+                // Allocation check builds: buffers have settled after warm-up, so from here on
+                // any allocation inside a no-alloc zone is a regression
+                if (hotas_alloc::compiled_in() && !hotas_alloc::armed() && now_tp - started_tp > std::chrono::seconds(5)) {
+                    hotas_alloc::arm(true);
+                }
+                if (now_tp >= next_rate_check_tp) {
+                    next_rate_check_tp = now_tp + std::chrono::seconds(1);
+                    double rate_hz = 0.0;
+                    if (g_input_rate_auto.load()) {
+                        for (size_t d = 0; d < device_count; ++d) rate_hz = std::max(rate_hz, hotas.report_rate_hz((DeviceIndex)d));
                     }
-                };
-                std::vector<uint8_t> stick_bytes;
-                std::vector<uint8_t> throttle_bytes;
-                bool have_stick_report = false;
-                bool have_throttle_report = false;
-                for (auto &p : live) {
-                    const std::string &path = p.first;
-                    const std::string &hex = p.second;
-                    if (hex.empty() || hex == "(no data yet)") continue;
-                    if (path.find("vid_0738&pid_2221") != std::string::npos && path.find("mi_00") != std::string::npos) {
-                        hex_to_bytes(hex, stick_bytes);
-                        have_stick_report = !stick_bytes.empty();
-                    } else if (path.find("vid_0738&pid_a221") != std::string::npos && path.find("mi_00") != std::string::npos) {
-                        hex_to_bytes(hex, throttle_bytes);
-                        have_throttle_report = !throttle_bytes.empty();
+                    if (rate_hz != applied_rate_hz) {
+                        applied_rate_hz = rate_hz;
+                        const double period_us = rate_hz > 0.0 ? std::clamp(1e6 / rate_hz, 1000.0, 4000.0) : 4000.0;
+                        pass_period = std::chrono::microseconds((int64_t)period_us);
+                        hotas_mapper.set_pacing(rate_hz > 0.0 ? HotasMapper::Pacing::EventDriven : HotasMapper::Pacing::Fixed);
+                        HOTAS_LOG_INFO("pipeline", "report rate {} Hz: {} us passes, {} mapper pacing", rate_hz, (int64_t)period_us,
+                                       rate_hz > 0.0 ? "event-driven" : "fixed");
                     }
                 }
-                if (have_stick_report || have_throttle_report) {
+                // Every signal goes to shared memory only while someone reads it; otherwise the
+                // export adds nothing to what the other consumers evaluate
+                if (const bool readers = g_telemetry_all_signals && telemetry.readers_attached() > 0; readers != telemetry_readers) {
+                    telemetry_readers = readers;
+                    signal_bus.set_interest(bus_telemetry, readers ? telemetry_all : telemetry_none);
+                    HOTAS_LOG_INFO("telemetry", "{}", readers ? "reader attached: exporting all signals" : "no readers: exporting only the signals in use");
+                }
+                // React to connects/disconnects flagged by the reader threads: a device that went
+                // away stops contributing (its outputs are released once) instead of freezing
+                if (const uint32_t lost = liveness_lost.exchange(0, std::memory_order_acquire)) {
+                    for (size_t d = 0; d < device_count; ++d) {
+                        if (!(lost & (1u << d)) || hotas.liveness((DeviceIndex)d).connected) continue;
+                        HOTAS_LOG_INFO("hid", "{} disconnected", hotas.devices().device((DeviceIndex)d).name);
+                        frame_merger.drop_device(d);
+                        pipeline.clear_report((DeviceIndex)d);
+                    }
+                }
+                if (const uint32_t joined = liveness_connected.exchange(0, std::memory_order_acquire)) {
+                    for (size_t d = 0; d < device_count; ++d) {
+                        if (joined & (1u << d)) HOTAS_LOG_INFO("hid", "{} connected", hotas.devices().device((DeviceIndex)d).name);
+                    }
+                }
+                // Connection-based liveness: prefer handle visibility over report freshness.
+                bool connected = hotas.any_connected();
+                // Every report (any device) becomes a frame with all devices' latest state,
+                // evaluated at its own arrival time; the mapper keeps the newest
+                size_t frames = 0;
+                {
+                    HOTAS_TRACE_SCOPE("pipeline.decode");
+                    HOTAS_NO_ALLOC_ZONE("pipeline.decode");
+                    const double pick_t = std::chrono::duration<double>(clock::now().time_since_epoch()).count();
+                    while (const MergedFrame* frame = frame_merger.next()) {
+                        input_meter.record(pick_t - frame->t, frame_merger.backlog());
+                        pipeline.process_frame(*frame, false);
+                        ++frames;
+                    }
+                    if (frames) pipeline.notify_mapper();
+                    HOTAS_TRACE_COUNTER("pipeline.frame_skew_ms", frame_merger.skew_stats().last_ms);
+                }
+                const uint32_t report_mask = pipeline.report_mask();
+                if (report_mask != 0) {
                     last_ok_tp = now_tp;
                     hotas_detected.store(true, std::memory_order_release);
                     // Auto-start mapper on first detection if not already running
                     static bool mapper_started_auto = false;
                     if (virtual_enabled && !mapper_started_auto) {
-                        hotas_mapper.start(1000.0);
+                        start_mapper();
                         mapper_started_auto = true;
                     }
                     double now = std::chrono::duration<double>(now_tp.time_since_epoch()).count();
-                    // Build per-signal values using CSV descriptors
-                    auto sigs = hotas.list_signals();
-                    auto extract_bits = [&](const std::vector<uint8_t>& bytes, int bit_start, int bits)->uint64_t {
-                        if (bits <= 0) return 0;
-                        uint64_t val = 0;
-                        for (int i = 0; i < bits; ++i) {
-                            int bit_global = bit_start + i;
-                            size_t byte_idx = (size_t)bit_global / 8;
-                            int bit_in_byte = bit_global % 8; // LSB-first
-                            int bitv = 0;
-                            if (byte_idx < bytes.size()) bitv = (bytes[byte_idx] >> bit_in_byte) & 1;
-                            val |= (uint64_t)bitv << i;
-                        }
-                        return val;
-                    };
-                    for (const auto &sd : sigs) {
-                        const std::vector<uint8_t>& bytes = (sd.device == HotasReader::SignalDescriptor::DeviceKind::Stick) ? stick_bytes : throttle_bytes;
-                        if (bytes.empty()) continue;
-                        uint64_t raw = extract_bits(bytes, sd.bit_start, sd.bits);
-                        double v = 0.0;
-                        // Normalize common analog types
-                        if (sd.id == "joy_x" || sd.id == "joy_y" || sd.id == "joy_z") {
-                            double maxv = (double)((1ULL << sd.bits) - 1);
-                            v = (maxv > 0.0) ? (double)raw / maxv * 2.0 - 1.0 : 0.0;
-                        } else if (sd.id == "c_joy_x" || sd.id == "c_joy_y" || sd.id == "thumb_joy_x" || sd.id == "thumb_joy_y") {
-                            v = ((double)raw / 255.0) * 2.0 - 1.0;
-                        } else if (sd.id == "left_throttle" || sd.id == "right_throttle") {
-                            // Treat each throttle as a joystick-like axis: normalize to -1..1
-                            double maxv = (double)((1ULL << sd.bits) - 1);
-                            v = (maxv > 0.0) ? (double)raw / maxv * 2.0 - 1.0 : 0.0;
-                        } else if (sd.analog) {
-                            v = (double)raw; // other analogs raw 0..(2^bits-1)
-                        } else {
-                            v = (double)raw; // digital/multi-bit raw value
-                        }
-                        // Apply per-signal filtering prior to mapping
-                        int mode = 0;
-                        std::string map_key = std::string(device_prefix(sd.device)) + ":" + sd.id;
-                        auto fm_it = hotas_filter_modes.find(map_key);
-                        if (fm_it != hotas_filter_modes.end()) mode = fm_it->second;
-                        double out_v = v;
-                        if (mode == 2) {
-                            // Analog rate limiter: cap per-sample change to percent of full range
-                            double prev_filtered = prev_vals.count(map_key) ? prev_vals[map_key] : v;
-                            double dv = v - prev_filtered;
-                            // Determine full range for this signal based on normalization
-                            double full_range = 1.0;
-                            if (sd.id == "JOY_X" || sd.id == "JOY_Y" || sd.id == "JOY_Z" || sd.id == "left_throttle" || sd.id == "right_throttle") {
-                                full_range = 2.0; // normalized to -1..1
-                            } else if (sd.analog && sd.bits > 0) {
-                                full_range = (double)((1ULL << sd.bits) - 1ULL); // raw integer range
-                            }
-                            double max_step = (working.analog_delta / 100.0) * full_range;
-                            if (dv > max_step) out_v = prev_filtered + max_step;
-                            else if (dv < -max_step) out_v = prev_filtered - max_step;
-                            else out_v = v;
-                        } else if (mode == 1) {
-                            // Digital debounce/gating
-                            double &rise = rise_times[map_key];
-                            if (!sd.analog && sd.bits > 1) {
-                                // Multi-bit digital (e.g., hats): gate discrete value changes
-                                double prev_filtered = prev_vals.count(map_key) ? prev_vals[map_key] : v;
-                                double prev_raw = prev_raw_vals.count(map_key) ? prev_raw_vals[map_key] : v;
-                                double &pend = pending_vals[map_key];
-                                if (!prev_raw_vals.count(map_key)) {
-                                    rise = -1.0; pend = v; out_v = v;
-                                } else {
-                                    if (v != prev_raw) {
-                                        // Value changed; start/refresh hold timer and keep previous filtered value
-                                        rise = now; pend = v; out_v = prev_filtered;
-                                    } else {
-                                        // Stable; promote after threshold when pending matches and differs from filtered
-                                        if (rise >= 0.0 && (now - rise) >= (working.digital_max_ms/1000.0) && pend == v && v != prev_filtered) {
-                                            out_v = v; rise = -1.0;
-                                        } else {
-                                            out_v = prev_filtered;
-                                        }
-                                    }
-                                }
-                            } else {
-                                // Binary digital: interpret non-analog values >0 as active
-                                bool now_hi = sd.analog ? (v >= 0.5) : (v > 0.0);
-                                double prev_raw = prev_raw_vals.count(map_key) ? prev_raw_vals[map_key] : v;
-                                bool prev_hi = sd.analog ? (prev_raw >= 0.5) : (prev_raw > 0.0);
-                                if (!prev_raw_vals.count(map_key)) rise = -1.0;
-                                if (now_hi && !prev_hi) {
-                                    rise = now; active_flags[map_key] = false;
-                                } else if (now_hi && prev_hi) {
-                                    if (!active_flags[map_key] && rise >= 0.0) {
-                                        double dur = now - rise;
-                                        if (dur >= (working.digital_max_ms/1000.0)) active_flags[map_key] = true;
-                                    }
-                                } else if (!now_hi && prev_hi) {
-                                    active_flags[map_key] = false; rise = -1.0;
-                                } else {
-                                    rise = -1.0; active_flags[map_key] = false;
-                                }
-                                out_v = active_flags[map_key] ? 1.0 : 0.0;
-                            }
-                        }
-                        // Store previous values: filtered for analog spikes, RAW for digital gating
-                        prev_vals[map_key] = out_v;
-                        prev_raw_vals[map_key] = v;
-                        hotas_mapper.accept_sample(map_key, out_v, now);
-                        // Store filtered value for UI plots (parent signal)
-                        HidBuf &fb = g_hid_filtered_buffers[std::string(device_prefix(sd.device)) + ":" + sd.name];
-                        fb.t.push_back(now);
-                        fb.v.push_back(out_v);
-                        // Expand Digital-Multi signals into per-direction buttons and write to mapper and plots
-                        auto trim_buf = [&](HidBuf &buf) {
-                            double t0 = now - g_window_seconds;
-                            size_t first_keep = 0;
-                            while (first_keep < buf.t.size() && buf.t[first_keep] < t0) ++first_keep;
-                            if (first_keep > 0) {
-                                buf.t.erase(buf.t.begin(), buf.t.begin() + first_keep);
-                                buf.v.erase(buf.v.begin(), buf.v.begin() + first_keep);
-                            }
-                        };
-                        auto push_dir = [&](const std::string &sub_id, double dir_v) {
-                            std::string sub_key = std::string(device_prefix(sd.device)) + ":" + sub_id;
-                            hotas_mapper.accept_sample(sub_key, dir_v, now);
-                            HidBuf &sfb = g_hid_filtered_buffers[std::string(device_prefix(sd.device)) + ":" + sub_id];
-                            sfb.t.push_back(now);
-                            sfb.v.push_back(dir_v);
-                            trim_buf(sfb);
-                        };
-                        // HATs H1/H2/H3/H4: 4-bit mask: Up(0), Right(1), Down(2), Left(3)
-                        if (!sd.analog && sd.bits == 4 && (sd.id == "H1" || sd.id == "H2" || sd.id == "H3" || sd.id == "H4")) {
-                            int mask = (int)out_v;
-                            push_dir(sd.name + "_UP",   ((mask >> 0) & 1) ? 1.0 : 0.0);
-                            push_dir(sd.name + "_RIGHT",((mask >> 1) & 1) ? 1.0 : 0.0);
-                            push_dir(sd.name + "_DOWN", ((mask >> 2) & 1) ? 1.0 : 0.0);
-                            push_dir(sd.name + "_LEFT", ((mask >> 3) & 1) ? 1.0 : 0.0);
+                    HOTAS_NO_ALLOC_ZONE("pipeline.process");
+                    // No new report this pass: re-evaluate anyway so debounce timing keeps advancing
+                    if (frames == 0) pipeline.process(now);
+                    // Store filtered values for UI plots (parent signals and HAT/POV directions)
+                    if (now - last_plot_t >= 0.004) {
+                        last_plot_t = now;
+                        const auto &vals = pipeline.values();
+                        for (size_t k = 0; k < filtered_rings.size(); ++k) {
+                            if (!pipeline.output_valid(k)) continue;
+                            filtered_rings[k]->push(now, (float)vals[k]);
                         }
-                        // POV: 0-8 enumerated (None, Up, Up-Right, Right, Down-Right, Down, Down-Left, Left, Up-Left)
-                        if (!sd.analog && sd.bits == 4 && sd.id == "POV") {
-                            int pv = (int)out_v;
-                            bool none = (pv == 0);
-                            bool up = (pv == 1 || pv == 2 || pv == 8);
-                            bool right = (pv == 2 || pv == 3 || pv == 4);
-                            bool down = (pv == 4 || pv == 5 || pv == 6);
-                            bool left = (pv == 6 || pv == 7 || pv == 8);
-                            bool up_right = (pv == 2);
-                            bool down_right = (pv == 4);
-                            bool down_left = (pv == 6);
-                            bool up_left = (pv == 8);
-                            push_dir("POV_UP", up && !none ? 1.0 : 0.0);
-                            push_dir("POV_RIGHT", right && !none ? 1.0 : 0.0);
-                            push_dir("POV_DOWN", down && !none ? 1.0 : 0.0);
-                            push_dir("POV_LEFT", left && !none ? 1.0 : 0.0);
-                            push_dir("POV_UP_RIGHT", up_right ? 1.0 : 0.0);
-                            push_dir("POV_DOWN_RIGHT", down_right ? 1.0 : 0.0);
-                            push_dir("POV_DOWN_LEFT", down_left ? 1.0 : 0.0);
-                            push_dir("POV_UP_LEFT", up_left ? 1.0 : 0.0);
-                        }
-                        // Trim parent buffer to window
-                        trim_buf(fb);
+                        g_hid_filtered_latest.store(now, std::memory_order_release);
+                    }
+                    // Publish the frame to shared memory (memory writes only; no syscalls)
+                    if (telemetry.is_open()) {
+                        const auto &dv = pipeline.descriptor_values();
+                        telemetry.publish(now, dv.data(), (uint32_t)dv.size(), report_mask); // HOTAS_TELEMETRY_FLAG_DEVICE(i)
                     }
                 } else {
                     // If no valid HOTAS data is arriving, only re-enumerate when devices appear disconnected.
                     if (!connected && (now_tp - last_ok_tp > std::chrono::seconds(1)) && now_tp >= next_refresh_tp) {
+                        // Joining the reader threads can block for ~200 ms: not a stall
+                        heartbeat.pause();
                         hotas.stop_hid_live();
                         hotas.start_hid_live();
+                        heartbeat.resume();
                         next_refresh_tp = now_tp + std::chrono::seconds(2); // cooldown to avoid busy re-enumeration
                         hotas_detected.store(false, std::memory_order_release);
                     } else if (connected) {
@@ -825,12 +1038,29 @@ int APIENTRY WinMain(HINSTANCE, HINSTANCE, LPSTR, int) {
                         hotas_detected.store(true, std::memory_order_release);
                     }
                 }
+                // Fused topology: the output stage runs here, right after the frames it consumes
+                if (g_pipeline_fused && hotas_mapper.is_running()) hotas_mapper.tick();
             }
-            // Poll HOTAS at ~250Hz even when disabled (fast wakeup when enabled)
-            std::this_thread::sleep_for(std::chrono::milliseconds(4));
+            // Poll HOTAS at ~250Hz (or the detected report rate) even when disabled
+            std::this_thread::sleep_for(pass_period);
         }
     });
 
+    // Stall watchdog: while any input-path stage is stuck, hold the virtual pad centered so
+    // a stall never leaves an axis deflected (the handler runs on the watchdog thread)
+    int stalled_stages = 0;
+    hotas_watchdog::set_stall_handler([&](const hotas_watchdog::StallNotice& n) {
+        if (n.begin) HOTAS_LOG_WARN("watchdog", "{} stalled (no heartbeat for {} ms)", n.stage, n.duration_s * 1000.0);
+        else HOTAS_LOG_INFO("watchdog", "{} recovered after {} ms", n.stage, n.duration_s * 1000.0);
+        stalled_stages += n.begin ? 1 : -1;
+        if (stalled_stages < 0) stalled_stages = 0;
+        if (!g_stall_neutral_enabled.load()) { hotas_mapper.set_neutral_hold(false); return; }
+        hotas_mapper.set_neutral_hold(stalled_stages > 0);
+        // The publisher cannot apply the hold while it is the one stuck
+        if (n.begin && std::strcmp(n.stage, "mapper") == 0) (void)hotas_mapper.submit_neutral_now();
+    });
+    hotas_watchdog::start();
+
     // Always start HID live and use external input path
     hotas.start_hid_live();
     poller.set_external_input(true);
@@ -839,6 +1069,9 @@ int APIENTRY WinMain(HINSTANCE, HINSTANCE, LPSTR, int) {
 
     // Main loop
     MSG msg{};
+    HOTAS_TRACE_THREAD_NAME("ui");
+    uint64_t ui_allocations_mark = hotas_alloc::thread_allocations();
+    uint64_t ui_frame_allocations = 0; // heap allocations by the UI thread over the last frame (alloc-check builds)
     while (msg.message != WM_QUIT) {
         if (PeekMessage(&msg, nullptr, 0U, 0U, PM_REMOVE)) {
             TranslateMessage(&msg);
@@ -855,6 +1088,14 @@ int APIENTRY WinMain(HINSTANCE, HINSTANCE, LPSTR, int) {
             continue; // skip frame build/render
         }
 
+        HOTAS_TRACE_SCOPE("ui.frame");
+        // The last frame's draw data is presented: its temporaries are done with
+        ui_frame_arena().reset();
+        {
+            const uint64_t allocations = hotas_alloc::thread_allocations();
+            ui_frame_allocations = allocations - ui_allocations_mark;
+            ui_allocations_mark = allocations;
+        }
         ImGui_ImplDX11_NewFrame();
         ImGui_ImplWin32_NewFrame();
         ImGui::NewFrame();
@@ -925,6 +1166,7 @@ int APIENTRY WinMain(HINSTANCE, HINSTANCE, LPSTR, int) {
                             }
                             show_hotas_detect_window = true;
                         }
+                        ImGui::MenuItem("Axis Spectrum...", nullptr, &show_spectrum_window);
                         // Toggle: Virtual Output Monitor (X360)
                         bool open_vom = g_show_virtual_output_window;
                         if (ImGui::MenuItem("Virtual Output Monitor", nullptr, open_vom)) {
@@ -938,11 +1180,21 @@ int APIENTRY WinMain(HINSTANCE, HINSTANCE, LPSTR, int) {
                                 g_output_started = false;
                             }
                         }
+                        ImGui::MenuItem("Log", nullptr, &g_show_log_window);
                         static bool show_developer_view_menu = false;
                         if (ImGui::MenuItem("Developer View", nullptr, &show_developer_view_menu)) {
                             // toggle developer view; actual docking handled after layout build
                             show_developer_view = show_developer_view_menu;
                         }
+                        // Timeline export (Chrome/Perfetto JSON); only live in HOTAS_ENABLE_TRACING builds
+                        if (ImGui::MenuItem("Export Trace", nullptr, false, hotas_trace::compiled_in())) {
+                            std::string err;
+                            if (hotas_trace::export_chrome_json("hotas_trace.json", &err)) {
+                                g_trace_status = "Trace: wrote hotas_trace.json (" + std::to_string(hotas_trace::event_count()) + " events)";
+                            } else {
+                                g_trace_status = "Trace: export failed (" + err + ")";
+                            }
+                        }
                         ImGui::EndMenu();
                     }
                 ImGui::EndMenuBar();
@@ -992,7 +1244,7 @@ int APIENTRY WinMain(HINSTANCE, HINSTANCE, LPSTR, int) {
         // Virtual controller output toggle (driven by HotasMapper)
         if (ImGui::Checkbox("Virtual Output", &virtual_enabled)) {
             if (virtual_enabled) {
-                hotas_mapper.start(1000.0);
+                start_mapper();
                 g_virtual_output_enabled = true;
             } else {
                 hotas_mapper.stop();
@@ -1019,12 +1271,159 @@ int APIENTRY WinMain(HINSTANCE, HINSTANCE, LPSTR, int) {
             ImGui::Text("Avg loop: %.2f us", stats.avg_loop_us);
         }
         ImGui::TextDisabled("Polling rate: 1000 Hz (fixed)");
-        // Connection status (independent of report liveness)
+        // Connection status (reader-maintained liveness atomics; no locks)
+        {
+            const auto &devices = hotas.devices();
+            for (size_t d = 0; d < devices.size(); ++d) {
+                const auto live = hotas.liveness((DeviceIndex)d);
+                ImGui::Text("%s: %s", devices.device((DeviceIndex)d).label.c_str(), live.connected ? "Connected" : "Not Connected");
+                if (live.changes > 1) { ImGui::SameLine(); ImGui::TextDisabled("(%llu reconnects)", (unsigned long long)(live.changes / 2)); }
+            }
+        }
+        if (telemetry.is_open()) {
+            ImGui::TextDisabled("Telemetry export: %s (%llu frames)", HOTAS_TELEMETRY_DEFAULT_NAME, (unsigned long long)telemetry.frames_published());
+        } else if (g_telemetry_export_enabled) {
+            ImGui::TextDisabled("Telemetry export: unavailable (%s)", telemetry.last_error().c_str());
+        }
+        ImGui::TextDisabled("Evaluating %zu of %zu signals", signal_bus.union_count(), pipeline.signals().size());
+        if (ImGui::IsItemHovered()) {
+            std::string tip = "Signals with a consumer:";
+            for (const auto &c : signal_bus.consumers()) tip += "\n  " + c.name + ": " + std::to_string(c.signals);
+            ImGui::SetTooltip("%s", tip.c_str());
+        }
+        if (!g_trace_status.empty()) ImGui::TextDisabled("%s", g_trace_status.c_str());
         {
-            bool stick_conn = hotas.has_stick();
-            bool throttle_conn = hotas.has_throttle();
-            ImGui::Text("HOTAS Stick: %s", stick_conn ? "Connected" : "Not Connected");
-            ImGui::Text("HOTAS Throttle: %s", throttle_conn ? "Connected" : "Not Connected");
+            const FrameArena &arena = ui_frame_arena();
+            if (hotas_alloc::compiled_in()) {
+                ImGui::TextDisabled("UI frame: %.1f KB arena (peak %.1f KB), %llu heap allocations", arena.last_frame_used() / 1024.0,
+                                    arena.peak_used() / 1024.0, (unsigned long long)ui_frame_allocations);
+            } else {
+                ImGui::TextDisabled("UI frame: %.1f KB arena (peak %.1f KB)", arena.last_frame_used() / 1024.0, arena.peak_used() / 1024.0);
+            }
+        }
+        if (hotas_alloc::compiled_in()) {
+            hotas_alloc::Violation v[1];
+            if (!hotas_alloc::armed()) {
+                ImGui::TextDisabled("Alloc check: warming up");
+            } else if (hotas_alloc::violations(v, 1) == 0) {
+                ImGui::TextDisabled("Alloc check: no allocations in hot-path zones");
+            } else {
+                char where[160];
+                hotas_alloc::format_zone_stack(v[0], where, sizeof(where));
+                ImGui::TextColored(ImVec4(1.0f, 0.5f, 0.3f, 1.0f), "Alloc check: %llu allocations in zones (first: %s)",
+                                   (unsigned long long)hotas_alloc::violation_count(), where);
+            }
+        }
+        if (ImGui::TreeNode("Threads")) {
+            ImGui::TextDisabled("Memory lock: %s", hotas_rt::memory_lock_status().c_str());
+            ImGui::TextDisabled("Ring pages: %s", hotas_mem::status().c_str());
+            if (ImGui::BeginTable("thread_roles", 5, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_SizingFixedFit)) {
+                ImGui::TableSetupColumn("Thread");
+                ImGui::TableSetupColumn("Role");
+                ImGui::TableSetupColumn("Requested");
+                ImGui::TableSetupColumn("Applied");
+                ImGui::TableSetupColumn("CPUs");
+                ImGui::TableHeadersRow();
+                for (const auto &ts : hotas_rt::thread_status()) {
+                    ImGui::TableNextRow();
+                    ImGui::TableSetColumnIndex(0);
+                    if (ts.alive) ImGui::Text("%s (%llu)", ts.name.c_str(), (unsigned long long)ts.os_tid);
+                    else ImGui::TextDisabled("%s (exited)", ts.name.c_str());
+                    ImGui::TableSetColumnIndex(1); ImGui::TextUnformatted(hotas_rt::role_name(ts.role));
+                    ImGui::TableSetColumnIndex(2); ImGui::TextUnformatted(hotas_rt::priority_name(ts.requested));
+                    ImGui::TableSetColumnIndex(3); ImGui::TextUnformatted(ts.applied.c_str());
+                    ImGui::TableSetColumnIndex(4);
+                    if (ts.cpu_mask == 0) ImGui::TextDisabled("any");
+                    else if (ts.affinity_ok) ImGui::TextUnformatted(hotas_rt::format_cpu_list(ts.cpu_mask).c_str());
+                    else ImGui::TextColored(ImVec4(1.0f, 0.5f, 0.3f, 1.0f), "%s (failed)", hotas_rt::format_cpu_list(ts.cpu_mask).c_str());
+                }
+                ImGui::EndTable();
+            }
+            ImGui::TreePop();
+        }
+        if (ImGui::TreeNode("Pipeline")) {
+            ImGui::TextDisabled("Topology: %s (pipeline_topology in filter_settings.cfg, applied at startup)",
+                                g_pipeline_fused ? "fused: output stage on the pipeline thread" : "split: output stage on its own thread");
+            if (ImGui::BeginTable("pipeline_stages", 6, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_SizingFixedFit)) {
+                ImGui::TableSetupColumn("Boundary");
+                ImGui::TableSetupColumn("Queue");
+                ImGui::TableSetupColumn("Depth (max)");
+                ImGui::TableSetupColumn("Lag mean (us)");
+                ImGui::TableSetupColumn("Lag max (us)");
+                ImGui::TableSetupColumn("Items");
+                ImGui::TableHeadersRow();
+                auto meter_row = [](const char* name, const char* queue, const StageMeter::Snapshot& m) {
+                    ImGui::TableNextRow();
+                    ImGui::TableSetColumnIndex(0); ImGui::TextUnformatted(name);
+                    ImGui::TableSetColumnIndex(1); ImGui::TextUnformatted(queue);
+                    ImGui::TableSetColumnIndex(2); ImGui::Text("%zu (%zu)", m.depth, m.high_water);
+                    ImGui::TableSetColumnIndex(3); ImGui::Text("%.1f", m.lag_mean_us);
+                    ImGui::TableSetColumnIndex(4); ImGui::Text("%.1f", m.lag_max_us);
+                    ImGui::TableSetColumnIndex(5); ImGui::Text("%llu", (unsigned long long)m.items);
+                };
+                meter_row("io -> pipeline", "report rings", input_meter.snapshot());
+                const auto qs = hotas_mapper.sample_queue_stats();
+                if (qs.capacity) {
+                    char queue[64];
+                    std::snprintf(queue, sizeof(queue), "SPSC %zu frames, %llu full", qs.capacity, (unsigned long long)qs.overflows);
+                    meter_row("pipeline -> output", queue, qs.meter);
+                } else {
+                    ImGui::TableNextRow();
+                    ImGui::TableSetColumnIndex(0); ImGui::TextUnformatted("pipeline -> output");
+                    ImGui::TableSetColumnIndex(1); ImGui::TextDisabled("%s", g_pipeline_fused ? "fused (same thread)" : "mapper lock");
+                }
+                ImGui::EndTable();
+            }
+            ImGui::TreePop();
+        }
+        if (ImGui::TreeNode("Stalls")) {
+            bool stall_neutral = g_stall_neutral_enabled.load();
+            if (ImGui::Checkbox("Center output while an input stage is stalled", &stall_neutral)) g_stall_neutral_enabled.store(stall_neutral);
+            char hist_hdr[hotas_watchdog::kBuckets][16];
+            for (size_t b = 0; b < hotas_watchdog::kBuckets; ++b) {
+                if (b + 1 < hotas_watchdog::kBuckets) std::snprintf(hist_hdr[b], sizeof(hist_hdr[b]), "<%.0f", hotas_watchdog::kBucketMs[b]);
+                else std::snprintf(hist_hdr[b], sizeof(hist_hdr[b]), ">=%.0f", hotas_watchdog::kBucketMs[b - 1]);
+            }
+            if (ImGui::BeginTable("stall_stages", 4 + (int)hotas_watchdog::kBuckets, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_SizingFixedFit)) {
+                ImGui::TableSetupColumn("Stage");
+                ImGui::TableSetupColumn("State");
+                ImGui::TableSetupColumn("Stalls");
+                ImGui::TableSetupColumn("Longest ms");
+                for (size_t b = 0; b < hotas_watchdog::kBuckets; ++b) ImGui::TableSetupColumn(hist_hdr[b]);
+                ImGui::TableHeadersRow();
+                for (const auto &st : hotas_watchdog::stage_stats()) {
+                    ImGui::TableNextRow();
+                    ImGui::TableSetColumnIndex(0); ImGui::TextUnformatted(st.name.c_str());
+                    ImGui::TableSetColumnIndex(1);
+                    if (!st.active) ImGui::TextDisabled("idle");
+                    else if (st.paused) ImGui::TextDisabled("paused");
+                    else if (st.stalled) ImGui::TextColored(ImVec4(1.0f, 0.4f, 0.3f, 1.0f), "STALLED %.0f ms", st.current_stall_s * 1000.0);
+                    else ImGui::Text("ok");
+                    ImGui::TableSetColumnIndex(2); ImGui::Text("%llu", (unsigned long long)st.stalls);
+                    ImGui::TableSetColumnIndex(3); ImGui::Text("%.1f", st.longest_s * 1000.0);
+                    for (size_t b = 0; b < hotas_watchdog::kBuckets; ++b) {
+                        ImGui::TableSetColumnIndex(4 + (int)b);
+                        if (st.histogram[b]) ImGui::Text("%llu", (unsigned long long)st.histogram[b]); else ImGui::TextDisabled("-");
+                    }
+                }
+                ImGui::EndTable();
+            }
+            auto stalls = hotas_watchdog::recent_stalls();
+            for (size_t i = stalls.size(); i-- > 0;) {
+                const auto &rec = stalls[i];
+                ImGui::PushID((int)i);
+                if (ImGui::TreeNode("stall", "%s: %.1f ms%s", rec.stage.c_str(), rec.duration_s * 1000.0, rec.ongoing ? " (ongoing)" : "")) {
+                    if (rec.tail.empty()) ImGui::TextDisabled("No trace events (build with HOTAS_ENABLE_TRACING)");
+                    for (const auto &ev : rec.tail) {
+                        if (ev.counter) ImGui::Text("-%8.2f ms  %s = %.6g", ev.age_ms, ev.name ? ev.name : "?", ev.value);
+                        else ImGui::Text("-%8.2f ms  %s (%.3f ms)", ev.age_ms, ev.name ? ev.name : "?", ev.dur_ms);
+                    }
+                    ImGui::TreePop();
+                }
+                ImGui::PopID();
+            }
+            if (ImGui::Button("Reset stall stats")) hotas_watchdog::reset_stats();
+            ImGui::TreePop();
         }
         // Window length controls (1 - 60 seconds)
         double win = g_window_seconds;
@@ -1080,29 +1479,107 @@ int APIENTRY WinMain(HINSTANCE, HINSTANCE, LPSTR, int) {
                     working.digital_max_ms = digital_max;
                     filter_dirty = true;
                     forwarder.set_params(analog_delta, digital_max/1000.0);
+                    pipeline.set_filter_params(analog_delta, digital_max);
+                }
+
+                ImGui::SeparatorText("Ghost Burst Filter");
+                ImGui::TextDisabled("Holds a device's buttons when several flip in the same report (EMI), so Digital Pulse Max can stay short.");
+                bool burst_updated = false;
+                burst_updated |= ImGui::SliderInt("Buttons flipping at once (0 = off)", &working.coincidence_min_bits, 0, 16);
+                burst_updated |= ImGui::SliderFloat("Axis jump with a flip (% full range)", &working.coincidence_axis_jump, 1.0f, 100.0f, "%.0f%%");
+                double hold_min = 0.0, hold_max = 200.0;
+                burst_updated |= ImGui::SliderScalar("Burst hold (ms)", ImGuiDataType_Double, &working.coincidence_hold_ms, &hold_min, &hold_max, "%.1f");
+                if (burst_updated) {
+                    filter_dirty = true;
+                    pipeline.set_coincidence_params(working.coincidence_min_bits, working.coincidence_axis_jump, working.coincidence_hold_ms);
+                }
+                if (working.coincidence_min_bits > 0) {
+                    const auto &devices = hotas.devices();
+                    for (size_t d = 0; d < devices.size(); ++d) {
+                        ImGui::TextDisabled("%s: %llu bursts held", devices.device((DeviceIndex)d).label.c_str(),
+                                            (unsigned long long)pipeline.coincidence_bursts((DeviceIndex)d));
+                    }
                 }
                 
+                ImGui::SeparatorText("Spike Detection");
+                ImGui::TextDisabled("Flags axis samples that jump well beyond the axis' own noise; Reject Spikes inputs hold the earlier level through them.");
+                bool spike_updated = false;
+                spike_updated |= ImGui::SliderFloat("Spike threshold (sigma, 0 = off)", &working.spike_k_sigma, 0.0f, 20.0f, "%.1f");
+                spike_updated |= ImGui::SliderFloat("Spike return band (% full range)", &working.spike_return, 1.0f, 50.0f, "%.0f%%");
+                if (spike_updated) {
+                    filter_dirty = true;
+                    pipeline.set_spike_params(working.spike_k_sigma, working.spike_return);
+                }
+                if (working.spike_k_sigma > 0.0f) {
+                    // Newest events from the pipeline's anomaly ring
+                    static uint64_t spike_cursor = 0;
+                    static std::vector<AnomalyEvent> recent_spikes;
+                    pipeline.anomalies().read(spike_cursor, recent_spikes);
+                    if (recent_spikes.size() > 8) recent_spikes.erase(recent_spikes.begin(), recent_spikes.end() - 8);
+                    ImGui::TextDisabled("%llu spikes flagged", (unsigned long long)pipeline.anomalies().total());
+                    const auto &sigs = pipeline.signals();
+                    for (auto it = recent_spikes.rbegin(); it != recent_spikes.rend(); ++it) {
+                        if (it->descriptor >= sigs.size()) continue;
+                        ImGui::TextDisabled("  %s: %s %.3f -> %.3f (z %.1f)", sigs[it->descriptor].device_name.c_str(),
+                                            sigs[it->descriptor].name.c_str(), it->baseline, it->value, it->z);
+                    }
+                }
+
                 ImGui::SeparatorText("HOTAS Per-Input Filter Modes");
-                ImGui::TextDisabled("Select per-signal mode: None (raw), Digital (debounce), Analog (rate limit).");
-                const char* items[] = { "None", "Digital", "Analog" };
-                if (ImGui::BeginTable("hotas_filter_modes", 2, ImGuiTableFlags_BordersInnerV | ImGuiTableFlags_RowBg | ImGuiTableFlags_Resizable)) {
+                ImGui::TextDisabled("Select per-signal mode: None (raw), Digital (debounce), Analog (rate limit), Reject Spikes (needs spike detection).");
+                // Live readouts from the filtered rings' block aggregates (no window copy per frame);
+                // every signal is evaluated while they are shown
+                static bool show_readouts = false;
+                static float readout_seconds = 2.0f;
+                if (ImGui::Checkbox("Live readouts", &show_readouts)) {
+                    signal_bus.set_interest(bus_readouts, SignalSet(pipeline.signals().size(), show_readouts));
+                }
+                if (show_readouts) {
+                    ImGui::SameLine();
+                    ImGui::SetNextItemWidth(120);
+                    ImGui::SliderFloat("over (s)", &readout_seconds, 0.5f, 60.0f, "%.1f", ImGuiSliderFlags_Logarithmic);
+                }
+                const char* items[] = { "None", "Digital", "Analog", "Reject Spikes" };
+                if (ImGui::BeginTable("hotas_filter_modes", show_readouts ? 3 : 2, ImGuiTableFlags_BordersInnerV | ImGuiTableFlags_RowBg | ImGuiTableFlags_Resizable)) {
                     ImGui::TableSetupColumn("Signal");
                     ImGui::TableSetupColumn("Mode");
-                    auto sigs = hotas.list_signals();
-                    for (const auto &sd : sigs) {
+                    if (show_readouts) ImGui::TableSetupColumn("Noise / peak / on");
+                    const double readout_t1 = g_hid_filtered_latest.load(std::memory_order_acquire);
+                    const auto &sigs = hotas.list_signals();
+                    // Keys and widget ids per signal, built once (the signal list is fixed after startup)
+                    struct RowKeys { std::string map_key, plot_key, combo_id; };
+                    static std::vector<RowKeys> row_keys;
+                    if (row_keys.size() != sigs.size()) {
+                        row_keys.clear();
+                        for (const auto &sd : sigs) {
+                            const std::string map_key = sd.device_name + ":" + sd.id;
+                            row_keys.push_back(RowKeys{ map_key, sd.device_name + ":" + sd.name, "##hotas_mode_" + map_key });
+                        }
+                    }
+                    for (size_t si = 0; si < sigs.size(); ++si) {
+                        const auto &sd = sigs[si];
+                        const RowKeys &keys = row_keys[si];
                         ImGui::TableNextRow();
                         ImGui::TableSetColumnIndex(0);
-                        const char* dev = (sd.device == HotasReader::SignalDescriptor::DeviceKind::Stick) ? "Stick" : "Throttle";
-                        std::string disp = std::string(dev) + ": " + sd.name;
-                        ImGui::TextUnformatted(disp.c_str());
+                        ImGui::Text("%s: %s", sd.device_name.c_str(), sd.name.c_str());
                         ImGui::TableSetColumnIndex(1);
-                        std::string map_key = std::string((sd.device == HotasReader::SignalDescriptor::DeviceKind::Stick) ? "stick" : "throttle") + ":" + sd.id;
+                        const std::string &map_key = keys.map_key;
                         int mode = 0; auto it = hotas_filter_modes.find(map_key); if (it != hotas_filter_modes.end()) mode = it->second;
-                        ImGui::SetNextItemWidth(120);
-                        if (ImGui::Combo((std::string("##hotas_mode_") + map_key).c_str(), &mode, items, IM_ARRAYSIZE(items))) {
+                        ImGui::SetNextItemWidth(140);
+                        if (ImGui::Combo(keys.combo_id.c_str(), &mode, items, IM_ARRAYSIZE(items))) {
                             hotas_filter_modes[map_key] = mode;
+                            pipeline.set_filter_mode(map_key, mode);
                             filter_dirty = true;
                         }
+                        if (!show_readouts) continue;
+                        ImGui::TableSetColumnIndex(2);
+                        auto ring = g_hid_filtered_rings.find(keys.plot_key);
+                        const SampleAggregate agg = ring != g_hid_filtered_rings.end()
+                            ? ring->second->aggregate(readout_t1 - readout_seconds, readout_t1) : SampleAggregate{};
+                        if (agg.count == 0) ImGui::TextDisabled("-");
+                        else if (sd.analog) ImGui::Text("sd %.4f  peak %.3f", agg.stddev, agg.peak()); // noise of a held axis, largest deflection
+                        else if (sd.bits == 1) ImGui::Text("on %.0f%%", agg.mean * 100.0);
+                        else ImGui::Text("%.0f..%.0f", agg.min, agg.max);
                     }
                     ImGui::EndTable();
                 }
@@ -1127,7 +1604,7 @@ int APIENTRY WinMain(HINSTANCE, HINSTANCE, LPSTR, int) {
                         }
                         // Persist current runtime + filter settings and HOTAS per-signal modes
                         SaveFilterSettings("config/filter_settings.cfg", filter_settings);
-                        SaveHotasFilterModes("config/filter_settings.cfg", hotas.list_signals(), hotas_filter_modes);
+                        SaveHotasFilterModes("config/filter_settings.cfg", hotas.list_signals(), hotas_filter_modes, hotas_biquads);
                         // Update snapshots
                         saved_window_seconds = g_window_seconds;
                         filter_dirty = false;
@@ -1141,6 +1618,9 @@ int APIENTRY WinMain(HINSTANCE, HINSTANCE, LPSTR, int) {
                             // Apply persisted settings to forwarder
                             forwarder.enable_filter(working.enabled);
                             forwarder.set_params(working.analog_delta, working.digital_max_ms/1000.0);
+                            pipeline.set_filter_params(working.analog_delta, working.digital_max_ms);
+                            pipeline.set_coincidence_params(working.coincidence_min_bits, working.coincidence_axis_jump, working.coincidence_hold_ms);
+                            pipeline.set_spike_params(working.spike_k_sigma, working.spike_return);
                         }
                         if (runtime_dirty) {
                             g_window_seconds = saved_window_seconds;
@@ -1187,6 +1667,24 @@ int APIENTRY WinMain(HINSTANCE, HINSTANCE, LPSTR, int) {
             ImGui::End();
         }
 
+        // Log window (Help -> Log): the logger's in-memory tail
+        if (g_show_log_window) {
+            ImGui::Begin("Log", &g_show_log_window);
+            int lvl = (int)hotas_log::level();
+            const char* levels[] = { "debug", "info", "warn", "error" };
+            ImGui::SetNextItemWidth(120.0f);
+            if (ImGui::Combo("Level", &lvl, levels, 4)) hotas_log::set_level((hotas_log::Level)lvl);
+            ImGui::SameLine();
+            ImGui::TextDisabled("dropped: %llu", (unsigned long long)hotas_log::dropped());
+            ImGui::BeginChild("log_lines");
+            for (const auto &l : hotas_log::recent()) {
+                ImGui::Text("%c %-8s %s", "DIWE"[(int)l.level & 3], l.category, l.text.c_str());
+            }
+            if (ImGui::GetScrollY() >= ImGui::GetScrollMaxY()) ImGui::SetScrollHereY(1.0f);
+            ImGui::EndChild();
+            ImGui::End();
+        }
+
         // HOTAS detection window (Help -> Detect Inputs...)
         if (show_hotas_detect_window) {
             ImGui::Begin("Detect HOTAS Devices", &show_hotas_detect_window, ImGuiWindowFlags_NoBackground);
@@ -1207,6 +1705,102 @@ int APIENTRY WinMain(HINSTANCE, HINSTANCE, LPSTR, int) {
                 out.close();
             }
             ImGui::Separator();
+            // Report arrival statistics per device (measured on the reader threads)
+            ImGui::TextUnformatted("Report intervals");
+            ImGui::SameLine();
+            if (ImGui::SmallButton("Reset##report_stats")) hotas.reset_report_stats();
+            ImGui::SameLine();
+            bool rate_auto = g_input_rate_auto.load();
+            if (ImGui::Checkbox("Pace pipeline to detected rate", &rate_auto)) g_input_rate_auto.store(rate_auto);
+            ImGui::SetItemTooltip("Run the pipeline once per report (1-4 ms) and wake the mapper per frame once a fixed report rate is detected.");
+            const auto &stat_devices = hotas.devices();
+            std::vector<ReportIntervalStats::Snapshot> stat_snaps(stat_devices.size());
+            for (size_t d = 0; d < stat_snaps.size(); ++d) stat_snaps[d] = hotas.report_stats((DeviceIndex)d);
+            if (ImGui::BeginTable("report_stats", 9, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_SizingFixedFit)) {
+                const char* cols[] = { "Device", "Reports", "Rate", "Mean ms", "p50 ms", "p99 ms", "Max gap ms", "Duplicates", "Missed (est.)" };
+                for (const char* c : cols) ImGui::TableSetupColumn(c);
+                ImGui::TableHeadersRow();
+                for (size_t d = 0; d < stat_snaps.size(); ++d) {
+                    const auto &st = stat_snaps[d];
+                    ImGui::TableNextRow();
+                    ImGui::TableSetColumnIndex(0); ImGui::TextUnformatted(stat_devices.device((DeviceIndex)d).label.c_str());
+                    ImGui::TableSetColumnIndex(1); ImGui::Text("%llu", (unsigned long long)st.reports);
+                    ImGui::TableSetColumnIndex(2);
+                    if (st.measuring()) ImGui::TextDisabled("measuring");
+                    else if (st.nominal_hz > 0.0) ImGui::Text("%.0f Hz (%.0f ms)", st.nominal_hz, st.nominal_ms);
+                    else ImGui::TextUnformatted("irregular");
+                    ImGui::TableSetColumnIndex(3); ImGui::Text("%.3f", st.mean_ms);
+                    ImGui::TableSetColumnIndex(4); ImGui::Text("%.3f", st.p50_ms);
+                    ImGui::TableSetColumnIndex(5); ImGui::Text("%.3f", st.p99_ms);
+                    ImGui::TableSetColumnIndex(6); ImGui::Text("%.3f", st.max_gap_ms);
+                    ImGui::TableSetColumnIndex(7);
+                    ImGui::Text("%llu (%.0f%%)", (unsigned long long)st.duplicates, st.reports ? 100.0 * (double)st.duplicates / (double)st.reports : 0.0);
+                    ImGui::TableSetColumnIndex(8);
+                    if (st.nominal_hz > 0.0) ImGui::Text("%llu", (unsigned long long)st.missed_estimate);
+                    else ImGui::TextDisabled("-");
+                }
+                ImGui::EndTable();
+            }
+            // Interval histograms (log-spaced buckets, 4 per octave from 64 us)
+            for (size_t d = 0; d < stat_snaps.size(); ++d) {
+                const auto &st = stat_snaps[d];
+                if (st.intervals == 0) continue;
+                float hist[ReportIntervalStats::kBuckets];
+                for (size_t b = 0; b < ReportIntervalStats::kBuckets; ++b) hist[b] = (float)st.histogram[b];
+                char label[96];
+                std::snprintf(label, sizeof(label), "%s##report_hist%zu", stat_devices.device((DeviceIndex)d).label.c_str(), d);
+                ImGui::PlotHistogram(label, hist, (int)ReportIntervalStats::kBuckets, 0, "interval histogram (64 us .. 1 s, log)", 0.0f, FLT_MAX, ImVec2(0, 60));
+            }
+            // Merged frames: how old the stalest other device's report was when one reported
+            const auto skew = frame_merger.skew_stats();
+            ImGui::Text("Merged frames: %llu, skew mean %.2f ms, max %.2f ms, last %.2f ms",
+                        (unsigned long long)skew.frames, skew.mean_ms, skew.max_ms, skew.last_ms);
+            ImGui::Text("Frames with a device silent for %.0f ms or more: %llu; reports dropped by the pipeline: %llu",
+                        frame_merger.skew_bound() * 1000.0, (unsigned long long)skew.over_bound, (unsigned long long)skew.dropped);
+            ImGui::Separator();
+            // Axis health: value/step histograms the pipeline records per analog axis
+            ImGui::TextUnformatted("Axis health");
+            ImGui::SameLine();
+            if (ImGui::SmallButton("Reset##axis_hist")) pipeline.reset_histograms();
+            ImGui::SameLine();
+            static int axis_period = 0;
+            const char* axis_periods[] = { "since reset", "last 10 s", "last 60 s", "last 10 min" };
+            const double axis_period_s[] = { 0.0, 10.0, 60.0, 600.0 };
+            ImGui::SetNextItemWidth(120);
+            if (ImGui::Combo("##axis_period", &axis_period, axis_periods, IM_ARRAYSIZE(axis_periods))) {
+                pipeline.set_histogram_period(axis_period_s[axis_period]);
+            }
+            ImGui::TextDisabled("Sweep an axis slowly end to end: stretches it never reports (red) or leaves by a jump (orange) point at a worn track.");
+            const auto &axis_sigs = pipeline.signals();
+            for (size_t i = 0; i < axis_sigs.size(); ++i) {
+                const AxisHistogram* h = pipeline.axis_histogram(i);
+                if (!h || !pipeline.signal_active(i)) continue;
+                const AxisHistogram::Snapshot hs = h->snapshot();
+                if (hs.samples == 0) continue;
+                ImGui::Text("%s: %s  (%llu samples, %.0f s)", axis_sigs[i].device_name.c_str(), axis_sigs[i].name.c_str(),
+                            (unsigned long long)hs.samples, hs.seconds);
+                frame_vector<HeatMark> marks(&ui_frame_arena());
+                for (const auto &r : hs.dead_spots) marks.push_back(HeatMark{ r.first, r.last, IM_COL32(230, 40, 40, 200) });
+                for (const auto &r : hs.jump_regions) marks.push_back(HeatMark{ r.first, r.last, IM_COL32(255, 150, 0, 200) });
+                DrawHeatStrip(hs.values.data(), hs.bins, marks, 10.0f);
+                ImGui::SetItemTooltip("Value histogram, low to high end of travel (log scale)");
+                DrawHeatStrip(hs.steps.data(), AxisHistogram::kBins, {}, 4.0f);
+                ImGui::SetItemTooltip("Sample-to-sample steps, centered on no change (log scale)");
+                if (hs.measuring()) {
+                    ImGui::TextDisabled("  measuring");
+                    continue;
+                }
+                if (hs.dead_spots.empty() && hs.jump_regions.empty()) ImGui::TextDisabled("  no dead spots or jumps");
+                for (const auto &r : hs.dead_spots) {
+                    ImGui::TextColored(ImVec4(1, 0.3f, 0.3f, 1), "  dead spot at %.1f-%.1f%% of travel (%llu samples)",
+                                       hs.position(r.first) * 100.0, hs.position(r.last) * 100.0, (unsigned long long)r.count);
+                }
+                for (const auto &r : hs.jump_regions) {
+                    ImGui::TextColored(ImVec4(1, 0.6f, 0, 1), "  jumps from %.1f-%.1f%% of travel (%llu)",
+                                       hs.position(r.first) * 100.0, hs.position(r.last) * 100.0, (unsigned long long)r.count);
+                }
+            }
+            ImGui::Separator();
             if (hotas_detect_lines.empty()) {
                 ImGui::TextDisabled("No devices found. Press Refresh to rescan.");
             } else {
@@ -1217,6 +1811,101 @@ int APIENTRY WinMain(HINSTANCE, HINSTANCE, LPSTR, int) {
             ImGui::End();
         }
 
+        // Axis Spectrum window (Help -> Axis Spectrum...): noise spectrum per analog axis,
+        // live from the input rings or from a recorded session, with suggested sections
+        spectrum.set_enabled(false);
+        if (show_spectrum_window) {
+            ImGui::Begin("Axis Spectrum", &show_spectrum_window);
+            ImGui::TextDisabled("Hold the controls still or move them slowly. Peaks above %.0f Hz are hum or interference (notch); a raised floor is hiss (low-pass).",
+                                kSpectrumMotionHz);
+            static int fft_sel = 2;
+            const char* fft_sizes[] = { "256", "512", "1024", "2048" };
+            const size_t fft_n[] = { 256, 512, 1024, 2048 };
+            ImGui::SetNextItemWidth(100);
+            if (ImGui::Combo("FFT size", &fft_sel, fft_sizes, IM_ARRAYSIZE(fft_sizes))) spectrum.set_fft_size(fft_n[fft_sel]);
+            ImGui::SameLine();
+            static int spectrum_source = 0; // 0 = live, 1 = recording
+            ImGui::RadioButton("Live", &spectrum_source, 0);
+            ImGui::SameLine();
+            ImGui::RadioButton("Recording", &spectrum_source, 1);
+            static char recording_path[260] = "hotas.hidrec";
+            static std::vector<SpectrumWorker::Entry> recorded;
+            static std::string recording_status;
+            if (spectrum_source == 1) {
+                ImGui::SetNextItemWidth(300);
+                ImGui::InputText("##recording_path", recording_path, sizeof(recording_path));
+                ImGui::SameLine();
+                if (ImGui::Button("Analyze")) {
+                    std::vector<RecordedReport> reports;
+                    std::string err;
+                    recorded.clear();
+                    if (!load_report_recording(recording_path, reports, &err)) {
+                        recording_status = err;
+                    } else {
+                        std::stable_sort(reports.begin(), reports.end(), [](const RecordedReport& a, const RecordedReport& b) { return a.t < b.t; });
+                        const auto inputs = recorded_analog_inputs(pipeline.signals(), reports);
+                        for (const auto &src : spectrum_sources) {
+                            if (inputs[src.descriptor].empty()) continue;
+                            SpectrumWorker::Entry e;
+                            e.source = src;
+                            e.valid = analyze_spectrum(inputs[src.descriptor], fft_n[fft_sel], e.result, src.full_range);
+                            recorded.push_back(std::move(e));
+                        }
+                        recording_status = std::to_string(reports.size()) + " reports, " + std::to_string(recorded.size()) + " axes";
+                    }
+                }
+                if (!recording_status.empty()) ImGui::TextDisabled("%s", recording_status.c_str());
+            }
+            spectrum.set_enabled(spectrum_source == 0);
+            const std::vector<SpectrumWorker::Entry> entries = spectrum_source == 0 ? spectrum.results() : recorded;
+            const auto &spec_sigs = pipeline.signals();
+            static std::vector<float> spec_hz;
+            for (const auto &e : entries) {
+                if (spectrum_source == 0 && !pipeline.signal_active(e.source.descriptor)) continue;
+                const auto &sd = spec_sigs[e.source.descriptor];
+                const std::string map_key = sd.device_name + ":" + sd.id;
+                ImGui::PushID(map_key.c_str());
+                ImGui::SeparatorText(e.source.name.c_str());
+                if (!e.valid) {
+                    ImGui::TextDisabled("  collecting samples");
+                    ImGui::PopID();
+                    continue;
+                }
+                const SpectrumResult &r = e.result;
+                spec_hz.resize(r.power_db.size());
+                for (size_t k = 0; k < spec_hz.size(); ++k) spec_hz[k] = (float)(k * r.bin_hz);
+                if (ImPlot::BeginPlot("##spectrum", ImVec2(-1, 140), ImPlotFlags_NoTitle | ImPlotFlags_NoLegend)) {
+                    ImPlot::SetupAxes("Hz", "dB", 0, ImPlotAxisFlags_AutoFit);
+                    ImPlot::SetupAxisLimits(ImAxis_X1, 0, r.fs * 0.5, ImGuiCond_Always);
+                    ImPlot::PlotLine("power", spec_hz.data(), r.power_db.data(), (int)spec_hz.size());
+                    ImPlot::EndPlot();
+                }
+                ImGui::TextDisabled("  %.0f Hz sampling, %zu segments, floor %.1f dB, %.4f rms above %.0f Hz", r.fs, r.segments, r.floor_db,
+                                    r.hf_rms, kSpectrumMotionHz);
+                for (const auto &p : r.peaks) ImGui::TextDisabled("  peak %.1f Hz, %.0f dB above the floor", p.hz, p.prominence_db);
+                const BiquadChainSpec applied = pipeline.biquad_chain(e.source.descriptor);
+                ImGui::Text("  Suggested: %s (%s)", format_biquad_chain(r.suggestion).c_str(), r.reason.c_str());
+                ImGui::Text("  Applied: %s", format_biquad_chain(applied).c_str());
+                ImGui::BeginDisabled(r.suggestion.empty() || r.suggestion == applied);
+                if (ImGui::SmallButton("Apply suggestion")) {
+                    hotas_biquads[map_key] = r.suggestion;
+                    pipeline.set_biquad_chain(map_key, r.suggestion);
+                    filter_dirty = true;
+                }
+                ImGui::EndDisabled();
+                ImGui::SameLine();
+                ImGui::BeginDisabled(applied.empty());
+                if (ImGui::SmallButton("Clear")) {
+                    hotas_biquads.erase(map_key);
+                    pipeline.set_biquad_chain(map_key, BiquadChainSpec{});
+                    filter_dirty = true;
+                }
+                ImGui::EndDisabled();
+                ImGui::PopID();
+            }
+            ImGui::End();
+        }
+
         // Mappings window (Edit -> Mappings...)
         if (show_mappings_window) {
             ImGui::Begin("Mappings", &show_mappings_window);
@@ -1239,61 +1928,28 @@ int APIENTRY WinMain(HINSTANCE, HINSTANCE, LPSTR, int) {
 
             // Add mapping form
             static char new_id[64] = "m1";
-            static int device_sel = 0; // 0=All,1=Stick,2=Throttle
-            const char* device_names[] = { "All", "Stick", "Throttle" };
-            ImGui::Combo("Device", &device_sel, device_names, IM_ARRAYSIZE(device_names));
-            ImGui::SetItemTooltip("Filter HOTAS signals by device: All (all signals), Stick (joystick inputs), or Throttle (throttle/quadrant inputs)");
-
-            // Build signal list from HotasReader signals filtered by DeviceKind
-            auto sigs = hotas.list_signals();
-            struct SigChoice { std::string id; std::string display; };
-            std::vector<SigChoice> sig_choices; sig_choices.reserve(sigs.size());
-            for (const auto &sd : sigs) {
-                bool include = (device_sel == 0) ||
-                               (device_sel == 1 && sd.device == HotasReader::SignalDescriptor::DeviceKind::Stick) ||
-                               (device_sel == 2 && sd.device == HotasReader::SignalDescriptor::DeviceKind::Throttle);
-                if (!include) continue;
-                SigChoice ch;
-                ch.id = std::string(device_prefix(sd.device)) + ":" + sd.id; // always device-prefixed for unambiguous mapping
-                ch.display = sd.name + std::string(" (") + sd.id + ")";
-                sig_choices.push_back(std::move(ch));
-            }
-            // Append virtual sub-signals for HATs and POV so users can bind per-direction inputs
-            auto append_sub = [&](const char* devp, const char* base, const char* pretty){
-                const char* dirs[][2] = { {"UP","Up"}, {"RIGHT","Right"}, {"DOWN","Down"}, {"LEFT","Left"} };
-                for (int i=0;i<4;++i) {
-                    SigChoice ch; ch.id = std::string(devp) + ":" + base + "_" + dirs[i][0];
-                    ch.display = std::string(pretty) + " " + dirs[i][1] + " (" + base + "_" + dirs[i][0] + ")";
-                    sig_choices.push_back(std::move(ch));
-                }
-            };
-            auto append_pov = [&](const char* devp){
-                const char* povs[] = {"POV_UP","POV_RIGHT","POV_DOWN","POV_LEFT","POV_UP_RIGHT","POV_DOWN_RIGHT","POV_DOWN_LEFT","POV_UP_LEFT"};
-                const char* labels[] = {"POV Up","POV Right","POV Down","POV Left","POV Up-Right","POV Down-Right","POV Down-Left","POV Up-Left"};
-                for (int i=0;i<8;++i) {
-                    SigChoice ch; ch.id = std::string(devp) + ":" + povs[i]; ch.display = std::string(labels[i]) + " (" + povs[i] + ")"; sig_choices.push_back(std::move(ch));
-                }
-            };
-            // Device filter for sub-signals
-            if (device_sel == 0 || device_sel == 1) {
-                append_sub("stick","H1","H1");
-                append_sub("stick","H2","H2");
-                append_pov("stick");
-            }
-            if (device_sel == 0 || device_sel == 2) {
-                append_sub("throttle","H3","H3");
-                append_sub("throttle","H4","H4");
+            static int device_sel = 0; // 0=All, i+1 = registry device i
+            {
+                frame_vector<const char*> device_names(&ui_frame_arena());
+                device_names.push_back("All");
+                for (const auto &def : hotas.devices().devices()) device_names.push_back(def.label.c_str());
+                if (device_sel >= (int)device_names.size()) device_sel = 0;
+                ImGui::Combo("Device", &device_sel, device_names.data(), (int)device_names.size());
             }
-            if (sig_choices.empty()) {
-                for (const auto &sd : sigs) {
-                    SigChoice ch; ch.id = std::string(device_prefix(sd.device)) + ":" + sd.id; ch.display = sd.name + std::string(" (") + sd.id + ")";
-                    sig_choices.push_back(std::move(ch));
-                }
+            ImGui::SetItemTooltip("Filter HOTAS signals by device: All (all signals) or one of the registered devices");
+
+            // Signal list from the pipeline outputs (descriptors plus HAT/POV directions), rebuilt
+            // when the device selection changes (the outputs are fixed after startup)
+            static std::vector<SigChoice> sig_choices;
+            static int sig_choices_device = -1;
+            if (sig_choices_device != device_sel) {
+                sig_choices = BuildSignalChoices(pipeline, device_sel);
+                sig_choices_device = device_sel;
             }
 
             static int sig_sel = 0;
             if (sig_sel >= (int)sig_choices.size()) sig_sel = 0;
-            std::vector<const char*> sig_items; sig_items.reserve(sig_choices.size());
+            frame_vector<const char*> sig_items(&ui_frame_arena()); sig_items.reserve(sig_choices.size());
             for (auto &ch : sig_choices) sig_items.push_back(ch.display.c_str());
 
             ImGui::InputText("Mapping ID", new_id, sizeof(new_id));
@@ -1465,62 +2121,25 @@ int APIENTRY WinMain(HINSTANCE, HINSTANCE, LPSTR, int) {
                     // Remove button per row
                     ImGui::TableNextRow();
                     ImGui::TableSetColumnIndex(0);
-                    if (ImGui::SmallButton((std::string("Remove##") + me.id).c_str())) {
+                    if (ImGui::SmallButton(ui_frame_arena().format("Remove##%s", me.id.c_str()))) {
                         hotas_mapper.remove_mapping(me.id);
                     }
                     ImGui::SameLine();
-                    if (ImGui::SmallButton((std::string("Edit##") + me.id).c_str())) {
+                    if (ImGui::SmallButton(ui_frame_arena().format("Edit##%s", me.id.c_str()))) {
                         // Prefill form with this entry
                         strncpy(new_id, me.id.c_str(), sizeof(new_id)-1); new_id[sizeof(new_id)-1] = '\0';
                         // signal id device prefix -> device selector and list index
-                        int dev_for_sig = 0; // 1=Stick,2=Throttle
                         std::string sid = me.signal_id;
-                        std::string base_id = sid;
-                        if (sid.rfind("stick:",0) == 0) { dev_for_sig = 1; base_id = sid.substr(6); }
-                        else if (sid.rfind("throttle:",0) == 0) { dev_for_sig = 2; base_id = sid.substr(9); }
-                        device_sel = dev_for_sig;
-                        // rebuild choices (including sub-signals) and pick matching
-                        sig_choices.clear(); sig_items.clear();
-                        auto sigs2 = hotas.list_signals();
-                        for (const auto &sd : sigs2) {
-                            bool include = (device_sel == 0) ||
-                                           (device_sel == 1 && sd.device == HotasReader::SignalDescriptor::DeviceKind::Stick) ||
-                                           (device_sel == 2 && sd.device == HotasReader::SignalDescriptor::DeviceKind::Throttle);
-                            if (!include) continue;
-                            SigChoice ch; ch.id = std::string(device_prefix(sd.device)) + ":" + sd.id; ch.display = sd.name + std::string(" (") + sd.id + ")";
-                            if (sd.id == base_id) sig_sel = (int)sig_choices.size();
-                            sig_choices.push_back(std::move(ch));
-                        }
-                        // Append sub-signals for selection
-                        if (device_sel == 0 || device_sel == 1) {
-                            auto add_and_match = [&](const std::string &id, const std::string &disp){ SigChoice ch{ id, disp }; if (sid == id) sig_sel = (int)sig_choices.size(); sig_choices.push_back(std::move(ch)); };
-                            add_and_match("stick:H1_UP","H1 Up (H1_UP)");
-                            add_and_match("stick:H1_RIGHT","H1 Right (H1_RIGHT)");
-                            add_and_match("stick:H1_DOWN","H1 Down (H1_DOWN)");
-                            add_and_match("stick:H1_LEFT","H1 Left (H1_LEFT)");
-                            add_and_match("stick:H2_UP","H2 Up (H2_UP)");
-                            add_and_match("stick:H2_RIGHT","H2 Right (H2_RIGHT)");
-                            add_and_match("stick:H2_DOWN","H2 Down (H2_DOWN)");
-                            add_and_match("stick:H2_LEFT","H2 Left (H2_LEFT)");
-                            add_and_match("stick:POV_UP","POV Up (POV_UP)");
-                            add_and_match("stick:POV_RIGHT","POV Right (POV_RIGHT)");
-                            add_and_match("stick:POV_DOWN","POV Down (POV_DOWN)");
-                            add_and_match("stick:POV_LEFT","POV Left (POV_LEFT)");
-                            add_and_match("stick:POV_UP_RIGHT","POV Up-Right (POV_UP_RIGHT)");
-                            add_and_match("stick:POV_DOWN_RIGHT","POV Down-Right (POV_DOWN_RIGHT)");
-                            add_and_match("stick:POV_DOWN_LEFT","POV Down-Left (POV_DOWN_LEFT)");
-                            add_and_match("stick:POV_UP_LEFT","POV Up-Left (POV_UP_LEFT)");
-                        }
-                        if (device_sel == 0 || device_sel == 2) {
-                            auto add_and_match = [&](const std::string &id, const std::string &disp){ SigChoice ch{ id, disp }; if (sid == id) sig_sel = (int)sig_choices.size(); sig_choices.push_back(std::move(ch)); };
-                            add_and_match("throttle:H3_UP","H3 Up (H3_UP)");
-                            add_and_match("throttle:H3_RIGHT","H3 Right (H3_RIGHT)");
-                            add_and_match("throttle:H3_DOWN","H3 Down (H3_DOWN)");
-                            add_and_match("throttle:H3_LEFT","H3 Left (H3_LEFT)");
-                            add_and_match("throttle:H4_UP","H4 Up (H4_UP)");
-                            add_and_match("throttle:H4_RIGHT","H4 Right (H4_RIGHT)");
-                            add_and_match("throttle:H4_DOWN","H4 Down (H4_DOWN)");
-                            add_and_match("throttle:H4_LEFT","H4 Left (H4_LEFT)");
+                        const size_t colon = sid.find(':');
+                        const int dev_for_sig = colon == std::string::npos ? -1 : hotas.devices().find(sid.substr(0, colon));
+                        device_sel = dev_for_sig + 1;
+                        // rebuild choices (including sub-signals) and pick matching; legacy ids have no prefix
+                        sig_choices = BuildSignalChoices(pipeline, device_sel);
+                        sig_choices_device = device_sel;
+                        for (size_t c = 0; c < sig_choices.size(); ++c) {
+                            const std::string &id = sig_choices[c].id;
+                            if (id == sid || (colon == std::string::npos && id.size() > sid.size() && id.compare(id.size() - sid.size(), sid.size(), sid) == 0 &&
+                                              id[id.size() - sid.size() - 1] == ':')) { sig_sel = (int)c; break; }
                         }
                         sig_items.clear(); sig_items.reserve(sig_choices.size());
                         for (auto &ch : sig_choices) sig_items.push_back(ch.display.c_str());
@@ -1556,62 +2175,43 @@ int APIENTRY WinMain(HINSTANCE, HINSTANCE, LPSTR, int) {
         }
         // Stick window: parse HID live hex and show raw integer graphs for stick inputs
         ImGui::Begin("Stick", nullptr, ImGuiWindowFlags_NoBackground);
-        // Build maps dynamically from HotasReader::list_signals() (CSV-driven)
-        struct HidInputMap { std::string id; std::string name; int bit_start; int bits; bool analog; };
-        std::vector<HidInputMap> stick_map;
-        std::vector<HidInputMap> throttle_map;
-        {
-            auto sigs = hotas.list_signals();
-            for (const auto &sd : sigs) {
-                HidInputMap m{ sd.id, sd.name, sd.bit_start, sd.bits, sd.analog };
-                if (sd.device == HotasReader::SignalDescriptor::DeviceKind::Stick) stick_map.push_back(m);
-                else throttle_map.push_back(m);
+        // Build maps from HotasReader::list_signals() (CSV-driven, fixed after startup) once,
+        // with the "<device>:<name>" buffer keys
+        struct HidInputMap { std::string id; std::string name; std::string key; int bit_start; int bits; bool analog; SignalNorm norm; };
+        const auto &registry = hotas.devices();
+        static std::vector<std::vector<HidInputMap>> device_maps; // by device index
+        if (device_maps.size() != registry.size()) {
+            device_maps.assign(registry.size(), {});
+            for (const auto &sd : hotas.list_signals()) {
+                if (sd.device < device_maps.size())
+                    device_maps[sd.device].push_back(HidInputMap{ sd.id, sd.name, sd.device_name + ":" + sd.name, sd.bit_start, sd.bits, sd.analog, sd.norm });
             }
         }
 
-        // Per-signal sample buffers (shared)
-
-        // Helper: parse hex string to bytes
-        auto hex_to_bytes = [&](const std::string &hex, std::vector<uint8_t> &out) {
-            out.clear();
-            auto hexval = [](char c)->int {
-                if (c >= '0' && c <= '9') return c - '0';
-                if (c >= 'a' && c <= 'f') return 10 + (c - 'a');
-                if (c >= 'A' && c <= 'F') return 10 + (c - 'A');
-                return 0;
-            };
-            for (size_t i = 0; i + 1 < hex.size(); i += 2) {
-                int hi = hexval(hex[i]), lo = hexval(hex[i+1]);
-                out.push_back((uint8_t)((hi << 4) | lo));
-            }
-        };
-
-        // Acquire latest HID live snapshot and extract stick and throttle reports separately
-        auto hid_snap = hotas.get_hid_live_snapshot();
-        std::vector<uint8_t> stick_bytes;
-        std::vector<uint8_t> throttle_bytes;
-        bool have_stick_report = false;
-        bool have_throttle_report = false;
-        for (auto &p : hid_snap) {
-            const std::string &path = p.first;
-            const std::string &hex = p.second;
-            if (hex.empty() || hex == "(no data yet)") continue;
-            if (path.find("vid_0738&pid_2221") != std::string::npos && path.find("mi_00") != std::string::npos) {
-                hex_to_bytes(hex, stick_bytes);
-                have_stick_report = !stick_bytes.empty();
-            } else if (path.find("vid_0738&pid_a221") != std::string::npos && path.find("mi_00") != std::string::npos) {
-                hex_to_bytes(hex, throttle_bytes);
-                have_throttle_report = !throttle_bytes.empty();
-            }
-        }
+        // Latest raw report of each device's report interface (buffers reused across frames;
+        // path -> device matches cached, matching lower-cases the path)
+        static std::vector<std::vector<uint8_t>> device_bytes;
+        static std::unordered_map<std::string, DeviceMatch> path_matches;
+        device_bytes.resize(registry.size());
+        for (auto &b : device_bytes) b.clear();
+        bool have_any_report = false;
+        hotas.visit_hid_live([&](const std::string &path, const uint8_t *data, size_t len) {
+            if (len == 0) return;
+            auto pm = path_matches.find(path);
+            if (pm == path_matches.end()) pm = path_matches.emplace(path, registry.match(path)).first;
+            const DeviceMatch dm = pm->second;
+            if (!dm || !dm.report_interface) return;
+            device_bytes[(size_t)dm.device].assign(data, data + len);
+            have_any_report = true;
+        });
 
         double now_ts = hotas.latest_time();
-        if (!have_stick_report && !have_throttle_report) {
-            ImGui::TextDisabled("No HID stick/throttle reports available yet.");
+        if (!have_any_report) {
+            ImGui::TextDisabled("No HID reports available yet.");
         } else {
             double window = g_window_seconds;
             double t0 = now_ts - window;
-            auto extract_and_store = [&](const std::vector<HidInputMap>& maps, const std::vector<uint8_t>& bytes, const char* devpref) {
+            auto extract_and_store = [&](const std::vector<HidInputMap>& maps, const std::vector<uint8_t>& bytes) {
                 if (bytes.empty()) return;
                 for (auto &m : maps) {
                     uint64_t val = 0;
@@ -1628,21 +2228,10 @@ int APIENTRY WinMain(HINSTANCE, HINSTANCE, LPSTR, int) {
                     }
                     double plotted = 0.0;
                     double y_min = 0.0, y_max = 1.0;
-                    std::string mid(m.id);
-                    // Normalize specific analogs
-                    if (mid == "joy_x" || mid == "joy_y" || mid == "joy_z") {
-                        // 12-16 bit unsig -> -1..1
-                        double maxv = (double)((1ULL << m.bits) - 1);
-                        plotted = (maxv > 0.0) ? (double)val / maxv * 2.0 - 1.0 : 0.0;
-                        y_min = -1.0; y_max = 1.0;
-                    } else if (mid == "c_joy_x" || mid == "c_joy_y" || mid == "thumb_joy_x" || mid == "thumb_joy_y") {
-                        // 8-bit joystick-like -> -1..1
-                        plotted = ((double)val / 255.0) * 2.0 - 1.0;
-                        y_min = -1.0; y_max = 1.0;
-                    } else if (mid == "left_throttle" || mid == "right_throttle") {
-                        // 10-bit throttle -> treat as joystick axis: -1..1
-                        double maxv = (double)((1ULL << m.bits) - 1);
-                        plotted = (maxv > 0.0) ? (double)val / maxv * 2.0 - 1.0 : 0.0;
+                    // Normalize as the device definition says (same as the pipeline)
+                    if (m.norm != SignalNorm::Raw) {
+                        // full-scale, 8-bit or signed -> -1..1
+                        plotted = normalize_signal(m.norm, val, m.bits);
                         y_min = -1.0; y_max = 1.0;
                     } else if (m.analog) {
                         // Other analogs: plot raw 0..(2^bits-1)
@@ -1653,7 +2242,7 @@ int APIENTRY WinMain(HINSTANCE, HINSTANCE, LPSTR, int) {
                         y_min = 0.0; y_max = (double)((1ULL << m.bits) - 1);
                         plotted = (double)val;
                     }
-                    HidBuf &b = g_hid_buffers[std::string(devpref) + ":" + m.name];
+                    HidBuf &b = g_hid_buffers[m.key];
                     b.t.push_back(now_ts);
                     b.v.push_back(plotted);
                     size_t first_keep = 0;
@@ -1664,8 +2253,7 @@ int APIENTRY WinMain(HINSTANCE, HINSTANCE, LPSTR, int) {
                     }
                 }
             };
-            if (have_stick_report) extract_and_store(stick_map, stick_bytes, "stick");
-            if (have_throttle_report) extract_and_store(throttle_map, throttle_bytes, "throttle");
+            for (size_t d = 0; d < registry.size(); ++d) extract_and_store(device_maps[d], device_bytes[d]);
 
             // Grouped plots per request (using common PlotHidGroup helper)
 
@@ -1725,6 +2313,36 @@ int APIENTRY WinMain(HINSTANCE, HINSTANCE, LPSTR, int) {
         }
         ImGui::End();
 
+        // Devices other than the X56 halves (from config/devices): generic plot groups per device
+        {
+            static const DeviceRegistry x56_builtin = DeviceRegistry::x56();
+            bool window_open = false;
+            const double window = g_window_seconds;
+            const double t0 = hotas.latest_time() - window;
+            for (size_t d = 0; d < registry.size(); ++d) {
+                const DeviceDefinition &def = registry.device((DeviceIndex)d);
+                if (x56_builtin.find_usb(def.vid, def.pid) >= 0 || device_maps[d].empty()) continue;
+                if (!window_open) { ImGui::Begin("Devices", nullptr, ImGuiWindowFlags_NoBackground); window_open = true; }
+                ImGui::SeparatorText(def.label.c_str());
+                double raw_max = 1.0;
+                FrameArena &arena = ui_frame_arena();
+                frame_vector<std::pair<const char*, const char*>> axes(&arena), analogs(&arena), buttons(&arena), multi(&arena);
+                for (const auto &m : device_maps[d]) {
+                    const std::pair<const char*, const char*> series{ m.key.c_str(), m.name.c_str() };
+                    if (m.norm != SignalNorm::Raw) axes.push_back(series);
+                    else if (m.analog) { analogs.push_back(series); raw_max = std::max(raw_max, (double)((1ULL << m.bits) - 1)); }
+                    else if (m.bits == 1) buttons.push_back(series);
+                    else multi.push_back(series);
+                }
+                const char *dev = def.name.c_str();
+                PlotHidGroup(arena.format("Axes##dev_%s", dev), g_hid_buffers, axes, window, t0, -1.0f, 1.0f);
+                PlotHidGroup(arena.format("Analog##dev_%s", dev), g_hid_buffers, analogs, window, t0, 0.0f, (float)raw_max);
+                PlotHidGroup(arena.format("Buttons##dev_%s", dev), g_hid_buffers, buttons, window, t0, 0.0f, 1.0f);
+                PlotHidGroup(arena.format("Hats##dev_%s", dev), g_hid_buffers, multi, window, t0, 0.0f, 15.0f);
+            }
+            if (window_open) ImGui::End();
+        }
+
         // HID Live monitor (temporary) - only visible in Developer View
         static bool hid_live_running = false;
         if (show_developer_view) {
@@ -1746,56 +2364,51 @@ int APIENTRY WinMain(HINSTANCE, HINSTANCE, LPSTR, int) {
             ImGui::TableSetupColumn("Device Path", ImGuiTableColumnFlags_WidthStretch, 0.7f);
             ImGui::TableSetupColumn("Last Report (hex)", ImGuiTableColumnFlags_WidthStretch, 0.3f);
             ImGui::TableHeadersRow();
-            auto live_snap = hotas.get_hid_live_snapshot();
-            for (auto &p : live_snap) {
+            // Copy the reports out under the reader lock (into the frame arena), draw after
+            struct LiveRow { const char *path; const uint8_t *bytes; size_t len; };
+            FrameArena &arena = ui_frame_arena();
+            frame_vector<LiveRow> live_rows(&arena);
+            hotas.visit_hid_live([&](const std::string &path, const uint8_t *data, size_t len) {
+                uint8_t *copy = static_cast<uint8_t*>(arena.allocate(len ? len : 1, 1));
+                std::copy(data, data + len, copy);
+                live_rows.push_back(LiveRow{ arena.format("%s", path.c_str()), copy, len });
+            });
+            for (const auto &p : live_rows) {
                 ImGui::TableNextRow();
                 ImGui::TableSetColumnIndex(0);
-                ImGui::TextUnformatted(p.first.c_str());
+                ImGui::TextUnformatted(p.path);
                 ImGui::TableSetColumnIndex(1);
                 // Right cell: show raw hex and below render tables of 8-bit groups
-                if (p.second.empty() || p.second == "(no data yet)") {
-                    ImGui::TextUnformatted(p.second.c_str());
+                if (p.len == 0) {
+                    ImGui::TextUnformatted("(no data yet)");
                 } else {
-                    const std::string &hex = p.second;
                     // Show grouped hex bytes on one line
-                    std::string grouped;
-                    for (size_t i = 0; i + 1 < hex.size(); i += 2) {
-                        if (!grouped.empty()) grouped += ' ';
-                        grouped += hex.substr(i, 2);
-                    }
-                    ImGui::TextUnformatted(grouped.c_str());
-
-                    // Convert hex string to bytes
-                    auto hexval = [&](char c)->int {
-                        if (c >= '0' && c <= '9') return c - '0';
-                        if (c >= 'a' && c <= 'f') return 10 + (c - 'a');
-                        if (c >= 'A' && c <= 'F') return 10 + (c - 'A');
-                        return 0;
-                    };
-                    std::vector<uint8_t> live_bytes;
-                    for (size_t i = 0; i + 1 < hex.size(); i += 2) {
-                        int v = (hexval(hex[i]) << 4) | hexval(hex[i+1]);
-                        live_bytes.push_back((uint8_t)v);
+                    static const char digits[] = "0123456789abcdef";
+                    char *grouped = static_cast<char*>(arena.allocate(p.len * 3, 1));
+                    for (size_t i = 0; i < p.len; ++i) {
+                        grouped[i * 3] = digits[p.bytes[i] >> 4];
+                        grouped[i * 3 + 1] = digits[p.bytes[i] & 15];
+                        grouped[i * 3 + 2] = ' ';
                     }
+                    grouped[p.len * 3 - 1] = '\0';
+                    ImGui::TextUnformatted(grouped);
 
-                    size_t total_bits = live_bytes.size() * 8;
-                    if (total_bits == 0) continue;
+                    const uint8_t *live_bytes = p.bytes;
+                    size_t total_bits = p.len * 8;
                     size_t tables = (total_bits + 7) / 8; // number of 8-bit tables
 
                     // Render tables vertically (stacked), each table is 2 rows x 8 cols
                     for (size_t t = 0; t < tables; ++t) {
                         // Each child gets a unique id using both device path and table index
-                        std::string child_id = std::string("hidlive_tbl_") + p.first + "_" + std::to_string(t);
-                        std::string table_id = std::string("tbl_") + p.first + "_" + std::to_string(t);
-                        ImGui::BeginChild(child_id.c_str(), ImVec2(0, 60), true);
-                        if (ImGui::BeginTable(table_id.c_str(), 8, ImGuiTableFlags_SizingFixedFit)) {
+                        ImGui::BeginChild(arena.format("hidlive_tbl_%s_%zu", p.path, t), ImVec2(0, 60), true);
+                        if (ImGui::BeginTable(arena.format("tbl_%s_%zu", p.path, t), 8, ImGuiTableFlags_SizingFixedFit)) {
                             // First row: global bit indices
                             ImGui::TableNextRow();
                             for (int c = 0; c < 8; ++c) {
                                 size_t bit_global = t * 8 + c;
                                 ImGui::TableSetColumnIndex(c);
                                 if (bit_global < total_bits) {
-                                    ImGui::TextUnformatted(std::to_string(bit_global).c_str());
+                                    ImGui::Text("%zu", bit_global);
                                 } else {
                                     ImGui::TextUnformatted("");
                                 }
@@ -1834,11 +2447,60 @@ int APIENTRY WinMain(HINSTANCE, HINSTANCE, LPSTR, int) {
             }
         }
 
-        ImGui::Begin("Filtered Signals", nullptr, ImGuiWindowFlags_NoBackground);
-        {
+        update_mapping_interest();
+        // Plotted series are only evaluated while the window is visible (hidden ones keep no history)
+        plot_interest.clear();
+        if (ImGui::Begin("Filtered Signals", nullptr, ImGuiWindowFlags_NoBackground)) {
+            g_plot_interest = &plot_interest;
             double window = g_window_seconds;
             double latest = hotas.latest_time();
             double t0 = latest - window;
+            refresh_filtered_buffers(window);
+            // The window as one table: the filtered HOTAS outputs in use next to the controller
+            // signals they drive, a row at every sample time of any of them (held values)
+            static std::string window_export_status;
+            if (ImGui::SmallButton("Export window CSV")) {
+                std::vector<const SampleRing*> rings;
+                std::vector<std::string> names;
+                for (const auto &out : pipeline.outputs()) {
+                    auto it = g_hid_filtered_rings.find(out.plot_key);
+                    if (it == g_hid_filtered_rings.end() || out.descriptor < 0 || !pipeline.signal_active((size_t)out.descriptor)) continue;
+                    rings.push_back(it->second);
+                    names.push_back(out.plot_key);
+                }
+                for (size_t k = 0; k < SignalCount; ++k) {
+                    rings.push_back(&poller.ring((Signal)k));
+                    names.push_back(std::string("x360:") + SIGNAL_META[k].name);
+                }
+                const double t1 = g_hid_filtered_latest.load(std::memory_order_acquire);
+                AlignedWindow table;
+                aligned_window(rings, t1 - window, t1, 0.0, AlignInterp::Hold, table);
+                std::ofstream csv("hotas_window.csv", std::ios::out | std::ios::trunc);
+                if (!csv) {
+                    window_export_status = "could not write hotas_window.csv";
+                } else {
+                    csv << "t";
+                    for (const auto &nm : names) csv << "," << nm;
+                    csv << "\n";
+                    char cell[32];
+                    for (size_t r = 0; r < table.rows(); ++r) {
+                        std::snprintf(cell, sizeof(cell), "%.6f", table.t[r] - (t1 - window));
+                        csv << cell;
+                        for (const auto &col : table.columns) {
+                            csv << ",";
+                            if (std::isnan(col[r])) continue;
+                            std::snprintf(cell, sizeof(cell), "%.6g", col[r]);
+                            csv << cell;
+                        }
+                        csv << "\n";
+                    }
+                    window_export_status = "wrote hotas_window.csv (" + std::to_string(table.rows()) + " rows, " + std::to_string(names.size()) + " signals)";
+                }
+            }
+            if (!window_export_status.empty()) {
+                ImGui::SameLine();
+                ImGui::TextDisabled("%s", window_export_status.c_str());
+            }
             // Reuse the same groupings as raw Stick/Throttle using filtered buffers
             PlotHidGroup("Joy Stick (filtered)", g_hid_filtered_buffers, { {"stick:JOY_X","x"}, {"stick:JOY_Y","y"}, {"stick:JOY_Z","z"} }, window, t0, -1.0f, 1.0f);
             PlotHidGroup("C-Joy (filtered)", g_hid_filtered_buffers, { {"stick:C_JOY_X","x"}, {"stick:C_JOY_Y","y"} }, window, t0, -1.0f, 1.0f);
@@ -1878,8 +2540,13 @@ int APIENTRY WinMain(HINSTANCE, HINSTANCE, LPSTR, int) {
             PlotHidGroup("H4 (filtered)", g_hid_filtered_buffers, {
                 {"throttle:H4_UP","Up"}, {"throttle:H4_RIGHT","Right"}, {"throttle:H4_DOWN","Down"}, {"throttle:H4_LEFT","Left"}
             }, window, t0, 0.0f, 1.0f);
+            g_plot_interest = nullptr;
         }
         ImGui::End();
+        if (plot_interest != plot_interest_sent) {
+            signal_bus.set_interest(bus_plots, plot_interest);
+            plot_interest_sent.assign(plot_interest);
+        }
 
         // Render plots window
 
@@ -1892,13 +2559,18 @@ int APIENTRY WinMain(HINSTANCE, HINSTANCE, LPSTR, int) {
     }
 
     // Shutdown background HOTAS thread and resources
+    hotas_watchdog::stop();
+    hotas_watchdog::set_stall_handler(nullptr);
     hotas_bg_enabled.store(false, std::memory_order_release);
     hotas_bg_thread_running.store(false, std::memory_order_release);
     if (hotas_background_thread.joinable()) hotas_background_thread.join();
+    spectrum.stop();
     hotas.stop_hid_live();
+    hotas.set_liveness_handler(nullptr);
     hotas_mapper.stop();
     
     poller.stop();
+    hotas_log::stop();
     // No auto-save on exit; user must press Save.
     timeEndPeriod(1);
 
@@ -0,0 +1,69 @@
+#include "plot_series.hpp"
+
+namespace {
+
+// Shared by the heap and the frame-arena (pmr) overloads
+template <class Vec>
+void stride_downsample_impl(const std::vector<Sample>& in, int max_points, Vec& xt, Vec& yv) {
+    xt.clear(); yv.clear();
+    if ((int)in.size() <= max_points || max_points <= 0) {
+        xt.reserve(in.size()); yv.reserve(in.size());
+        for (auto &s : in) { xt.push_back(s.t); yv.push_back(s.v); }
+        return;
+    }
+    double step = (double)in.size() / (double)max_points;
+    xt.reserve(max_points+1); yv.reserve(max_points+1);
+    double i = 0.0; size_t n = in.size();
+    while ((size_t)i < n) {
+        size_t idx = (size_t)i;
+        const auto &s = in[idx];
+        xt.push_back(s.t); yv.push_back(s.v);
+        i += step;
+    }
+    if (xt.back() != in.back().t) { xt.push_back(in.back().t); yv.push_back(in.back().v); }
+}
+
+// Build step series from baseline+edges sample array. Assumes 'in' is time-ordered.
+template <class Vec>
+void build_step_series_impl(const std::vector<Sample>& in, double t0, double window_end, Vec& x, Vec& y) {
+    x.clear(); y.clear();
+    if (in.empty()) return;
+    // Start with first sample (baseline)
+    float current = in.front().v;
+    double prev_t = in.front().t;
+    // Anchor at window start if baseline precedes it
+    if (prev_t < t0) {
+        prev_t = t0;
+    }
+    x.push_back(prev_t - t0); y.push_back(current);
+    for (size_t i = 1; i < in.size(); ++i) {
+        const auto &s = in[i];
+        double t = s.t;
+        if (t < t0) continue; // still before window
+        if (s.v == current) continue; // no change (shouldn't happen if edges only, but safe)
+        // Vertical step: duplicate time with old then new value
+        double rel_t = t - t0;
+        x.push_back(rel_t); y.push_back(current); // hold previous until change
+        current = s.v;
+        x.push_back(rel_t); y.push_back(current); // new state
+    }
+    // Extend to window end
+    if (!x.empty() && x.back() < window_end) {
+        x.push_back(window_end); y.push_back(y.back());
+    }
+}
+
+} // namespace
+
+void stride_downsample(const std::vector<Sample>& in, int max_points, std::vector<double>& xt, std::vector<double>& yv) {
+    stride_downsample_impl(in, max_points, xt, yv);
+}
+void stride_downsample(const std::vector<Sample>& in, int max_points, std::pmr::vector<double>& xt, std::pmr::vector<double>& yv) {
+    stride_downsample_impl(in, max_points, xt, yv);
+}
+void build_step_series(const std::vector<Sample>& in, double t0, double window_end, std::vector<double>& x, std::vector<double>& y) {
+    build_step_series_impl(in, t0, window_end, x, y);
+}
+void build_step_series(const std::vector<Sample>& in, double t0, double window_end, std::pmr::vector<double>& x, std::pmr::vector<double>& y) {
+    build_step_series_impl(in, t0, window_end, x, y);
+}
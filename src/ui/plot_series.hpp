@@ -0,0 +1,15 @@
+#pragma once
+#include <memory_resource>
+#include <vector>
+#include "core/ring_buffer.hpp"
+
+// Plot point builders (no ImGui dependency; see plots_panel.cpp for how they are drawn).
+
+// Copy samples into x/y, keeping at most ~max_points by fixed stride (last sample always kept).
+void stride_downsample(const std::vector<Sample>& in, int max_points, std::vector<double>& xt, std::vector<double>& yv);
+void stride_downsample(const std::vector<Sample>& in, int max_points, std::pmr::vector<double>& xt, std::pmr::vector<double>& yv);
+
+// Build a step series from baseline+edges samples (time-ordered). x is relative to t0
+// and the last value is held to window_end.
+void build_step_series(const std::vector<Sample>& in, double t0, double window_end, std::vector<double>& x, std::vector<double>& y);
+void build_step_series(const std::vector<Sample>& in, double t0, double window_end, std::pmr::vector<double>& x, std::pmr::vector<double>& y);
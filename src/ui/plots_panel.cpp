@@ -10,35 +10,18 @@
 // accidentally removing narrow pulses while keeping per-frame point
 // counts low.
 #include "plots_panel.hpp"
+#include "plot_series.hpp"
+#include "core/frame_arena.hpp"
 #include <implot.h>
 #include <algorithm>
 #include <cmath>
 
-static void stride_downsample(const std::vector<Sample>& in, int max_points, std::vector<double>& xt, std::vector<double>& yv) {
-    xt.clear(); yv.clear();
-    if ((int)in.size() <= max_points || max_points <= 0) {
-        xt.reserve(in.size()); yv.reserve(in.size());
-        for (auto &s : in) { xt.push_back(s.t); yv.push_back(s.v); }
-        return;
-    }
-    double step = (double)in.size() / (double)max_points;
-    xt.reserve(max_points+1); yv.reserve(max_points+1);
-    double i = 0.0; size_t n = in.size();
-    while ((size_t)i < n) {
-        size_t idx = (size_t)i;
-        const auto &s = in[idx];
-        xt.push_back(s.t); yv.push_back(s.v);
-        i += step;
-    }
-    if (xt.back() != in.back().t) { xt.push_back(in.back().t); yv.push_back(in.back().v); }
-}
-
 void PlotsPanel::draw_signal(Signal sig, const char* label, bool analog, float y_min, float y_max) {
     _poller.snapshot(sig, _tmp);
     if (_tmp.empty()) return;
     double latest = _poller.latest_time();
     double t0 = latest - _cfg.window_seconds;
-    std::vector<double> x; std::vector<double> y;
+    frame_vector<double> x(&ui_frame_arena()), y(&ui_frame_arena());
     stride_downsample(_tmp, _cfg.downsample_max, x, y);
     for (auto &vx : x) vx -= t0; // shift to 0..window
     if (ImPlot::BeginPlot(label, ImVec2(-1,150), ImPlotFlags_NoTitle)) {
@@ -48,17 +31,7 @@ void PlotsPanel::draw_signal(Signal sig, const char* label, bool analog, float y
         ImPlot::PlotLine(label, x.data(), y.data(), (int)x.size());
         if (_cfg.filter_mode && analog) {
             _anomaly_x.clear(); _anomaly_y.clear();
-            // Simple spike heuristic: large absolute delta vs previous raw sample (not downsampled)
-            for (size_t i = 1; i < _tmp.size(); ++i) {
-                float dv = fabsf(_tmp[i].v - _tmp[i-1].v);
-                if (dv >= _cfg.analog_spike_delta) {
-                    double tx = _tmp[i].t - t0;
-                    if (tx >= 0.0 && tx <= _cfg.window_seconds) {
-                        _anomaly_x.push_back(tx);
-                        _anomaly_y.push_back(_tmp[i].v);
-                    }
-                }
-            }
+            mark_spikes(sig, t0, y_max - y_min);
             if (!_anomaly_x.empty()) {
                 ImPlot::SetNextMarkerStyle(ImPlotMarker_Circle, 6.0f, ImVec4(1,0,0,1), 1.0f, ImVec4(1,0,0,1));
                 ImPlot::PlotScatter("Spikes", _anomaly_x.data(), _anomaly_y.data(), (int)_anomaly_x.size());
@@ -68,16 +41,17 @@ void PlotsPanel::draw_signal(Signal sig, const char* label, bool analog, float y
     }
 }
 
-void PlotsPanel::draw_signals_group(const char* plot_label, const std::vector<std::pair<Signal,const char*>>& signals, float y_min, float y_max) {
+void PlotsPanel::draw_signals_group(const char* plot_label, SignalList signals, float y_min, float y_max) {
     // Gather all snapshots first to keep time base consistent (each may have slightly different lengths)
     double latest = _poller.latest_time();
     double t0 = latest - _cfg.window_seconds;
-    struct Series { std::vector<double> x; std::vector<double> y; const char* label; };
-    std::vector<Series> series; series.reserve(signals.size());
+    FrameArena& arena = ui_frame_arena();
+    struct Series { frame_vector<double> x; frame_vector<double> y; const char* label; };
+    frame_vector<Series> series(&arena); series.reserve(signals.size());
     for (auto &sp : signals) {
         _poller.snapshot(sp.first, _tmp);
         if (_tmp.empty()) continue;
-        Series s; s.label = sp.second;
+        Series s{ frame_vector<double>(&arena), frame_vector<double>(&arena), sp.second };
         stride_downsample(_tmp, _cfg.downsample_max, s.x, s.y);
         for (auto &vx : s.x) vx -= t0;
         series.push_back(std::move(s));
@@ -96,16 +70,7 @@ void PlotsPanel::draw_signals_group(const char* plot_label, const std::vector<st
             _anomaly_x.clear(); _anomaly_y.clear();
             for (auto &sp : signals) {
                 _poller.snapshot(sp.first, _tmp);
-                for (size_t i = 1; i < _tmp.size(); ++i) {
-                    float dv = fabsf(_tmp[i].v - _tmp[i-1].v);
-                    if (dv >= _cfg.analog_spike_delta) {
-                        double tx = _tmp[i].t - t0;
-                        if (tx >= 0.0 && tx <= _cfg.window_seconds) {
-                            _anomaly_x.push_back(tx);
-                            _anomaly_y.push_back(_tmp[i].v);
-                        }
-                    }
-                }
+                mark_spikes(sp.first, t0, y_max - y_min);
             }
             if (!_anomaly_x.empty()) {
                 ImPlot::SetNextMarkerStyle(ImPlotMarker_Cross, 5.0f, ImVec4(1,0,0,1), 1.0f, ImVec4(1,0,0,1));
@@ -116,46 +81,39 @@ void PlotsPanel::draw_signals_group(const char* plot_label, const std::vector<st
     }
 }
 
-// Build step series from baseline+edges sample array. Assumes 'in' is time-ordered.
-void PlotsPanel::build_step_series(const std::vector<Sample>& in, double t0, double window_end, std::vector<double>& x, std::vector<double>& y) {
-    x.clear(); y.clear();
-    if (in.empty()) return;
-    // Start with first sample (baseline)
-    float current = in.front().v;
-    double prev_t = in.front().t;
-    // Anchor at window start if baseline precedes it
-    if (prev_t < t0) {
-        prev_t = t0;
-    }
-    x.push_back(prev_t - t0); y.push_back(current);
-    for (size_t i = 1; i < in.size(); ++i) {
-        const auto &s = in[i];
-        double t = s.t;
-        if (t < t0) continue; // still before window
-        if (s.v == current) continue; // no change (shouldn't happen if edges only, but safe)
-        // Vertical step: duplicate time with old then new value
-        double rel_t = t - t0;
-        x.push_back(rel_t); y.push_back(current); // hold previous until change
-        current = s.v;
-        x.push_back(rel_t); y.push_back(current); // new state
+void PlotsPanel::mark_spikes(Signal sig, double t0, float full_range) {
+    SpikeTrack& tr = _spikes[(size_t)sig];
+    if (!_tmp.empty() && _tmp.back().t < tr.last_t) tr = SpikeTrack{}; // history cleared
+    SpikeParams sp;
+    sp.k_sigma = _cfg.analog_spike_k;
+    sp.return_fraction = full_range > 0.0f ? _cfg.analog_spike_return / full_range : 0.0;
+    // Only the samples that arrived since the last frame go through the detector
+    for (const Sample& s : _tmp) {
+        if (s.t <= tr.last_t) continue;
+        if (tr.detector.update(s.v, sp, full_range) == SpikeDetector::State::Start) tr.marks.push_back(s);
+        tr.last_t = s.t;
     }
-    // Extend to window end
-    if (!x.empty() && x.back() < window_end) {
-        x.push_back(window_end); y.push_back(y.back());
+    size_t old = 0;
+    while (old < tr.marks.size() && tr.marks[old].t < t0) ++old;
+    tr.marks.erase(tr.marks.begin(), tr.marks.begin() + (ptrdiff_t)old);
+    for (const Sample& m : tr.marks) {
+        _anomaly_x.push_back(m.t - t0);
+        _anomaly_y.push_back(m.v);
     }
 }
 
-void PlotsPanel::draw_signals_group_edges(const char* plot_label, const std::vector<std::pair<Signal,const char*>>& signals, float y_min, float y_max) {
+void PlotsPanel::draw_signals_group_edges(const char* plot_label, SignalList signals, float y_min, float y_max) {
     double latest = _poller.latest_time();
     double t0 = latest - _cfg.window_seconds;
     double window_end = _cfg.window_seconds;
-    struct Series { std::vector<double> x; std::vector<double> y; const char* label; };
-    std::vector<Series> series; series.reserve(signals.size());
-    std::vector<Sample> local;
+    FrameArena& arena = ui_frame_arena();
+    struct Series { frame_vector<double> x; frame_vector<double> y; const char* label; };
+    frame_vector<Series> series(&arena); series.reserve(signals.size());
+    std::vector<Sample>& local = _edges;
     for (auto &sp : signals) {
         _poller.snapshot_with_baseline(sp.first, local);
         if (local.empty()) continue;
-        Series s; s.label = sp.second;
+        Series s{ frame_vector<double>(&arena), frame_vector<double>(&arena), sp.second };
         build_step_series(local, t0, window_end, s.x, s.y);
         if (!s.x.empty()) series.push_back(std::move(s));
     }
@@ -230,13 +188,13 @@ void PlotsPanel::draw() {
             ImGui::EndGroup();
             if (_left_trigger_digital || _right_trigger_digital) {
                 // Treat any digital triggers as edge-based digital signals (using baseline+edges) combined with any remaining analog one
-                std::vector<std::pair<Signal,const char*>> digitalSeries; digitalSeries.reserve(2);
+                frame_vector<std::pair<Signal,const char*>> digitalSeries(&ui_frame_arena()); digitalSeries.reserve(2);
                 if (_left_trigger_digital) digitalSeries.push_back({Signal::LeftTrigger, "Left Trigger (LT) Digital"});
                 if (_right_trigger_digital) digitalSeries.push_back({Signal::RightTrigger, "Right Trigger (RT) Digital"});
                 // Plot digital triggers using the same edge-group function (re-using digital short pulse highlighting logic) by borrowing draw_signals_group_edges mechanics.
                 draw_signals_group_edges("Triggers (Digital)", digitalSeries, -0.05f, 1.05f);
                 // If one trigger remains analog, plot it separately (regular analog group call with just that one)
-                std::vector<std::pair<Signal,const char*>> analogRem;
+                frame_vector<std::pair<Signal,const char*>> analogRem(&ui_frame_arena());
                 if (!_left_trigger_digital) analogRem.push_back({Signal::LeftTrigger, "Left Trigger (LT) Analog"});
                 if (!_right_trigger_digital) analogRem.push_back({Signal::RightTrigger, "Right Trigger (RT) Analog"});
                 if (!analogRem.empty()) {
@@ -1,14 +1,19 @@
 #pragma once
+#include <array>
+#include <initializer_list>
+#include <span>
 #include <vector>
+#include "core/spike_detector.hpp"
 #include "xinput/xinput_poll.hpp"
 
 struct PlotConfig {
     double window_seconds = 60.0;   // rolling window length in seconds
     int downsample_max = 8000;       // max points per plot after stride downsampling
     bool filter_mode = false;        // enable anomaly highlighting
-    // Analog spike detection: absolute delta threshold (value jump) and z-score style optional later
-    float analog_spike_delta = 0.05f; // jump > this between consecutive samples counts as spike
-    float analog_spike_return = 0.15f; // optional hysteresis when returning (future use)
+    // Analog spike detection (streaming, see core/spike_detector.hpp): a jump this many
+    // sigmas of the signal's own first-difference noise counts as a spike
+    float analog_spike_k = 6.0f;
+    float analog_spike_return = 0.15f; // spike over once the value is back within this of the level before it
     // Digital noise: very short pulses (press then release) shorter than this (seconds) considered ghost
     double digital_pulse_max = 0.005; // 5 ms default
 };
@@ -20,8 +25,8 @@ public:
     void set_window_seconds(double w) { _cfg.window_seconds = w; }
     double window_seconds() const { return _cfg.window_seconds; }
     void set_filter_mode(bool enabled) { _cfg.filter_mode = enabled; }
-    void set_filter_thresholds(float analog_delta, float analog_return, double digital_pulse_max) {
-        _cfg.analog_spike_delta = analog_delta;
+    void set_filter_thresholds(float analog_k, float analog_return, double digital_pulse_max) {
+        _cfg.analog_spike_k = analog_k;
         _cfg.analog_spike_return = analog_return;
         _cfg.digital_pulse_max = digital_pulse_max;
     }
@@ -30,15 +35,32 @@ public:
     bool right_trigger_digital() const { return _right_trigger_digital; }
 private:
     void draw_signal(Signal sig, const char* label, bool analog, float y_min, float y_max);
-    void draw_signals_group(const char* plot_label, const std::vector<std::pair<Signal,const char*>>& signals, float y_min, float y_max);
-    void draw_signals_group_edges(const char* plot_label, const std::vector<std::pair<Signal,const char*>>& signals, float y_min, float y_max);
-    void build_step_series(const std::vector<Sample>& in, double t0, double window_end, std::vector<double>& x, std::vector<double>& y);
+    // Series lists and point arrays are per-frame temporaries in ui_frame_arena()
+    using SignalList = std::span<const std::pair<Signal,const char*>>;
+    void draw_signals_group(const char* plot_label, SignalList signals, float y_min, float y_max);
+    void draw_signals_group(const char* plot_label, std::initializer_list<std::pair<Signal,const char*>> signals, float y_min, float y_max) {
+        draw_signals_group(plot_label, SignalList(signals.begin(), signals.size()), y_min, y_max);
+    }
+    // Feed samples of _tmp newer than the last call to the signal's detector and append
+    // the spikes inside the window to the anomaly buffers
+    void mark_spikes(Signal sig, double t0, float full_range);
+    void draw_signals_group_edges(const char* plot_label, SignalList signals, float y_min, float y_max);
+    void draw_signals_group_edges(const char* plot_label, std::initializer_list<std::pair<Signal,const char*>> signals, float y_min, float y_max) {
+        draw_signals_group_edges(plot_label, SignalList(signals.begin(), signals.size()), y_min, y_max);
+    }
     XInputPoller& _poller;
     PlotConfig _cfg;
-    std::vector<Sample> _tmp; // reused buffer to avoid reallocations
+    std::vector<Sample> _tmp; // reused buffers to avoid reallocations
+    std::vector<Sample> _edges;
     // Working buffers for anomaly markers
     std::vector<double> _anomaly_x; 
     std::vector<double> _anomaly_y; 
+    struct SpikeTrack {
+        SpikeDetector detector;
+        double last_t = -1.0;       // newest sample already fed
+        std::vector<Sample> marks;  // spike starts, oldest first
+    };
+    std::array<SpikeTrack, SignalCount> _spikes{};
     bool _left_trigger_digital = false;
     bool _right_trigger_digital = false;
 };
@@ -1,5 +1,6 @@
 #pragma once
 #include "xinput_poll.hpp"
+#include "core/cache_line.hpp"
 #include <ViGEm/Client.h>
 #include <Xinput.h>
 #include <mutex>
@@ -114,13 +115,14 @@ public:
     }
     double latest_filtered_time() const { return _latest_time_filtered.load(std::memory_order_acquire); }
     void clear_filtered() {
-        for (auto &r : _filtered_rings) r.clear();
+        for (auto &r : _filtered_rings) r.request_clear();
         _latest_time_filtered.store(0.0, std::memory_order_release);
     }
 
     void process(double t, const XInputPoller::ControllerState& s) override {
         XInputPoller::ControllerState cur = s;
-        if (_inject_test.exchange(false, std::memory_order_acq_rel)) {
+        // Load first: an exchange per report would write the UI's line every time
+        if (_inject_test.load(std::memory_order_relaxed) && _inject_test.exchange(false, std::memory_order_acq_rel)) {
             cur.lx = -1.0f; cur.ly = 1.0f;
             cur.rx = 1.0f; cur.ry = -1.0f;
             cur.lt = 1.0f; cur.rt = 1.0f;
@@ -324,26 +326,32 @@ private:
         _prev = cs;
     }
 
+    // Set from the UI, read by process() on the poller thread for every report
     std::atomic<bool> _filter_enabled{false};
     std::atomic<bool> _enabled{false};
+    std::atomic<bool> _inject_test{false};
+    std::atomic<bool> _lt_digital{false};
+    std::atomic<bool> _rt_digital{false};
+    // Per-signal filter mode: 0=none, 1=digital, 2=analog
+    std::array<std::atomic<int>, SignalCount> _signal_mode{};
+    std::atomic<double> _window_seconds{30.0};
+    PVIGEM_CLIENT _client = nullptr;
+    PVIGEM_TARGET _target = nullptr;
     bool _ready = false;
     std::string _status = "Not initialized";
     std::string _last_update_status; // empty if OK
-    PVIGEM_CLIENT _client = nullptr;
-    PVIGEM_TARGET _target = nullptr;
+
+    // Filter state: written by process() for every report while filtering (set_params()
+    // takes _mtx from the UI only when the settings change)
+    alignas(kCacheLineSize) std::mutex _mtx;
     float _analog_rate_pct = 5.0f;
     double _digital_max = 0.005;
     XInputPoller::ControllerState _prev{}; bool _have_prev=false;
     double _rise_time[16] = { -1.0 }; // per-button pending rise time (buttons + digital triggers)
     bool _btn_prev_raw[16] = {false}; // raw instantaneous highs
     bool _btn_active[16] = {false};   // promoted (visible) highs after gating threshold
-    std::mutex _mtx;
-    std::atomic<bool> _inject_test{false};
-    std::atomic<bool> _lt_digital{false};
-    std::atomic<bool> _rt_digital{false};
-    // Per-signal filter mode: 0=none, 1=digital, 2=analog
-    std::array<std::atomic<int>, SignalCount> _signal_mode{};
-    std::atomic<double> _window_seconds{30.0};
-    std::atomic<double> _latest_time_filtered{0.0};
+
+    // Published by process() for the UI's snapshots
+    alignas(kCacheLineSize) std::atomic<double> _latest_time_filtered{0.0};
     std::array<SampleRing, SignalCount> _filtered_rings;
 };
@@ -1,195 +1,239 @@
 #include "hotas_mapper.hpp"
+#include "vk_codes.hpp"
+#include "core/trace.hpp"
+#include "core/alloc_guard.hpp"
+#include "core/async_log.hpp"
+#include "core/stall_watchdog.hpp"
+#include "core/thread_roles.hpp"
 #include <nlohmann/json.hpp>
+#include <algorithm>
+#include <array>
 #include <fstream>
 #include <thread>
 #include <chrono>
 #include <mutex>
-#include <iostream>
-#include <sstream>
-#include <Windows.h>
-#include <ViGEm/Client.h>
-#include <Xinput.h>
+#include <string_view>
 #include <unordered_map>
 #include <cmath>
-#include <chrono>
 #include <vector>
-#include <unordered_map>
-
-HotasMapper::HotasMapper() {}
 
-HotasMapper::~HotasMapper() { stop(); }
+HotasMapper::HotasMapper() : backend(make_platform_output()) {}
 
-// Enable verbose diagnostics for mapper (set true to print mapping and vigem events)
-static bool g_verbose_mapper = false; // disable verbose mapper logging
-
-// ViGEm client (single global target used by the mapper)
-static PVIGEM_CLIENT g_vigem_client = nullptr;
-static PVIGEM_TARGET g_vigem_target = nullptr;
-static bool g_vigem_ready = false;
-
-static void ensure_vigem_initialized() {
-    if (g_vigem_ready) return;
-    // initialize ViGEm client
-    g_vigem_client = vigem_alloc();
-    if (!g_vigem_client) { return; }
-    VIGEM_ERROR err = vigem_connect(g_vigem_client);
-    if (!VIGEM_SUCCESS(err)) { return; }
-    g_vigem_target = vigem_target_x360_alloc();
-    if (!g_vigem_target) { return; }
-    err = vigem_target_add(g_vigem_client, g_vigem_target);
-    if (!VIGEM_SUCCESS(err)) { return; }
-    g_vigem_ready = true;
+HotasMapper::HotasMapper(std::unique_ptr<IOutputBackend> b) : backend(std::move(b)) {
+    if (!backend) backend = make_platform_output();
 }
 
-static void cleanup_vigem() {
-    if (g_vigem_ready) {
-        if (g_vigem_target && g_vigem_client) {
-            vigem_target_remove(g_vigem_client, g_vigem_target);
-            vigem_target_free(g_vigem_target);
-        }
-        if (g_vigem_client) vigem_free(g_vigem_client);
-    }
-    g_vigem_ready = false;
-    g_vigem_client = nullptr; g_vigem_target = nullptr;
-}
+HotasMapper::~HotasMapper() { stop(); }
 
-// Keyboard auto-repeat parameters (from system) and per-key repeat state
-struct KbdRepeatParams { int delay_ms = 250; int interval_ms = 33; bool inited = false; };
-static KbdRepeatParams g_kbd_params;
-
-static void init_kbd_params_once() {
-    if (g_kbd_params.inited) return;
-    UINT delay = 1, speed = 31; // sensible defaults
-    SystemParametersInfoA(SPI_GETKEYBOARDDELAY, 0, &delay, 0);
-    SystemParametersInfoA(SPI_GETKEYBOARDSPEED, 0, &speed, 0);
-    int delay_ms = static_cast<int>((delay + 1) * 250); // 0..3 => 250..1000ms
-    // Map 0..31 to approx 2.5..30 cps
-    double cps = 2.5 + (27.5 * (static_cast<double>(speed) / 31.0));
-    int interval_ms = cps > 0.1 ? static_cast<int>(1000.0 / cps) : 40;
-    g_kbd_params.delay_ms = delay_ms;
-    g_kbd_params.interval_ms = (interval_ms < 10) ? 10 : interval_ms;
-    g_kbd_params.inited = true;
+static double steady_seconds() {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
 }
 
-struct KeyRepeatState {
-    bool pressed = false;
-    std::string name;
-    std::chrono::steady_clock::time_point press_time;
-    std::chrono::steady_clock::time_point next_repeat;
+// Named keys accepted in "keyboard:<name>" actions; the first name of a code is the one logged
+static constexpr struct { const char* name; uint32_t vk; } kVkNames[] = {
+    { "SPACE", VK_SPACE }, { "SHIFT", VK_SHIFT }, { "LSHIFT", VK_LSHIFT }, { "RSHIFT", VK_RSHIFT },
+    { "CONTROL", VK_CONTROL }, { "LCONTROL", VK_LCONTROL }, { "RCONTROL", VK_RCONTROL },
+    { "ALT", VK_MENU }, { "MENU", VK_MENU }, { "LALT", VK_LMENU }, { "LMENU", VK_LMENU },
+    { "RALT", VK_RMENU }, { "RMENU", VK_RMENU }, { "RETURN", VK_RETURN }, { "ENTER", VK_RETURN },
+    { "TAB", VK_TAB }, { "ESC", VK_ESCAPE }, { "ESCAPE", VK_ESCAPE },
+    { "UP", VK_UP }, { "DOWN", VK_DOWN }, { "LEFT", VK_LEFT }, { "RIGHT", VK_RIGHT },
+    { "BACK", VK_BACK }, { "BACKSPACE", VK_BACK }, { "DELETE", VK_DELETE }, { "DEL", VK_DELETE },
+    { "HOME", VK_HOME }, { "END", VK_END }, { "PAGEUP", VK_PRIOR }, { "PAGEDOWN", VK_NEXT },
+    { "CAPS", VK_CAPITAL }, { "NUMLOCK", VK_NUMLOCK }, { "SCROLL", VK_SCROLL },
+};
+static constexpr const char* kFunctionKeys[24] = {
+    "F1", "F2", "F3", "F4", "F5", "F6", "F7", "F8", "F9", "F10", "F11", "F12",
+    "F13", "F14", "F15", "F16", "F17", "F18", "F19", "F20", "F21", "F22", "F23", "F24",
 };
-static std::unordered_map<UINT, KeyRepeatState> g_key_repeat;
 
-static UINT parse_vk(const std::string& name) {
+static uint32_t parse_vk(const std::string& name) {
     std::string s = name; for (auto &c : s) c = (char)toupper((unsigned char)c);
     if (s.rfind("VK_",0) == 0) {
         s = s.substr(3);
     }
     // Common VK names
-    if (s == "SPACE") return VK_SPACE;
-    if (s == "SHIFT") return VK_SHIFT;
-    if (s == "LSHIFT") return VK_LSHIFT;
-    if (s == "RSHIFT") return VK_RSHIFT;
-    if (s == "CONTROL") return VK_CONTROL;
-    if (s == "LCONTROL") return VK_LCONTROL;
-    if (s == "RCONTROL") return VK_RCONTROL;
-    if (s == "ALT" || s == "MENU") return VK_MENU;
-    if (s == "LALT" || s == "LMENU") return VK_LMENU;
-    if (s == "RALT" || s == "RMENU") return VK_RMENU;
-    if (s == "RETURN" || s == "ENTER") return VK_RETURN;
-    if (s == "TAB") return VK_TAB;
-    if (s == "ESC" || s == "ESCAPE") return VK_ESCAPE;
-    if (s == "UP") return VK_UP;
-    if (s == "DOWN") return VK_DOWN;
-    if (s == "LEFT") return VK_LEFT;
-    if (s == "RIGHT") return VK_RIGHT;
-    if (s == "BACK" || s == "BACKSPACE") return VK_BACK;
-    if (s == "DELETE" || s == "DEL") return VK_DELETE;
-    if (s == "HOME") return VK_HOME;
-    if (s == "END") return VK_END;
-    if (s == "PAGEUP") return VK_PRIOR;
-    if (s == "PAGEDOWN") return VK_NEXT;
-    if (s == "CAPS") return VK_CAPITAL;
-    if (s == "NUMLOCK") return VK_NUMLOCK;
-    if (s == "SCROLL") return VK_SCROLL;
+    for (const auto &k : kVkNames) {
+        if (s == k.name) return k.vk;
+    }
     // Single ASCII letter/digit
     if (s.size() == 1) {
         char c = s[0];
-        if (c >= 'A' && c <= 'Z') return (UINT)c;
-        if (c >= '0' && c <= '9') return (UINT)c;
+        if (c >= 'A' && c <= 'Z') return (uint32_t)c;
+        if (c >= '0' && c <= '9') return (uint32_t)c;
     }
     // F-keys
     if (s.size() >= 2 && s[0]=='F') {
         int fn = 0; try { fn = std::stoi(s.substr(1)); } catch(...) { fn = 0; }
-        if (fn >= 1 && fn <= 24) return (UINT)(VK_F1 + (fn - 1));
+        if (fn >= 1 && fn <= 24) return (uint32_t)(VK_F1 + (fn - 1));
     }
     return 0; // unknown
 }
 
-static bool is_extended_vk(UINT vk) {
-    switch (vk) {
-        case VK_RMENU: case VK_RCONTROL:
-        case VK_INSERT: case VK_DELETE:
-        case VK_HOME: case VK_END:
-        case VK_PRIOR: case VK_NEXT: // PageUp/PageDown
-        case VK_LEFT: case VK_RIGHT: case VK_UP: case VK_DOWN:
-        case VK_DIVIDE: case VK_NUMLOCK:
-            return true;
-        default: return false;
+// Name of a mapped key code for the key logs; static storage, so tick() can log it
+// without copying the binding's name
+static std::string_view vk_name(uint32_t vk) {
+    static constexpr char kAlnum[] = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ";
+    for (const auto &k : kVkNames) {
+        if (k.vk == vk) return k.name;
     }
+    if (vk >= '0' && vk <= '9') return std::string_view(&kAlnum[vk - '0'], 1);
+    if (vk >= 'A' && vk <= 'Z') return std::string_view(&kAlnum[10 + vk - 'A'], 1);
+    if (vk >= VK_F1 && vk < VK_F1 + 24) return kFunctionKeys[vk - VK_F1];
+    return "?";
 }
 
-static void send_key(UINT vk, bool down) {
-    if (vk == 0) return;
-    HKL layout = GetKeyboardLayout(0);
-    UINT sc = MapVirtualKeyEx(vk, MAPVK_VK_TO_VSC, layout);
-    INPUT in{}; in.type = INPUT_KEYBOARD;
-    in.ki.wVk = 0; // use scan code to ensure proper 'code' and game handling
-    in.ki.wScan = (WORD)sc;
-    in.ki.dwFlags = KEYEVENTF_SCANCODE | (down ? 0 : KEYEVENTF_KEYUP);
-    if (is_extended_vk(vk)) in.ki.dwFlags |= KEYEVENTF_EXTENDEDKEY;
-    SendInput(1, &in, sizeof(INPUT));
-}
-
-// Internal storage for mapping entries
-// (kept in the cpp to avoid exposing internal containers in header)
-static std::vector<MappingEntry> g_mappings;
-
-// Optional injection callback (set by UI/main) so mapper can inject mapped states
-static HotasMapper::InjectCallback g_inject_cb = nullptr;
-
 void HotasMapper::set_inject_callback(InjectCallback cb) {
-    g_inject_cb = cb;
+    std::lock_guard<std::mutex> lk(cb_mtx);
+    inject_cb = std::move(cb);
 }
 
-void HotasMapper::start(double target_hz) {
+void HotasMapper::start(double target_hz, Pacing pacing) {
     if (running.exchange(true)) return; // already running
+    current_pacing.store(pacing, std::memory_order_relaxed);
+    ticks_inline.store(false, std::memory_order_relaxed);
     worker = new std::thread(&HotasMapper::publisher_thread_main, this, target_hz);
     // started publisher thread
 }
 
+void HotasMapper::start_inline() {
+    if (running.exchange(true)) return;
+    ticks_inline.store(true, std::memory_order_relaxed);
+    backend->open();
+}
+
+void HotasMapper::set_pacing(Pacing pacing) {
+    if (current_pacing.exchange(pacing, std::memory_order_relaxed) != pacing) notify_frame();
+}
+
 void HotasMapper::stop() {
     if (!running.exchange(false)) return;
+    notify_frame(); // wake an event-driven publisher so it sees running == false
     if (worker) {
         worker->join();
         delete worker; worker = nullptr;
     }
+    // Inline ticks run on the pipeline thread: wait for one in progress
+    std::lock_guard<std::mutex> out_lk(out_mtx);
     // Release any pressed keys on stop
-    for (auto &kv : g_key_repeat) {
-        if (kv.second.pressed) {
-            send_key(kv.first, false);
+    release_keys();
+    // ensure the output device is released when the mapper stops
+    backend->close();
+}
+
+bool HotasMapper::submit_neutral_now() {
+    std::unique_lock<std::mutex> out_lk(out_mtx, std::try_to_lock);
+    if (!out_lk.owns_lock()) return false;
+    if (backend->ready()) backend->submit(X360Report{}, OutputTiming{ 0.0, steady_seconds() });
+    for (uint32_t vk = 0; vk < key_repeat.size(); ++vk) {
+        if (!key_repeat[vk].pressed) continue;
+        backend->send_key(vk, false);
+        key_repeat[vk].pressed = false;
+        --keys_held;
+    }
+    return true;
+}
+
+void HotasMapper::release_keys() {
+    for (uint32_t vk = 0; vk < key_repeat.size(); ++vk) {
+        if (key_repeat[vk].pressed) {
+            backend->send_key(vk, false);
         }
+        key_repeat[vk] = KeyRepeatState{};
     }
-    g_key_repeat.clear();
-    // ensure cleanup of vigem resources when the mapper stops
-    cleanup_vigem();
+    keys_held = 0;
+}
+
+int HotasMapper::slot_locked(const std::string& signal_id) {
+    auto it = slot_of.find(signal_id);
+    if (it != slot_of.end()) return it->second;
+    // New signal: grow every slot-indexed table once, so the sample path never allocates
+    const int slot = (int)slot_of.size();
+    slot_of.emplace(signal_id, slot);
+    pending_values.push_back(0.0);
+    pending_dirty.push_back(0);
+    dirty_slots.reserve(slot_of.size());
+    curvals.push_back(0.0);
+    return slot;
+}
+
+int HotasMapper::signal_slot(const std::string& signal_id) {
+    std::lock_guard<std::mutex> lk(mtx);
+    return slot_locked(signal_id);
+}
+
+void HotasMapper::store_sample_locked(int slot, double value, double timestamp) {
+    pending_values[(size_t)slot] = value; // latest value per signal wins
+    if (!pending_dirty[(size_t)slot]) { pending_dirty[(size_t)slot] = 1; dirty_slots.push_back(slot); }
+    if (timestamp > pending_source_t) pending_source_t = timestamp;
 }
 
 void HotasMapper::accept_sample(const std::string& signal_id, double value, double timestamp) {
     std::lock_guard<std::mutex> lk(mtx);
-    pending_samples.emplace_back(signal_id, value, timestamp);
-    if (g_verbose_mapper) {
-        std::ostringstream ss; ss << "HotasMapper: accepted sample " << signal_id << "=" << value << " ts=" << timestamp; std::cerr << ss.str() << "\n";
+    store_sample_locked(slot_locked(signal_id), value, timestamp);
+    HOTAS_LOG_DEBUG("mapper", "accepted sample {}={} ts={}", signal_id, value, timestamp);
+}
+
+void HotasMapper::set_sample_queue(size_t depth) {
+    std::lock_guard<std::mutex> lk(mtx);
+    sample_queue = depth ? std::make_unique<SpscQueue<SampleFrame>>(depth) : nullptr;
+}
+
+HotasMapper::QueueStats HotasMapper::sample_queue_stats() const {
+    QueueStats qs;
+    std::lock_guard<std::mutex> lk(mtx);
+    if (!sample_queue) return qs;
+    qs.capacity = sample_queue->capacity();
+    qs.frames = sample_queue->pushed();
+    qs.overflows = sample_queue->overflows();
+    qs.meter = queue_meter.snapshot();
+    return qs;
+}
+
+void HotasMapper::drain_queue_locked(double now) {
+    while (const SampleFrame* f = sample_queue->front()) {
+        for (uint32_t i = 0; i < f->count; ++i) {
+            const SlotSample& s = f->samples[i];
+            if (s.slot >= 0 && (size_t)s.slot < pending_values.size()) store_sample_locked(s.slot, s.value, s.timestamp);
+        }
+        const double lag = now - f->enqueued_t;
+        sample_queue->pop();
+        queue_meter.record(lag, sample_queue->size());
+    }
+}
+
+void HotasMapper::accept_samples(const SlotSample* samples, size_t count) {
+    SpscQueue<SampleFrame>* q = sample_queue.get();
+    const double now = q ? steady_seconds() : 0.0;
+    if (q) {
+        while (count > 0) {
+            SampleFrame* f = q->begin_push();
+            if (!f) break;
+            const size_t k = std::min(count, SampleFrame::kMaxSamples);
+            std::copy(samples, samples + k, f->samples);
+            f->count = (uint32_t)k;
+            f->enqueued_t = now;
+            q->commit_push();
+            samples += k;
+            count -= k;
+        }
+        if (count == 0) return;
+    }
+    std::lock_guard<std::mutex> lk(mtx);
+    // Queue full: take over its backlog first so the rest is stored in order
+    if (q) drain_queue_locked(now);
+    for (size_t i = 0; i < count; ++i) {
+        const SlotSample& s = samples[i];
+        if (s.slot < 0 || (size_t)s.slot >= pending_values.size()) continue;
+        store_sample_locked(s.slot, s.value, s.timestamp);
+    }
+}
+
+void HotasMapper::notify_frame() {
+    {
+        std::lock_guard<std::mutex> lk(wake_mtx);
+        wake_pending = true;
     }
+    wake_cv.notify_one();
 }
 
 std::vector<HotasMappedOutput> HotasMapper::list_mappings() const {
@@ -199,23 +243,25 @@ std::vector<HotasMappedOutput> HotasMapper::list_mappings() const {
 
 std::vector<MappingEntry> HotasMapper::list_mapping_entries() const {
     std::lock_guard<std::mutex> lk(mtx);
-    return g_mappings;
+    return mappings;
 }
 
 bool HotasMapper::add_mapping(const MappingEntry& e) {
     std::lock_guard<std::mutex> lk(mtx);
     // Overwrite if id exists; else append
-    for (auto &m : g_mappings) {
-        if (m.id == e.id) { m = e; return true; }
+    bool replaced = false;
+    for (auto &m : mappings) {
+        if (m.id == e.id) { m = e; replaced = true; break; }
     }
-    g_mappings.push_back(e);
+    if (!replaced) mappings.push_back(e);
+    rebuild_plan_locked();
     return true;
 }
 
 bool HotasMapper::remove_mapping(const std::string& mapping_id) {
     std::lock_guard<std::mutex> lk(mtx);
-    for (size_t i = 0; i < g_mappings.size(); ++i) {
-        if (g_mappings[i].id == mapping_id) { g_mappings.erase(g_mappings.begin() + i); return true; }
+    for (size_t i = 0; i < mappings.size(); ++i) {
+        if (mappings[i].id == mapping_id) { mappings.erase(mappings.begin() + i); rebuild_plan_locked(); return true; }
     }
     return false;
 }
@@ -225,7 +271,7 @@ bool HotasMapper::save_profile(const std::string& path) const {
     {
         std::lock_guard<std::mutex> lk(mtx);
         j["mappings"] = nlohmann::json::array();
-        for (auto &m : g_mappings) {
+        for (auto &m : mappings) {
             nlohmann::json jm;
             jm["id"] = m.id;
             jm["signal_id"] = m.signal_id;
@@ -271,206 +317,212 @@ bool HotasMapper::load_profile(const std::string& path) {
             loaded.push_back(me);
         }
         std::lock_guard<std::mutex> lk(mtx);
-        g_mappings = std::move(loaded);
+        mappings = std::move(loaded);
+        rebuild_plan_locked();
         return true;
     } catch (...) { return false; }
 }
 
 void HotasMapper::publisher_thread_main(double hz) {
-    using clock = std::chrono::high_resolution_clock;
-    auto period = std::chrono::duration<double>(1.0 / hz);
-    ensure_vigem_initialized();
-    std::unordered_map<std::string,double> curvals;
+    using clock = std::chrono::steady_clock;
+    auto period = std::chrono::duration_cast<clock::duration>(std::chrono::duration<double>(1.0 / hz));
+    backend->open();
+    HOTAS_TRACE_THREAD_NAME("mapper");
+    hotas_rt::ScopedThreadRole role(hotas_rt::ThreadRole::Output, "mapper");
+    hotas_watchdog::StageHeartbeat heartbeat("mapper", 0.05);
     while (running) {
         auto t0 = clock::now();
-        // simple publish: just print and clear pending samples
-        {
-            std::lock_guard<std::mutex> lk(mtx);
-            if (!pending_samples.empty()) {
-                for (auto &s : pending_samples) {
-                    const auto &id = std::get<0>(s);
-                    double v = std::get<1>(s);
-                    curvals[id] = v; // update latest value for the logical signal
+        heartbeat.beat();
+        tick();
+        if (current_pacing.load(std::memory_order_relaxed) == Pacing::EventDriven) {
+            // Wake on the next frame; the period is only an idle timeout (key auto-repeat)
+            std::unique_lock<std::mutex> lk(wake_mtx);
+            wake_cv.wait_until(lk, t0 + period, [&]{ return wake_pending || !running; });
+            wake_pending = false;
+        } else {
+            auto t1 = clock::now();
+            std::this_thread::sleep_for(period - (t1 - t0));
+        }
+    }
+}
+
+// X360 targets in resolution order (axes, then buttons)
+struct X360Target { const char* action; int axis; uint16_t mask; };
+static const X360Target kX360Targets[] = {
+    {"x360:left_x", 0, 0}, {"x360:left_y", 1, 0}, {"x360:right_x", 2, 0}, {"x360:right_y", 3, 0},
+    {"x360:left_trigger", 4, 0}, {"x360:right_trigger", 5, 0},
+    {"x360:button_a", -1, X360_BUTTON_A}, {"x360:button_b", -1, X360_BUTTON_B},
+    {"x360:button_x", -1, X360_BUTTON_X}, {"x360:button_y", -1, X360_BUTTON_Y},
+    {"x360:left_shoulder", -1, X360_BUTTON_LEFT_SHOULDER}, {"x360:right_shoulder", -1, X360_BUTTON_RIGHT_SHOULDER},
+    {"x360:back", -1, X360_BUTTON_BACK}, {"x360:start", -1, X360_BUTTON_START},
+    {"x360:left_thumb", -1, X360_BUTTON_LEFT_THUMB}, {"x360:right_thumb", -1, X360_BUTTON_RIGHT_THUMB},
+    {"x360:dpad_up", -1, X360_BUTTON_DPAD_UP}, {"x360:dpad_down", -1, X360_BUTTON_DPAD_DOWN},
+    {"x360:dpad_left", -1, X360_BUTTON_DPAD_LEFT}, {"x360:dpad_right", -1, X360_BUTTON_DPAD_RIGHT},
+};
+static_assert(sizeof(kX360Targets) / sizeof(kX360Targets[0]) == 20, "target table size");
+
+void HotasMapper::rebuild_plan_locked() {
+    // Compile the mapping list into slot-indexed tables so tick() does no lookups or allocation
+    for (auto &t : plan.targets) t.clear();
+    plan.keys.clear();
+    plan.has_mappings = !mappings.empty();
+    mappings_gen.fetch_add(1, std::memory_order_release);
+    for (const auto &m : mappings) {
+        if (m.action.rfind("x360:",0) == 0) {
+            for (size_t t = 0; t < plan.targets.size(); ++t) {
+                if (m.action == kX360Targets[t].action) {
+                    plan.targets[t].push_back(Source{ slot_locked(m.signal_id), m.deadband, m.priority });
+                    break;
                 }
-                pending_samples.clear();
             }
+        } else if (m.action.rfind("keyboard:",0) == 0) {
+            std::string keyStr = m.action.substr(9);
+            uint32_t vk = parse_vk(keyStr);
+            if (vk == 0 || vk >= key_repeat.size()) continue;
+            plan.keys.push_back(KeyBinding{ slot_locked(m.signal_id), vk });
         }
-        // Build and send x360 report if any mappings target x360
-        if (!g_mappings.empty()) {
-            XUSB_REPORT rep{};
+    }
+    // Highest priority first
+    for (auto &t : plan.targets) {
+        std::stable_sort(t.begin(), t.end(), [](const Source& a, const Source& b){ return a.priority > b.priority; });
+    }
+}
+
+void HotasMapper::tick() {
+    HOTAS_TRACE_SCOPE("mapper.tick");
+    HOTAS_NO_ALLOC_ZONE("mapper.tick");
+    const double tick_t = steady_seconds();
+    X360Report rep{};
+    bool has_mappings = false;
+    bool has_keys = false;
+    std::array<uint8_t, 256> desired_active{}; // vk -> wanted down
+    {
+        std::lock_guard<std::mutex> lk(mtx);
+        if (sample_queue) drain_queue_locked(tick_t);
+        // Drain pending samples (latest value per signal) into the current values
+        HOTAS_TRACE_COUNTER("mapper.pending", dirty_slots.size());
+        if (!dirty_slots.empty()) {
+            // Lag between the newest sample's source time and this tick
+            HOTAS_TRACE_COUNTER("mapper.sample_lag_us", (tick_t - pending_source_t) * 1e6);
+            for (int slot : dirty_slots) {
+                curvals[(size_t)slot] = pending_values[(size_t)slot];
+                pending_dirty[(size_t)slot] = 0;
+            }
+            dirty_slots.clear();
+            if (pending_source_t > latest_source_t) latest_source_t = pending_source_t;
+        }
+        has_mappings = plan.has_mappings;
+        if (has_mappings) {
             auto to_short = [](double v){ double vv = v; if (vv>1) vv=1; if (vv<-1) vv=-1; return (int16_t)(vv>=0? vv*32767.0 : vv*32768.0); };
             auto to_trig = [](double v){ double vv = v; if (vv<0) vv=0; if (vv>1) vv=1; return (uint8_t)(vv*255.0 + 0.5); };
-            // Group mappings by action
-            std::unordered_map<std::string, std::vector<MappingEntry>> groups;
-            {
-                std::lock_guard<std::mutex> lk(mtx);
-                for (const auto &m : g_mappings) {
-                    if (m.action.rfind("x360:",0) != 0) continue;
-                    groups[m.action].push_back(m);
-                }
-            }
-            auto read_val = [&](const std::string &sid)->double {
-                auto it = curvals.find(sid);
-                return (it != curvals.end()) ? it->second : 0.0;
-            };
-            auto resolve_axis = [&](const std::vector<MappingEntry>& vec)->double {
-                if (vec.empty()) return 0.0;
-                // sort by priority desc
-                std::vector<MappingEntry> tmp = vec;
-                std::sort(tmp.begin(), tmp.end(), [](const MappingEntry& a, const MappingEntry& b){ return a.priority > b.priority; });
+            auto resolve_axis = [&](const std::vector<Source>& vec)->double {
+                // sources are sorted by priority desc
                 double fallback_max = 0.0; double fallback_val = 0.0;
-                for (const auto &m : tmp) {
-                    double v = read_val(m.signal_id);
+                for (const auto &src : vec) {
+                    double v = curvals[(size_t)src.slot];
                     double mag = std::fabs(v);
-                    if (mag > m.deadband) {
+                    if (mag > src.deadband) {
                         return v; // first above deadband wins by priority
                     }
                     if (mag > fallback_max) { fallback_max = mag; fallback_val = v; }
                 }
                 return fallback_val; // none above deadband: use largest magnitude
             };
-            auto resolve_button = [&](const std::vector<MappingEntry>& vec)->bool {
-                if (vec.empty()) return false;
-                std::vector<MappingEntry> tmp = vec;
-                std::sort(tmp.begin(), tmp.end(), [](const MappingEntry& a, const MappingEntry& b){ return a.priority > b.priority; });
-                for (const auto &m : tmp) {
-                    double v = read_val(m.signal_id);
-                    if (v > 0.5) return true; // first active wins
+            auto resolve_button = [&](const std::vector<Source>& vec)->bool {
+                for (const auto &src : vec) {
+                    if (curvals[(size_t)src.slot] > 0.5) return true; // first active wins
                 }
                 return false;
             };
-
             // Axes
-            if (groups.count("x360:left_x")) rep.sThumbLX = to_short(resolve_axis(groups["x360:left_x"]));
-            if (groups.count("x360:left_y")) rep.sThumbLY = to_short(-resolve_axis(groups["x360:left_y"]));
-            if (groups.count("x360:right_x")) rep.sThumbRX = to_short(resolve_axis(groups["x360:right_x"]));
-            if (groups.count("x360:right_y")) rep.sThumbRY = to_short(-resolve_axis(groups["x360:right_y"]));
-            if (groups.count("x360:left_trigger")) rep.bLeftTrigger = to_trig(resolve_axis(groups["x360:left_trigger"]));
-            if (groups.count("x360:right_trigger")) rep.bRightTrigger = to_trig(resolve_axis(groups["x360:right_trigger"]));
-
+            const auto &tg = plan.targets;
+            if (!tg[0].empty()) rep.lx = to_short(resolve_axis(tg[0]));
+            if (!tg[1].empty()) rep.ly = to_short(-resolve_axis(tg[1]));
+            if (!tg[2].empty()) rep.rx = to_short(resolve_axis(tg[2]));
+            if (!tg[3].empty()) rep.ry = to_short(-resolve_axis(tg[3]));
+            if (!tg[4].empty()) rep.left_trigger = to_trig(resolve_axis(tg[4]));
+            if (!tg[5].empty()) rep.right_trigger = to_trig(resolve_axis(tg[5]));
             // Buttons/DPad
             uint16_t button_mask = 0;
-            if (groups.count("x360:button_a") && resolve_button(groups["x360:button_a"])) button_mask |= XINPUT_GAMEPAD_A;
-            if (groups.count("x360:button_b") && resolve_button(groups["x360:button_b"])) button_mask |= XINPUT_GAMEPAD_B;
-            if (groups.count("x360:button_x") && resolve_button(groups["x360:button_x"])) button_mask |= XINPUT_GAMEPAD_X;
-            if (groups.count("x360:button_y") && resolve_button(groups["x360:button_y"])) button_mask |= XINPUT_GAMEPAD_Y;
-            if (groups.count("x360:left_shoulder") && resolve_button(groups["x360:left_shoulder"])) button_mask |= XINPUT_GAMEPAD_LEFT_SHOULDER;
-            if (groups.count("x360:right_shoulder") && resolve_button(groups["x360:right_shoulder"])) button_mask |= XINPUT_GAMEPAD_RIGHT_SHOULDER;
-            if (groups.count("x360:back") && resolve_button(groups["x360:back"])) button_mask |= XINPUT_GAMEPAD_BACK;
-            if (groups.count("x360:start") && resolve_button(groups["x360:start"])) button_mask |= XINPUT_GAMEPAD_START;
-            if (groups.count("x360:left_thumb") && resolve_button(groups["x360:left_thumb"])) button_mask |= XINPUT_GAMEPAD_LEFT_THUMB;
-            if (groups.count("x360:right_thumb") && resolve_button(groups["x360:right_thumb"])) button_mask |= XINPUT_GAMEPAD_RIGHT_THUMB;
-            if (groups.count("x360:dpad_up") && resolve_button(groups["x360:dpad_up"])) button_mask |= XINPUT_GAMEPAD_DPAD_UP;
-            if (groups.count("x360:dpad_down") && resolve_button(groups["x360:dpad_down"])) button_mask |= XINPUT_GAMEPAD_DPAD_DOWN;
-            if (groups.count("x360:dpad_left") && resolve_button(groups["x360:dpad_left"])) button_mask |= XINPUT_GAMEPAD_DPAD_LEFT;
-            if (groups.count("x360:dpad_right") && resolve_button(groups["x360:dpad_right"])) button_mask |= XINPUT_GAMEPAD_DPAD_RIGHT;
-            rep.wButtons = button_mask;
-            // Before sending the report, optionally call the inject callback with a mapped ControllerState
-            if (g_inject_cb) {
+            for (size_t t = 6; t < tg.size(); ++t) {
+                if (!tg[t].empty() && resolve_button(tg[t])) button_mask |= kX360Targets[t].mask;
+            }
+            rep.buttons = button_mask;
+        }
+        // Keyboard mappings: aggregate per key (any active source holds it down)
+        has_keys = !plan.keys.empty();
+        for (const auto &kb : plan.keys) {
+            bool active = std::fabs(curvals[(size_t)kb.slot]) > 0.01; // axes use -1..1; buttons 0/1
+            desired_active[kb.vk] = desired_active[kb.vk] || active;
+        }
+        if (hold_neutral.load(std::memory_order_relaxed)) {
+            rep = X360Report{};
+            desired_active.fill(0);
+        }
+    }
+    if (has_mappings) {
+        // Before sending the report, optionally call the inject callback with a mapped ControllerState
+        {
+            std::lock_guard<std::mutex> cb_lk(cb_mtx);
+            if (inject_cb) {
                 XInputPoller::ControllerState cs{};
                 auto to_float = [](int16_t s)->float {
                     return (s >= 0)
                         ? static_cast<float>(static_cast<double>(s) / 32767.0)
                         : static_cast<float>(static_cast<double>(s) / 32768.0);
                 };
-                cs.lx = to_float(rep.sThumbLX);
-                cs.ly = -to_float(rep.sThumbLY);
-                cs.rx = to_float(rep.sThumbRX);
-                cs.ry = -to_float(rep.sThumbRY);
-                cs.lt = rep.bLeftTrigger / 255.0f;
-                cs.rt = rep.bRightTrigger / 255.0f;
-                cs.buttons = rep.wButtons;
-                // timestamp unknown here; use steady_clock
-                using clock = std::chrono::steady_clock;
-                double t = std::chrono::duration<double>(clock::now().time_since_epoch()).count();
-                try { g_inject_cb(t, cs); } catch(...) {}
-            }
-            // send report (only if ViGEm ready)
-            if (g_vigem_ready) {
-                if (g_verbose_mapper) {
-                    std::ostringstream ss;
-                    ss << "HotasMapper: sending X360 report: LX=" << rep.sThumbLX << " LY=" << rep.sThumbLY
-                       << " RX=" << rep.sThumbRX << " RY=" << rep.sThumbRY << " LT=" << (int)rep.bLeftTrigger
-                       << " RT=" << (int)rep.bRightTrigger << " buttons=0x" << std::hex << rep.wButtons << std::dec;
-                    std::cerr << ss.str() << "\n";
-                }
-                VIGEM_ERROR err = vigem_target_x360_update(g_vigem_client, g_vigem_target, rep);
-                if (!VIGEM_SUCCESS(err)) {
-                    // ViGEm update failed; remain silent
-                }
+                cs.lx = to_float(rep.lx);
+                cs.ly = -to_float(rep.ly);
+                cs.rx = to_float(rep.rx);
+                cs.ry = -to_float(rep.ry);
+                cs.lt = rep.left_trigger / 255.0f;
+                cs.rt = rep.right_trigger / 255.0f;
+                cs.buttons = rep.buttons;
+                try { inject_cb(steady_seconds(), cs); } catch(...) {}
             }
         }
-        // Handle keyboard mappings with aggregation + auto-repeat while held
-        if (!g_mappings.empty()) {
-            init_kbd_params_once();
-            std::unordered_map<UINT, bool> desired_active; // vk -> active
-            std::unordered_map<UINT, std::string> vk_names;
-            for (auto &m : g_mappings) {
-                if (m.action.rfind("keyboard:",0) != 0) continue;
-                std::string keyStr = m.action.substr(9);
-                UINT vk = parse_vk(keyStr);
-                if (vk == 0) continue;
-                double v = curvals.count(m.signal_id) ? curvals[m.signal_id] : 0.0;
-                bool active = std::fabs(v) > 0.01; // axes use -1..1; buttons 0/1
-                auto it = desired_active.find(vk);
-                if (it == desired_active.end()) desired_active[vk] = active;
-                else it->second = it->second || active;
-                vk_names[vk] = keyStr;
-            }
-
-            const auto now = std::chrono::steady_clock::now();
-            // Press, repeat, or release as needed
-            for (auto &kv : desired_active) {
-                UINT vk = kv.first; bool want = kv.second;
-                auto &st = g_key_repeat[vk];
-                if (want && !st.pressed) {
-                    send_key(vk, true);
-                    st.pressed = true;
-                    st.name = vk_names[vk];
-                    st.press_time = now;
-                    st.next_repeat = now + std::chrono::milliseconds(g_kbd_params.delay_ms);
-                        if (g_verbose_mapper) {
-                            std::ostringstream ss; ss << "HotasMapper: keydown " << st.name;
-                            std::cerr << ss.str() << "\n";
-                        }
-                } else if (want && st.pressed) {
-                    if (now >= st.next_repeat) {
-                        send_key(vk, true); // generate auto-repeat keydown
-                        st.next_repeat = now + std::chrono::milliseconds(g_kbd_params.interval_ms);
-                        if (g_verbose_mapper) {
-                            std::ostringstream ss; ss << "HotasMapper: keyrepeat " << (st.name.empty()?std::to_string(vk):st.name);
-                            std::cerr << ss.str() << "\n";
-                        }
-                    }
-                } else if (!want && st.pressed) {
-                    send_key(vk, false);
-                    st.pressed = false;
-                        if (g_verbose_mapper) {
-                            std::ostringstream ss; ss << "HotasMapper: keyup " << (st.name.empty()?std::to_string(vk):st.name);
-                            std::cerr << ss.str() << "\n";
-                        }
-                }
-            }
-            // Release any keys no longer desired (not in desired_active)
-            std::vector<UINT> to_release;
-            for (auto &kv : g_key_repeat) {
-                UINT vk = kv.first; auto &st = kv.second;
-                bool want = desired_active.count(vk) ? desired_active[vk] : false;
-                if (st.pressed && !want) to_release.push_back(vk);
-            }
-            for (UINT vk : to_release) {
-                auto it = g_key_repeat.find(vk);
-                if (it != g_key_repeat.end() && it->second.pressed) {
-                    send_key(vk, false);
-                    if (g_verbose_mapper) {
-                        std::ostringstream ss; ss << "HotasMapper: keyup " << (it->second.name.empty()?std::to_string(vk):it->second.name);
-                        std::cerr << ss.str() << "\n";
-                    }
-                    it->second.pressed = false;
+    }
+    // Backend calls are serialized with submit_neutral_now() and stop()
+    std::lock_guard<std::mutex> out_lk(out_mtx);
+    if (ticks_inline.load(std::memory_order_relaxed) && !running.load(std::memory_order_relaxed)) return; // stopped meanwhile
+    if (has_mappings) {
+        // send report (only if the output device is ready)
+        if (backend->ready()) {
+            HOTAS_LOG_DEBUG("mapper", "X360 report LX={} LY={} RX={} RY={} LT={} RT={} buttons={}",
+                            rep.lx, rep.ly, rep.rx, rep.ry, rep.left_trigger, rep.right_trigger, hotas_log::Hex{rep.buttons});
+            backend->submit(rep, OutputTiming{ latest_source_t, tick_t });
+        }
+    }
+    // Handle keyboard mappings with aggregation + auto-repeat while held
+    if (has_keys || keys_held > 0) {
+        if (!kbd_params_inited) {
+            backend->keyboard_repeat(kbd_delay_ms, kbd_interval_ms);
+            kbd_params_inited = true;
+        }
+        const auto now = std::chrono::steady_clock::now();
+        // Press, repeat, or release as needed (keys no longer mapped are released too)
+        for (uint32_t vk = 0; vk < key_repeat.size(); ++vk) {
+            bool want = desired_active[vk] != 0;
+            auto &st = key_repeat[vk];
+            if (want && !st.pressed) {
+                backend->send_key(vk, true);
+                st.pressed = true;
+                ++keys_held;
+                st.press_time = now;
+                st.next_repeat = now + std::chrono::milliseconds(kbd_delay_ms);
+                HOTAS_LOG_DEBUG("mapper", "keydown {} (vk {})", vk_name(vk), vk);
+            } else if (want && st.pressed) {
+                if (now >= st.next_repeat) {
+                    backend->send_key(vk, true); // generate auto-repeat keydown
+                    st.next_repeat = now + std::chrono::milliseconds(kbd_interval_ms);
+                    HOTAS_LOG_DEBUG("mapper", "keyrepeat {} (vk {})", vk_name(vk), vk);
                 }
+            } else if (!want && st.pressed) {
+                backend->send_key(vk, false);
+                st.pressed = false;
+                --keys_held;
+                HOTAS_LOG_DEBUG("mapper", "keyup {} (vk {})", vk_name(vk), vk);
             }
         }
-        auto t1 = clock::now();
-        std::this_thread::sleep_for(period - (t1 - t0));
     }
 }
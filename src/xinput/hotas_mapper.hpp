@@ -6,8 +6,14 @@
 #include <atomic>
 #include <thread>
 #include <mutex>
-#include <tuple>
+#include <condition_variable>
+#include <array>
+#include <memory>
+#include <chrono>
+#include <unordered_map>
 #include "xinput_poll.hpp"
+#include "output_backend.hpp"
+#include "core/stage_queue.hpp"
 
 // Minimal HotasMapper scaffolding: translates logical HOTAS signals into
 // output actions (XInput/keyboard/mouse). This is a starting point and will
@@ -34,16 +40,56 @@ struct MappingEntry {
 
 class HotasMapper {
 public:
-    HotasMapper();
+    // How the publisher thread is woken:
+    //  Fixed       - every 1/target_hz seconds
+    //  EventDriven - as soon as notify_frame() is called (1/target_hz is the idle timeout,
+    //                which keeps keyboard auto-repeat running without input)
+    enum class Pacing { Fixed, EventDriven };
+
+    HotasMapper();  // platform output (ViGEm on Windows)
+    explicit HotasMapper(std::unique_ptr<IOutputBackend> backend);
     ~HotasMapper();
 
     // Start/stop the mapper's publisher thread (publishes at target_hz)
-    void start(double target_hz = 1000.0);
+    void start(double target_hz = 1000.0, Pacing pacing = Pacing::Fixed);
+    // Fused topology: open the output without a publisher thread; the pipeline thread
+    // calls tick() after each pass. stop() waits for a tick in progress.
+    void start_inline();
     void stop();
+    bool is_running() const { return running.load(std::memory_order_relaxed); }
+    Pacing pacing() const { return current_pacing.load(std::memory_order_relaxed); }
+    // Switch pacing while running (e.g. once the device report rate is known)
+    void set_pacing(Pacing pacing);
 
     // Called by the poller when new logical samples are available
-    // (signal_id, value, timestamp)
+    // (signal_id, value, timestamp). timestamp is the source report's arrival time
+    // and is passed through to the output backend.
     void accept_sample(const std::string& signal_id, double value, double timestamp);
+    // Index-based sample path for the pipeline: resolve each id to a slot once with
+    // signal_slot(), then pass whole frames. Slots stay valid for the mapper's lifetime
+    // and this path never allocates.
+    struct SlotSample { int slot; double value; double timestamp; };
+    int signal_slot(const std::string& signal_id);
+    void accept_samples(const SlotSample* samples, size_t count);
+    // Split topology: with depth > 0, accept_samples() pushes frames into a wait-free
+    // SPSC queue that tick() drains, so the pipeline thread never takes the mapper lock.
+    // If the queue is full (publisher behind) the producer drains it and stores under
+    // the lock instead, so no sample is lost or reordered. 0 = always store under the
+    // lock. Call while stopped; accept_samples() then belongs to one producer thread.
+    void set_sample_queue(size_t depth);
+    struct QueueStats {
+        size_t capacity = 0;       // frames; 0 = no queue
+        uint64_t frames = 0;       // pushed
+        uint64_t overflows = 0;    // pushes that found the queue full
+        StageMeter::Snapshot meter; // depth and lag (push -> tick) seen by the publisher
+    };
+    QueueStats sample_queue_stats() const;
+    // Event-driven pacing: wake the publisher now (call once per frame after accept_sample()).
+    void notify_frame();
+
+    // One publish pass: drain samples, resolve mappings, submit to the backend.
+    // Runs on the publisher thread; may be called directly when no thread is started.
+    void tick();
 
     // For UI: list current mapped outputs (brief description)
     std::vector<HotasMappedOutput> list_mappings() const;
@@ -52,6 +98,9 @@ public:
     std::vector<MappingEntry> list_mapping_entries() const;
     bool add_mapping(const MappingEntry& e);
     bool remove_mapping(const std::string& mapping_id);
+    // Bumped whenever the mapping list changes (add/remove/load), so consumers can
+    // re-read list_mapping_entries() only when needed
+    uint64_t mappings_version() const { return mappings_gen.load(std::memory_order_acquire); }
 
     // Persist/load mapping profile (JSON)
     bool save_profile(const std::string& path) const;
@@ -60,12 +109,80 @@ public:
     using InjectCallback = std::function<void(double,const XInputPoller::ControllerState&)>;
     void set_inject_callback(InjectCallback cb);
 
+    IOutputBackend* output_backend() const { return backend.get(); }
+
+    // Stall handling (driven by the watchdog). While held, tick() publishes a centered
+    // report and releases mapped keys whatever the inputs say.
+    void set_neutral_hold(bool on) { hold_neutral.store(on, std::memory_order_relaxed); }
+    bool neutral_hold() const { return hold_neutral.load(std::memory_order_relaxed); }
+    // Center the output and release held keys now, from any thread, for when the publisher
+    // itself is stuck. Returns false if the publisher is inside a backend call.
+    bool submit_neutral_now();
+
 private:
     void publisher_thread_main(double hz);
+    void release_keys();
+    int slot_locked(const std::string& signal_id);
+    void store_sample_locked(int slot, double value, double timestamp);
+    void rebuild_plan_locked();
+    void drain_queue_locked(double now);
 
+    std::unique_ptr<IOutputBackend> backend;
     std::atomic<bool> running{false};
+    std::atomic<bool> ticks_inline{false};
     std::thread* worker = nullptr;
-    // simple sample store (thread-safe minimal); improve later
+    std::atomic<Pacing> current_pacing{Pacing::Fixed};
+    // Sample store and mappings (guarded by mtx)
     mutable std::mutex mtx;
-    std::vector<std::tuple<std::string,double,double>> pending_samples; // id,val,ts
+    std::unordered_map<std::string,int> slot_of;   // signal id -> slot
+    std::vector<double> pending_values;            // latest unpublished value per slot
+    std::vector<uint8_t> pending_dirty;
+    std::vector<int> dirty_slots;                  // capacity kept >= slot count
+    double pending_source_t = 0.0;
+    // Pipeline -> publisher frames (split topology); popped under mtx
+    struct SampleFrame {
+        static constexpr size_t kMaxSamples = 32; // larger batches span several frames
+        double enqueued_t = 0.0;
+        uint32_t count = 0;
+        SlotSample samples[kMaxSamples];
+    };
+    std::unique_ptr<SpscQueue<SampleFrame>> sample_queue;
+    StageMeter queue_meter;
+    std::vector<MappingEntry> mappings;
+    std::atomic<uint64_t> mappings_gen{0};
+    // Mappings compiled to slot indices (rebuilt whenever mappings change)
+    struct Source { int slot; double deadband; int priority; };
+    struct KeyBinding { int slot; uint32_t vk; };
+    struct Plan {
+        std::array<std::vector<Source>, 20> targets; // x360 axes then buttons, priority desc
+        std::vector<KeyBinding> keys;
+        bool has_mappings = false;
+    } plan;
+
+    std::mutex cb_mtx;
+    InjectCallback inject_cb;
+
+    std::atomic<bool> hold_neutral{false};
+    // Serializes backend submit/keys between tick(), submit_neutral_now() and stop(), and
+    // guards the key state below; tick() only hands it the wanted keys computed under mtx
+    std::mutex out_mtx;
+    struct KeyRepeatState {
+        bool pressed = false;
+        std::chrono::steady_clock::time_point press_time;
+        std::chrono::steady_clock::time_point next_repeat;
+    };
+    std::array<KeyRepeatState, 256> key_repeat;    // by virtual-key code
+    int keys_held = 0;
+    int kbd_delay_ms = 250;
+    int kbd_interval_ms = 33;
+    bool kbd_params_inited = false;
+
+    // Event-driven wakeup
+    std::mutex wake_mtx;
+    std::condition_variable wake_cv;
+    bool wake_pending = false;
+
+    // Publisher-side state (only touched by tick(); curvals is sized under mtx)
+    std::vector<double> curvals;                   // current value per slot
+    double latest_source_t = 0.0;
 };
@@ -0,0 +1,463 @@
+#include "hotas_pipeline.hpp"
+#include "core/alloc_guard.hpp"
+#include "core/async_log.hpp"
+#include "core/hid_decode.hpp"
+#include "core/trace.hpp"
+#include "generated/x56_bitmap.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+HotasPipeline::HotasPipeline(std::vector<SignalDescriptor> signals, size_t device_count)
+    : _signals(std::move(signals)) {
+    const size_t n = _signals.size();
+    for (const auto& sd : _signals) if ((size_t)sd.device + 1 > device_count) device_count = (size_t)sd.device + 1;
+    _devices.resize(device_count);
+    _release_pending.assign(device_count, 0);
+    _evaluated_t.assign(device_count, -1.0);
+    _coinc_masks.resize(device_count);
+    _bursts = std::make_unique<std::atomic<uint64_t>[]>(device_count);
+    _device_plans.resize(device_count);
+    _plans.resize(n);
+    _state.resize(n);
+    _spikes.resize(n);
+    _histograms.resize(n);
+    _input_rings.assign(n, nullptr);
+    _biquad_specs.resize(n);
+    _biquad_applied.resize(n);
+    _biquad_lane.assign(n, -1);
+    _modes = std::make_unique<std::atomic<uint8_t>[]>(n);
+    for (size_t i = 0; i < n; ++i) _modes[i].store(FilterNone, std::memory_order_relaxed);
+    _descriptor_values.assign(n, 0.0f);
+    _active = SignalSet(n, true);
+    _polled = SignalSet(n);
+    _active_count = n;
+
+    for (size_t i = 0; i < n; ++i) {
+        const SignalDescriptor& sd = _signals[i];
+        Plan& p = _plans[i];
+        p.device = sd.device;
+        _device_plans[sd.device].push_back(i);
+        p.bit_start = sd.bit_start;
+        p.bits = sd.bits;
+        p.analog = sd.analog;
+        p.multi_bit_digital = !sd.analog && sd.bits > 1;
+        if (sd.analog && sd.bits > 0) _histograms[i] = std::make_unique<AxisHistogram>(sd.bits, sd.norm == SignalNorm::Signed);
+        if (!sd.analog && sd.bits == 1) _coinc_masks[sd.device].add_bits(sd.bit_start, 1);
+        // Normalization and HAT/POV expansion come from the device definition
+        p.norm = sd.norm;
+        p.expand = (!sd.analog && sd.bits == 4) ? sd.expand : SignalExpand::None;
+        // Rate limiter range: normalized signals span 2.0, other analogs their raw integer range
+        if (p.norm != SignalNorm::Raw) p.full_range = 2.0;
+        else if (sd.analog && sd.bits > 0) p.full_range = (double)((1ULL << sd.bits) - 1ULL);
+
+        // Keys are built once here so process() never formats strings
+        const std::string prefix = sd.device_name + ":";
+        p.first_output = _outputs.size();
+        _outputs.push_back(Output{ prefix + sd.id, prefix + sd.name, (int)i, false });
+        auto add_derived = [&](const std::string& sub_id) {
+            _outputs.push_back(Output{ prefix + sub_id, prefix + sub_id, (int)i, true });
+        };
+        if (p.expand == SignalExpand::Hat) {
+            // 4-bit mask: Up(0), Right(1), Down(2), Left(3)
+            add_derived(sd.name + "_UP");
+            add_derived(sd.name + "_RIGHT");
+            add_derived(sd.name + "_DOWN");
+            add_derived(sd.name + "_LEFT");
+        } else if (p.expand == SignalExpand::Pov || p.expand == SignalExpand::HatSwitch) {
+            for (const char* d : { "_UP", "_RIGHT", "_DOWN", "_LEFT", "_UP_RIGHT", "_DOWN_RIGHT", "_DOWN_LEFT", "_UP_LEFT" }) {
+                add_derived(sd.name + d);
+            }
+        }
+    }
+    _values.assign(_outputs.size(), 0.0);
+    _valid.assign(_outputs.size(), 0);
+
+    // A device read with the stock X56 bit map (same fields, same order) decodes with the
+    // generated code, offsets folded into constants; custom layouts keep the generic plan
+    auto same_layout = [&](const std::vector<size_t>& plans, const x56_bitmap::Field* fields, size_t count) {
+        if (plans.size() != count) return false;
+        for (size_t k = 0; k < count; ++k) {
+            if (_plans[plans[k]].bit_start != fields[k].bit_start || _plans[plans[k]].bits != fields[k].bits) return false;
+        }
+        return true;
+    };
+    using Stick = x56_bitmap::Layout<DeviceRegistry::kX56Stick>;
+    using Throttle = x56_bitmap::Layout<DeviceRegistry::kX56Throttle>;
+    _device_decoders.assign(device_count, nullptr);
+    size_t widest = 0;
+    for (size_t d = 0; d < device_count; ++d) {
+        const auto& plans = _device_plans[d];
+        widest = std::max(widest, plans.size());
+        if (same_layout(plans, Stick::fields, Stick::count)) _device_decoders[d] = &Stick::decode;
+        else if (same_layout(plans, Throttle::fields, Throttle::count)) _device_decoders[d] = &Throttle::decode;
+    }
+    _raw.assign(widest, 0);
+
+    // One biquad lane per analog descriptor, banks sized up front so sync_biquads() never allocates
+    _biquads.resize(device_count);
+    for (size_t d = 0; d < device_count; ++d) {
+        DeviceBiquads& bq = _biquads[d];
+        for (size_t k = 0; k < _device_plans[d].size(); ++k) {
+            const size_t i = _device_plans[d][k];
+            if (!_plans[i].analog) continue;
+            _biquad_lane[i] = (int)bq.descriptors.size();
+            bq.descriptors.push_back(i);
+            bq.plan_pos.push_back(k);
+        }
+        bq.bank = BiquadBank(bq.descriptors.size());
+        bq.in.assign(bq.bank.padded_lanes(), 0.0f);
+        bq.out.assign(bq.bank.padded_lanes(), 0.0f);
+        bq.reprime.assign(bq.descriptors.size(), 0);
+    }
+}
+
+void HotasPipeline::set_mapper(HotasMapper* mapper) {
+    _mapper = mapper;
+    _mapper_slots.assign(_outputs.size(), -1);
+    _frame.assign(_outputs.size(), HotasMapper::SlotSample{ -1, 0.0, 0.0 });
+    if (!_mapper) return;
+    for (size_t k = 0; k < _outputs.size(); ++k) _mapper_slots[k] = _mapper->signal_slot(_outputs[k].map_key);
+}
+
+void HotasPipeline::set_signal_bus(const SignalBus* bus) {
+    _bus = bus && bus->signal_count() == _plans.size() ? bus : nullptr;
+    _bus_seen = 0; // poll on the next pass
+    if (!_bus) {
+        _active = SignalSet(_plans.size(), true);
+        _active_count = _plans.size();
+    }
+}
+
+SignalSet HotasPipeline::interest_for(const std::vector<std::string>& map_keys) const {
+    SignalSet set(_plans.size());
+    for (const auto& key : map_keys) {
+        for (const auto& o : _outputs) if (o.map_key == key) { set.set((size_t)o.descriptor); break; }
+    }
+    return set;
+}
+
+void HotasPipeline::sync_interest() {
+    if (!_bus || !_bus->poll(_bus_seen, _polled)) return;
+    for (size_t i = 0; i < _plans.size(); ++i) {
+        if (_active.test(i) == _polled.test(i)) continue;
+        // Re-subscribed: no history from before the gap. Dropped: nothing stale goes out.
+        _state[i] = InputFilterState{};
+        _spikes[i] = SpikeDetector{};
+        if (_biquad_lane[i] >= 0) {
+            DeviceBiquads& bq = _biquads[_plans[i].device];
+            bq.reprime[(size_t)_biquad_lane[i]] = 1;
+            bq.pending = true;
+        }
+        _descriptor_values[i] = 0.0f;
+        const size_t end = i + 1 < _plans.size() ? _plans[i + 1].first_output : _outputs.size();
+        for (size_t k = _plans[i].first_output; k < end; ++k) { _values[k] = 0.0; _valid[k] = 0; }
+    }
+    std::swap(_active, _polled);
+    _active_count = _active.count();
+}
+
+void HotasPipeline::set_filter_mode(const std::string& map_key, int mode) {
+    if (mode < FilterNone || mode > FilterSpike) mode = FilterNone;
+    for (size_t i = 0; i < _plans.size(); ++i) {
+        if (_outputs[_plans[i].first_output].map_key == map_key) {
+            _modes[i].store((uint8_t)mode, std::memory_order_relaxed);
+            return;
+        }
+    }
+}
+
+void HotasPipeline::set_filter_params(double analog_delta_percent, double digital_max_ms) {
+    _analog_delta.store(analog_delta_percent, std::memory_order_relaxed);
+    _digital_max_ms.store(digital_max_ms, std::memory_order_relaxed);
+}
+
+void HotasPipeline::set_coincidence_params(int min_bits, double axis_jump_percent, double hold_ms) {
+    _coinc_axis_jump.store(axis_jump_percent, std::memory_order_relaxed);
+    _coinc_hold_ms.store(hold_ms, std::memory_order_relaxed);
+    _coinc_min_bits.store(std::max(0, min_bits), std::memory_order_relaxed);
+}
+
+void HotasPipeline::set_spike_params(double k_sigma, double return_percent) {
+    _spike_return.store(return_percent, std::memory_order_relaxed);
+    _spike_k.store(std::max(0.0, k_sigma), std::memory_order_relaxed);
+}
+
+void HotasPipeline::set_histogram_period(double seconds) {
+    for (auto& h : _histograms) if (h) h->set_period(seconds);
+}
+
+void HotasPipeline::reset_histograms() {
+    for (auto& h : _histograms) if (h) h->request_reset();
+}
+
+void HotasPipeline::set_biquad_chain(const std::string& map_key, const BiquadChainSpec& chain) {
+    for (size_t i = 0; i < _plans.size(); ++i) {
+        if (_biquad_lane[i] < 0 || _outputs[_plans[i].first_output].map_key != map_key) continue;
+        std::lock_guard<std::mutex> g(_biquad_mutex);
+        _biquad_specs[i] = chain;
+        _biquad_gen.fetch_add(1, std::memory_order_release);
+        return;
+    }
+}
+
+BiquadChainSpec HotasPipeline::biquad_chain(size_t descriptor) const {
+    std::lock_guard<std::mutex> g(_biquad_mutex);
+    return descriptor < _biquad_specs.size() ? _biquad_specs[descriptor] : BiquadChainSpec{};
+}
+
+void HotasPipeline::set_input_rings(std::vector<SampleRing*> rings) {
+    rings.resize(_plans.size(), nullptr);
+    _input_rings = std::move(rings);
+}
+
+void HotasPipeline::sync_biquads() {
+    const uint64_t gen = _biquad_gen.load(std::memory_order_acquire);
+    if (gen == _biquad_seen) return;
+    std::lock_guard<std::mutex> g(_biquad_mutex);
+    _biquad_seen = gen;
+    for (DeviceBiquads& bq : _biquads) {
+        bq.on = false;
+        for (size_t l = 0; l < bq.descriptors.size(); ++l) {
+            const size_t i = bq.descriptors[l];
+            if (_biquad_specs[i] != _biquad_applied[i]) {
+                _biquad_applied[i] = _biquad_specs[i];
+                bq.bank.set_lane(l, _biquad_applied[i]);
+                bq.reprime[l] = 1;
+                bq.pending = true;
+            }
+            if (!_biquad_applied[i].empty()) bq.on = true;
+        }
+    }
+}
+
+void HotasPipeline::detect_burst(size_t device, const uint8_t* data, size_t len, double t, int min_bits) {
+    DeviceReport& d = _devices[device];
+    const int flips = _coinc_masks[device].flips(d.data, data, len);
+    if (flips == 0) return; // the common case: one popcount per mask word
+    // Some button flipped: did an axis jump in the same report?
+    const double jump = _coinc_axis_jump.load(std::memory_order_relaxed) / 100.0;
+    bool spike = false;
+    for (size_t i : _device_plans[device]) {
+        const Plan& p = _plans[i];
+        if (!p.analog) continue;
+        const double a = normalize_signal(p.norm, extract_bits(d.data, d.len, p.bit_start, p.bits), p.bits);
+        const double b = normalize_signal(p.norm, extract_bits(data, len, p.bit_start, p.bits), p.bits);
+        if (std::fabs(b - a) >= jump * p.full_range) { spike = true; break; }
+    }
+    if (flips < min_bits && !spike) return;
+    d.hold_until = t + _coinc_hold_ms.load(std::memory_order_relaxed) / 1000.0;
+    d.axis_spike = spike;
+    _bursts[device].store(_bursts[device].load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    HOTAS_LOG_DEBUG("pipeline", "ghost burst on device {}: {} buttons flipped{}", device, flips, spike ? " with an axis jump" : "");
+}
+
+void HotasPipeline::ingest(DeviceIndex device, const uint8_t* data, size_t len, double t) {
+    if (device >= _devices.size()) return;
+    DeviceReport& d = _devices[device];
+    if (len > HidReport::kMaxBytes) len = HidReport::kMaxBytes;
+    d.axis_spike = false;
+    const int min_bits = _coinc_min_bits.load(std::memory_order_relaxed);
+    if (min_bits > 0 && d.len == len) detect_burst(device, data, len, t, min_bits);
+    std::memcpy(d.data, data, len);
+    d.len = (uint16_t)len;
+    d.t = t;
+}
+
+uint32_t HotasPipeline::report_mask() const {
+    uint32_t mask = 0;
+    for (size_t d = 0; d < _devices.size(); ++d) if (_devices[d].len > 0) mask |= 1u << d;
+    return mask;
+}
+
+void HotasPipeline::clear_reports() {
+    for (auto& d : _devices) d = DeviceReport{};
+}
+
+void HotasPipeline::clear_report(DeviceIndex device) {
+    if (device >= _devices.size() || _devices[device].len == 0) return;
+    _devices[device] = DeviceReport{};
+    _release_pending[device] = 1;
+    _evaluated_t[device] = -1.0;
+    for (size_t i : _device_plans[device]) _spikes[i] = SpikeDetector{};
+    DeviceBiquads& bq = _biquads[device];
+    std::fill(bq.reprime.begin(), bq.reprime.end(), (uint8_t)1); // no transient from the old level on reconnect
+    bq.pending = true;
+}
+
+double HotasPipeline::condition(size_t i, uint64_t raw, int mode, double t, bool fresh, const SpikeParams& spike) {
+    const Plan& p = _plans[i];
+    double v = normalize_signal(p.norm, raw, p.bits); // Raw: analog 0..(2^bits-1) or digital/multi-bit value
+    if (!p.analog) return v;
+    SpikeDetector& sd = _spikes[i];
+    if (fresh) {
+        if (AxisHistogram* h = _histograms[i].get()) h->record(raw, t);
+        if (SampleRing* ring = _input_rings[i]) ring->push(t, (float)v);
+        if (spike.k_sigma > 0.0 && sd.update(v, spike, p.full_range) == SpikeDetector::State::Start) {
+            _anomalies.push(AnomalyEvent{ t, (uint32_t)i, (float)v, (float)sd.baseline, (float)sd.z });
+        }
+    }
+    if (mode == FilterSpike && spike.k_sigma > 0.0 && sd.in_spike()) v = sd.baseline;
+    return v;
+}
+
+double HotasPipeline::filter(size_t i, double v, double now, int mode, double analog_delta, double digital_max_s) {
+    HOTAS_NO_ALLOC_ZONE("filter");
+    const Plan& p = _plans[i];
+    InputFilterState& st = _state[i];
+    if (mode == FilterAnalog) return filter_analog(st, v, p.full_range, analog_delta);
+    if (mode == FilterDigital) return filter_digital(st, v, now, digital_max_s, p.analog, p.multi_bit_digital);
+    return filter_none(st, v);
+}
+
+void HotasPipeline::process(double now, bool notify) {
+    size_t n = 0;
+    {
+        HOTAS_TRACE_SCOPE("pipeline.filter_map");
+        HOTAS_NO_ALLOC_ZONE("pipeline.filter_map");
+        sync_interest();
+        sync_biquads();
+        for (size_t d = 0; d < _devices.size(); ++d) evaluate_device(d, now, n);
+    }
+    forward(n, notify);
+}
+
+void HotasPipeline::process_frame(const MergedFrame& f, bool notify) {
+    const MergedFrame::Part& part = f.parts[f.trigger];
+    if (part.len > 0) ingest(f.trigger, part.data, part.len, part.t);
+    size_t n = 0;
+    {
+        HOTAS_TRACE_SCOPE("pipeline.filter_map");
+        HOTAS_NO_ALLOC_ZONE("pipeline.filter_map");
+        sync_interest();
+        sync_biquads();
+        if (f.trigger < _devices.size()) evaluate_device(f.trigger, f.t, n);
+        // A disconnected device's release goes out with the next frame, whoever triggers it
+        for (size_t d = 0; d < _devices.size(); ++d) {
+            if (_release_pending[d] && d != f.trigger) evaluate_device(d, f.t, n);
+        }
+    }
+    forward(n, notify);
+}
+
+void HotasPipeline::evaluate_device(size_t device, double now, size_t& n) {
+    const double analog_delta = _analog_delta.load(std::memory_order_relaxed);
+    const double digital_max_s = _digital_max_ms.load(std::memory_order_relaxed) / 1000.0;
+    SpikeParams spike;
+    spike.k_sigma = _spike_k.load(std::memory_order_relaxed);
+    spike.return_fraction = _spike_return.load(std::memory_order_relaxed) / 100.0;
+    const DeviceReport& dev = _devices[device];
+    const bool release = _release_pending[device] != 0;
+    const bool held = now < dev.hold_until;
+    _release_pending[device] = 0;
+    const std::vector<size_t>& plans = _device_plans[device];
+    const DecodeFn decode = _device_decoders[device];
+    if (decode && dev.len > 0) decode(dev.data, dev.len, _raw.data());
+    // process() re-evaluates devices without a new report: detectors and biquads step once per report
+    const bool fresh = dev.len > 0 && dev.t != _evaluated_t[device];
+    _evaluated_t[device] = dev.t;
+    DeviceBiquads& bq = _biquads[device];
+    if (bq.on && dev.len > 0 && !dev.axis_spike && (fresh || bq.pending)) {
+        // All of the device's biquad lanes in one pass; their descriptors take bq.out below.
+        // A (re)started lane is primed to its input and passes it until the next report.
+        for (size_t l = 0; l < bq.descriptors.size(); ++l) {
+            const size_t i = bq.descriptors[l];
+            if (!_active.test(i)) continue;
+            const Plan& p = _plans[i];
+            const uint64_t raw = decode ? _raw[bq.plan_pos[l]] : extract_bits(dev.data, dev.len, p.bit_start, p.bits);
+            bq.in[l] = (float)condition(i, raw, _modes[i].load(std::memory_order_relaxed), dev.t, fresh, spike);
+            if (bq.reprime[l]) {
+                bq.bank.prime(l, bq.in[l]);
+                bq.out[l] = bq.in[l];
+                bq.reprime[l] = 0;
+            }
+        }
+        if (fresh) bq.bank.process(bq.in.data(), bq.out.data());
+        bq.pending = false;
+    }
+    for (size_t pi = 0; pi < plans.size(); ++pi) {
+        const size_t i = plans[pi];
+        if (!_active.test(i)) continue; // no consumer
+        const Plan& p = _plans[i];
+        // Ghost burst: digital signals keep their values through the hold, axes skip the spiking report
+        if (dev.len > 0 && (p.analog ? dev.axis_spike : held)) continue;
+        const size_t out0 = p.first_output;
+        const size_t out_count = (i + 1 < _plans.size() ? _plans[i + 1].first_output : _outputs.size()) - out0;
+        if (dev.len == 0) {
+            for (size_t k = 0; k < out_count; ++k) {
+                _values[out0 + k] = 0.0;
+                _valid[out0 + k] = release ? 1 : 0;
+            }
+            _descriptor_values[i] = 0.0f;
+        } else {
+            const int mode = _modes[i].load(std::memory_order_relaxed);
+            const int lane = _biquad_lane[i];
+            double v;
+            if (bq.on && lane >= 0) {
+                v = bq.out[(size_t)lane];
+            } else {
+                const uint64_t raw = decode ? _raw[pi] : extract_bits(dev.data, dev.len, p.bit_start, p.bits);
+                v = condition(i, raw, mode, dev.t, fresh, spike);
+            }
+            const double out_v = filter(i, v, now, mode, analog_delta, digital_max_s);
+            _descriptor_values[i] = (float)out_v;
+            _values[out0] = out_v;
+            _valid[out0] = 1;
+            if (p.expand == SignalExpand::Hat) {
+                int mask = (int)out_v;
+                for (int b = 0; b < 4; ++b) _values[out0 + 1 + b] = ((mask >> b) & 1) ? 1.0 : 0.0;
+            } else if (p.expand == SignalExpand::Pov || p.expand == SignalExpand::HatSwitch) {
+                // 0-8 enumerated (None, Up, Up-Right, Right, Down-Right, Down, Down-Left, Left, Up-Left);
+                // a HID hat switch counts 0-7 from Up and reports anything else as none
+                int pv = (int)out_v;
+                if (p.expand == SignalExpand::HatSwitch) pv = (pv >= 0 && pv <= 7) ? pv + 1 : 0;
+                bool none = (pv == 0);
+                bool up = (pv == 1 || pv == 2 || pv == 8);
+                bool right = (pv == 2 || pv == 3 || pv == 4);
+                bool down = (pv == 4 || pv == 5 || pv == 6);
+                bool left = (pv == 6 || pv == 7 || pv == 8);
+                double* o = &_values[out0 + 1];
+                o[0] = up && !none ? 1.0 : 0.0;
+                o[1] = right && !none ? 1.0 : 0.0;
+                o[2] = down && !none ? 1.0 : 0.0;
+                o[3] = left && !none ? 1.0 : 0.0;
+                o[4] = (pv == 2) ? 1.0 : 0.0;
+                o[5] = (pv == 4) ? 1.0 : 0.0;
+                o[6] = (pv == 6) ? 1.0 : 0.0;
+                o[7] = (pv == 8) ? 1.0 : 0.0;
+            }
+            for (size_t k = 1; k < out_count; ++k) _valid[out0 + k] = 1;
+        }
+        // Queue this descriptor's outputs for the mapper
+        if (!_mapper) continue;
+        for (size_t k = out0; k < out0 + out_count; ++k) {
+            if (_valid[k]) _frame[n++] = HotasMapper::SlotSample{ _mapper_slots[k], _values[k], dev.t };
+        }
+    }
+}
+
+void HotasPipeline::forward(size_t n, bool notify) {
+    if (!_mapper) return;
+    HOTAS_TRACE_SCOPE("pipeline.forward");
+    HOTAS_NO_ALLOC_ZONE("pipeline.forward");
+    _mapper->accept_samples(_frame.data(), n);
+    if (notify) notify_mapper();
+}
+
+void HotasPipeline::notify_mapper() {
+    if (_mapper && _mapper->pacing() == HotasMapper::Pacing::EventDriven) _mapper->notify_frame();
+}
+
+std::vector<std::vector<Sample>> recorded_analog_inputs(const std::vector<HotasReader::SignalDescriptor>& signals,
+                                                        const std::vector<RecordedReport>& reports) {
+    std::vector<std::vector<Sample>> out(signals.size());
+    for (const RecordedReport& r : reports) {
+        for (size_t i = 0; i < signals.size(); ++i) {
+            const auto& sd = signals[i];
+            if (!sd.analog || sd.bits <= 0 || sd.device_name != r.device) continue;
+            const uint64_t raw = extract_bits(r.bytes.data(), r.bytes.size(), sd.bit_start, sd.bits);
+            out[i].push_back(Sample{ r.t, (float)normalize_signal(sd.norm, raw, sd.bits) });
+        }
+    }
+    return out;
+}
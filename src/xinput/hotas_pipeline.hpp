@@ -0,0 +1,234 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "hotas_reader.hpp"
+#include "hotas_mapper.hpp"
+#include "core/anomaly_ring.hpp"
+#include "core/axis_histogram.hpp"
+#include "core/biquad.hpp"
+#include "core/coincidence_filter.hpp"
+#include "core/frame_merger.hpp"
+#include "core/hid_report_ring.hpp"
+#include "core/input_filters.hpp"
+#include "core/report_recording.hpp"
+#include "core/ring_buffer.hpp"
+#include "core/signal_bus.hpp"
+#include "core/spike_detector.hpp"
+
+// Decode -> filter -> map stage for the registered devices' reports.
+// Keeps the latest raw report of each device (by registry index) plus all per-signal
+// filter state.
+// process() evaluates every descriptor (or those a signal bus has subscribers for),
+// including the HAT/POV direction signals derived from them, and forwards the results to the mapper, stamped with the arrival
+// time of the report they came from; process_frame() does the same for the one
+// device that reported.
+//
+// ingest()/process() belong to a single pipeline thread. Filter modes and
+// parameters are atomics and may be changed from the UI thread at any time.
+class HotasPipeline {
+public:
+    using SignalDescriptor = HotasReader::SignalDescriptor;
+
+    // FilterSpike: analog samples inside a detected spike are replaced by the level before it
+    enum FilterMode : uint8_t { FilterNone = 0, FilterDigital = 1, FilterAnalog = 2, FilterSpike = 3 };
+
+    // One value produced by process(): a descriptor signal or a direction derived from it.
+    struct Output {
+        std::string map_key;   // mapper id, e.g. "stick:joy_x", "stick:H1_UP"
+        std::string plot_key;  // filtered-plot id, e.g. "stick:JOY_X", "stick:H1_UP"
+        int descriptor = -1;   // index into signals()
+        bool derived = false;  // HAT/POV direction
+    };
+
+    // device_count: number of registry devices; 0 = one past the highest device in `signals`.
+    explicit HotasPipeline(std::vector<SignalDescriptor> signals, size_t device_count = 0);
+
+    // Resolves every output's mapper slot up front, so process() forwards by index.
+    void set_mapper(HotasMapper* mapper);
+    const std::vector<SignalDescriptor>& signals() const { return _signals; }
+    const std::vector<Output>& outputs() const { return _outputs; }
+    size_t device_count() const { return _devices.size(); }
+
+    // Filter configuration (any thread). map_key is "<device>:<id>".
+    void set_filter_mode(const std::string& map_key, int mode);
+    int filter_mode(size_t descriptor) const { return _modes[descriptor].load(std::memory_order_relaxed); }
+    // analog_delta_percent: max step per sample as % of full range; digital_max_ms: hold time
+    void set_filter_params(double analog_delta_percent, double digital_max_ms);
+    // Ghost burst filter (any thread). A report in which min_bits or more one-bit digital
+    // fields flip at once, or an axis jumps by axis_jump_percent of its range while any of
+    // them flips, is treated as a burst: the device's digital signals keep their values
+    // until hold_ms after it and its axes ignore that report. min_bits 0 turns it off.
+    void set_coincidence_params(int min_bits, double axis_jump_percent, double hold_ms);
+    uint64_t coincidence_bursts(DeviceIndex device) const { return _bursts[device].load(std::memory_order_relaxed); }
+    // Spike detector on every evaluated analog signal (any thread): a first difference
+    // k_sigma or more from its running mean opens a spike, which ends once the value is
+    // back within return_percent of full range of the level before it (see
+    // spike_detector.hpp). Spikes go to anomalies(); FilterSpike signals also hold the
+    // earlier level through them. k_sigma 0 turns it off.
+    void set_spike_params(double k_sigma, double return_percent);
+    const AnomalyRing& anomalies() const { return _anomalies; }
+
+    // Value/step histograms of each analog descriptor's raw codes, recorded as it is
+    // evaluated (null for digital descriptors). Period and reset may be set from any
+    // thread and take effect on the next sample; see axis_histogram.hpp.
+    AxisHistogram* axis_histogram(size_t descriptor) const { return _histograms[descriptor].get(); }
+    void set_histogram_period(double seconds);
+    void reset_histograms();
+
+    // Notch/low-pass sections per analog signal (any thread), applied after spike
+    // rejection and before the filter mode (see biquad.hpp). A device's axes with
+    // sections run together, one SIMD lane each, once per new report. Changes are picked
+    // up at the start of the next process()/process_frame(); a changed lane starts primed
+    // to its next input. map_key is "<device>:<id>"; an empty chain removes the sections.
+    void set_biquad_chain(const std::string& map_key, const BiquadChainSpec& chain);
+    BiquadChainSpec biquad_chain(size_t descriptor) const;
+
+    // Rings (by descriptor, null = none) that receive each new report's analog value
+    // before any filtering, e.g. for the spectrum analyzer. Set before the first process().
+    void set_input_rings(std::vector<SampleRing*> rings);
+
+    // Evaluate only the descriptors some consumer of `bus` is interested in (null = all).
+    // Changes are picked up at the start of the next process()/process_frame(); a
+    // descriptor that becomes wanted again starts with fresh filter state. One that is
+    // dropped reads 0 (invalid) here but forwards nothing, so the mapper keeps the last
+    // value it got for it.
+    void set_signal_bus(const SignalBus* bus);
+    bool signal_active(size_t descriptor) const { return _active.test(descriptor); }
+    size_t active_signal_count() const { return _active_count; }
+    // Descriptors behind the given mapper ids ("stick:joy_x", "stick:H1_UP"): a profile's interest
+    SignalSet interest_for(const std::vector<std::string>& map_keys) const;
+
+    // Latest raw report for a device.
+    void ingest(DeviceIndex device, const uint8_t* data, size_t len, double t);
+    void ingest(DeviceIndex device, const HidReport& r) { ingest(device, r.data, r.len, r.t); }
+    bool has_report(DeviceIndex device) const { return _devices[device].len > 0; }
+    double report_time(DeviceIndex device) const { return _devices[device].t; }
+    // Bit per device index with a report
+    uint32_t report_mask() const;
+    void clear_reports();
+    // Forget one device's report (it disconnected). The next process() forwards 0 for that
+    // device's outputs once, so nothing it drove stays deflected, then marks them invalid.
+    void clear_report(DeviceIndex device);
+
+    // Evaluate all signals of devices that have reported; `now` drives debounce timing.
+    // With notify=false an event-driven mapper is not woken; call notify_mapper() after
+    // the last of several frames evaluated back to back.
+    void process(double now, bool notify = true);
+    // Ingest a merged frame's triggering report and evaluate only that device's signals,
+    // at the frame time (plus any pending disconnect release). The other devices' outputs
+    // keep their last values, so each device is filtered once per report of its own and
+    // a frame costs the same however many devices are attached.
+    void process_frame(const MergedFrame& f, bool notify = true);
+    void notify_mapper();
+
+    // Results of the last process(): values()[i] / output_valid(i) belong to outputs()[i].
+    const std::vector<double>& values() const { return _values; }
+    bool output_valid(size_t i) const { return _valid[i] != 0; }
+    // Filtered value per descriptor (0 for devices without a report), e.g. for telemetry
+    const std::vector<float>& descriptor_values() const { return _descriptor_values; }
+
+private:
+    struct Plan {
+        uint8_t device = 0;
+        int bit_start = 0;
+        int bits = 0;
+        bool analog = false;
+        bool multi_bit_digital = false;
+        SignalNorm norm = SignalNorm::Raw;
+        SignalExpand expand = SignalExpand::None;
+        double full_range = 1.0;  // range used by the analog rate limiter
+        size_t first_output = 0;  // parent output; derived outputs follow it
+    };
+
+    struct DeviceReport {
+        double t = 0.0;
+        double hold_until = -1.0;  // ghost burst: digital signals frozen until then
+        bool axis_spike = false;   // ghost burst with an axis jump: axes skip this report
+        uint16_t len = 0;
+        uint8_t data[HidReport::kMaxBytes] = {};
+    };
+
+    // Biquad lanes of one device; descriptors and plan positions by lane
+    struct DeviceBiquads {
+        BiquadBank bank;
+        std::vector<size_t> descriptors;
+        std::vector<size_t> plan_pos;
+        std::vector<float> in, out;     // padded lanes
+        std::vector<uint8_t> reprime;   // prime the lane with its next input
+        bool pending = false;           // some lane waits for reprime
+        bool on = false;                // any lane has a section
+    };
+
+    // Raw code -> value the filter mode sees: histogram, input ring and spike detector
+    // (updated only for a new report), then spike rejection
+    double condition(size_t i, uint64_t raw, int mode, double t, bool fresh, const SpikeParams& spike);
+    double filter(size_t i, double v, double now, int mode, double analog_delta, double digital_max_s);
+    // Compare an incoming report with the device's previous one (ghost burst filter)
+    void detect_burst(size_t device, const uint8_t* data, size_t len, double t, int min_bits);
+    // Evaluate one device's descriptors, appending their valid outputs to _frame[n...]
+    void evaluate_device(size_t device, double now, size_t& n);
+    void forward(size_t n, bool notify);
+    // Take a changed interest union from the bus
+    void sync_interest();
+    // Take changed biquad chains into the banks
+    void sync_biquads();
+
+    std::vector<SignalDescriptor> _signals;
+    std::vector<Plan> _plans;
+    std::vector<std::vector<size_t>> _device_plans; // plan indices per device
+    std::vector<Output> _outputs;
+    std::vector<InputFilterState> _state;
+    std::unique_ptr<std::atomic<uint8_t>[]> _modes;
+    std::atomic<double> _analog_delta{5.0};   // FilterSettings defaults
+    std::atomic<double> _digital_max_ms{5.0};
+    std::atomic<int> _coinc_min_bits{0};
+    std::atomic<double> _coinc_axis_jump{25.0};
+    std::atomic<double> _coinc_hold_ms{20.0};
+    std::vector<CoincidenceMask> _coinc_masks;              // one-bit digital fields per device
+    std::unique_ptr<std::atomic<uint64_t>[]> _bursts;       // per device
+    std::atomic<double> _spike_k{0.0};
+    std::atomic<double> _spike_return{15.0};
+    std::vector<SpikeDetector> _spikes;                     // per descriptor (analog only)
+    std::vector<std::unique_ptr<AxisHistogram>> _histograms; // per descriptor (analog only)
+    AnomalyRing _anomalies;
+    std::vector<SampleRing*> _input_rings;                  // per descriptor
+    mutable std::mutex _biquad_mutex;
+    std::vector<BiquadChainSpec> _biquad_specs;             // per descriptor, guarded by _biquad_mutex
+    std::atomic<uint64_t> _biquad_gen{0};                   // bumped by set_biquad_chain
+    uint64_t _biquad_seen = 0;
+    std::vector<BiquadChainSpec> _biquad_applied;           // per descriptor, pipeline thread
+    std::vector<int> _biquad_lane;                          // per descriptor, -1 = none
+    std::vector<DeviceBiquads> _biquads;                    // by device
+
+    // Straight-line decoder for a device whose signals are exactly a built-in X56 layout
+    // (generated from the stock bit map); null = extract each plan's bits generically
+    using DecodeFn = void (*)(const uint8_t* report, size_t len, uint64_t* out);
+    std::vector<DecodeFn> _device_decoders;  // by device index
+    std::vector<uint64_t> _raw;              // decoder output, sized to the largest device
+
+    const SignalBus* _bus = nullptr;
+    uint64_t _bus_seen = 0;
+    SignalSet _active;                       // descriptors evaluated
+    SignalSet _polled;                       // poll() target, swapped with _active
+    size_t _active_count = 0;
+
+    std::vector<DeviceReport> _devices;      // by device index
+    std::vector<uint8_t> _release_pending;   // by device index
+    std::vector<double> _evaluated_t;        // by device index: report time last evaluated
+    std::vector<double> _values;
+    std::vector<uint8_t> _valid;
+    std::vector<float> _descriptor_values;
+    HotasMapper* _mapper = nullptr;
+    std::vector<int> _mapper_slots;     // per output
+    std::vector<HotasMapper::SlotSample> _frame; // forwarded samples, sized to outputs
+};
+
+// Input samples of every analog descriptor in a recording, as set_input_rings() would
+// have collected them live (by descriptor, empty for digital ones); reports of devices
+// none of `signals` belongs to are skipped. Offline source for the spectrum analyzer.
+std::vector<std::vector<Sample>> recorded_analog_inputs(const std::vector<HotasReader::SignalDescriptor>& signals,
+                                                        const std::vector<RecordedReport>& reports);
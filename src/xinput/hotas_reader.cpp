@@ -1,4 +1,11 @@
 #include "hotas_reader.hpp"
+#include "core/trace.hpp"
+#include "core/hid_decode.hpp"
+#include "core/report_stats.hpp"
+#include "core/alloc_guard.hpp"
+#include "core/async_log.hpp"
+#include "core/stall_watchdog.hpp"
+#include "core/thread_roles.hpp"
 #ifndef WIN32_LEAN_AND_MEAN
 #define WIN32_LEAN_AND_MEAN
 #endif
@@ -25,6 +32,7 @@
 #include <map>
 #include <mutex>
 #include <algorithm>
+#include <cstring>
 #include <fstream>
 
 struct HotasReader::HotasReaderInternalState {
@@ -34,24 +42,62 @@ struct HotasReader::HotasReaderInternalState {
     std::atomic<double> latest{0.0};
     std::vector<SignalDescriptor> signals; // loaded from CSV on startup
 
-    // HID device handles (invalid if not opened)
-    HANDLE stick_handle = INVALID_HANDLE_VALUE;
-    HANDLE throttle_handle = INVALID_HANDLE_VALUE;
-
     // Temporary live monitor
     std::atomic<bool> live_running{false};
     std::vector<std::thread> live_threads;
     std::vector<HANDLE> live_handles;
     mutable std::mutex live_mutex;
-    struct LiveEntry { std::string hex; double ts; };
-    std::map<std::string, LiveEntry> live_last; // devicePath -> {hex, timestamp}
+    // Latest raw report per interface; hex for the UI is produced on demand
+    struct LiveEntry { double ts = 0.0; uint16_t len = 0; uint8_t data[HidReport::kMaxBytes] = {}; };
+    std::map<std::string, LiveEntry> live_last; // devicePath -> {timestamp, bytes} (len 0 = no data yet)
+    DeviceRegistry devices;
+    // Per registered device, by registry index. Reader threads resolve their device once
+    // when they start and then only touch its DeviceState.
+    struct DeviceState {
+        // Raw reports for the pipeline (the device's report interface); written by its reader thread
+        HidReportRing reports{256};
+        // Arrival statistics of the same interface
+        ReportIntervalStats stats;
+        // Liveness, written by each of the device's reader threads
+        std::atomic<int64_t> last_report_ns{0};
+        std::atomic<uint64_t> report_count{0};
+        std::atomic<uint64_t> changes{0};
+        std::atomic<bool> connected{false};
+        // Input report ID the signals decode; reports with other IDs stay out of the ring (0 = all)
+        uint8_t report_id = 0;
+        // Connection-only handle opened at startup (invalid if not present)
+        HANDLE handle = INVALID_HANDLE_VALUE;
+    };
+    std::vector<std::unique_ptr<DeviceState>> device_state;
+    std::mutex liveness_handler_mutex;
+    LivenessHandler liveness_handler;
+
+    // Flip the connected flag; the thread that flips it reports the transition
+    void set_connected(DeviceIndex device, bool on) {
+        DeviceState& d = *device_state[device];
+        if (d.connected.exchange(on, std::memory_order_acq_rel) == on) return;
+        d.changes.fetch_add(1, std::memory_order_relaxed);
+        std::lock_guard<std::mutex> g(liveness_handler_mutex);
+        if (liveness_handler) liveness_handler(device, on);
+    }
 };
 
-static std::vector<std::string> s_debug_lines;
+// Consider a device connected only with recent HID activity
+static constexpr int64_t kLiveTimeoutNs = 500000000;
+
+static int64_t steady_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Start of the latest enumerate_devices() pass; debug_lines() returns the "hid" log lines since then
+static std::atomic<int64_t> s_enumerate_started_ns{0};
 
 // debug_lines returns any collected debug strings (may be empty)
 std::vector<std::string> HotasReader::debug_lines() {
-    return s_debug_lines;
+    hotas_log::flush();
+    std::vector<std::string> out;
+    for (auto &l : hotas_log::recent("hid", s_enumerate_started_ns.load())) out.push_back(std::move(l.text));
+    return out;
 }
 
 static std::string wcs_to_utf8(const wchar_t* w) {
@@ -65,12 +111,16 @@ static std::string wcs_to_utf8(const wchar_t* w) {
     return out;
 }
 
-HotasReader::HotasReader() {
+HotasReader::HotasReader(DeviceRegistry devices) {
     internal_state = new HotasReaderInternalState();
+    internal_state->devices = std::move(devices);
+    for (size_t d = 0; d < internal_state->devices.size(); ++d) {
+        internal_state->device_state.push_back(std::make_unique<HotasReaderInternalState::DeviceState>());
+    }
 
-    // Attempt to enumerate HID devices and open Saitek stick/throttle handles.
+    // Attempt to enumerate HID devices and open a handle per registered device.
     auto lines = HotasReader::enumerate_devices();
-    // enumerate_devices also populates s_debug_lines; we now try to open handles
+    // enumerate_devices also logs its failures (see debug_lines); we now try to open handles
     // by re-scanning and opening the matching device paths.
 
     GUID hidGuid;
@@ -79,7 +129,7 @@ HotasReader::HotasReader() {
 
     HDEVINFO devInfo = SetupDiGetClassDevsW(&hidGuid, NULL, NULL, DIGCF_PRESENT | DIGCF_DEVICEINTERFACE);
     if (devInfo == INVALID_HANDLE_VALUE) {
-        s_debug_lines.push_back("SetupDiGetClassDevsW failed");
+        HOTAS_LOG_LIMITED(hotas_log::Level::Warn, "hid", 0, "SetupDiGetClassDevsW failed");
         return;
     }
 
@@ -95,8 +145,7 @@ HotasReader::HotasReader() {
         SP_DEVINFO_DATA devInfoData;
         devInfoData.cbSize = sizeof(SP_DEVINFO_DATA);
         if (!SetupDiGetDeviceInterfaceDetailW(devInfo, &ifData, detail, required, NULL, &devInfoData)) {
-            std::ostringstream oss; oss << "SetupDiGetDeviceInterfaceDetailW failed at index " << idx;
-            s_debug_lines.push_back(oss.str());
+            HOTAS_LOG_LIMITED(hotas_log::Level::Warn, "hid", 0, "SetupDiGetDeviceInterfaceDetailW failed at index {}", idx);
             continue;
         }
         const wchar_t* devicePath = detail->DevicePath;
@@ -104,23 +153,16 @@ HotasReader::HotasReader() {
         HANDLE h = CreateFileW(devicePath, GENERIC_READ | GENERIC_WRITE,
             FILE_SHARE_READ | FILE_SHARE_WRITE, NULL, OPEN_EXISTING, 0, NULL);
         if (h == INVALID_HANDLE_VALUE) {
-            std::ostringstream oss; oss << "CreateFileW failed for path: " << wcs_to_utf8(devicePath);
-            s_debug_lines.push_back(oss.str());
+            HOTAS_LOG_LIMITED(hotas_log::Level::Warn, "hid", 0, "CreateFileW failed for path: {}", wcs_to_utf8(devicePath));
             continue;
         }
         // Only open handles for the specific device paths requested (connection-only)
         std::string p = wcs_to_utf8(devicePath);
-        if (p.find("vid_0738&pid_2221") != std::string::npos && (p.find("mi_00") != std::string::npos || p.find("mi_02") != std::string::npos)) {
-            if (internal_state->stick_handle == INVALID_HANDLE_VALUE) {
-                internal_state->stick_handle = h;
-                s_debug_lines.push_back(std::string("Opened stick HID handle: ") + p);
-                continue; // keep handle
-            }
-        }
-        if (p.find("vid_0738&pid_a221") != std::string::npos && (p.find("mi_00") != std::string::npos || p.find("mi_02") != std::string::npos)) {
-            if (internal_state->throttle_handle == INVALID_HANDLE_VALUE) {
-                internal_state->throttle_handle = h;
-                s_debug_lines.push_back(std::string("Opened throttle HID handle: ") + p);
+        if (const DeviceMatch m = internal_state->devices.match(p)) {
+            auto& dev = *internal_state->device_state[(size_t)m.device];
+            if (dev.handle == INVALID_HANDLE_VALUE) {
+                dev.handle = h;
+                HOTAS_LOG_INFO("hid", "Opened {} HID handle: {}", internal_state->devices.device((DeviceIndex)m.device).name, p);
                 continue; // keep handle
             }
         }
@@ -130,139 +172,14 @@ HotasReader::HotasReader() {
 
     SetupDiDestroyDeviceInfoList(devInfo);
 
-    // Load signal descriptors from CSV (single source of truth)
-    auto load_csv_signals = [&](const wchar_t* path)->bool {
-        std::string sp = wcs_to_utf8(path);
-        std::ifstream in(sp.c_str());
-        if (!in) return false;
-        std::string line;
-        // Skip header
-        if (!std::getline(in, line)) return false;
-        std::vector<SignalDescriptor> sigs;
-        while (std::getline(in, line)) {
-            if (line.empty()) continue;
-            // Basic CSV split (no quoted field parsing beyond notes at end)
-            std::vector<std::string> cols; cols.reserve(8);
-            size_t pos = 0;
-            while (pos < line.size()) {
-                size_t comma = line.find(',', pos);
-                if (comma == std::string::npos) comma = line.size();
-                cols.emplace_back(line.substr(pos, comma - pos));
-                pos = (comma == line.size()) ? comma : (comma + 1);
-            }
-            if (cols.size() < 7) continue;
-            std::string device = cols[0];
-            std::string inputType = cols[3];
-            std::string inputId = cols[4];
-            std::string bitRange = cols[5];
-            std::string bitsStr = cols[6];
-            // Parse bit_start from range "A-B" or single number
-            int bit_start = 0; int bits = 0;
-            try {
-                size_t dash = bitRange.find('-');
-                if (dash == std::string::npos) bit_start = std::stoi(bitRange);
-                else bit_start = std::stoi(bitRange.substr(0, dash));
-                bits = std::stoi(bitsStr);
-            } catch (...) { continue; }
-            bool analog = false;
-            {
-                std::string t = inputType; 
-                for (auto &c : t) c = (char)tolower((unsigned char)c);
-                analog = (t.find("analog") != std::string::npos);
-            }
-            // Build display name: uppercase with '-' -> '_' and id-specific casing
-            auto to_upper_underscore = [](std::string s){
-                for (auto &c : s) {
-                    if (c == '-') c = '_';
-                    else c = (char)toupper((unsigned char)c);
-                }
-                return s;
-            };
-            std::string name = to_upper_underscore(inputId);
-            // Normalize known variants
-            if (name == "G-WHEEL") name = "G_WHEEL";
-            HotasReader::SignalDescriptor::DeviceKind dk = HotasReader::SignalDescriptor::DeviceKind::Stick;
-            {
-                std::string d = device; for (auto &c : d) c = (char)tolower((unsigned char)c);
-                if (d.find("throttle") != std::string::npos) dk = HotasReader::SignalDescriptor::DeviceKind::Throttle;
-                else dk = HotasReader::SignalDescriptor::DeviceKind::Stick;
-            }
-            SignalDescriptor sd{ inputId, name, bit_start, bits, analog, dk };
-            sigs.push_back(sd);
-        }
-        internal_state->signals = std::move(sigs);
-        return !internal_state->signals.empty();
-    };
-    // Load signal descriptors strictly from the portable config folder next to the exe
-    
-    load_csv_signals(L"config\\X56_Hotas_hid_bit_map.csv");
-    // Fallback to built-in minimal set if CSV missing
-    if (internal_state->signals.empty()) {
-        internal_state->signals = std::vector<SignalDescriptor>{
-            {"joy_x","JOY_X",8,16,true, SignalDescriptor::DeviceKind::Stick},
-            {"joy_y","JOY_Y",24,16,true, SignalDescriptor::DeviceKind::Stick},
-            {"joy_z","JOY_Z",40,12,true, SignalDescriptor::DeviceKind::Stick},
-            {"c_joy_x","C_JOY_X",80,8,true, SignalDescriptor::DeviceKind::Stick},
-            {"c_joy_y","C_JOY_Y",88,8,true, SignalDescriptor::DeviceKind::Stick},
-            {"C","C",59,1,false, SignalDescriptor::DeviceKind::Stick},
-            {"trigger","TRIGGER",56,1,false, SignalDescriptor::DeviceKind::Stick},
-            {"A","BTN_A",57,1,false, SignalDescriptor::DeviceKind::Stick},
-            {"B","BTN_B",58,1,false, SignalDescriptor::DeviceKind::Stick},
-            {"D","BTN_D",60,1,false, SignalDescriptor::DeviceKind::Stick},
-            {"E","BTN_E",61,1,false, SignalDescriptor::DeviceKind::Stick},
-            {"POV","POV",52,4,false, SignalDescriptor::DeviceKind::Stick},
-            {"H1","H1",62,4,false, SignalDescriptor::DeviceKind::Stick},
-            {"H2","H2",66,4,false, SignalDescriptor::DeviceKind::Stick},
-            {"left_throttle","LEFT_THROTTLE",8,10,true, SignalDescriptor::DeviceKind::Throttle},
-            {"right_throttle","RIGHT_THROTTLE",18,10,true, SignalDescriptor::DeviceKind::Throttle},
-            {"F_wheel","F_WHEEL",64,8,true, SignalDescriptor::DeviceKind::Throttle},
-            {"G_wheel","G_WHEEL",80,8,true, SignalDescriptor::DeviceKind::Throttle},
-            {"RTY3","RTY3",104,8,true, SignalDescriptor::DeviceKind::Throttle},
-            {"RTY4","RTY4",96,8,true, SignalDescriptor::DeviceKind::Throttle},
-            {"thumb_joy_x","THUMB_JOY_X",72,8,true, SignalDescriptor::DeviceKind::Throttle},
-            {"thumb_joy_y","THUMB_JOY_Y",88,8,true, SignalDescriptor::DeviceKind::Throttle},
-            {"pinky_encoder","PINKY_ENCODER",57,2,false, SignalDescriptor::DeviceKind::Throttle},
-            {"thumb_joy_press","THUMB_JOY_PRESS",59,1,false, SignalDescriptor::DeviceKind::Throttle},
-            {"E_th","E",28,1,false, SignalDescriptor::DeviceKind::Throttle},
-            {"F_th","F",29,1,false, SignalDescriptor::DeviceKind::Throttle},
-            {"G_th","G",30,1,false, SignalDescriptor::DeviceKind::Throttle},
-            {"H_th","H",32,1,false, SignalDescriptor::DeviceKind::Throttle},
-            {"I_th","I",31,1,false, SignalDescriptor::DeviceKind::Throttle},
-            {"K1_up","K1_UP",55,1,false, SignalDescriptor::DeviceKind::Throttle},
-            {"K1_down","K1_DOWN",56,1,false, SignalDescriptor::DeviceKind::Throttle},
-            {"slide","SLIDE",60,1,false, SignalDescriptor::DeviceKind::Throttle},
-            {"SW1","SW1",33,1,false, SignalDescriptor::DeviceKind::Throttle},
-            {"SW2","SW2",34,1,false, SignalDescriptor::DeviceKind::Throttle},
-            {"SW3","SW3",35,1,false, SignalDescriptor::DeviceKind::Throttle},
-            {"SW4","SW4",36,1,false, SignalDescriptor::DeviceKind::Throttle},
-            {"SW5","SW5",37,1,false, SignalDescriptor::DeviceKind::Throttle},
-            {"SW6","SW6",38,1,false, SignalDescriptor::DeviceKind::Throttle},
-            {"TGL1_up","TGL1_UP",39,1,false, SignalDescriptor::DeviceKind::Throttle},
-            {"TGL1_down","TGL1_DOWN",40,1,false, SignalDescriptor::DeviceKind::Throttle},
-            {"TGL2_up","TGL2_UP",41,1,false, SignalDescriptor::DeviceKind::Throttle},
-            {"TGL2_down","TGL2_DOWN",42,1,false, SignalDescriptor::DeviceKind::Throttle},
-            {"TGL3_up","TGL3_UP",43,1,false, SignalDescriptor::DeviceKind::Throttle},
-            {"TGL3_down","TGL3_DOWN",44,1,false, SignalDescriptor::DeviceKind::Throttle},
-            {"TGL4_up","TGL4_UP",45,1,false, SignalDescriptor::DeviceKind::Throttle},
-            {"TGL4_down","TGL4_DOWN",46,1,false, SignalDescriptor::DeviceKind::Throttle},
-            {"M1","M1",61,1,false, SignalDescriptor::DeviceKind::Throttle},
-            {"M2","M2",62,1,false, SignalDescriptor::DeviceKind::Throttle},
-            {"S1","S1",63,1,false, SignalDescriptor::DeviceKind::Throttle},
-            {"H3","H3",47,4,false, SignalDescriptor::DeviceKind::Throttle},
-            {"H4","H4",51,4,false, SignalDescriptor::DeviceKind::Throttle}
-        };
+    // Load signal descriptors from CSV (single source of truth); fall back to the
+    // built-in table if the portable config folder next to the exe is missing it.
+    internal_state->signals = load_signals(internal_state->devices, "config");
+    for (const auto& sd : internal_state->signals) {
+        if (sd.report_id != 0) internal_state->device_state[sd.device]->report_id = sd.report_id;
     }
 }
 
-static std::string to_hex(const uint8_t* d, size_t n) {
-    std::ostringstream oss;
-    oss << std::hex;
-    for (size_t i=0;i<n;++i) {
-        oss.width(2); oss.fill('0'); oss << (int)d[i];
-    }
-    return oss.str();
-}
-
 void HotasReader::start_hid_live() {
     if (!internal_state) return;
     if (internal_state->live_running.exchange(true)) return; // already running
@@ -285,13 +202,12 @@ void HotasReader::start_hid_live() {
         }
         std::wstring wp(detail->DevicePath);
         std::string path = wcs_to_utf8(wp.c_str());
-        // Only register paths matching the exact stick/throttle identifiers requested by user
-        if ((path.find("vid_0738&pid_2221") != std::string::npos && (path.find("mi_00") != std::string::npos || path.find("mi_02") != std::string::npos)) ||
-            (path.find("vid_0738&pid_a221") != std::string::npos && (path.find("mi_00") != std::string::npos || path.find("mi_02") != std::string::npos))) {
+        // Only register interfaces of registered devices
+        if (internal_state->devices.match(path)) {
             paths.push_back(wp);
             
             std::lock_guard<std::mutex> g(internal_state->live_mutex);
-            internal_state->live_last[path] = HotasReader::HotasReaderInternalState::LiveEntry{ std::string("(no data yet)"), 0.0 };
+            internal_state->live_last[path] = HotasReader::HotasReaderInternalState::LiveEntry{};
         }
     }
     SetupDiDestroyDeviceInfoList(devInfo);
@@ -308,18 +224,42 @@ void HotasReader::start_hid_live() {
         }
         std::string path = wcs_to_utf8(wp.c_str());
         
+        HotasReader::HotasReaderInternalState::LiveEntry* live = nullptr;
         {
             std::lock_guard<std::mutex> g(internal_state->live_mutex);
             internal_state->live_handles.push_back(h);
-            // Register the path so UI shows it even before any reports arrive
-            internal_state->live_last[path] = HotasReader::HotasReaderInternalState::LiveEntry{ std::string("(no data yet)"), 0.0 };
+            // Register the path so UI shows it even before any reports arrive.
+            // Map nodes are stable; the entry outlives the thread (cleared after join).
+            live = &internal_state->live_last[path];
+            *live = HotasReader::HotasReaderInternalState::LiveEntry{};
         }
-        internal_state->live_threads.emplace_back([this, h, path]() {
+        internal_state->live_threads.emplace_back([this, h, path, live]() {
+            HOTAS_TRACE_THREAD_NAME("hid-read");
+            hotas_rt::ScopedThreadRole role(hotas_rt::ThreadRole::InputIo, "hid-read");
+            // Device this interface belongs to (every monitored path matched the registry),
+            // and whether it feeds the device's pipeline ring
+            const DeviceMatch match = internal_state->devices.match(path);
+            const DeviceIndex device = (DeviceIndex)match.device;
+            auto& dev = *internal_state->device_state[device];
+            HidReportRing* ring = match.report_interface ? &dev.reports : nullptr;
+            ReportIntervalStats* stats = match.report_interface ? &dev.stats : nullptr;
+            auto check_timeout = [&]() {
+                if (dev.connected.load(std::memory_order_relaxed) &&
+                    steady_ns() - dev.last_report_ns.load(std::memory_order_relaxed) > kLiveTimeoutNs) {
+                    internal_state->set_connected(device, false);
+                }
+            };
+            // Reads wait up to 200 ms for a report, so only a much longer gap is a stall
+            std::string stage = "hid-read:" + internal_state->devices.device(device).name;
+            if (!match.report_interface) stage += ":mi_" + std::to_string(match.interface);
+            hotas_watchdog::StageHeartbeat heartbeat(stage.c_str(), 0.5);
             const size_t buf_sz = 64;
             std::vector<uint8_t> rbuf(buf_sz);
             OVERLAPPED ov{}; ov.hEvent = CreateEvent(NULL, TRUE, FALSE, NULL);
             
             while (internal_state->live_running.load()) {
+                HOTAS_NO_ALLOC_ZONE("hid.read");
+                heartbeat.beat();
                 ResetEvent(ov.hEvent);
                 DWORD read = 0;
                 BOOL ok = ReadFile(h, rbuf.data(), (DWORD)buf_sz, &read, &ov);
@@ -330,30 +270,43 @@ void HotasReader::start_hid_live() {
                         if (w == WAIT_OBJECT_0) {
                             GetOverlappedResult(h, &ov, &read, FALSE);
                         } else {
-                            
+                            check_timeout();
                             continue;
                         }
                     } else {
-                        
+                        // Read failed (typically unplugged); the other interface may still report
+                        internal_state->set_connected(device, false);
                         break; // error
                     }
                 }
                 if (read > 0) {
-                    {
-                        
+                    HOTAS_TRACE_SCOPE("hid.read_complete");
+                    const int64_t now_ns = steady_ns();
+                    const double ts = (double)now_ns * 1e-9;
+                    dev.last_report_ns.store(now_ns, std::memory_order_relaxed);
+                    dev.report_count.fetch_add(1, std::memory_order_relaxed);
+                    if (!dev.connected.load(std::memory_order_relaxed)) internal_state->set_connected(device, true);
+                    if (!dev.report_id || rbuf[0] == dev.report_id) {
+                        if (ring) ring->push(rbuf.data(), read, ts);
+                        if (stats) stats->on_report(ts, rbuf.data(), read);
                     }
-                    std::string hex = to_hex(rbuf.data(), read);
-                    double ts = std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+                    const size_t n = std::min<size_t>(read, HidReport::kMaxBytes);
                     std::lock_guard<std::mutex> g(internal_state->live_mutex);
-                    internal_state->live_last[path] = HotasReader::HotasReaderInternalState::LiveEntry{ hex, ts };
+                    std::memcpy(live->data, rbuf.data(), n);
+                    live->len = (uint16_t)n;
+                    live->ts = ts;
+                    // No sleep here: ReadFile already waits for the next report, and sleeping
+                    // would let reports queue in the driver (stamping them late, in bursts)
                 } else {
                     
                     // mark as no data yet
-                    std::lock_guard<std::mutex> g(internal_state->live_mutex);
-                    auto it = internal_state->live_last.find(path);
-                    if (it != internal_state->live_last.end()) it->second.hex = std::string("(no data yet)");
+                    check_timeout();
+                    {
+                        std::lock_guard<std::mutex> g(internal_state->live_mutex);
+                        live->len = 0;
+                    }
+                    std::this_thread::sleep_for(std::chrono::milliseconds(5));
                 }
-                std::this_thread::sleep_for(std::chrono::milliseconds(5));
             }
             CloseHandle(ov.hEvent);
             
@@ -369,6 +322,7 @@ void HotasReader::stop_hid_live() {
     // join threads
     for (auto &t : internal_state->live_threads) if (t.joinable()) t.join();
     internal_state->live_threads.clear();
+    for (size_t d = 0; d < internal_state->device_state.size(); ++d) internal_state->set_connected((DeviceIndex)d, false);
     // close handles
     {
         std::lock_guard<std::mutex> g(internal_state->live_mutex);
@@ -382,20 +336,29 @@ std::vector<std::pair<std::string,std::string>> HotasReader::get_hid_live_snapsh
     std::vector<std::pair<std::string,std::string>> out;
     if (!internal_state) return out;
     std::lock_guard<std::mutex> g(internal_state->live_mutex);
-    for (auto &p : internal_state->live_last) out.emplace_back(p.first, p.second.hex);
+    for (auto &p : internal_state->live_last) {
+        out.emplace_back(p.first, p.second.len ? bytes_to_hex(p.second.data, p.second.len) : std::string("(no data yet)"));
+    }
     return out;
 }
 
+void HotasReader::visit_hid_live(const std::function<void(const std::string&, const uint8_t*, size_t)>& fn) const {
+    if (!internal_state) return;
+    std::lock_guard<std::mutex> g(internal_state->live_mutex);
+    for (auto &p : internal_state->live_last) fn(p.first, p.second.data, p.second.len);
+}
+
 std::vector<std::string> HotasReader::enumerate_devices() {
     std::vector<std::string> lines;
-    s_debug_lines.clear();
+    s_enumerate_started_ns.store(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
 
     GUID hidGuid;
     HidD_GetHidGuid(&hidGuid);
 
     HDEVINFO devInfo = SetupDiGetClassDevsW(&hidGuid, NULL, NULL, DIGCF_PRESENT | DIGCF_DEVICEINTERFACE);
     if (devInfo == INVALID_HANDLE_VALUE) {
-        s_debug_lines.push_back("SetupDiGetClassDevsW failed");
+        HOTAS_LOG_LIMITED(hotas_log::Level::Warn, "hid", 0, "SetupDiGetClassDevsW failed");
         return {};
     }
 
@@ -410,8 +373,7 @@ std::vector<std::string> HotasReader::enumerate_devices() {
         SP_DEVINFO_DATA devInfoData;
         devInfoData.cbSize = sizeof(SP_DEVINFO_DATA);
         if (!SetupDiGetDeviceInterfaceDetailW(devInfo, &ifData, detail, required, NULL, &devInfoData)) {
-            std::ostringstream oss; oss << "SetupDiGetDeviceInterfaceDetailW failed at index " << idx;
-            s_debug_lines.push_back(oss.str());
+            HOTAS_LOG_LIMITED(hotas_log::Level::Warn, "hid", 0, "SetupDiGetDeviceInterfaceDetailW failed at index {}", idx);
             continue;
         }
         const wchar_t* devicePath = detail->DevicePath;
@@ -419,8 +381,7 @@ std::vector<std::string> HotasReader::enumerate_devices() {
         HANDLE h = CreateFileW(devicePath, GENERIC_READ | GENERIC_WRITE,
             FILE_SHARE_READ | FILE_SHARE_WRITE, NULL, OPEN_EXISTING, 0, NULL);
         if (h == INVALID_HANDLE_VALUE) {
-            std::ostringstream oss; oss << "CreateFileW failed for path: " << wcs_to_utf8(devicePath);
-            s_debug_lines.push_back(oss.str());
+            HOTAS_LOG_LIMITED(hotas_log::Level::Warn, "hid", 0, "CreateFileW failed for path: {}", wcs_to_utf8(devicePath));
             continue;
         }
         // Do not query product strings here; only report the device path.
@@ -432,124 +393,91 @@ std::vector<std::string> HotasReader::enumerate_devices() {
     return lines;
 }
 
-std::vector<HotasReader::SignalDescriptor> HotasReader::list_signals() const {
-    if (!internal_state) return {};
-    return internal_state->signals;
+const DeviceRegistry& HotasReader::devices() const {
+    return internal_state->devices;
+}
+
+const HidReportRing& HotasReader::report_ring(DeviceIndex device) const {
+    return internal_state->device_state[device]->reports;
+}
+
+ReportIntervalStats::Snapshot HotasReader::report_stats(DeviceIndex device) const {
+    if (!internal_state || device >= internal_state->device_state.size()) return {};
+    return internal_state->device_state[device]->stats.snapshot();
+}
+
+double HotasReader::report_rate_hz(DeviceIndex device) const {
+    return report_stats(device).nominal_hz;
+}
+
+HotasReader::DeviceLiveness HotasReader::liveness(DeviceIndex device) const {
+    DeviceLiveness out;
+    if (!internal_state || device >= internal_state->device_state.size()) return out;
+    const auto& l = *internal_state->device_state[device];
+    out.connected = l.connected.load(std::memory_order_acquire);
+    out.last_report_ns = l.last_report_ns.load(std::memory_order_relaxed);
+    out.reports = l.report_count.load(std::memory_order_relaxed);
+    out.changes = l.changes.load(std::memory_order_relaxed);
+    // Reader threads flag a timeout only while they run; check the age here as well
+    if (out.connected && steady_ns() - out.last_report_ns > kLiveTimeoutNs) out.connected = false;
+    return out;
+}
+
+void HotasReader::set_liveness_handler(LivenessHandler handler) {
+    if (!internal_state) return;
+    std::lock_guard<std::mutex> g(internal_state->liveness_handler_mutex);
+    internal_state->liveness_handler = std::move(handler);
+}
+
+void HotasReader::reset_report_stats() {
+    if (!internal_state) return;
+    for (auto& d : internal_state->device_state) d->stats.request_reset();
+}
+
+const std::vector<HotasReader::SignalDescriptor>& HotasReader::list_signals() const {
+    static const std::vector<SignalDescriptor> none;
+    return internal_state ? internal_state->signals : none;
 }
 
 HotasReader::~HotasReader() {
     if (internal_state) {
-        if (internal_state->stick_handle != INVALID_HANDLE_VALUE) {
-            CloseHandle(internal_state->stick_handle);
-            internal_state->stick_handle = INVALID_HANDLE_VALUE;
-        }
-        if (internal_state->throttle_handle != INVALID_HANDLE_VALUE) {
-            CloseHandle(internal_state->throttle_handle);
-            internal_state->throttle_handle = INVALID_HANDLE_VALUE;
+        for (auto& d : internal_state->device_state) {
+            if (d->handle != INVALID_HANDLE_VALUE) {
+                CloseHandle(d->handle);
+                d->handle = INVALID_HANDLE_VALUE;
+            }
         }
         delete internal_state;
         internal_state = nullptr;
     }
 }
 
-// Helper: convert hex string to bytes
-static bool hex_to_bytes(const std::string& hex, std::vector<uint8_t>& out) {
-    out.clear();
-    if (hex.size() < 2) return false;
-    auto hexv = [](char c) -> int {
-        if (c >= '0' && c <= '9') return c - '0';
-        if (c >= 'a' && c <= 'f') return 10 + (c - 'a');
-        if (c >= 'A' && c <= 'F') return 10 + (c - 'A');
-        return -1;
-    };
-    for (size_t i = 0; i + 1 < hex.size(); i += 2) {
-        int hi = hexv(hex[i]);
-        int lo = hexv(hex[i+1]);
-        if (hi < 0 || lo < 0) return false;
-        out.push_back(static_cast<uint8_t>((hi << 4) | lo));
-    }
-    return !out.empty();
-}
-
- 
-
 // Poll devices and synthesize a ControllerState from latest HID reports.
-// Uses live_last_hex captured by start_hid_live(); runs independent of UI focus.
+// Uses the latest reports captured by start_hid_live(); runs independent of UI focus.
 HotasSnapshot HotasReader::poll_once() {
     HotasSnapshot snap;
     if (!internal_state) return snap;
 
-    // Grab latest HID hex for known device paths (stick/throttle), requiring freshness
-    std::string stick_hex;
-    std::string throttle_hex;
     double now_sec = std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
     // Advance UI timebase on every poll to avoid apparent freezes when inputs idle
     internal_state->latest.store(now_sec, std::memory_order_release);
-    const double fresh_thresh = 0.5; // seconds
-    {
-        std::lock_guard<std::mutex> g(internal_state->live_mutex);
-        for (const auto& kv : internal_state->live_last) {
-            const std::string& path = kv.first;
-            const auto& entry  = kv.second;
-            const std::string& hex  = entry.hex;
-            if (hex.empty() || hex == "(no data yet)") continue;
-            // Require recent updates to avoid using stale data after disconnect
-            if (entry.ts <= 0.0 || (now_sec - entry.ts) > fresh_thresh) continue;
-            if (path.find("vid_0738&pid_2221") != std::string::npos && (path.find("mi_00") != std::string::npos || path.find("mi_02") != std::string::npos)) {
-                stick_hex = hex;
-            } else if (path.find("vid_0738&pid_a221") != std::string::npos && (path.find("mi_00") != std::string::npos || path.find("mi_02") != std::string::npos)) {
-                throttle_hex = hex;
-            }
-        }
-    }
-    
-
-    std::vector<uint8_t> stick_bytes;
-    std::vector<uint8_t> throttle_bytes;
-    bool have_stick = !stick_hex.empty() && hex_to_bytes(stick_hex, stick_bytes);
-    bool have_throttle = !throttle_hex.empty() && hex_to_bytes(throttle_hex, throttle_bytes);
 
     // Hard-coded stick/throttle → ControllerState mapping removed.
     // This reader only advances time and reports availability; actual mapping is file-driven via HotasMapper.
     // Report ok if any fresh HID data is present (for liveness), but do not synthesize ControllerState here.
-    bool any_ok = have_stick || have_throttle;
-    snap.ok = any_ok;
+    snap.ok = any_connected();
     
 
     return snap;
 }
 
-bool HotasReader::has_stick() const {
-    if (!internal_state) return false;
-    const double now = std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
-    const double fresh_thresh = 0.5; // seconds; consider connected only with recent HID activity
-    std::lock_guard<std::mutex> g(internal_state->live_mutex);
-    for (const auto& kv : internal_state->live_last) {
-        const std::string& path = kv.first;
-        const auto& entry = kv.second;
-        if (path.find("vid_0738&pid_2221") != std::string::npos && (path.find("mi_00") != std::string::npos || path.find("mi_02") != std::string::npos)) {
-            if (!entry.hex.empty() && entry.hex != "(no data yet)" && entry.ts > 0.0 && (now - entry.ts) <= fresh_thresh) {
-                return true;
-            }
-        }
-    }
-    return false;
+bool HotasReader::has_device(DeviceIndex device) const {
+    return liveness(device).connected;
 }
 
-bool HotasReader::has_throttle() const {
+bool HotasReader::any_connected() const {
     if (!internal_state) return false;
-    const double now = std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
-    const double fresh_thresh = 0.5; // seconds; consider connected only with recent HID activity
-    std::lock_guard<std::mutex> g(internal_state->live_mutex);
-    for (const auto& kv : internal_state->live_last) {
-        const std::string& path = kv.first;
-        const auto& entry = kv.second;
-        if (path.find("vid_0738&pid_a221") != std::string::npos && (path.find("mi_00") != std::string::npos || path.find("mi_02") != std::string::npos)) {
-            if (!entry.hex.empty() && entry.hex != "(no data yet)" && entry.ts > 0.0 && (now - entry.ts) <= fresh_thresh) {
-                return true;
-            }
-        }
-    }
+    for (size_t d = 0; d < internal_state->device_state.size(); ++d) if (has_device((DeviceIndex)d)) return true;
     return false;
 }
 
@@ -3,14 +3,19 @@
 #include "xinput_poll.hpp"
 #include <optional>
 #include "core/ring_buffer.hpp"
+#include "core/hid_report_ring.hpp"
+#include "core/report_stats.hpp"
+#include "core/device_registry.hpp"
+#include "core/hid_descriptor.hpp"
 #include <atomic>
+#include <functional>
 #include <vector>
 #include <string>
 
-// HOTAS reader that attempts to find and read the two X56 devices
-// reported by Device Manager: "X56 H.O.T.A.S. Stick (Bulk)" and
-// "X56 H.O.T.A.S. Throttle (Bulk)". It combines their states into a
-// single XInputPoller::ControllerState snapshot for injection.
+// HOTAS reader for the HID controllers in a DeviceRegistry (by default the two
+// X56 halves, "X56 H.O.T.A.S. Stick (Bulk)" and "X56 H.O.T.A.S. Throttle (Bulk)").
+// Every registered device gets its own report ring, statistics and liveness, all
+// addressed by the device's dense registry index.
 
 struct HotasSnapshot {
     bool ok = false;
@@ -19,14 +24,16 @@ struct HotasSnapshot {
 
 class HotasReader {
 public:
-    HotasReader();
+    explicit HotasReader(DeviceRegistry devices = DeviceRegistry::x56());
     ~HotasReader();
 
-    // Poll both devices and return a combined snapshot. ok==true when at least
-    // one device provided usable data (prefer both combined).
+    // Poll all devices and return a combined snapshot. ok==true when at least
+    // one device provided usable data.
     HotasSnapshot poll_once();
-    bool has_stick() const;
-    bool has_throttle() const;
+    const DeviceRegistry& devices() const;
+    // Lock-free: a device is connected while it has reported within the last 0.5 s.
+    bool has_device(DeviceIndex device) const;
+    bool any_connected() const;
     // Snapshot JOY axes into out vectors (timestamps are steady-clock seconds)
     double latest_time() const;
     void snapshot_joys(std::vector<Sample>& out_x, std::vector<Sample>& out_y, double window_seconds) const;
@@ -41,18 +48,61 @@ public:
     void stop_hid_live();
     // Returns pairs of device path and last raw report hex string
     std::vector<std::pair<std::string,std::string>> get_hid_live_snapshot() const;
+    // Same without copies: calls fn(path, bytes, len) for each device (len 0 = no data yet)
+    // under the lock the reader threads take per report, so fn should only copy out
+    void visit_hid_live(const std::function<void(const std::string& path, const uint8_t* data, size_t len)>& fn) const;
 
     // Signal descriptor for a logical HOTAS input
     struct SignalDescriptor {
         std::string id; // unique id
         std::string name; // human label
-        int bit_start;
-        int bits;
-        bool analog;
-        enum class DeviceKind { Stick, Throttle } device; // origin device
+        int bit_start = 0;
+        int bits = 0;
+        bool analog = false;
+        DeviceIndex device = 0;      // registry index of the origin device
+        SignalNorm norm = SignalNorm::Raw;
+        SignalExpand expand = SignalExpand::None;
+        std::string device_name;     // registry name of `device`, the "<device>:" key prefix
+        uint8_t report_id = 0;       // input report the bit offsets refer to; 0 = every report
     };
-    // List signals known by the reader (useful for mapping UI)
-    std::vector<SignalDescriptor> list_signals() const;
+    // List signals known by the reader (useful for mapping UI); fixed after construction
+    const std::vector<SignalDescriptor>& list_signals() const;
+    // Parse a bit map CSV (Device,VID,PID,Input Type,Input,Bit range,# bits,Notes). Rows are
+    // assigned to the registered device with their VID/PID (others skipped). Empty on failure.
+    static std::vector<SignalDescriptor> load_signal_csv(const std::string& path, const DeviceRegistry& devices);
+    // Signals generated from a parsed report descriptor, for registry device `device`: the
+    // usable fields (variable, non-constant, not vendor-defined) of the input report with the
+    // most of them, named by usage ("x", "rz", "hat", "button_3"). Empty when none are usable.
+    static std::vector<SignalDescriptor> descriptor_signals(const HidDescriptor& desc, const DeviceRegistry& devices, DeviceIndex device);
+    // Every device's signals from `config_dir`, grouped by device in registry order: generated
+    // from its "descriptor" (cached in <config_dir>/cache) or read from its bit map CSV
+    static std::vector<SignalDescriptor> load_signals(const DeviceRegistry& devices, const std::string& config_dir);
+    // Built-in X56 table (DeviceRegistry::x56() indices) used when the CSV is missing;
+    // generated from the same CSV at build time, so both give identical descriptors
+    static std::vector<SignalDescriptor> default_signals();
+
+    // Raw report stream of one device (arrival-stamped), for the pipeline.
+    // The ring lives as long as the reader, across start/stop_hid_live().
+    const HidReportRing& report_ring(DeviceIndex device) const;
+    // Inter-report interval statistics of the same stream, and its detected USB report
+    // rate (0 while measuring, or when the device only reports on change).
+    ReportIntervalStats::Snapshot report_stats(DeviceIndex device) const;
+    double report_rate_hz(DeviceIndex device) const;
+    void reset_report_stats();
+
+    // Per-device liveness, kept as atomics by the reader threads (any thread may read).
+    struct DeviceLiveness {
+        bool connected = false;
+        int64_t last_report_ns = 0;  // steady clock; 0 = never
+        uint64_t reports = 0;        // across the device's interfaces
+        uint64_t changes = 0;        // connect/disconnect transitions so far
+    };
+    DeviceLiveness liveness(DeviceIndex device) const;
+    // Called on connect/disconnect transitions, on a reader thread (or the thread calling
+    // stop_hid_live()); keep it short. A disconnect is reported after 0.5 s without
+    // reports or when the device's reads fail. Replaces any previous handler.
+    using LivenessHandler = std::function<void(DeviceIndex, bool connected)>;
+    void set_liveness_handler(LivenessHandler handler);
 
 private:
     // Internal state for HotasReader; keep name explicit and non-abbreviated
@@ -0,0 +1,51 @@
+#pragma once
+#include "output_backend.hpp"
+#include <atomic>
+#include <chrono>
+#include <vector>
+
+// Output backend that drives no device and records what it was sent.
+// Storage is preallocated; submissions beyond capacity are counted but dropped,
+// so the hot path never allocates. Used by benchmarks and on non-Windows builds.
+class RecordingNullOutput : public IOutputBackend {
+public:
+    struct Record {
+        X360Report report;
+        OutputTiming timing;
+        double submit_t = 0.0; // when submit() was called
+    };
+
+    explicit RecordingNullOutput(size_t capacity = 0) : _records(capacity) {}
+
+    bool open() override { _open = true; return true; }
+    void close() override { _open = false; }
+    bool ready() const override { return _open; }
+
+    void submit(const X360Report& report, const OutputTiming& timing) override {
+        const double now = std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+        _submits.fetch_add(1, std::memory_order_relaxed);
+        const size_t n = _count.load(std::memory_order_relaxed);
+        if (n >= _records.size()) return;
+        _records[n] = Record{ report, timing, now };
+        _count.store(n + 1, std::memory_order_release);
+    }
+
+    void send_key(uint32_t vk, bool down) override {
+        (void)vk; (void)down;
+        _key_events.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // Records [0, count()) are stable once observed.
+    size_t count() const { return _count.load(std::memory_order_acquire); }
+    const Record& record(size_t i) const { return _records[i]; }
+    uint64_t submits() const { return _submits.load(std::memory_order_relaxed); }
+    uint64_t key_events() const { return _key_events.load(std::memory_order_relaxed); }
+    void reset() { _count.store(0, std::memory_order_release); _submits.store(0); _key_events.store(0); }
+
+private:
+    std::vector<Record> _records;
+    std::atomic<size_t> _count{0};
+    std::atomic<uint64_t> _submits{0};
+    std::atomic<uint64_t> _key_events{0};
+    bool _open = false;
+};
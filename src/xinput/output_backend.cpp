@@ -0,0 +1,13 @@
+#include "output_backend.hpp"
+#include "null_output.hpp"
+#if defined(_WIN32)
+#include "vigem_output.hpp"
+#endif
+
+std::unique_ptr<IOutputBackend> make_platform_output() {
+#if defined(_WIN32)
+    return std::make_unique<ViGEmOutput>();
+#else
+    return std::make_unique<RecordingNullOutput>();
+#endif
+}
@@ -0,0 +1,52 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+
+// Virtual controller state sent by HotasMapper. Field ranges match ViGEm's
+// XUSB_REPORT so the Windows backend can copy it straight through.
+struct X360Report {
+    uint16_t buttons = 0;      // X360_BUTTON_* mask (same bits as XINPUT_GAMEPAD_*)
+    uint8_t left_trigger = 0;  // 0..255
+    uint8_t right_trigger = 0; // 0..255
+    int16_t lx = 0, ly = 0;    // -32768..32767 (Y up)
+    int16_t rx = 0, ry = 0;
+};
+
+inline constexpr uint16_t X360_BUTTON_DPAD_UP        = 0x0001;
+inline constexpr uint16_t X360_BUTTON_DPAD_DOWN      = 0x0002;
+inline constexpr uint16_t X360_BUTTON_DPAD_LEFT      = 0x0004;
+inline constexpr uint16_t X360_BUTTON_DPAD_RIGHT     = 0x0008;
+inline constexpr uint16_t X360_BUTTON_START          = 0x0010;
+inline constexpr uint16_t X360_BUTTON_BACK           = 0x0020;
+inline constexpr uint16_t X360_BUTTON_LEFT_THUMB     = 0x0040;
+inline constexpr uint16_t X360_BUTTON_RIGHT_THUMB    = 0x0080;
+inline constexpr uint16_t X360_BUTTON_LEFT_SHOULDER  = 0x0100;
+inline constexpr uint16_t X360_BUTTON_RIGHT_SHOULDER = 0x0200;
+inline constexpr uint16_t X360_BUTTON_A              = 0x1000;
+inline constexpr uint16_t X360_BUTTON_B              = 0x2000;
+inline constexpr uint16_t X360_BUTTON_X              = 0x4000;
+inline constexpr uint16_t X360_BUTTON_Y              = 0x8000;
+
+// Timing that travels with each submitted report (steady-clock seconds).
+struct OutputTiming {
+    double source_t = 0.0; // arrival time of the newest HID report reflected in this output
+    double tick_t = 0.0;   // when the mapper tick that built it started
+};
+
+// Where HotasMapper sends its results. Calls come from the mapper publisher
+// thread only (or whoever drives HotasMapper::tick()).
+class IOutputBackend {
+public:
+    virtual ~IOutputBackend() = default;
+    virtual bool open() = 0;   // acquire the device; false if unavailable
+    virtual void close() = 0;
+    virtual bool ready() const = 0;
+    virtual void submit(const X360Report& report, const OutputTiming& timing) = 0;
+    // Windows virtual-key code (see vk_codes.hpp)
+    virtual void send_key(uint32_t vk, bool down) = 0;
+    // System keyboard auto-repeat timing; false keeps the mapper defaults.
+    virtual bool keyboard_repeat(int& delay_ms, int& interval_ms) const { (void)delay_ms; (void)interval_ms; return false; }
+};
+
+// ViGEm on Windows, a RecordingNullOutput elsewhere.
+std::unique_ptr<IOutputBackend> make_platform_output();
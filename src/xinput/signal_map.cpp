@@ -0,0 +1,317 @@
+#include "hotas_reader.hpp"
+#include "core/async_log.hpp"
+#include "generated/x56_bitmap.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// Portable half of HotasReader: the signal bit map does not depend on the HID
+// backend, so tools and benchmarks can load it on any platform.
+
+namespace {
+
+using SignalDescriptor = HotasReader::SignalDescriptor;
+
+// Device-level attributes of a descriptor, taken from its definition; `norm` / `expand`
+// apply to signals the definition does not list
+void annotate(SignalDescriptor& sd, DeviceIndex index, const DeviceDefinition& def,
+              SignalNorm norm = SignalNorm::Raw, SignalExpand expand = SignalExpand::None) {
+    sd.device = index;
+    sd.device_name = def.name;
+    sd.norm = def.norm_of(sd.id, norm);
+    sd.expand = (!sd.analog && sd.bits == 4) ? def.expand_of(sd.id, expand) : SignalExpand::None;
+}
+
+// --- Report descriptor signals ---------------------------------------------------
+
+constexpr uint16_t kPageGenericDesktop = 0x01;
+constexpr uint16_t kPageSimulation = 0x02;
+constexpr uint16_t kPageButton = 0x09;
+constexpr uint16_t kUsageHatSwitch = 0x39;
+
+std::string usage_id(uint16_t page, uint16_t usage) {
+    if (page == kPageGenericDesktop && usage >= 0x30 && usage <= kUsageHatSwitch) {
+        static const char* const names[] = { "x", "y", "z", "rx", "ry", "rz", "slider", "dial", "wheel", "hat" };
+        return names[usage - 0x30];
+    }
+    if (page == kPageSimulation) {
+        switch (usage) {
+        case 0xBA: return "rudder";
+        case 0xBB: return "throttle";
+        case 0xC4: return "accelerator";
+        case 0xC5: return "brake";
+        case 0xC8: return "steering";
+        default: break;
+        }
+    }
+    if (page == kPageButton) return "button_" + std::to_string(usage);
+    char buf[24];
+    std::snprintf(buf, sizeof(buf), "usage_%02x_%02x", page, usage);
+    return buf;
+}
+
+bool usable(const HidField& f) { return !f.constant && f.variable && !f.vendor_defined() && f.bits <= 32; }
+
+// Signals of the descriptor with their usage-derived norm/expand, not yet tied to a device
+std::vector<SignalDescriptor> generate_signals(const HidDescriptor& desc) {
+    // The pipeline decodes one layout per device: take the report with the most usable fields
+    uint8_t report_id = 0;
+    size_t best = 0;
+    for (uint8_t id : desc.report_ids) {
+        const size_t n = (size_t)std::count_if(desc.inputs.begin(), desc.inputs.end(),
+                                               [&](const HidField& f) { return f.report_id == id && usable(f); });
+        if (n > best) { best = n; report_id = id; }
+    }
+    std::vector<SignalDescriptor> sigs;
+    std::vector<std::pair<std::string, int>> seen; // repeated usages become "slider", "slider2", ...
+    for (const HidField& f : desc.inputs) {
+        if (f.report_id != report_id || !usable(f)) continue;
+        const std::string base = usage_id(f.usage_page, f.usage);
+        auto it = std::find_if(seen.begin(), seen.end(), [&](const auto& p) { return p.first == base; });
+        if (it == seen.end()) { seen.emplace_back(base, 0); it = seen.end() - 1; }
+        const int n = ++it->second;
+        const bool hat = f.usage_page == kPageGenericDesktop && f.usage == kUsageHatSwitch;
+        const bool axis_page = f.usage_page == kPageGenericDesktop || f.usage_page == kPageSimulation;
+
+        SignalDescriptor sd;
+        sd.id = n == 1 ? base : base + std::to_string(n);
+        sd.name = sd.id;
+        for (auto& c : sd.name) c = (char)toupper((unsigned char)c);
+        sd.bit_start = f.bit_start;
+        sd.bits = f.bits;
+        sd.analog = !hat && f.usage_page != kPageButton && f.bits > 1;
+        sd.report_id = f.report_id;
+        if (sd.analog && axis_page && !f.relative) sd.norm = f.logical_min < 0 ? SignalNorm::Signed : SignalNorm::FullScale;
+        if (hat && f.bits == 4) {
+            if (f.logical_min == 1 && f.logical_max == 8) sd.expand = SignalExpand::Pov;
+            else if (f.logical_min == 0) sd.expand = SignalExpand::HatSwitch;
+        }
+        sigs.push_back(std::move(sd));
+    }
+    return sigs;
+}
+
+// Generated signals are cached per device, keyed by the descriptor bytes:
+//   # hid descriptor v1 <fnv1a hex>
+//   id,name,bit_start,bits,analog,report_id,norm,expand
+constexpr const char* kCacheTag = "# hid descriptor v1 ";
+
+std::string cache_key(uint64_t hash) {
+    char buf[20];
+    std::snprintf(buf, sizeof(buf), "%016llx", (unsigned long long)hash);
+    return buf;
+}
+
+bool read_signal_cache(const std::string& path, uint64_t hash, std::vector<SignalDescriptor>& out) {
+    std::ifstream in(path);
+    std::string line;
+    if (!in || !std::getline(in, line) || line != kCacheTag + cache_key(hash)) return false;
+    if (!std::getline(in, line)) return false; // column header
+    std::vector<SignalDescriptor> sigs;
+    while (std::getline(in, line)) {
+        if (line.empty()) continue;
+        std::vector<std::string> cols;
+        size_t pos = 0;
+        for (size_t comma; (comma = line.find(',', pos)) != std::string::npos; pos = comma + 1) cols.push_back(line.substr(pos, comma - pos));
+        cols.push_back(line.substr(pos));
+        if (cols.size() != 8) return false;
+        SignalDescriptor sd;
+        try {
+            sd.id = cols[0];
+            sd.name = cols[1];
+            sd.bit_start = std::stoi(cols[2]);
+            sd.bits = std::stoi(cols[3]);
+            sd.analog = cols[4] == "1";
+            sd.report_id = (uint8_t)std::stoi(cols[5]);
+        } catch (...) { return false; }
+        if (!parse_signal_norm(cols[6], sd.norm) || !parse_signal_expand(cols[7], sd.expand)) return false;
+        sigs.push_back(std::move(sd));
+    }
+    if (sigs.empty()) return false;
+    out = std::move(sigs);
+    return true;
+}
+
+void write_signal_cache(const std::string& path, uint64_t hash, const std::vector<SignalDescriptor>& sigs) {
+    std::error_code ec;
+    std::filesystem::create_directories(std::filesystem::path(path).parent_path(), ec);
+    std::ofstream out(path, std::ios::out | std::ios::trunc);
+    if (!out) return; // read-only config: regenerate next run
+    out << kCacheTag << cache_key(hash) << "\n" << "id,name,bit_start,bits,analog,report_id,norm,expand\n";
+    for (const auto& sd : sigs) {
+        out << sd.id << ',' << sd.name << ',' << sd.bit_start << ',' << sd.bits << ',' << (sd.analog ? 1 : 0) << ','
+            << (int)sd.report_id << ',' << signal_norm_name(sd.norm) << ',' << signal_expand_name(sd.expand) << "\n";
+    }
+}
+
+// A device's signals from its "descriptor" file, through the cache; empty when the
+// descriptor is missing, malformed or has nothing but vendor-defined inputs
+std::vector<SignalDescriptor> descriptor_device_signals(const DeviceDefinition& def, const std::string& config_dir) {
+    std::vector<uint8_t> bytes;
+    std::string error;
+    if (!load_hid_descriptor_file(config_dir + "/" + def.descriptor_file, bytes, &error)) {
+        HOTAS_LOG_WARN("hid", "{}: {}", def.name, error);
+        return {};
+    }
+    const uint64_t hash = hid_descriptor_hash(bytes);
+    const std::string cache = config_dir + "/cache/" + def.name + ".signals.csv";
+    std::vector<SignalDescriptor> sigs;
+    if (read_signal_cache(cache, hash, sigs)) return sigs;
+    HidDescriptor desc;
+    if (!parse_hid_descriptor(bytes.data(), bytes.size(), desc, &error)) {
+        HOTAS_LOG_WARN("hid", "{}: report descriptor: {}", def.name, error);
+        return {};
+    }
+    sigs = generate_signals(desc);
+    if (sigs.empty()) {
+        HOTAS_LOG_INFO("hid", "{}: report descriptor has only vendor-defined inputs", def.name);
+        return {};
+    }
+    HOTAS_LOG_INFO("hid", "{}: {} signals from the report descriptor", def.name, sigs.size());
+    write_signal_cache(cache, hash, sigs);
+    return sigs;
+}
+
+// CSV ids are hex without the leading zeros ("738", "a221")
+bool parse_hex_id(const std::string& s, uint16_t& out) {
+    try {
+        size_t used = 0;
+        const unsigned long v = std::stoul(s, &used, 16);
+        if (used != s.size() || v > 0xffff) return false;
+        out = (uint16_t)v;
+        return true;
+    } catch (...) { return false; }
+}
+
+} // namespace
+
+std::vector<HotasReader::SignalDescriptor> HotasReader::load_signal_csv(const std::string& path, const DeviceRegistry& devices) {
+    std::ifstream in(path);
+    if (!in) return {};
+    std::string line;
+    // Skip header
+    if (!std::getline(in, line)) return {};
+    std::vector<SignalDescriptor> sigs;
+    while (std::getline(in, line)) {
+        if (line.empty()) continue;
+        // Basic CSV split (no quoted field parsing beyond notes at end)
+        std::vector<std::string> cols; cols.reserve(8);
+        size_t pos = 0;
+        while (pos < line.size()) {
+            size_t comma = line.find(',', pos);
+            if (comma == std::string::npos) comma = line.size();
+            cols.emplace_back(line.substr(pos, comma - pos));
+            pos = (comma == line.size()) ? comma : (comma + 1);
+        }
+        if (cols.size() < 7) continue;
+        std::string inputType = cols[3];
+        std::string inputId = cols[4];
+        std::string bitRange = cols[5];
+        std::string bitsStr = cols[6];
+        // Rows belong to the registered device with the same VID/PID; others are skipped
+        uint16_t vid = 0, pid = 0;
+        if (!parse_hex_id(cols[1], vid) || !parse_hex_id(cols[2], pid)) continue;
+        const int device = devices.find_usb(vid, pid);
+        if (device < 0) continue;
+        // Parse bit_start from range "A-B" or single number
+        int bit_start = 0; int bits = 0;
+        try {
+            size_t dash = bitRange.find('-');
+            if (dash == std::string::npos) bit_start = std::stoi(bitRange);
+            else bit_start = std::stoi(bitRange.substr(0, dash));
+            bits = std::stoi(bitsStr);
+        } catch (...) { continue; }
+        bool analog = false;
+        {
+            std::string t = inputType; 
+            for (auto &c : t) c = (char)tolower((unsigned char)c);
+            analog = (t.find("analog") != std::string::npos);
+        }
+        // Build display name: uppercase with '-' -> '_' and id-specific casing
+        auto to_upper_underscore = [](std::string s){
+            for (auto &c : s) {
+                if (c == '-') c = '_';
+                else c = (char)toupper((unsigned char)c);
+            }
+            return s;
+        };
+        std::string name = to_upper_underscore(inputId);
+        // Normalize known variants
+        if (name == "G-WHEEL") name = "G_WHEEL";
+        SignalDescriptor sd;
+        sd.id = inputId; sd.name = name; sd.bit_start = bit_start; sd.bits = bits; sd.analog = analog;
+        annotate(sd, (DeviceIndex)device, devices.device((DeviceIndex)device));
+        sigs.push_back(sd);
+    }
+    return sigs;
+}
+
+std::vector<HotasReader::SignalDescriptor> HotasReader::descriptor_signals(const HidDescriptor& desc, const DeviceRegistry& devices, DeviceIndex device) {
+    std::vector<SignalDescriptor> sigs = generate_signals(desc);
+    for (auto& sd : sigs) annotate(sd, device, devices.device(device), sd.norm, sd.expand);
+    return sigs;
+}
+
+std::vector<HotasReader::SignalDescriptor> HotasReader::load_signals(const DeviceRegistry& devices, const std::string& config_dir) {
+    std::vector<SignalDescriptor> sigs;
+    // Devices with a usable report descriptor; the others read their bit map
+    std::vector<bool> generated(devices.size(), false);
+    for (size_t d = 0; d < devices.size(); ++d) {
+        const DeviceDefinition& def = devices.device((DeviceIndex)d);
+        if (def.descriptor_file.empty()) continue;
+        for (auto& sd : descriptor_device_signals(def, config_dir)) {
+            annotate(sd, (DeviceIndex)d, def, sd.norm, sd.expand);
+            sigs.push_back(std::move(sd));
+            generated[d] = true;
+        }
+    }
+    std::vector<std::string> loaded;
+    for (size_t d = 0; d < devices.size(); ++d) {
+        const std::string& csv = devices.device((DeviceIndex)d).bitmap_csv;
+        if (generated[d] || csv.empty() || std::find(loaded.begin(), loaded.end(), csv) != loaded.end()) continue;
+        loaded.push_back(csv);
+        // A shared bit map holds rows for several devices; keep those whose definition names this file
+        for (auto& sd : load_signal_csv(config_dir + "/" + csv, devices)) {
+            if (!generated[sd.device] && devices.device(sd.device).bitmap_csv == csv) sigs.push_back(std::move(sd));
+        }
+    }
+    // X56 halves without a bit map on disk fall back to the built-in table
+    const DeviceRegistry builtin = DeviceRegistry::x56();
+    const std::vector<SignalDescriptor> defaults = default_signals();
+    for (size_t d = 0; d < devices.size(); ++d) {
+        const DeviceDefinition& def = devices.device((DeviceIndex)d);
+        if (std::any_of(sigs.begin(), sigs.end(), [&](const SignalDescriptor& sd) { return sd.device == d; })) continue;
+        const int b = builtin.find_usb(def.vid, def.pid);
+        if (b < 0) continue;
+        for (SignalDescriptor sd : defaults) {
+            if (sd.device != b) continue;
+            annotate(sd, (DeviceIndex)d, def);
+            sigs.push_back(std::move(sd));
+        }
+    }
+    // Grouped by device, in registry order
+    std::stable_sort(sigs.begin(), sigs.end(), [](const SignalDescriptor& a, const SignalDescriptor& b) { return a.device < b.device; });
+    return sigs;
+}
+
+std::vector<HotasReader::SignalDescriptor> HotasReader::default_signals() {
+    // Same rows as the bit map CSV, compiled in by the build (x56_bitmap.hpp)
+    const DeviceRegistry x56 = DeviceRegistry::x56();
+    std::vector<SignalDescriptor> sigs;
+    auto add = [&](DeviceIndex device, const x56_bitmap::Field* fields, size_t count) {
+        for (size_t i = 0; i < count; ++i) {
+            SignalDescriptor sd;
+            sd.id = fields[i].id; sd.name = fields[i].name; sd.bit_start = fields[i].bit_start; sd.bits = fields[i].bits; sd.analog = fields[i].analog;
+            annotate(sd, device, x56.device(device));
+            sigs.push_back(std::move(sd));
+        }
+    };
+    using Stick = x56_bitmap::Layout<DeviceRegistry::kX56Stick>;
+    using Throttle = x56_bitmap::Layout<DeviceRegistry::kX56Throttle>;
+    add(DeviceRegistry::kX56Stick, Stick::fields, Stick::count);
+    add(DeviceRegistry::kX56Throttle, Throttle::fields, Throttle::count);
+    return sigs;
+}
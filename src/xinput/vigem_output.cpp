@@ -0,0 +1,92 @@
+#include "vigem_output.hpp"
+#include "core/trace.hpp"
+#include <Windows.h>
+#include <ViGEm/Client.h>
+
+ViGEmOutput::~ViGEmOutput() { close(); }
+
+bool ViGEmOutput::open() {
+    if (_ready) return true;
+    PVIGEM_CLIENT client = vigem_alloc();
+    if (!client) { return false; }
+    VIGEM_ERROR err = vigem_connect(client);
+    if (!VIGEM_SUCCESS(err)) { vigem_free(client); return false; }
+    PVIGEM_TARGET target = vigem_target_x360_alloc();
+    if (!target) { vigem_free(client); return false; }
+    err = vigem_target_add(client, target);
+    if (!VIGEM_SUCCESS(err)) { vigem_target_free(target); vigem_free(client); return false; }
+    _client = client;
+    _target = target;
+    _ready = true;
+    return true;
+}
+
+void ViGEmOutput::close() {
+    if (_ready) {
+        auto client = static_cast<PVIGEM_CLIENT>(_client);
+        auto target = static_cast<PVIGEM_TARGET>(_target);
+        if (target && client) {
+            vigem_target_remove(client, target);
+            vigem_target_free(target);
+        }
+        if (client) vigem_free(client);
+    }
+    _ready = false;
+    _client = nullptr; _target = nullptr;
+}
+
+void ViGEmOutput::submit(const X360Report& report, const OutputTiming& timing) {
+    (void)timing;
+    if (!_ready) return;
+    XUSB_REPORT rep{};
+    rep.wButtons = report.buttons;
+    rep.bLeftTrigger = report.left_trigger;
+    rep.bRightTrigger = report.right_trigger;
+    rep.sThumbLX = report.lx;
+    rep.sThumbLY = report.ly;
+    rep.sThumbRX = report.rx;
+    rep.sThumbRY = report.ry;
+    HOTAS_TRACE_SCOPE("output.vigem_update");
+    VIGEM_ERROR err = vigem_target_x360_update(static_cast<PVIGEM_CLIENT>(_client), static_cast<PVIGEM_TARGET>(_target), rep);
+    if (!VIGEM_SUCCESS(err)) {
+        // ViGEm update failed; remain silent
+    }
+}
+
+static bool is_extended_vk(UINT vk) {
+    switch (vk) {
+        case VK_RMENU: case VK_RCONTROL:
+        case VK_INSERT: case VK_DELETE:
+        case VK_HOME: case VK_END:
+        case VK_PRIOR: case VK_NEXT: // PageUp/PageDown
+        case VK_LEFT: case VK_RIGHT: case VK_UP: case VK_DOWN:
+        case VK_DIVIDE: case VK_NUMLOCK:
+            return true;
+        default: return false;
+    }
+}
+
+void ViGEmOutput::send_key(uint32_t vk, bool down) {
+    if (vk == 0) return;
+    HKL layout = GetKeyboardLayout(0);
+    UINT sc = MapVirtualKeyEx(vk, MAPVK_VK_TO_VSC, layout);
+    INPUT in{}; in.type = INPUT_KEYBOARD;
+    in.ki.wVk = 0; // use scan code to ensure proper 'code' and game handling
+    in.ki.wScan = (WORD)sc;
+    in.ki.dwFlags = KEYEVENTF_SCANCODE | (down ? 0 : KEYEVENTF_KEYUP);
+    if (is_extended_vk(vk)) in.ki.dwFlags |= KEYEVENTF_EXTENDEDKEY;
+    HOTAS_TRACE_SCOPE("output.send_input");
+    SendInput(1, &in, sizeof(INPUT));
+}
+
+bool ViGEmOutput::keyboard_repeat(int& delay_ms, int& interval_ms) const {
+    UINT delay = 1, speed = 31; // sensible defaults
+    SystemParametersInfoA(SPI_GETKEYBOARDDELAY, 0, &delay, 0);
+    SystemParametersInfoA(SPI_GETKEYBOARDSPEED, 0, &speed, 0);
+    delay_ms = static_cast<int>((delay + 1) * 250); // 0..3 => 250..1000ms
+    // Map 0..31 to approx 2.5..30 cps
+    double cps = 2.5 + (27.5 * (static_cast<double>(speed) / 31.0));
+    int iv = cps > 0.1 ? static_cast<int>(1000.0 / cps) : 40;
+    interval_ms = (iv < 10) ? 10 : iv;
+    return true;
+}
@@ -0,0 +1,21 @@
+#pragma once
+#include "output_backend.hpp"
+
+// ViGEm virtual X360 pad plus SendInput keyboard events (Windows only).
+class ViGEmOutput : public IOutputBackend {
+public:
+    ViGEmOutput() = default;
+    ~ViGEmOutput() override;
+
+    bool open() override;
+    void close() override;
+    bool ready() const override { return _ready; }
+    void submit(const X360Report& report, const OutputTiming& timing) override;
+    void send_key(uint32_t vk, bool down) override;
+    bool keyboard_repeat(int& delay_ms, int& interval_ms) const override;
+
+private:
+    void* _client = nullptr; // PVIGEM_CLIENT
+    void* _target = nullptr; // PVIGEM_TARGET
+    bool _ready = false;
+};
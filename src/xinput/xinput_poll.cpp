@@ -1,4 +1,7 @@
 #include "xinput_poll.hpp"
+#include "core/trace.hpp"
+#include "core/alloc_guard.hpp"
+#include "core/thread_roles.hpp"
 #include <windows.h>
 #include <Xinput.h>
 #include <chrono>
@@ -49,12 +52,14 @@ void XInputPoller::snapshot_with_baseline(Signal sig, std::vector<Sample>& out)
 
 void XInputPoller::clear() {
     for (auto &r : _rings) {
-        r.clear();
+        r.request_clear();
     }
     _latest_time.store(0.0, std::memory_order_release);
 }
 
 void XInputPoller::inject_state(double t, const ControllerState& state) {
+    HOTAS_TRACE_SCOPE("xinput.inject_state");
+    HOTAS_NO_ALLOC_ZONE("xinput.inject_state");
     // Push into rings exactly like the XInput path did
     _rings[(size_t)Signal::LeftX].push(t, state.lx);
     _rings[(size_t)Signal::LeftY].push(t, state.ly);
@@ -108,7 +113,8 @@ void XInputPoller::run(int controller_index) {
     bool prev_connected = false;
 
     // Simplified scheduling: basic deadline, per-loop stats update, minimal logic.
-    SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_ABOVE_NORMAL); // keep slight priority bump
+    HOTAS_TRACE_THREAD_NAME("xinput-poll");
+    hotas_rt::ScopedThreadRole role(hotas_rt::ThreadRole::InputIo, "xinput-poll");
 
     while (_running.load(std::memory_order_relaxed)) {
         controller_index = _controller_index.load(std::memory_order_relaxed);
@@ -5,6 +5,7 @@
 #include <thread>
 #include <atomic>
 #include <vector>
+#include "core/cache_line.hpp"
 #include "core/ring_buffer.hpp"
 
 // Signals enumeration similar to Python version
@@ -59,6 +60,10 @@ public:
 
     void snapshot(Signal sig, std::vector<Sample>& out) const;
     void snapshot_with_baseline(Signal sig, std::vector<Sample>& out) const;
+    // Min/max/mean/RMS/count of a signal over [t0, t1] without copying the window
+    SampleAggregate aggregate(Signal sig, double t0, double t1) const { return _rings[static_cast<size_t>(sig)].aggregate(t0, t1); }
+    // Direct ring access, e.g. to line controller signals up with others in aligned_window()
+    const SampleRing& ring(Signal sig) const { return _rings[static_cast<size_t>(sig)]; }
     // Inject an externally-sourced controller state (e.g. HOTAS reader) into the poller.
     // This will push samples to the internal rings and notify any sink exactly as if
     // the poller had read them itself.
@@ -77,17 +82,20 @@ public:
 
 private:
     void run(int controller_index);
+    // Set from the UI (start/stop and the settings), read by the poller thread every loop
     std::atomic<bool> _running{false};
-    std::atomic<bool> _connected{false};
-    std::atomic<double> _latest_time{0.0};
     std::atomic<double> _target_hz{1000.0};
     std::atomic<double> _window_seconds{30.0};
-    std::atomic<PollStats> _stats; // atomic trivially copyable
-    std::thread _thread;
-
-    std::array<SampleRing, SignalCount> _rings; // sized by capacity
     std::atomic<IControllerSink*> _sink{nullptr};
     std::atomic<int> _controller_index{0};
     std::atomic<bool> _external_only{false};
+    std::thread _thread;
+
+    // Written by the poller thread every loop (or by inject_state()), read by the UI
+    alignas(kCacheLineSize) std::atomic<bool> _connected{false};
+    std::atomic<double> _latest_time{0.0};
+    std::atomic<PollStats> _stats; // atomic trivially copyable
     std::atomic<uint64_t> _samples_captured{0}; // total samples processed by polling thread
+
+    std::array<SampleRing, SignalCount> _rings; // sized by capacity; each ring keeps its write index on its own line
 };